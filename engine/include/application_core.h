@@ -44,6 +44,7 @@ public:
     bool loadObject(const std::string& name, const std::string& path, 
                    const glm::vec3& position, const glm::vec3& scale = glm::vec3(1.0f));
     bool renderToPNG(const std::string& path, int width, int height);
+    bool renderToEXR(const std::string& path, int width, int height);
     bool applyJsonOpsV1(const std::string& json, std::string& error);
     std::string buildShareLink() const;
     std::string sceneToJson() const;
@@ -56,10 +57,6 @@ public:
     void setRaytraceMode(bool enabled);
     bool isRaytraceMode() const;
     
-    // reflection samples per pixel support
-    void setReflectionSpp(int spp);
-    int getReflectionSpp() const;
-    
     // schema validation support
     void setStrictSchema(bool enabled, const std::string& version = "v1.3");
     bool isStrictSchemaEnabled() const;
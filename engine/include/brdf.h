@@ -2,9 +2,58 @@
 
 #include <glm/glm.hpp>
 
+// GGX microfacet BSDF shared by direct lighting and path-traced bounces.
+// All directions are in world space, normalized, and point away from the surface.
 namespace brdf
 {
-    // Cook–Torrance with Beckmann NDF, Cook–Torrance geometry term, Schlick Fresnel.
+    // Artist roughness [0, 1] to GGX alpha (roughness^2), clamped so a
+    // perfectly smooth surface stays a very sharp but finite lobe
+    float roughnessToAlpha(float roughness);
+
+    // GGX (Trowbridge–Reitz) normal distribution function
+    float ggxD(float NdotH, float alpha);
+
+    // Smith masking for one direction, and height-correlated masking-shadowing
+    float smithG1(float NdotX, float alpha);
+    float smithG2(float NdotV, float NdotL, float alpha);
+
+    glm::vec3 fresnelSchlick(float cosTheta, const glm::vec3& F0);
+
+    // Specular lobe D·G2·F / (4·N·V·N·L); the caller multiplies by N·L
+    glm::vec3 ggxSpecular(
+        const glm::vec3& N,
+        const glm::vec3& V,
+        const glm::vec3& L,
+        const glm::vec3& F0,
+        float alpha);
+
+    // Microfacet normal drawn from the normals visible from V
+    // (Heitz 2018, "Sampling the GGX Distribution of Visible Normals")
+    glm::vec3 sampleVisibleNormal(const glm::vec3& N, const glm::vec3& V, float alpha, float u1, float u2);
+
+    // Solid-angle density of L when it is generated by sampleGGXReflection
+    float ggxReflectionPdf(const glm::vec3& N, const glm::vec3& V, const glm::vec3& L, float alpha);
+
+    struct GlossySample
+    {
+        glm::vec3 direction;      // Reflected direction L
+        glm::vec3 weight;         // f·(N·L)/pdf = F·G2/G1(V)
+        float pdf;                // Solid-angle density of direction, for MIS
+    };
+
+    // Importance-sample the specular lobe. Returns false when the sampled
+    // direction ends up below the surface; that path carries no energy.
+    bool sampleGGXReflection(
+        const glm::vec3& N,
+        const glm::vec3& V,
+        const glm::vec3& F0,
+        float roughness,
+        float u1,
+        float u2,
+        GlossySample& sample);
+
+    // Cook–Torrance with GGX NDF, height-correlated Smith G2, Schlick Fresnel,
+    // plus an energy-conserving Lambert diffuse term.
     // Inputs are all in world space and normalized except baseColor.
     // Returns BRDF value (not multiplied by light color/intensity), the caller should multiply by NdotL and light radiance.
     glm::vec3 cookTorrance(
@@ -15,4 +64,3 @@ namespace brdf
         float roughness,
         float metallic);
 }
-
@@ -1,22 +1,413 @@
 #pragma once
 #include <vector>
-#include "triangle.h"
+#include <algorithm>
+#include <cstdint>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <new>
 #include "ray.h"
 #include <glm/glm.hpp>
 
-class BVHNode
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GLINT_BVH_SSE 1
+#include <emmintrin.h>
+#endif
+
+// Flattened BVH node (32 bytes, stored contiguously).
+// Interior nodes keep the index of their left child in leftFirst; the right
+// child always lives at leftFirst + 1. Leaves keep the first entry of their
+// primitive range in leftFirst and a non-zero primCount.
+struct BVHNode
+{
+    glm::vec3 boundsMin{ FLT_MAX };
+    uint32_t  leftFirst = 0;
+    glm::vec3 boundsMax{ -FLT_MAX };
+    uint32_t  primCount = 0;
+
+    bool isLeaf() const { return primCount > 0; }
+};
+static_assert(sizeof(BVHNode) == 32, "BVHNode must stay 32 bytes for cache-friendly traversal");
+
+// std::allocator only guarantees alignof(T); node arrays are allocated on
+// 64-byte boundaries so the sibling pair at an even index fills one line
+template <typename T, size_t Alignment>
+struct AlignedAllocator
+{
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment))); }
+    void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t(Alignment)); }
+
+    template <typename U> bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+using BVHNodeArray = std::vector<BVHNode, AlignedAllocator<BVHNode, 64>>;
+
+// Ray data precomputed once per traversal
+struct BVHRay
+{
+    glm::vec3 origin;
+    glm::vec3 invDir;
+
+    explicit BVHRay(const Ray& r) : origin(r.origin)
+    {
+        // Clamp zero components so the slab test never evaluates 0 * inf
+        auto safeInv = [](float d) { return 1.0f / (std::abs(d) > 1e-20f ? d : std::copysign(1e-20f, d)); };
+        invDir = glm::vec3(safeInv(r.direction.x), safeInv(r.direction.y), safeInv(r.direction.z));
+    }
+};
+
+// Slab test against a node; returns entry distance or FLT_MAX on a miss.
+// Boxes entered beyond tMax are culled.
+inline float intersectNodeBounds(const BVHRay& ray, const BVHNode& node, float tMax)
+{
+    const glm::vec3 t0 = (node.boundsMin - ray.origin) * ray.invDir;
+    const glm::vec3 t1 = (node.boundsMax - ray.origin) * ray.invDir;
+    const glm::vec3 tSmall = glm::min(t0, t1);
+    const glm::vec3 tLarge = glm::max(t0, t1);
+    const float tNear = std::max(std::max(tSmall.x, tSmall.y), std::max(tSmall.z, 0.0f));
+    const float tFar  = std::min(std::min(tLarge.x, tLarge.y), std::min(tLarge.z, tMax));
+    return tNear <= tFar ? tNear : FLT_MAX;
+}
+
+// Four rays traversed together (coherent primary rays). Lanes with a
+// negative tMax are inactive and never enter a node.
+struct BVHRayPacket
+{
+    static constexpr int kWidth = 4;
+
+    alignas(16) float ox[kWidth], oy[kWidth], oz[kWidth];
+    alignas(16) float ix[kWidth], iy[kWidth], iz[kWidth];
+
+    explicit BVHRayPacket(const Ray (&rays)[kWidth])
+    {
+        for (int i = 0; i < kWidth; ++i)
+        {
+            const BVHRay r(rays[i]);
+            ox[i] = r.origin.x; oy[i] = r.origin.y; oz[i] = r.origin.z;
+            ix[i] = r.invDir.x; iy[i] = r.invDir.y; iz[i] = r.invDir.z;
+        }
+    }
+};
+
+// Slab test of all packet lanes against a node. Returns a bitmask of lanes
+// that enter the box before their tMax and the smallest entry distance
+// among them in minNear.
+inline int intersectNodeBounds(const BVHRayPacket& p, const BVHNode& node, const float* tMax, float& minNear)
+{
+#ifdef GLINT_BVH_SSE
+    auto slab = [](float lo, float hi, const float* o, const float* inv, __m128& tNear, __m128& tFar) {
+        const __m128 origin = _mm_load_ps(o), invDir = _mm_load_ps(inv);
+        const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(lo), origin), invDir);
+        const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(hi), origin), invDir);
+        tNear = _mm_max_ps(tNear, _mm_min_ps(t0, t1));
+        tFar = _mm_min_ps(tFar, _mm_max_ps(t0, t1));
+    };
+    __m128 tNear = _mm_setzero_ps();
+    __m128 tFar = _mm_loadu_ps(tMax);
+    slab(node.boundsMin.x, node.boundsMax.x, p.ox, p.ix, tNear, tFar);
+    slab(node.boundsMin.y, node.boundsMax.y, p.oy, p.iy, tNear, tFar);
+    slab(node.boundsMin.z, node.boundsMax.z, p.oz, p.iz, tNear, tFar);
+    const __m128 hit = _mm_cmple_ps(tNear, tFar);
+    const int mask = _mm_movemask_ps(hit);
+    if (mask)
+    {
+        __m128 m = _mm_or_ps(_mm_and_ps(hit, tNear), _mm_andnot_ps(hit, _mm_set1_ps(FLT_MAX)));
+        m = _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+        m = _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+        minNear = _mm_cvtss_f32(m);
+    }
+    return mask;
+#else
+    int mask = 0;
+    minNear = FLT_MAX;
+    for (int i = 0; i < BVHRayPacket::kWidth; ++i)
+    {
+        auto slab = [&](float lo, float hi, float o, float inv, float& tNear, float& tFar) {
+            const float t0 = (lo - o) * inv, t1 = (hi - o) * inv;
+            tNear = std::max(tNear, std::min(t0, t1));
+            tFar = std::min(tFar, std::max(t0, t1));
+        };
+        float tNear = 0.0f, tFar = tMax[i];
+        slab(node.boundsMin.x, node.boundsMax.x, p.ox[i], p.ix[i], tNear, tFar);
+        slab(node.boundsMin.y, node.boundsMax.y, p.oy[i], p.iy[i], tNear, tFar);
+        slab(node.boundsMin.z, node.boundsMax.z, p.oz[i], p.iz[i], tNear, tFar);
+        if (tNear <= tFar) { mask |= 1 << i; minNear = std::min(minNear, tNear); }
+    }
+    return mask;
+#endif
+}
+
+// Linear bounding volume hierarchy built with binned SAH.
+// The BVH only knows primitive bounds; callers resolve primitive indices
+// in the leaf callbacks passed to intersect()/intersectAny().
+class BVH
 {
 public:
-    glm::vec3 boundsMin;
-    glm::vec3 boundsMax;
-    std::vector<const Triangle*> triangles;
-    BVHNode* left = nullptr;
-    BVHNode* right = nullptr;
+    static constexpr int kMaxLeafSize = 8;     // leaves larger than this are always split
+    static constexpr int kMaxDepth = 60;       // keeps traversal stack bounded
+    static constexpr int kStackSize = 64;
+    // Triangle leaves are sized for the 4-wide kernels (triangle_simd.h); 8-wide ones just mask more lanes
+    static constexpr uint32_t kTriangleLeafWidth = 4;
+
+    // Build over primitives described by their axis-aligned bounds.
+    // leafWidth is how many primitives the leaf callback tests at once (SIMD
+    // kernels); the SAH then prices a leaf by ceil(count / leafWidth).
+    void build(const std::vector<glm::vec3>& primMin, const std::vector<glm::vec3>& primMax, uint32_t leafWidth = 1);
+    // Build over an indexed triangle list, bounding each triangle as the
+    // raytracer stores it (v0 plus edges) so no hit falls outside its box
+    void buildTriangles(const glm::vec3* positions, const uint32_t* indices, size_t triangleCount,
+                        uint32_t leafWidth = kTriangleLeafWidth);
+    // Adopt a previously built tree (e.g. from the mesh cache)
+    void assign(BVHNodeArray nodes, std::vector<uint32_t> primIndices);
+    // Recompute node bounds bottom-up after primitives moved; topology is kept
+    void refit(const std::vector<glm::vec3>& primMin, const std::vector<glm::vec3>& primMax);
+    void clear();
+
+    // For callers that permuted their primitive arrays into primIndices() order:
+    // leaves then reference contiguous primitive ranges directly
+    void resetPrimitiveOrder();
+
+    // Surface-area cost of the tree relative to its root; grows as refits degrade quality
+    float sahCost() const;
+
+    bool empty() const { return m_nodes.empty(); }
+    const BVHNodeArray& nodes() const { return m_nodes; }
+    const std::vector<uint32_t>& primIndices() const { return m_primIndices; }
+    size_t nodeCount() const { return m_nodes.size(); }
+    size_t memoryBytes() const { return m_nodes.capacity() * sizeof(BVHNode) + m_primIndices.capacity() * sizeof(uint32_t); }
+
+    // Closest-hit traversal. leafFn(primIndex, tMax) tests one primitive and
+    // must shrink tMax and return true when it records a closer hit.
+    template <typename LeafFn>
+    bool intersect(const Ray& ray, float& tMax, LeafFn&& leafFn) const;
+
+    // Any-hit traversal for occlusion queries; returns on the first primitive
+    // for which leafFn(primIndex, tMax) returns true.
+    template <typename LeafFn>
+    bool intersectAny(const Ray& ray, float tMax, LeafFn&& leafFn) const;
 
-    ~BVHNode();
+    // Leaf-range variants of the above: rangeFn(first, count, tMax) receives
+    // a whole leaf as a range of primIndices() so it can test several
+    // primitives at once (see triangle_simd.h).
+    template <typename RangeFn>
+    bool intersectRanges(const Ray& ray, float& tMax, RangeFn&& rangeFn) const;
+    template <typename RangeFn>
+    bool intersectAnyRanges(const Ray& ray, float tMax, RangeFn&& rangeFn) const;
 
-    bool intersect(const Ray& ray, const Triangle*& outTri, float& outT, glm::vec3& outNormal) const;
+    // Closest-hit traversal of a ray packet. A node is visited while any lane
+    // still enters it; rangeFn(first, count, tMax) tests the leaf for every
+    // active lane and shrinks the per-lane tMax entries it improves.
+    template <typename RangeFn>
+    void intersectPacket(const BVHRayPacket& packet, float (&tMax)[BVHRayPacket::kWidth], RangeFn&& rangeFn) const;
 
-    bool intersectAny(const Ray& ray, const Triangle*& outTri, float& tOut) const;
+    // Any-hit traversal of a ray packet (shadow rays). rangeFn(first, count, tMax)
+    // returns a bitmask of lanes it found occluded; those lanes are retired and
+    // traversal stops once every lane is resolved. Returns the occluded lanes.
+    template <typename RangeFn>
+    int intersectAnyPacket(const BVHRayPacket& packet, float (&tMax)[BVHRayPacket::kWidth], RangeFn&& rangeFn) const;
 
+private:
+    BVHNodeArray m_nodes;
+    std::vector<uint32_t> m_primIndices;
 };
+
+template <typename LeafFn>
+bool BVH::intersect(const Ray& ray, float& tMax, LeafFn&& leafFn) const
+{
+    return intersectRanges(ray, tMax, [&](uint32_t first, uint32_t count, float& t) {
+        bool hit = false;
+        for (uint32_t i = 0; i < count; ++i)
+            hit |= leafFn(m_primIndices[first + i], t);
+        return hit;
+    });
+}
+
+template <typename LeafFn>
+bool BVH::intersectAny(const Ray& ray, float tMax, LeafFn&& leafFn) const
+{
+    return intersectAnyRanges(ray, tMax, [&](uint32_t first, uint32_t count, float t) {
+        for (uint32_t i = 0; i < count; ++i)
+            if (leafFn(m_primIndices[first + i], t))
+                return true;
+        return false;
+    });
+}
+
+template <typename RangeFn>
+bool BVH::intersectRanges(const Ray& ray, float& tMax, RangeFn&& rangeFn) const
+{
+    if (m_nodes.empty()) return false;
+
+    const BVHRay bray(ray);
+    if (intersectNodeBounds(bray, m_nodes[0], tMax) == FLT_MAX) return false;
+
+    struct Entry { uint32_t node; float tNear; };
+    Entry stack[kStackSize];
+    int sp = 0;
+    uint32_t nodeIndex = 0;
+    bool hit = false;
+
+    for (;;)
+    {
+        const BVHNode& node = m_nodes[nodeIndex];
+        if (node.isLeaf())
+        {
+            hit |= rangeFn(node.leftFirst, node.primCount, tMax);
+        }
+        else
+        {
+            // Visit the nearer child first; the farther one is deferred
+            uint32_t nearChild = node.leftFirst;
+            uint32_t farChild = node.leftFirst + 1;
+            float dNear = intersectNodeBounds(bray, m_nodes[nearChild], tMax);
+            float dFar = intersectNodeBounds(bray, m_nodes[farChild], tMax);
+            if (dFar < dNear) { std::swap(dNear, dFar); std::swap(nearChild, farChild); }
+
+            if (dNear != FLT_MAX)
+            {
+                if (dFar != FLT_MAX) stack[sp++] = { farChild, dFar };
+                nodeIndex = nearChild;
+                continue;
+            }
+        }
+
+        // Pop the next candidate that can still beat the current closest hit
+        for (;;)
+        {
+            if (sp == 0) return hit;
+            const Entry e = stack[--sp];
+            if (e.tNear < tMax) { nodeIndex = e.node; break; }
+        }
+    }
+}
+
+template <typename RangeFn>
+bool BVH::intersectAnyRanges(const Ray& ray, float tMax, RangeFn&& rangeFn) const
+{
+    if (m_nodes.empty()) return false;
+
+    const BVHRay bray(ray);
+    uint32_t stack[kStackSize];
+    int sp = 0;
+    stack[sp++] = 0;
+
+    while (sp > 0)
+    {
+        const BVHNode& node = m_nodes[stack[--sp]];
+        if (intersectNodeBounds(bray, node, tMax) == FLT_MAX) continue;
+
+        if (node.isLeaf())
+        {
+            if (rangeFn(node.leftFirst, node.primCount, tMax))
+                return true;
+        }
+        else
+        {
+            stack[sp++] = node.leftFirst + 1;
+            stack[sp++] = node.leftFirst;
+        }
+    }
+    return false;
+}
+
+template <typename RangeFn>
+void BVH::intersectPacket(const BVHRayPacket& packet, float (&tMax)[BVHRayPacket::kWidth], RangeFn&& rangeFn) const
+{
+    if (m_nodes.empty()) return;
+
+    float rootNear;
+    if (!intersectNodeBounds(packet, m_nodes[0], tMax, rootNear)) return;
+
+    struct Entry { uint32_t node; float tNear; };
+    Entry stack[kStackSize];
+    int sp = 0;
+    uint32_t nodeIndex = 0;
+
+    auto farthestHit = [&]() {
+        float t = tMax[0];
+        for (int i = 1; i < BVHRayPacket::kWidth; ++i) t = std::max(t, tMax[i]);
+        return t;
+    };
+
+    for (;;)
+    {
+        const BVHNode& node = m_nodes[nodeIndex];
+        if (node.isLeaf())
+        {
+            rangeFn(node.leftFirst, node.primCount, tMax);
+        }
+        else
+        {
+            // Same ordering as the single-ray path, using the nearest entry
+            // among the lanes that hit each child
+            uint32_t nearChild = node.leftFirst;
+            uint32_t farChild = node.leftFirst + 1;
+            float dNear = FLT_MAX, dFar = FLT_MAX;
+            const int maskNear = intersectNodeBounds(packet, m_nodes[nearChild], tMax, dNear);
+            const int maskFar = intersectNodeBounds(packet, m_nodes[farChild], tMax, dFar);
+            if (!maskNear) dNear = FLT_MAX;
+            if (!maskFar) dFar = FLT_MAX;
+            if (dFar < dNear) { std::swap(dNear, dFar); std::swap(nearChild, farChild); }
+
+            if (dNear != FLT_MAX)
+            {
+                if (dFar != FLT_MAX) stack[sp++] = { farChild, dFar };
+                nodeIndex = nearChild;
+                continue;
+            }
+        }
+
+        // Pop the next candidate that can still beat some lane's closest hit
+        for (;;)
+        {
+            if (sp == 0) return;
+            const Entry e = stack[--sp];
+            if (e.tNear < farthestHit()) { nodeIndex = e.node; break; }
+        }
+    }
+}
+
+template <typename RangeFn>
+int BVH::intersectAnyPacket(const BVHRayPacket& packet, float (&tMax)[BVHRayPacket::kWidth], RangeFn&& rangeFn) const
+{
+    if (m_nodes.empty()) return 0;
+
+    int pending = 0;
+    for (int i = 0; i < BVHRayPacket::kWidth; ++i)
+        if (tMax[i] >= 0.0f) pending |= 1 << i;
+
+    uint32_t stack[kStackSize];
+    int sp = 0;
+    stack[sp++] = 0;
+    int occluded = 0;
+
+    // No child ordering: any blocker will do
+    while (sp > 0 && pending)
+    {
+        const BVHNode& node = m_nodes[stack[--sp]];
+        float tNear;
+        if (!intersectNodeBounds(packet, node, tMax, tNear)) continue;
+
+        if (node.isLeaf())
+        {
+            const int found = rangeFn(node.leftFirst, node.primCount, tMax) & pending;
+            for (int i = 0; i < BVHRayPacket::kWidth; ++i)
+                if (found & (1 << i)) tMax[i] = -1.0f;   // retired lanes never enter a node again
+            occluded |= found;
+            pending &= ~found;
+        }
+        else
+        {
+            stack[sp++] = node.leftFirst + 1;
+            stack[sp++] = node.leftFirst;
+        }
+    }
+    return occluded;
+}
@@ -28,6 +28,7 @@ struct CLIOptions {
     bool enableDenoise = false;
     bool forceRaytrace = false;
     bool strictSchema = false;
+    bool deprecatedReflectionSpp = false; // --refl-spp given; accepted but has no effect
     // New unified render mode flag (raster|ray|auto). '--mode' overrides '--raytrace'
     std::string mode = "auto";
     
@@ -39,7 +40,6 @@ struct CLIOptions {
     
     int outputWidth = 1024;
     int outputHeight = 1024;
-    int reflectionSpp = 8; // Default reflection samples per pixel
     int fixedTimestepMs = 0; // 0 = real-time clock
     
     // Render settings
@@ -66,6 +66,9 @@ private:
     static bool isValidSeed(const std::string& seed);
     static bool isValidExposure(const std::string& exposure);
     static bool isValidGamma(const std::string& gamma);
+    static bool isValidQuality(const std::string& quality);
+    static bool isValidTimeBudget(const std::string& seconds);
+    static bool isValidLodError(const std::string& pixels);
     static LogLevel parseLogLevel(const std::string& level);
     static uint32_t parseSeed(const std::string& seed);
     static float parseExposure(const std::string& exposure);
@@ -1,10 +1,19 @@
 // Centralized defaults for camera presets and related settings
 #pragma once
+#include <cstddef>
 
 namespace Defaults {
     // Default vertical FOV for camera presets (degrees)
     inline constexpr float CameraPresetFovDeg = 45.0f;
     // Extra margin as a fraction of bounding sphere radius
     inline constexpr float CameraPresetMargin = 0.25f;
+    // Mesh and texture bytes uploaded per frame for asynchronous loads
+    inline constexpr size_t AssetUploadBudgetBytes = size_t(64) << 20;
+    // Run MeshOptimizer (dedup, cache and overdraw order) on meshes at import
+    inline constexpr bool OptimizeImportedMeshes = true;
+    // Build MeshLod chains for imported meshes, and the screen-space error
+    // in pixels under which a simplified level is drawn (0 keeps full detail)
+    inline constexpr bool GenerateMeshLods = true;
+    inline constexpr float LodErrorPixels = 1.0f;
 }
 
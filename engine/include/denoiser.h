@@ -0,0 +1,48 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Intel Open Image Denoise wrapper for raytraced frames. The OIDN device and
+// its filter are created on first use and kept across frames; the filter is
+// only rebuilt when the set of guide images changes. Images larger than
+// kMaxUntiledExtent on either side are denoised in overlapping tiles, so the
+// filter's working memory stays that of one tile however large the frame is.
+//
+// Builds without OIDN_ENABLED compile to a denoiser that always fails.
+class Denoiser {
+public:
+    static constexpr int kMaxUntiledExtent = 4096;   // 4K frames go through whole; 8K is tiled
+    static constexpr int kTileExtent = 2048;
+
+    Denoiser();
+    ~Denoiser();
+    Denoiser(const Denoiser&) = delete;
+    Denoiser& operator=(const Denoiser&) = delete;
+
+    // Whether this build can denoise at all
+    static bool isAvailable();
+
+    // Denoise linear HDR color (width * height pixels) in place. albedo and
+    // normal are optional guides of the same size; a normal is only used
+    // together with an albedo, as OIDN requires. Returns false on any error.
+    bool denoise(std::vector<glm::vec3>& color, int width, int height,
+                 const std::vector<glm::vec3>* normal = nullptr,
+                 const std::vector<glm::vec3>* albedo = nullptr);
+
+    // One tile along an axis: the filter reads [origin, origin + tile size)
+    // and its result is kept for [begin, end). Every kept pixel has at least
+    // `overlap` pixels of context on both sides, or the image edge.
+    struct Span {
+        int origin = 0;
+        int begin = 0, end = 0;
+    };
+    // Tiles covering [0, size) exactly once. Origins are multiples of
+    // alignment except for the last tile, which is pulled back inside the
+    // image so every tile has the same size.
+    static std::vector<Span> splitAxis(int size, int tileSize, int overlap, int alignment);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "light_sampler.h"
+
+class TriangleMesh;
+
+namespace raytracer {
+
+    // Point on an emissive surface (or direction toward the environment)
+    // chosen for next event estimation
+    struct EmissiveSample {
+        glm::vec3 point;
+        glm::vec3 direction;       // Unit vector from the shading point to `point`
+        float distance;            // Infinite for the environment
+        glm::vec3 radiance;        // Emitted radiance toward the shading point
+        float pdf;                 // Solid-angle density at the shading point
+    };
+
+    // Area lights made of every triangle of instances whose material emits.
+    // Each emitting instance keeps its own world-space triangles and an
+    // area-weighted table over them; instances themselves are picked in
+    // proportion to emitted power. Emission is uniform and two-sided.
+    //
+    // Updates are per instance: a material change only touches the emitter's
+    // radiance, a transform change re-derives that emitter's triangles, and
+    // either way refresh() then rebuilds the small power table over emitters.
+    class EmissiveLights {
+    public:
+        void clear();
+
+        // (Re)register an instance. A zero radiance removes it as a light.
+        void setInstance(uint32_t instance, const TriangleMesh& mesh, const glm::mat4& objectToWorld,
+                         const glm::vec3& radiance);
+        // Material-only change: keeps the emitter's triangles, deriving them
+        // only when the instance starts emitting
+        void setRadiance(uint32_t instance, const TriangleMesh& mesh, const glm::mat4& objectToWorld,
+                         const glm::vec3& radiance);
+        // Rebuild the emitter selection table after a batch of updates
+        void refresh();
+
+        bool empty() const { return m_power.empty(); }
+        size_t emitterCount() const;
+        size_t triangleCount() const;
+
+        // Emitted radiance of an instance (zero when it is not a light)
+        glm::vec3 radiance(uint32_t instance) const;
+
+        // Choose an emitter, a triangle and a point on it from four uniform
+        // numbers. Fails when nothing emits or the point is degenerate.
+        bool sample(const glm::vec3& p, const float u[4], EmissiveSample& sample) const;
+
+        // Solid-angle density with which sample() would pick `point` on
+        // `instance` (with geometric normal `normal`) as seen from p
+        float pdf(uint32_t instance, const glm::vec3& p, const glm::vec3& point, const glm::vec3& normal) const;
+
+    private:
+        struct Emitter {
+            uint32_t instance = 0;
+            glm::vec3 radiance{ 0.0f };
+            float area = 0.0f;
+            std::vector<glm::vec3> vertices;   // Three world-space corners per triangle
+            AliasTable triangles;              // Proportional to triangle area
+        };
+
+        void buildTriangles(Emitter& emitter, const TriangleMesh& mesh, const glm::mat4& objectToWorld);
+
+        std::vector<Emitter> m_emitters;
+        std::vector<int32_t> m_slot;           // Instance -> m_emitters index, -1 if none
+        AliasTable m_power;
+        bool m_dirty = false;
+    };
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+// CPU copy of an equirectangular HDR environment, shared by the IBL upload
+// and the raytracer. Texel rows run bottom to top (the layout IBLSystem
+// uploads), so u = atan2(z, x) / 2pi + 0.5 and v = asin(y) / pi + 0.5,
+// matching the equirect-to-cubemap shader.
+//
+// Besides the texels it keeps a box-filtered MIP pyramid for blurred
+// lookups and a piecewise-constant 2D distribution (marginal over rows,
+// conditional within each row) proportional to luminance times the
+// solid angle of each texel, for importance-sampling directions.
+class EnvironmentMap
+{
+public:
+    // Load (or fetch from the cache) the environment at hdrPath. Loading
+    // and distribution construction run once per resolved path for as long
+    // as any caller holds the result. Returns nullptr on failure.
+    static std::shared_ptr<const EnvironmentMap> load(const std::string& hdrPath);
+
+    // Build from linear RGB(A) texels, rows bottom to top
+    EnvironmentMap(int width, int height, int channels, const float* pixels);
+
+    int width() const { return m_levels[0].width; }
+    int height() const { return m_levels[0].height; }
+    int levelCount() const { return static_cast<int>(m_levels.size()); }
+    // Full-resolution RGB texels, width() * height() entries
+    const std::vector<glm::vec3>& texels() const { return m_levels[0].texels; }
+
+    // Radiance arriving from direction dir (pointing away from the scene
+    // center), trilinearly filtered at a fractional MIP level
+    glm::vec3 eval(const glm::vec3& dir, float lod = 0.0f) const;
+
+    // MIP level whose texels cover about `solidAngle` steradians
+    float lodForSolidAngle(float solidAngle) const;
+
+    // Direction drawn in proportion to the sampling distribution, with its
+    // solid-angle density. Fails only for an all-black environment.
+    bool sample(float u1, float u2, glm::vec3& dir, float& pdf) const;
+    // Solid-angle density with which sample() returns dir
+    float pdf(const glm::vec3& dir) const;
+
+private:
+    struct Level
+    {
+        int width = 0, height = 0;
+        std::vector<glm::vec3> texels;
+    };
+
+    // Piecewise-constant 1D distribution over [0, 1)
+    struct Distribution
+    {
+        std::vector<float> func;
+        std::vector<float> cdf;      // func.size() + 1 entries, cdf[0] = 0
+        float integral = 0.0f;
+
+        void build(const float* values, int count);
+        // Continuous sample in [0, 1) and the bin it fell into
+        float sample(float u, int& bin) const;
+    };
+
+    glm::vec3 texel(const Level& level, int x, int y) const;
+    glm::vec3 bilinear(const Level& level, float u, float v) const;
+
+    std::vector<Level> m_levels;
+    int m_samplingLevel = 0;                 // Level the distribution was built from
+    std::vector<Distribution> m_conditional; // One per row of the sampling level
+    Distribution m_marginal;
+};
@@ -78,7 +78,8 @@ public:
     // Core drawing operations
     /**
      * @brief Execute a draw command with specified parameters
-     * @param desc Draw command descriptor with pipeline, buffers, counts
+     * @param desc Draw command descriptor with pipeline, buffers, counts;
+     *        instanceCount > 1 draws that many instances in one call
      */
     virtual void draw(const DrawDesc& desc) = 0;
     
@@ -69,7 +69,10 @@ enum class TextureFormat {
     R16F,
     R32F,
     Depth24Stencil8,
-    Depth32F
+    Depth32F,
+    // Vertex attribute formats, read as floats normalized to [0,1] / [-1,1]
+    RGBA16Unorm,
+    RG16Snorm
 };
 
 enum class TextureType {
@@ -233,7 +236,7 @@ struct VertexAttribute {
 struct VertexBinding {
     uint32_t binding = 0;
     uint32_t stride = 0;
-    bool perInstance = false;
+    bool perInstance = false;   // advance once per instance instead of per vertex
     BufferHandle buffer = INVALID_HANDLE;
 };
 
@@ -260,16 +263,22 @@ struct PipelineDesc {
 };
 
 // draw and readback commands
+enum class IndexFormat {
+    Uint32,
+    Uint16
+};
+
 struct DrawDesc {
     PipelineHandle pipeline = INVALID_HANDLE;
     BufferHandle vertexBuffer = INVALID_HANDLE;
     BufferHandle indexBuffer = INVALID_HANDLE;
+    IndexFormat indexFormat = IndexFormat::Uint32;
     uint32_t vertexCount = 0;
     uint32_t indexCount = 0;
-    uint32_t instanceCount = 1;
+    uint32_t instanceCount = 1;     // > 1 repeats the draw, stepping perInstance bindings
     uint32_t firstVertex = 0;
     uint32_t firstIndex = 0;
-    uint32_t firstInstance = 0;
+    uint32_t firstInstance = 0;     // offsets perInstance bindings; emulated by the GL backend (no base instance in GL 3.3 / WebGL2)
 };
 
 struct ReadbackDesc {
@@ -34,13 +34,14 @@ static inline void print_cli_help()
     std::printf("  --help                Show this help\n");
     std::printf("  --version             Print version\n");
     std::printf("  --ops <file>          JSON ops file to apply\n");
-    std::printf("  --render [<png>]      Output PNG path for headless render (defaults to renders/ folder)\n");
+    std::printf("  --render [<png>]      Output PNG path for headless render (defaults to renders/ folder);\n"
+                "                        a .exr path writes linear color with albedo/normal/Z/objectId layers\n");
     std::printf("  --asset-root <dir>    Restrict file access to this directory (security)\n");
     std::printf("  --w <int>             Output image width (default 1024)\n");
     std::printf("  --h <int>             Output image height (default 1024)\n");
     std::printf("  --samples <int>       MSAA sample count for rendering (1 = off)\n");
     std::printf("  --mode <m>            Render mode: raster | ray | auto (default auto)\n");
-    std::printf("  --refl-spp <int>      Reflection samples per pixel for glossy reflections (default 8)\n");
+    std::printf("  --refl-spp <int>      (Deprecated) No effect; glossy bounces share pixel samples\n");
     std::printf("  --fixed-timestep <ms> Use fixed timestep in milliseconds for deterministic updates\n");
     std::printf("  --denoise             Enable denoiser if available\n");
     std::printf("  --raytrace            (Deprecated) Force raytracing; use --mode ray\n");
@@ -51,12 +52,15 @@ static inline void print_cli_help()
     std::printf("  --tone <mode>         Tone mapping: linear, reinhard, aces, filmic (default linear)\n");
     std::printf("  --exposure <float>    Exposure adjustment in EV stops (default 0.0)\n");
     std::printf("  --gamma <float>       Gamma correction value (default 2.2)\n");
+    std::printf("  --quality <float>     Adaptive ray sampling target in (0,1]; noise goal is 1 - quality (default 0.95)\n");
+    std::printf("  --time-budget <sec>   Wall-clock limit for offline ray renders (default 0 = none)\n");
+    std::printf("  --lod-error <px>      Screen error allowed for simplified mesh LODs (default 1, 0 = full detail)\n");
     std::printf("\nJSON Operations v1.3 (Core Operations):\n");
     std::printf("  Object:     load, duplicate, remove/delete, select, transform\n");
     std::printf("  Camera:     set_camera, set_camera_preset, orbit_camera, frame_object\n");
     std::printf("  Lighting:   add_light (point/directional/spot)\n");
     std::printf("  Materials:  set_material, set_background, exposure, tone_map\n");
-    std::printf("  Rendering:  render_image\n");
+    std::printf("  Rendering:  render_image, set_lod_threshold\n");
     std::printf("\nExit Codes:\n");
     std::printf("  0  Success\n");
     std::printf("  2  Schema validation error (when using --strict-schema)\n");
@@ -28,5 +28,20 @@ bool LoadImageFloat(const std::string& path, ImageDataFloat& out, bool flipY = f
 // If flipY is true, vertically flips the image after load.
 bool LoadImage8(const std::string& path, ImageData8& out, bool flipY = false, int desiredChannels = 0);
 
+// One channel of an EXR file, read in place from interleaved pixels.
+enum class ExrPixelType { Half, Float, Uint };
+struct ExrChannel {
+    std::string name;                        // "R", "Z", "albedo.R", ...
+    const void* data = nullptr;              // first component of pixel 0: float, or uint32_t for Uint
+    int stride = 1;                          // components from one pixel to the next
+    ExrPixelType type = ExrPixelType::Half;  // stored type; Half and Float read float input
+};
+
+// Writes any number of channels (sorted by name, as EXR requires) to one
+// ZIP-compressed scanline EXR. Rows are read bottom-up when flipY is set,
+// so GL-ordered buffers need no flipped copy. Requires EXR support.
+bool SaveImageEXR(const std::string& path, int width, int height,
+                  std::vector<ExrChannel> channels, bool flipY = false);
+
 } // namespace ImageIO
 
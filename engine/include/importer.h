@@ -3,9 +3,11 @@
 #include <memory>
 #include "mesh_loader.h"   // MeshData
 #include "pbr_material.h" // todo use material core
+#include "config_defaults.h"
 
 struct ImporterOptions {
     bool flipUV = true; // flip V coordinate on load
+    bool optimize = Defaults::OptimizeImportedMeshes; // run MeshOptimizer on the result
 };
 
 class IImporter {
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glint3d/rhi.h>
+
+struct SceneObject;
+struct MeshBuffers;
+class PipelineManager;
+
+// Instanced drawing of objects that share mesh buffers (duplicates). group()
+// splits a frame's objects into batches that can go out as one draw: same
+// MeshBuffers, same selected LOD level, same material. draw() streams a
+// batch's model matrices into its own region of one ring buffer of
+// per-instance transforms, so no batch overwrites data an earlier draw may
+// still be reading, and draws it through a per-mesh instanced pbr pipeline
+// with firstInstance pointing at that region.
+class InstanceBatcher {
+public:
+    using Batch = std::vector<SceneObject*>;
+
+    static constexpr size_t kMinBatch = 2;         // smaller batches draw one by one
+    static constexpr size_t kFramesInFlight = 3;   // ring holds this many frames of transforms
+    static constexpr size_t kMinCapacity = 256;    // instances
+
+    InstanceBatcher() = default;
+    ~InstanceBatcher();
+    InstanceBatcher(const InstanceBatcher&) = delete;
+    InstanceBatcher& operator=(const InstanceBatcher&) = delete;
+
+    void init(glint3d::RHI* rhi, PipelineManager* pipelines);
+    void shutdown();
+
+    // Batches in order of first appearance; objects without shared mesh
+    // buffers are batches of one. Uses each object's lodLevel as selected
+    // for this frame.
+    static std::vector<Batch> group(const std::vector<SceneObject*>& objects);
+
+    // Grows the ring when the last frame did not fit kFramesInFlight times
+    void beginFrame();
+    // One instanced draw for batch. prepare binds the state shared by the
+    // batch (material, transforms, textures) for its first object and fills
+    // the draw's geometry. False when no instanced pipeline is available, so
+    // the caller draws the objects one by one.
+    bool draw(const Batch& batch, const std::function<void(const SceneObject&, glint3d::DrawDesc&)>& prepare);
+    // Releases pipelines of meshes that no longer exist
+    void endFrame();
+
+    size_t capacity() const { return m_capacity; }
+
+private:
+    void resize(size_t capacity);
+    void releasePipelines();
+
+    struct MeshPipeline {
+        std::weak_ptr<const MeshBuffers> mesh;
+        glint3d::PipelineHandle pipeline = glint3d::INVALID_HANDLE;
+    };
+
+    glint3d::RHI* m_rhi = nullptr;
+    PipelineManager* m_pipelines = nullptr;
+    glint3d::BufferHandle m_transforms = glint3d::INVALID_HANDLE;
+    size_t m_capacity = 0;    // instances in m_transforms
+    size_t m_cursor = 0;      // next free instance in the ring
+    size_t m_frameUsed = 0;   // instances written this frame
+    std::unordered_map<const MeshBuffers*, MeshPipeline> m_meshPipelines;
+    std::vector<glm::mat4> m_scratch;
+};
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
-#include "triangle.h"
+#include <cstdint>
 
 // CPU ray tracing hit record carrying shading payload
 struct HitRecord
@@ -10,7 +10,7 @@ struct HitRecord
     float t = 0.0f;
     glm::vec3 position{0.0f};
     glm::vec3 normal{0.0f, 1.0f, 0.0f};
-    const Triangle* tri = nullptr;
+    uint32_t triangle = 0;     // index into the owning TriangleMesh
 
     // Material snapshot (PBR)
     // Use material core
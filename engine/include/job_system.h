@@ -0,0 +1,59 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Background workers for independent, long-running jobs such as asset
+// loading. ThreadPool runs one blocking batch at a time across every core;
+// here submit() returns immediately with a future and jobs run in FIFO
+// order on a few dedicated threads. A job may itself use ThreadPool.
+class JobSystem
+{
+public:
+    // threadCount 0 = a few workers, leaving cores for ThreadPool batches
+    explicit JobSystem(unsigned threadCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Queue fn() and return a future for its result. Without worker
+    // threads (single-threaded web builds) the job runs when the future
+    // is first waited on.
+    template <typename Fn>
+    auto submit(Fn&& fn) -> std::future<std::invoke_result_t<std::decay_t<Fn>>>;
+
+    unsigned threadCount() const { return static_cast<unsigned>(m_threads.size()); }
+
+    // Process-wide job system
+    static JobSystem& shared();
+
+private:
+    void enqueue(std::function<void()> job);
+    void workerMain();
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::function<void()>> m_jobs;
+    bool m_stop = false;
+};
+
+template <typename Fn>
+auto JobSystem::submit(Fn&& fn) -> std::future<std::invoke_result_t<std::decay_t<Fn>>>
+{
+    using Result = std::invoke_result_t<std::decay_t<Fn>>;
+    if (m_threads.empty())
+        return std::async(std::launch::deferred, std::forward<Fn>(fn));
+
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+    std::future<Result> result = task->get_future();
+    enqueue([task]() { (*task)(); });
+    return result;
+}
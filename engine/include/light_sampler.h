@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "light.h"
+
+namespace raytracer {
+
+    // Distance falloff of point and spot lights
+    inline float distanceAttenuation(float distance) {
+        return 1.0f / (1.0f + 0.1f * distance + 0.01f * distance * distance);
+    }
+
+    // How shading points choose which lights to evaluate
+    enum class LightSampling {
+        Auto,       // All for small rigs, BVH past kExhaustiveLightLimit lights
+        All,        // Every light at every hit; noise free but O(lights)
+        Power,      // Alias table proportional to emitted power
+        BVH         // Light BVH guided by distance, orientation and power
+    };
+
+    // Lights to evaluate at one shading point. With `all` set every light is
+    // evaluated at full weight; otherwise the `fixed` lights at full weight
+    // plus the sampled ones, each scaled by its estimator weight.
+    struct LightSelection {
+        static constexpr int kMaxLights = 4;
+
+        bool all = true;
+        const std::vector<uint32_t>* fixed = nullptr;
+        int count = 0;
+        uint32_t index[kMaxLights];      // Into Light::m_lights
+        float weight[kMaxLights];        // 1 / (picks * probability of the pick)
+    };
+
+    // Walker/Vose alias table: O(1) sampling of a discrete distribution
+    class AliasTable {
+    public:
+        // Weights need not be normalized; all-zero or empty tables sample nothing
+        void build(const std::vector<float>& weights);
+        bool empty() const { return m_bins.empty(); }
+
+        // Index for u in [0, 1), with its probability
+        uint32_t sample(float u, float& pmf) const;
+        float pmf(uint32_t index) const { return m_bins[index].pmf; }
+
+    private:
+        struct Bin {
+            float threshold;
+            uint32_t alias;
+            float pmf;
+        };
+        std::vector<Bin> m_bins;
+    };
+
+    // Emission extent of a light or a cluster of lights: where it is, which
+    // directions it emits into (a cone around axis) and how strongly
+    struct LightBounds {
+        glm::vec3 boundsMin{ 0.0f };
+        glm::vec3 boundsMax{ 0.0f };
+        glm::vec3 axis{ 0.0f, 0.0f, 1.0f };
+        float cosTheta = -1.0f;          // Cone half-angle; -1 emits everywhere
+        float intensity = 0.0f;          // Radiant intensity, luminance-weighted
+
+        // Estimate of this cluster's contribution at p from its closest
+        // point; zero only when no light inside can reach p
+        float importance(const glm::vec3& p, const glm::vec3& n) const;
+    };
+
+    // Chooses a few of many lights per shading point so direct lighting
+    // costs roughly the same however large the rig is. Directional lights
+    // have no position to cull by and stay fixed at every hit.
+    class LightSampler {
+    public:
+        static constexpr int kExhaustiveLightLimit = 8;
+
+        void build(const Light& lights, LightSampling mode, int lightsPerHit);
+
+        // Effective mode after Auto is resolved
+        LightSampling mode() const { return m_mode; }
+
+        // Choose lights for a shading point from up to four uniform numbers
+        void select(const glm::vec3& p, const glm::vec3& n, const float u[4], LightSelection& selection) const;
+
+    private:
+        struct Node {
+            LightBounds bounds;
+            uint32_t offset = 0;     // Leaf: light index; interior: second child
+            bool leaf = false;
+        };
+
+        uint32_t buildNodes(std::vector<uint32_t>& order, uint32_t begin, uint32_t end,
+                            const std::vector<LightBounds>& bounds);
+        bool sampleBVH(const glm::vec3& p, const glm::vec3& n, float u, uint32_t& light, float& pmf) const;
+
+        LightSampling m_mode = LightSampling::All;
+        int m_lightsPerHit = 1;
+        std::vector<uint32_t> m_sampled;       // m_lights index of each sampled light
+        std::vector<uint32_t> m_fixed;         // m_lights indices evaluated every hit
+        AliasTable m_power;
+        std::vector<Node> m_nodes;
+    };
+}
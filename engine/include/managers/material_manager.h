@@ -35,6 +35,10 @@ public:
     // Update material data for a specific object
     void updateMaterialForObject(const SceneObject& obj);
 
+    // True when both objects fill the material block identically and bind the
+    // same textures, so one instanced draw can cover them
+    static bool sameMaterial(const SceneObject& a, const SceneObject& b);
+
     // Update material data from MaterialCore
     void updateMaterial(const MaterialCore& material);
 
@@ -11,6 +11,8 @@
 #include <unordered_map>
 #include <string>
 
+using glint3d::BufferHandle;
+using glint3d::INVALID_HANDLE;
 using glint3d::PipelineHandle;
 using glint3d::RHI;
 using glint3d::ShaderHandle;
@@ -35,6 +37,17 @@ public:
     void ensureObjectPipeline(SceneObject& obj, bool usePbr = true);
     PipelineHandle getOrCreatePipeline(const std::string& pipelineName, bool usePbr = true);
 
+    // Pbr pipeline over obj's mesh buffers plus a per-instance model matrix
+    // (locations 4-7) read from transforms, tightly packed mat4s. Not cached:
+    // the caller owns it and destroys it with the transform buffer
+    PipelineHandle createInstancedPipeline(const SceneObject& obj, BufferHandle transforms);
+    // Pipeline for the deferred g-buffer shader over obj's mesh buffers. Not
+    // cached: stored in obj.rhiPipelineGBuffer and destroyed with the object
+    PipelineHandle createGBufferPipeline(const SceneObject& obj, ShaderHandle shader);
+    // Vertex bindings, attributes (locations 0-2) and index buffer of obj's
+    // mesh, for pipelines built outside the manager
+    static void addMeshLayout(glint3d::PipelineDesc& pd, const SceneObject& obj);
+
     // Shader management
     ShaderHandle getBasicShader() const { return m_basicShaderRhi; }
     ShaderHandle getPbrShader() const { return m_pbrShaderRhi; }
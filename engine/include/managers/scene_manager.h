@@ -5,6 +5,8 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <deque>
+#include <future>
 #include <glm/glm.hpp>
 #include "../light.h"
 #include "../objloader.h"
@@ -27,15 +29,52 @@ using glint3d::INVALID_HANDLE;
 using glint3d::PipelineHandle;
 using glint3d::RHI;
 
+class BVH;
+namespace MeshLod { struct Level; }
+
+// gpu buffers of one mesh. duplicates reference their source's through
+// SceneObject::meshBuffers instead of uploading again; the buffers are
+// destroyed with the last reference
+struct MeshBuffers
+{
+    RHI* rhi = nullptr;
+    BufferHandle positions = INVALID_HANDLE;
+    BufferHandle normals = INVALID_HANDLE;
+    BufferHandle texCoords = INVALID_HANDLE;
+    BufferHandle indices = INVALID_HANDLE;
+    std::vector<BufferHandle> lodIndices;
+
+    MeshBuffers() = default;
+    MeshBuffers(const MeshBuffers&) = delete;
+    MeshBuffers& operator=(const MeshBuffers&) = delete;
+    ~MeshBuffers()
+    {
+        if (!rhi) return;
+        for (BufferHandle buffer : { positions, normals, texCoords, indices })
+            if (buffer != INVALID_HANDLE) rhi->destroyBuffer(buffer);
+        for (BufferHandle buffer : lodIndices)
+            if (buffer != INVALID_HANDLE) rhi->destroyBuffer(buffer);
+    }
+};
+
 struct SceneObject
 {
     std::string name;
-    // rhi buffer handles
+    // rhi buffer handles, owned by meshBuffers and shared with duplicates
+    std::shared_ptr<const MeshBuffers> meshBuffers;
     BufferHandle rhiVboPositions = INVALID_HANDLE;
     BufferHandle rhiVboNormals = INVALID_HANDLE;
     BufferHandle rhiVboTexCoords = INVALID_HANDLE;
     BufferHandle rhiVboTangents = INVALID_HANDLE;   // for pbr tangent data
     BufferHandle rhiEbo = INVALID_HANDLE;
+    // compact buffer formats chosen by MeshOptimizer::gpuLayout at upload
+    glint3d::IndexFormat rhiIndexFormat = glint3d::IndexFormat::Uint32;
+    bool rhiHalfTexCoords = false;
+    // positions are unorm16 and normals octahedral snorm16; the GPU model
+    // matrix is modelMatrix * rhiDequantize
+    glm::mat4 rhiDequantize{ 1.0f };
+    // one index buffer per meshLods level, same format as rhiEbo
+    std::vector<BufferHandle> rhiLodEbos;
     PipelineHandle rhiPipelineBasic = INVALID_HANDLE;   // basic shader pipeline
     PipelineHandle rhiPipelinePbr = INVALID_HANDLE;     // pbr shader pipeline
     PipelineHandle rhiPipelineGBuffer = INVALID_HANDLE; // deferred g-buffer pipeline
@@ -47,10 +86,18 @@ struct SceneObject
     glm::mat4 localMatrix{ 1.0f };        // local transform relative to parent
 
     ObjLoader objLoader;
-    Texture* texture = nullptr;       // legacy diffuse
-    Texture* baseColorTex = nullptr;  // pbr
-    Texture* normalTex = nullptr;     // pbr
-    Texture* mrTex = nullptr;         // pbr (metallic-roughness)
+    // object-space BVH over objLoader's triangles, set when the mesh cache
+    // supplied or stored one; the raytracer builds its own otherwise
+    std::shared_ptr<const BVH> meshBvh;
+    // simplified index buffers over objLoader's vertices, finest first;
+    // shared by duplicates like meshBvh
+    std::shared_ptr<const std::vector<MeshLod::Level>> meshLods;
+    int lodLevel = 0;               // drawn last frame: 0 is the base mesh, i > 0 is meshLods[i - 1]
+    // textures are shared with TextureCache, which may evict its own reference
+    std::shared_ptr<Texture> texture;       // legacy diffuse
+    std::shared_ptr<Texture> baseColorTex;  // pbr
+    std::shared_ptr<Texture> normalTex;     // pbr
+    std::shared_ptr<Texture> mrTex;         // pbr (metallic-roughness)
     Shader* shader = nullptr;
 
     bool      isStatic = false;
@@ -59,6 +106,11 @@ struct SceneObject
     // unified material system - single source of truth (ACTIVE)
     MaterialCore materialCore;
 
+    // change tracking for incremental consumers (raytracer)
+    uint32_t id = 0;                // unique per scene object, never reused
+    uint32_t meshId = 0;            // shared by duplicates that reference the same mesh data
+    uint32_t transformVersion = 0;  // bumped when modelMatrix changes
+    uint32_t materialVersion = 0;   // bumped when materialCore changes
 };
 
 class SceneManager 
@@ -68,8 +120,22 @@ public:
     ~SceneManager();
 
     // object management
+    // synchronous load: loadObjectAsync, then finishLoads
     bool loadObject(const std::string& name, const std::string& path, 
                    const glm::vec3& position, const glm::vec3& scale = glm::vec3(1.0f));
+
+    // asynchronous loading: the mesh is parsed (or mapped from the mesh cache)
+    // and its texture decoded on JobSystem workers. the object joins the scene
+    // when pumpLoads/finishLoads upload it on this thread, in submission order;
+    // the future then holds true. it holds false at once if the name is taken.
+    std::shared_future<bool> loadObjectAsync(const std::string& name, const std::string& path,
+                                             const glm::vec3& position, const glm::vec3& scale = glm::vec3(1.0f));
+    // upload finished loads until budgetBytes of mesh and texture data went to
+    // the gpu (at least one, so large assets still progress); returns objects added
+    size_t pumpLoads(size_t budgetBytes);
+    // wait for every pending load and upload it
+    void finishLoads();
+    bool hasPendingLoads() const { return !m_pendingLoads.empty(); }
     bool removeObject(const std::string& name);
     bool duplicateObject(const std::string& sourceName, const std::string& newName,
                         const glm::vec3* deltaPos = nullptr,
@@ -90,6 +156,12 @@ public:
     void setLocalMatrix(int objectIndex, const glm::mat4& localMatrix);
     void setLocalMatrix(const std::string& name, const glm::mat4& localMatrix);
     glm::mat4 getLocalMatrix(int objectIndex) const;
+
+    // change tracking: call after writing modelMatrix/materialCore directly
+    void markTransformDirty(int objectIndex);
+    void markMaterialDirty(int objectIndex);
+    void markMaterialDirty(const std::string& name);
+    uint64_t getRevision() const { return m_revision; } // changes on any add/remove/transform/material edit
     
     // selection
     void setSelectedObjectIndex(int index) { m_selectedObjectIndex = index; }
@@ -121,8 +193,27 @@ private:
     std::vector<SceneObject> m_objects;
     std::unordered_map<std::string, MaterialCore> m_materials;
     int m_selectedObjectIndex = -1;
+    uint32_t m_nextObjectId = 1;
+    uint64_t m_revision = 0;
+
+    // cpu half of a load, produced on a worker thread
+    struct AssetLoad;
+    struct PendingLoad
+    {
+        std::string name;
+        glm::mat4 localMatrix{ 1.0f };
+        std::future<std::shared_ptr<AssetLoad>> job;
+        std::promise<bool> done;
+    };
+    std::deque<PendingLoad> m_pendingLoads;
+
+    // everything about a load that needs no gpu; runs on a JobSystem worker
+    static std::shared_ptr<AssetLoad> loadAssetData(const std::string& path);
+    // add a finished load to the scene; returns the bytes uploaded
+    size_t finishLoad(PendingLoad& load);
 
     void setupObjectOpenGL(SceneObject& obj);
+    void setupObjectOpenGL(SceneObject& obj, const MeshArrays& mesh);
     void cleanupObjectOpenGL(SceneObject& obj);
 
 public:
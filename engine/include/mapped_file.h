@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Read-only view of a whole file. Desktop builds map the file into memory,
+// so large assets are paged in by the OS as they are read instead of being
+// copied into a buffer first; web builds read the file into memory.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps the file, replacing any previous one. Returns false (and stays
+    // closed) if it cannot be opened; an empty file opens with size() == 0.
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return m_open; }
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;
+#if defined(_WIN32)
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#elif defined(__EMSCRIPTEN__)
+    std::vector<char> m_buffer;
+#endif
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+#include "objloader.h"
+#include "mesh_lod.h"
+
+class BVH;
+struct BVHNode;
+
+// Binary mesh cache (.g3dmesh). After a source file has been parsed once,
+// its finished arrays - positions, normals, texcoords, tangents, indices,
+// bounds, LOD chain - and the raytracer's object-space BVH are written to a versioned
+// container with 64-byte aligned sections. Later loads of the unchanged
+// source map that file instead, so nothing is parsed, derived or rebuilt and
+// GPU buffers are created straight from the mapping.
+//
+// Cache files live in directory(), named by a hash of the source's absolute
+// path, and are only used while the source keeps the size and modification
+// time recorded in them. They are written in host byte order.
+namespace MeshCache {
+
+    constexpr uint32_t kVersion = 3;   // 2: meshes stored after MeshOptimizer, 3: LOD chain
+    constexpr size_t kSectionAlignment = 64;
+
+    // A mapped cache file. Arrays point into the mapping and stay valid
+    // until the view is closed or destroyed.
+    class View {
+    public:
+        bool isOpen() const { return m_file.isOpen(); }
+        void close() { m_file.close(); m_lods.clear(); }
+
+        const MeshArrays& arrays() const { return m_arrays; }
+        const BVHNode* bvhNodes() const { return m_bvhNodes; }
+        size_t bvhNodeCount() const { return m_bvhNodeCount; }
+        // One per triangle
+        const uint32_t* bvhPrimIndices() const { return m_bvhPrimIndices; }
+
+        // LOD levels, finest first; indices point into the mapping
+        struct Lod {
+            const uint32_t* indices;
+            size_t indexCount;
+            float error;
+        };
+        const std::vector<Lod>& lods() const { return m_lods; }
+
+    private:
+        friend bool open(const std::string& sourcePath, View& view);
+        MappedFile m_file;
+        MeshArrays m_arrays;
+        const BVHNode* m_bvhNodes = nullptr;
+        size_t m_bvhNodeCount = 0;
+        const uint32_t* m_bvhPrimIndices = nullptr;
+        std::vector<Lod> m_lods;
+    };
+
+    // Cache directory: $GLINT_MESH_CACHE if set, else glint3d-mesh-cache in
+    // the system temp directory. An empty directory disables the cache.
+    std::string directory();
+    void setDirectory(const std::string& dir);
+
+    // Cache file used for a source path
+    std::string cachePathFor(const std::string& sourcePath);
+
+    // Map the cache entry for sourcePath. Fails without a message when there
+    // is no entry or it is stale, from another version, or damaged: truncated,
+    // or with vertex, triangle or BVH node indices out of range.
+    bool open(const std::string& sourcePath, View& view);
+
+    // Write the entry for sourcePath; bvh must be built over mesh's triangles
+    // and lods over its vertices
+    bool store(const std::string& sourcePath, const MeshArrays& mesh, const BVH& bvh,
+               const std::vector<MeshLod::Level>& lods = {});
+
+} // namespace MeshCache
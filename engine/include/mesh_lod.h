@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "objloader.h"   // MeshArrays
+
+// Levels of detail for raster rendering. simplify() is a quadric error
+// (Garland & Heckbert) edge-collapse simplifier that only moves vertices onto
+// other existing vertices, so every level is just a new index buffer over the
+// base mesh's vertex buffers. Vertices split by attributes (UV or normal
+// seams) collapse together along the seam or not at all, and open borders are
+// held in place by boundary planes, so levels do not tear.
+//
+// Each level records its geometric error: how far, in object units, its
+// surface may deviate from the base mesh. selectLevel() turns that into
+// projected pixels and picks the coarsest level under a threshold.
+namespace MeshLod {
+
+    constexpr int kMaxLevels = 4;             // beyond the base mesh
+    constexpr float kLevelRatio = 0.5f;       // triangles kept per level
+    constexpr size_t kMinTriangles = 64;      // meshes or levels smaller than this stop the chain
+    constexpr float kMaxRelativeError = 0.05f;  // of the bounds diagonal
+    // A coarser level is only taken once its error is this far under the
+    // threshold, so objects near a switch distance do not flicker
+    constexpr float kHysteresis = 0.75f;
+
+    struct Level {
+        std::vector<uint32_t> indices;   // into the base mesh's vertices
+        float error = 0.0f;              // object-space deviation from the base mesh
+    };
+
+    // Simplify toward targetIndexCount without exceeding targetError; writes
+    // the result to destination (room for indexCount) and returns its index
+    // count. resultError receives the largest error introduced.
+    size_t simplify(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+                    const glm::vec3* positions, size_t vertexCount,
+                    size_t targetIndexCount, float targetError, float* resultError = nullptr);
+
+    // Successively halved levels, finest first; empty for small meshes
+    std::vector<Level> buildChain(const MeshArrays& mesh, int maxLevels = kMaxLevels);
+
+    // Screen pixels covered by one object-space unit at distance 1 from the
+    // camera (perspective) or at any distance (orthographic)
+    float pixelsPerUnit(const glm::mat4& projection, int viewportHeight);
+
+    // Level to draw: 0 is the base mesh, i > 0 is errors[i - 1]. pixelScale
+    // is pixelsPerUnit, times the object's scale, over its distance for
+    // perspective views. current is last frame's level.
+    int selectLevel(const float* errors, size_t count, float pixelScale, float thresholdPixels, int current);
+
+} // namespace MeshLod
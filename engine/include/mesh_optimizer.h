@@ -0,0 +1,95 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "mesh_loader.h"   // MeshData
+#include "objloader.h"     // MeshArrays
+
+// Import-time mesh optimization. optimize() rewrites a mesh without changing
+// what it draws:
+//   1. identical vertices (all attributes bit-equal) are merged,
+//   2. triangles are reordered for the post-transform vertex cache (Tipsify,
+//      Sander et al. 2007),
+//   3. the cache-friendly runs are sorted so outward-facing clusters draw
+//      first, cutting overdraw, as long as ACMR stays within
+//      kOverdrawThreshold of step 2's result,
+//   4. vertices are renumbered in first-use order for linear fetches.
+//
+// ACMR is the average number of cache misses (vertex shader runs) per
+// triangle and ATVR the same per vertex; both are simulated with a FIFO of
+// kCacheSize entries. gpuLayout() picks the compact buffer formats
+// SceneManager uploads, and quantize() produces their vertex streams.
+namespace MeshOptimizer {
+
+    constexpr uint32_t kCacheSize = 16;
+    constexpr float kOverdrawThreshold = 1.05f;
+
+    struct CacheStats {
+        float acmr = 0.0f;
+        float atvr = 0.0f;
+    };
+
+    CacheStats analyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                  uint32_t cacheSize = kCacheSize);
+
+    // Merge bit-identical vertices; returns how many were removed
+    size_t dedupVertices(MeshData& mesh);
+    // Reorder triangles in place for a post-transform cache of cacheSize
+    void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount,
+                             uint32_t cacheSize = kCacheSize);
+    // Sort cache-optimized runs of triangles front-to-back from outside the
+    // mesh; keeps the input order when that costs more than threshold x ACMR
+    void optimizeOverdraw(uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t vertexCount,
+                          float threshold = kOverdrawThreshold, uint32_t cacheSize = kCacheSize);
+    // Renumber vertices in first-use order, dropping unreferenced ones
+    void optimizeVertexFetch(MeshData& mesh);
+
+    // Buffer formats for the GPU copy of a mesh. Compact layouts always use
+    // quantize()'s positions and normals; 16-bit indices are used when every
+    // vertex is addressable, half texcoords when every UV survives the
+    // conversion within kHalfTexcoordTolerance.
+    constexpr float kHalfTexcoordTolerance = 1.0f / 2048.0f;
+    struct GpuLayout {
+        bool quantized = false;
+        bool index16 = false;
+        bool halfTexcoords = false;
+        size_t bytes = 0;   // positions, normals, texcoords and indices as uploaded
+    };
+    // compact=false gives the full-float, 32-bit index layout
+    GpuLayout gpuLayout(const MeshArrays& mesh, bool compact = true);
+    std::vector<uint16_t> packIndices16(const unsigned int* indices, size_t count);
+    std::vector<uint16_t> packHalfTexcoords(const glm::vec2* texcoords, size_t count);
+
+    // Octahedral mapping of unit vectors to [-1,1]^2
+    glm::vec2 octEncode(const glm::vec3& n);
+    glm::vec3 octDecode(const glm::vec2& e);
+
+    // Quantized vertex streams. Positions share one scale on all axes, so
+    // dequantize() is a uniform scale plus offset that can be folded into the
+    // model matrix without skewing normals.
+    struct QuantizedMesh {
+        std::vector<uint16_t> positions;    // 4 per vertex: unorm16 xyz, padding
+        glm::vec3 positionOffset{ 0.0f };   // position = offset + scale * q / 65535
+        float positionScale = 1.0f;
+        std::vector<int16_t> normals;       // 2 per vertex: octahedral snorm16
+        // Maps normalized positions (q / 65535) to object space
+        glm::mat4 dequantize() const;
+    };
+    QuantizedMesh quantize(const MeshArrays& mesh);
+
+    struct Report {
+        size_t verticesBefore = 0, verticesAfter = 0;
+        CacheStats before, after;
+        size_t bytesBefore = 0;      // full-float layout of the input
+        size_t bytesAfter = 0;       // gpuLayout() of the result, as uploaded
+    };
+    // Run all four steps on mesh
+    Report optimize(MeshData& mesh);
+    std::string describe(const Report& report);
+
+    // Conversions between the importer's and the loader's representations
+    MeshData toMeshData(const MeshArrays& arrays);
+    MeshArrays arraysOf(const MeshData& mesh);
+
+} // namespace MeshOptimizer
@@ -15,9 +15,18 @@ namespace microfacet
         float roughness,                   // Material roughness [0, 1]
         SeededRNG& rng                     // Random number generator
     );
+
+    // Same, driven by two caller-supplied uniforms in [0, 1) (no allocation,
+    // any sampler can feed it)
+    glm::vec3 sampleBeckmannNormal(
+        const glm::vec3& normal,           // Surface normal
+        float roughness,                   // Material roughness [0, 1]
+        float u1,                          // Polar angle sample
+        float u2                           // Azimuth sample
+    );
     
-    // Sample multiple Beckmann normals with stratified sampling
-    // Returns vector of sampled microfacet normals
+    // Sample multiple Beckmann normals from an Owen-scrambled Sobol set;
+    // rng only picks the scramble. Returns vector of sampled microfacet normals
     std::vector<glm::vec3> sampleBeckmannNormalsStratified(
         const glm::vec3& normal,           // Surface normal
         float roughness,                   // Material roughness [0, 1]
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Wavefront OBJ geometry reader. The file is memory-mapped and cut into
+// newline-aligned chunks that are parsed in parallel on the shared thread
+// pool with std::from_chars, then merged in file order, so the result does
+// not depend on how the file was split.
+//
+// Faces may use v, v/vt, v//vn or v/vt/vn corners with positive or negative
+// (relative) indices; polygons are fan-triangulated. Corners are turned into
+// output vertices by their (v, vt, vn) index triple, so a position is only
+// duplicated where its texture coordinates or normals differ. Texture
+// coordinates and normals are kept only when every face corner has one.
+// Other statements (groups, materials, lines, ...) are ignored.
+namespace ObjReader {
+
+    struct Mesh {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texcoords;   // empty, or one per position
+        std::vector<glm::vec3> normals;     // empty, or one per position
+        std::vector<uint32_t> indices;      // 3 per triangle
+        // OBJ vertex each output vertex came from; empty when that is the
+        // identity (no vertex was split by differing texcoords or normals)
+        std::vector<uint32_t> sourcePositions;
+        // Bounds of every `v` in the file
+        glm::vec3 minBound{0.0f}, maxBound{0.0f};
+    };
+
+    struct Stats {
+        size_t bytes = 0;
+        size_t chunks = 0;
+        double seconds = 0.0;
+        double megabytesPerSecond() const { return seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0; }
+    };
+
+    // Chunks are at least this large so small files are parsed on one thread
+    constexpr size_t kDefaultChunkBytes = size_t(4) << 20;
+
+    // Parse a file. Returns false with a message in error if the file cannot
+    // be read or a face references a vertex that does not exist.
+    bool parseFile(const std::string& path, Mesh& out, std::string* error = nullptr, Stats* stats = nullptr);
+
+    // Parse OBJ text already in memory
+    bool parseBuffer(const char* data, size_t size, Mesh& out, std::string* error = nullptr,
+                     Stats* stats = nullptr, size_t chunkBytes = kDefaultChunkBytes);
+
+} // namespace ObjReader
@@ -1,16 +1,40 @@
 ﻿#pragma once
 
+#include <limits>
+#include <memory>
 #include <vector>
 #include <glm/glm.hpp>
 
 struct Face { unsigned int a, b, c; };
 
+// Flat views of a triangulated mesh's arrays, owned elsewhere. normals,
+// texcoords and tangents are null when absent; all arrays have vertexCount
+// entries except indices (indexCount).
+struct MeshArrays
+{
+    const glm::vec3*    positions = nullptr;
+    const glm::vec3*    normals = nullptr;
+    const glm::vec2*    texcoords = nullptr;
+    const glm::vec3*    tangents = nullptr;
+    size_t              vertexCount = 0;
+    const unsigned int* indices = nullptr;
+    size_t              indexCount = 0;
+    glm::vec3           minBound{ 0.0f }, maxBound{ 0.0f };
+    bool                normalsFromSource = false;
+};
+
+namespace ObjReader { struct Mesh; }
+
+// Copies share one set of arrays (duplicated scene objects reference the same
+// vertex data); a copy that is modified gets its own arrays first.
 class ObjLoader
 {
 public:
     ObjLoader();
 
     void load(const char* filename);
+    // Take over a parsed OBJ mesh, deriving whatever normals/tangents it lacks
+    void setFromParsed(ObjReader::Mesh&& mesh);
     // Populate from raw arrays (triangulated). If normals is empty, they will be computed.
     void setFromRaw(const std::vector<glm::vec3>& positions,
                     const std::vector<unsigned>& indices, // 3*n entries
@@ -18,6 +42,11 @@ public:
                     const std::vector<glm::vec2>& uvs = {},
                     const std::vector<glm::vec3>& tangents = {});
 
+    // Copy finished mesh data as-is (e.g. from the mesh cache); nothing is recomputed
+    void copyFrom(const MeshArrays& arrays);
+    // This mesh's arrays, valid until it is modified
+    MeshArrays arrays() const;
+
     void reset();
 
     int                  getVertCount()  const;
@@ -28,31 +57,40 @@ public:
     const float* getNormals()    const;  // optional (same size as pos)
     const float* getTexcoords()  const;  // optional (2xgetVertCount())
     const float* getTangents()   const;  // optional (3xgetVertCount())
-    bool         hasTexcoords()  const { return !Texcoords.empty(); }
-    bool         hasTangents()   const { return !Tangents.empty(); }
+    bool         hasTexcoords()  const { return !data().Texcoords.empty(); }
+    bool         hasTangents()   const { return !data().Tangents.empty(); }
 
     glm::vec3            getMinBounds()  const;
     glm::vec3            getMaxBounds()  const;
 
     // Diagnostics helpers
     // Returns true if normals were provided by the source (not auto-computed here)
-    bool                 hadNormalsFromSource() const { return m_normalsProvidedFromSource; }
+    bool                 hadNormalsFromSource() const { return data().normalsProvidedFromSource; }
     // Recompute vertex normals using angle-weighted faces (more robust smoothing)
     void                 computeNormalsAngleWeighted();
     // Flip triangle winding and invert vertex normals
     void                 flipWindingAndNormals();
 
 private:
-    void computeNormals();                       // helper
-    void computeTangents();                      // requires positions + normals + texcoords
+    struct Data
+    {
+        std::vector<glm::vec3> Positions;
+        std::vector<Face>      Faces;
+        std::vector<glm::vec3> Normals;
+        std::vector<glm::vec2> Texcoords;
+        std::vector<glm::vec3> Tangents;
+
+        glm::vec3 minBound{ std::numeric_limits<float>::max() };
+        glm::vec3 maxBound{ std::numeric_limits<float>::lowest() };
+
+        bool normalsProvidedFromSource = false;
+    };
 
-    std::vector<glm::vec3> Positions;
-    std::vector<Face>      Faces;
-    std::vector<glm::vec3> Normals;
-    std::vector<glm::vec2> Texcoords;
-    std::vector<glm::vec3> Tangents;
+    const Data& data() const;
+    Data& edit();                                // unshares before writing
 
-    glm::vec3 minBound, maxBound;
+    static void computeNormals(Data& d);         // helper
+    static void computeTangents(Data& d);        // requires positions + normals + texcoords
 
-    bool m_normalsProvidedFromSource = false;
+    std::shared_ptr<Data> m_data;
 };
@@ -10,6 +10,7 @@ public:
     glm::vec3 origin;    // Ray start position
     glm::vec3 direction; // Ray direction (normalized)
 
+    Ray() : origin(0.0f), direction(0.0f, 0.0f, -1.0f) {}
     Ray(const glm::vec3& orig, const glm::vec3& dir)
         : origin(orig), direction(glm::normalize(dir)) {} // Normalize direction
 };
@@ -1,66 +1,330 @@
 ﻿#pragma once
 #include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <climits>
+#include <memory>
 #include "triangle.h"
 #include "ray.h"
 #include "objloader.h"
 #include "material_core.h"
 #include "bvh_node.h"
 #include "light.h"  
-#include "microfacet_sampling.h"
 #include "seeded_rng.h"
 #include "raytracer_lighting.h"
 #include "refraction.h"
+#include "environment_map.h"
+#include "texture_tile_cache.h"
 #include <glm/glm.hpp>
 
+class SceneManager;
+struct SceneObject;
+
+namespace raytracer {
+
+    // Per-pixel data about what each pixel sees, in the color output's layout
+    // (bottom row first)
+    struct AuxiliaryOutputs
+    {
+        std::vector<glm::vec3> albedo;    // first-hit albedo in [0, 1], averaged over the pixel's samples
+        std::vector<glm::vec3> normal;    // first-hit world-space shading normal, averaged likewise
+        std::vector<float> depth;         // view-space depth of the pixel center's hit (infinity on a miss)
+        std::vector<uint32_t> objectId;   // SceneObject::id hit through the pixel center (0 on a miss)
+
+        void reset(size_t pixels);
+        bool empty() const { return albedo.empty(); }
+    };
+}
+
 class Raytracer
 {
 public:
     Raytracer();
 
-    void loadModel(const ObjLoader& loader, const glm::mat4& transform, float reflectivity, const MaterialCore& mat);
+    // Bring the acceleration structures up to date with the scene. Unchanged
+    // scenes cost nothing; moved objects only update their instance and refit
+    // the top level; a mesh's BLAS is built once and shared by all duplicates.
+    void syncScene(const SceneManager& scene);
+    void clearScene();
 
     glm::vec3 traceRay(const Ray& r, const Light& lights, int depth = 3) const;  
+
+    // Shadow ray leaving a shared surface point toward one light
+    struct ShadowQuery
+    {
+        glm::vec3 direction{ 0.0f };     // unit vector toward the light
+        float maxDistance = 0.0f;        // distance to the light (infinity for directional)
+        bool blocked = false;            // output
+    };
+
+    // Any-hit occlusion test: stops at the first blocker, computes no hit data
+    bool occluded(const Ray& ray, float maxDistance) const;
+    // Resolve every shadow ray of one shading point together, in packets
+    void traceShadowRays(const glm::vec3& origin, ShadowQuery* queries, int count) const;
+    // One-shot render: restarts accumulation and traces samplesPerPixel
+    // samples per pixel (a single sample goes through the pixel center)
     void renderImage(std::vector<glm::vec3>& out,
         int W, int H,
         glm::vec3 camPos,
         glm::vec3 camFront,
         glm::vec3 camUp,
         float fovDeg,
-        const Light& lights);
+        const Light& lights,
+        int samplesPerPixel = 1);
+
+    // Progressive render: adds up to `samples` jittered samples per pixel to the
+    // running mean/variance buffers, never exceeding maxSamples in total, and
+    // writes the current mean to out. Accumulation restarts by itself when the
+    // camera, image size, lights, scene or sampling settings change.
+    // Returns the number of samples added (0 once maxSamples is reached).
+    int accumulate(std::vector<glm::vec3>& out,
+        int W, int H,
+        glm::vec3 camPos,
+        glm::vec3 camFront,
+        glm::vec3 camUp,
+        float fovDeg,
+        const Light& lights,
+        int samples,
+        int maxSamples = INT_MAX);
+    void resetAccumulation() { m_accumSamples = 0; }
+
+    // Limits for renderAdaptive()
+    struct AdaptiveSampling
+    {
+        int minSamples = 4;               // per pixel, before a tile may stop
+        int maxSamples = 64;              // per pixel
+        float noiseThreshold = 0.05f;     // relative standard error at which a tile stops
+        float timeBudgetSeconds = 0.0f;   // wall-clock limit, 0 = none
+        bool displayRange = true;         // clamp the output to [0, 1]; false keeps linear HDR radiance
+    };
+
+    // Offline render that spends samples where the image is still noisy. Every
+    // 16x16 tile gets minSamples, then keeps doubling its sample count until
+    // its noise estimate (checked from 4 samples on) drops below the threshold,
+    // it reaches maxSamples, or the time budget runs out. Returns the average
+    // samples per pixel.
+    float renderAdaptive(std::vector<glm::vec3>& out,
+        int W, int H,
+        glm::vec3 camPos,
+        glm::vec3 camFront,
+        glm::vec3 camUp,
+        float fovDeg,
+        const Light& lights,
+        const AdaptiveSampling& settings);
+
+    int getAccumulatedSamples() const { return m_accumSamples; }
+    // Per-pixel sample variance of the accumulated mean (zero below two samples)
+    void getAccumulatedVariance(std::vector<glm::vec3>& out) const;
+
+    using AuxiliaryOutputs = raytracer::AuxiliaryOutputs;
+
+    // Denoiser guides and data passes: when enabled, accumulate() and
+    // renderAdaptive() fill AuxiliaryOutputs alongside the color. Misses
+    // record the background as albedo and a zero normal.
+    void setAuxiliaryOutputs(bool enabled);
+    bool getAuxiliaryOutputsEnabled() const { return m_auxiliaryOutputs; }
+    // Outputs of the last render; empty when they were not recorded
+    const AuxiliaryOutputs& getAuxiliaryOutputs() const { return m_aux; }
     
     // Seed support for deterministic random sampling
-    void setSeed(uint32_t seed) { m_seed = seed; }
+    void setSeed(uint32_t seed) { if (seed != m_seed) { m_seed = seed; resetAccumulation(); } }
     uint32_t getSeed() const { return m_seed; }
-    
-    // Set reflection samples per pixel for glossy reflections
-    void setReflectionSpp(int spp) { m_reflectionSpp = spp; }
-    int getReflectionSpp() const { return m_reflectionSpp; }  
+
+    // HDR environment lighting the scene and seen by rays that miss it;
+    // without one misses return a constant dark background. The environment
+    // is importance-sampled at every path vertex.
+    void setEnvironment(std::shared_ptr<const EnvironmentMap> environment, float intensity = 1.0f);
+    void setEnvironmentIntensity(float intensity) { setEnvironment(m_environment, intensity); }
+    const EnvironmentMap* getEnvironment() const { return m_environment.get(); }
+    float getEnvironmentIntensity() const { return m_environmentIntensity; }
+
+    // Memory the texture cache may keep resident (see raytracer::TextureTileCache)
+    void setTextureBudget(size_t bytes) { m_textures.setBudget(bytes); }
+    size_t getTextureBudget() const { return m_textures.getBudget(); }
+    size_t getTextureCount() const { return m_textures.textureCount(); }
+
+    // Maximum number of path vertices (primary hit included) per sample
+    void setMaxDepth(int depth);
+    int getMaxDepth() const { return m_maxDepth; }
+
+    // How shading points pick lights (see raytracer::LightSampling) and how
+    // many they sample per hit when not evaluating every light
+    void setLightSampling(raytracer::LightSampling mode, int lightsPerHit = 1);
+    raytracer::LightSampling getLightSampling() const { return m_lightSampling; }
+    int getLightsPerHit() const { return m_lightsPerHit; }
+
+    // Fraction of the current (or last) renderImage() completed; safe to poll
+    // from another thread while rendering
+    float getRenderProgress() const
+    {
+        const uint32_t total = m_tilesTotal.load(std::memory_order_relaxed);
+        return total ? static_cast<float>(m_tilesDone.load(std::memory_order_relaxed)) / total : 0.0f;
+    }
+
+    // Acceleration structure statistics (diagnostics / benchmarks)
+    size_t getInstanceCount() const { return m_instances.size(); }
+    size_t getMeshCount() const { return m_blas.size(); }
+    size_t getTriangleCount() const;          // unique object-space triangles
+    size_t getEmissiveTriangleCount() const { return m_emissive.triangleCount(); }
+    size_t getAccelMemoryBytes() const;
 
 private:
-    std::vector<Triangle> triangles;
-    glm::vec3 lightPos, lightColor;
-    BVHNode* bvhRoot;
+    // Bottom level: object-space geometry of one mesh, shared by every instance
+    struct MeshBlas
+    {
+        uint32_t meshId = 0;
+        TriangleMesh mesh;               // triangles stored in BVH leaf order
+        BVH bvh;
+    };
+
+    // Top level entry: one per scene object with geometry
+    struct Instance
+    {
+        uint32_t objectId = 0;
+        uint32_t transformVersion = 0;
+        uint32_t materialVersion = 0;
+        uint32_t blas = 0;               // index into m_blas
+        uint32_t material = 0;           // index into m_materials
+        float reflectivity = 0.0f;
+        glm::mat4 worldToObject{ 1.0f };
+        glm::mat3 normalToWorld{ 1.0f };  // inverse-transpose of the object-to-world 3x3
+        glm::mat3 vectorToWorld{ 1.0f };  // object-to-world 3x3, for edges and tangents
+        glm::vec3 worldMin{ 0.0f };
+        glm::vec3 worldMax{ 0.0f };
+    };
+
+    struct HitRecord
+    {
+        float t = FLT_MAX;
+        float u = 0.0f, v = 0.0f;         // barycentrics within the triangle
+        uint32_t triangle = 0;
+        uint32_t instance = 0;
+    };
+
+    static constexpr int kPacketSize = BVHRayPacket::kWidth;
+    static constexpr int kTileSize = 16;   // pixels; even so 2x2 packets never straddle tiles
+    static constexpr int kRouletteDepth = 3; // path vertices before Russian roulette kicks in
+
+    // Texture maps of one material as cache handles (kNoTexture when absent
+    // or when the mesh has no texture coordinates)
+    struct MaterialTextures
+    {
+        uint32_t baseColor = raytracer::TextureTileCache::kNoTexture;
+        uint32_t normal = raytracer::TextureTileCache::kNoTexture;
+        uint32_t metallicRoughness = raytracer::TextureTileCache::kNoTexture;
+
+        bool any() const
+        {
+            return baseColor != raytracer::TextureTileCache::kNoTexture || normal != raytracer::TextureTileCache::kNoTexture ||
+                   metallicRoughness != raytracer::TextureTileCache::kNoTexture;
+        }
+    };
+
+    // What the denoiser needs from a pixel's first path vertex
+    struct FirstHit
+    {
+        glm::vec3 albedo{ 0.0f };
+        glm::vec3 normal{ 0.0f };
+    };
+
+    // Pinhole camera basis for primary ray generation
+    struct CameraRays
+    {
+        glm::vec3 origin, center, right, up;
+        int width = 0, height = 0;
+        float pixelSpread = 0.0f;        // angle one pixel subtends, in radians
+    };
+
+    static CameraRays makeCameraRays(int W, int H, const glm::vec3& camPos, const glm::vec3& camFront,
+                                     const glm::vec3& camUp, float fovDeg);
+    // Add samples [firstSample, firstSample + samples) to every pixel of the
+    // tile [x0,x1) x [y0,y1), updating the running mean/M2 buffers and, when
+    // not null, the auxiliary outputs
+    void traceTileSamples(const CameraRays& camera, int x0, int y0, int x1, int y1,
+                          int firstSample, int samples, const Light& lights,
+                          glm::vec3* mean, glm::vec3* m2, AuxiliaryOutputs* aux) const;
+    bool intersectClosest(const Ray& ray, HitRecord& hit) const;
+    int intersectClosest(const Ray (&rays)[kPacketSize], HitRecord (&hits)[kPacketSize]) const;
+    // Iterative path integrator: follows one path from an already found hit,
+    // adding emission and direct light at every vertex and continuing along
+    // a single reflection or refraction lobe. Vertex k draws its light
+    // choices from 4D group 4k+1 of the sampler, its point on emissive
+    // geometry from group 4k+2, its environment direction from group 4k+3
+    // and its bounce from group 4k+4 (group 0 is the pixel position).
+    // Without a light sampler every analytic light is evaluated.
+    // Texture lookups follow a ray cone starting at pixelSpread radians
+    // (zero reads full-resolution textures). firstHit, when given, receives
+    // the denoiser guides of the first vertex.
+    // No recursion and no heap allocation.
+    glm::vec3 tracePath(Ray ray, HitRecord hit, const Light& lights, int depth,
+                        const SobolSampler& sampler, const raytracer::LightSampler* lightSampler,
+                        float pixelSpread, FirstHit* firstHit) const;
+    // Material at a hit with its texture maps applied, for a ray of the given
+    // direction whose footprint there is footprintWidth wide. Returns the
+    // instance's material untouched when it has no maps; otherwise fills and
+    // returns `textured`, and bends `normal` by the normal map.
+    const MaterialCore& applyTextures(const Instance& inst, const HitRecord& hit, const glm::vec3& direction,
+                                      float footprintWidth, glm::vec3& normal, MaterialCore& textured) const;
+    void updateLightSampler(const Light& lights, uint64_t lightsKey);
+    // Radiance of a ray leaving the scene, at a MIP level of the environment
+    glm::vec3 background(const glm::vec3& direction, float lod) const;
+    void rebuildScene(const std::vector<SceneObject>& objects);
+    uint32_t acquireBlas(const SceneObject& obj);
+    void updateInstanceTransform(Instance& inst, const SceneObject& obj);
+    void updateInstanceMaterial(Instance& inst, const SceneObject& obj);
+    // Keep instance `index` in the emissive light table; geometryChanged
+    // re-derives its world-space triangles, otherwise only radiance changes
+    void updateInstanceEmission(uint32_t index, const SceneObject& obj, bool geometryChanged);
+    void buildTLAS();
+    void refitTLAS();
+
+    std::vector<MeshBlas> m_blas;
+    std::unordered_map<uint32_t, uint32_t> m_blasByMesh;   // meshId -> m_blas index
+    std::vector<Instance> m_instances;
+    std::vector<MaterialCore> m_materials;            // texture paths dropped, see m_materialTextures
+    std::vector<MaterialTextures> m_materialTextures;  // parallel to m_materials
+    raytracer::TextureTileCache m_textures;
+    BVH m_tlas;
+    float m_builtTlasCost = 0.0f;     // TLAS quality right after the last full build
+    const SceneManager* m_syncedScene = nullptr;
+    uint64_t m_syncedRevision = 0;
     uint32_t m_seed = 0;
-    int m_reflectionSpp = 8; // Default reflection samples per pixel
-    
-    // Helper method for glossy reflection sampling
-    glm::vec3 sampleGlossyReflection(
-        const glm::vec3& hitPoint,
-        const glm::vec3& viewDir,
-        const glm::vec3& normal,
-        const MaterialCore& material,
-        const Light& lights,
-        int depth,
-        SeededRng& rng
-    ) const;
+    int m_maxDepth = 3;
+
+    // Triangles of emissive instances, updated per instance with the scene
+    raytracer::EmissiveLights m_emissive;
+    std::shared_ptr<const EnvironmentMap> m_environment;
+    float m_environmentIntensity = 1.0f;
+
+    // Light selection, rebuilt when the rig or the sampling settings change
+    raytracer::LightSampler m_lightSampler;
+    raytracer::LightSampling m_lightSampling = raytracer::LightSampling::Auto;
+    int m_lightsPerHit = 1;
+    uint64_t m_lightSamplerKey = 0;
+    bool m_lightSamplerValid = false;
+
+    // Progressive accumulation: running mean and Welford M2 per pixel, stored
+    // in output order, plus the inputs they were rendered with
+    std::vector<glm::vec3> m_accumMean;
+    std::vector<glm::vec3> m_accumM2;
+    int m_accumSamples = 0;
+    int m_accumWidth = 0;
+    int m_accumHeight = 0;
+    glm::vec3 m_accumCamPos{ 0.0f }, m_accumCamFront{ 0.0f }, m_accumCamUp{ 0.0f };
+    float m_accumFov = 0.0f;
+    uint64_t m_accumLightsKey = 0;
+    // Empty unless auxiliary outputs are on
+    bool m_auxiliaryOutputs = false;
+    AuxiliaryOutputs m_aux;
+    std::atomic<uint32_t> m_tilesDone{ 0 };
+    std::atomic<uint32_t> m_tilesTotal{ 0 };
     
-    // Helper method for refraction
-    glm::vec3 computeRefraction(
+    // Continuation sampling for tracePath
+    Ray sampleRefraction(
         const glm::vec3& hitPoint,
         const glm::vec3& incident,
         const glm::vec3& normal,
         const MaterialCore& material,
-        const Light& lights,
-        int depth
+        float u
     ) const;
 };
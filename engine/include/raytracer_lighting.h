@@ -3,6 +3,8 @@
 #include "light.h"
 #include "material_core.h"
 #include "ray.h"
+#include "light_sampler.h"
+#include "emissive_lights.h"
 
 // Forward declaration
 class Raytracer;
@@ -14,6 +16,7 @@ namespace raytracer {
         glm::vec3 direction;      // Direction from hit point to light
         glm::vec3 color;          // Light color * intensity
         float distance;           // Distance to light (infinite for directional)
+        float pdf;                // Solid-angle density of area light samples; 0 for delta lights
         bool valid;               // Whether this light contributes
     };
 
@@ -56,14 +59,37 @@ namespace raytracer {
             const Raytracer& raytracer
         );
 
-        // Complete lighting calculation for a surface point
+        // Complete lighting calculation for a surface point, over every
+        // light or only the ones a LightSampler picked, plus directions
+        // sampled toward emissive geometry or the environment
         static glm::vec3 computeLighting(
             const glm::vec3& hitPoint,
             const glm::vec3& normal,
             const glm::vec3& viewDir,
             const MaterialCore& material,
             const Light& lights,
-            const Raytracer& raytracer
+            const Raytracer& raytracer,
+            const LightSelection& selection = LightSelection(),
+            const EmissiveSample* areaSamples = nullptr,
+            int areaSampleCount = 0
+        );
+
+        // Direct light reflected by the GGX specular lobe alone (the path
+        // tracer's reflection lobe); no diffuse or ambient term. When the
+        // caller also continues the path by sampling this lobe, the area and
+        // environment samples are MIS-weighted against it (power heuristic).
+        static glm::vec3 computeGlossyLighting(
+            const glm::vec3& hitPoint,
+            const glm::vec3& normal,
+            const glm::vec3& viewDir,
+            const glm::vec3& F0,
+            float roughness,
+            const Light& lights,
+            const Raytracer& raytracer,
+            const LightSelection& selection = LightSelection(),
+            const EmissiveSample* areaSamples = nullptr,
+            int areaSampleCount = 0,
+            bool lobeSampled = false
         );
     };
 
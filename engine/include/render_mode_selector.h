@@ -47,7 +47,8 @@ struct RenderConfig {
     int maxRayDepth = 8;             // max ray bounces for ray tracing
     int minSamples = 1;              // min samples per pixel
     int maxSamples = 64;             // max samples per pixel
-    float qualityThreshold = 0.95f;  // quality threshold for auto mode
+    float qualityThreshold = 0.95f;  // adaptive ray sampling: a tile stops at relative noise <= 1 - threshold
+    float timeBudgetSeconds = 0.0f;  // wall-clock cap for offline ray renders (0 = none)
     bool enableDenoising = true;     // enable ai denoising for ray tracing
 };
 
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <cstdint>
+#include "config_defaults.h"
 
 enum class ToneMappingMode {
     Linear,
@@ -24,6 +25,17 @@ struct RenderSettings {
 
     // Multisample anti-aliasing sample count (1 = off)
     int samples = 1;
+
+    // Adaptive ray sampling target in (0, 1]; tiles stop once their relative
+    // noise drops to 1 - quality
+    float quality = 0.95f;
+
+    // Wall-clock budget for offline ray renders in seconds (0 = unlimited)
+    float timeBudget = 0.0f;
+
+    // Projected mesh error in pixels under which a simplified level of
+    // detail is drawn (0 = always full detail)
+    float lodErrorPixels = Defaults::LodErrorPixels;
     
     // Helper functions
     static ToneMappingMode parseToneMapping(const std::string& str);
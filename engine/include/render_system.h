@@ -44,6 +44,8 @@
 #include <glint3d/uniform_blocks.h>
 #include "render_mode_selector.h"
 #include "render_pass.h"
+#include "config_defaults.h"
+#include "instance_batcher.h"
 
 using glint3d::BufferHandle;
 using glint3d::PipelineHandle;
@@ -56,11 +58,13 @@ using glint3d::TextureHandle;
 class SceneManager;
 class Light;
 class Raytracer;
+namespace raytracer { struct AuxiliaryOutputs; }
 class AxisRenderer;
 class Grid;
 class Gizmo;
 class Skybox;
 class IBLSystem;
+class Denoiser;
 class RenderGraph;
 class RenderPipelineModeSelector;
 enum class RenderPipelineMode;
@@ -96,6 +100,12 @@ struct RenderStats {
     float texturesMB = 0.0f;
     float geometryMB = 0.0f;
     float vramMB = 0.0f;
+    // TextureCache counters (process lifetime)
+    uint64_t textureCacheHits = 0;
+    uint64_t textureCacheMisses = 0;
+    uint64_t textureCacheEvictions = 0;
+    float textureCacheMB = 0.0f;       // resident in the cache, referenced or not
+    int instancedObjects = 0;          // objects drawn through instanced batches
     int topSharedCount = 0;
     std::string topSharedKey;
     std::vector<PassTiming> passTimings;
@@ -120,6 +130,13 @@ public:
                            TextureHandle textureHandle, int width, int height);
     bool renderToPNG(const SceneManager& scene, const Light& lights,
                     const std::string& path, int width, int height);
+    // one render, one multi-channel EXR: linear color (R, G, B) plus albedo.*,
+    // normal.* (world space), Z (view-space depth, infinite on background) and
+    // objectId (SceneObject::id, 0 on background). The ray path takes them from
+    // the raytracer, the raster path from the G-buffer; raster color is the
+    // forward pass without tone mapping, gamma or MSAA.
+    bool renderToEXR(const SceneManager& scene, const Light& lights,
+                    const std::string& path, int width, int height, bool halfFloat = true);
 
     // camera management
     void setCamera(const CameraState& camera) { m_cameraManager.setCamera(camera); }
@@ -182,19 +199,26 @@ public:
     void setSampleCount(int samples) { m_samples = samples < 1 ? 1 : samples; m_recreateTargets = true; }
     int  getSampleCount() const { return m_samples; }
 
+    // render configuration (sample budget, quality target); mode comes from the pipeline override
+    void setRenderConfig(const RenderConfig& config) { m_renderConfig = config; }
+    const RenderConfig& getRenderConfig() const { return m_renderConfig; }
+
+    // projected error in pixels under which meshes draw a simplified MeshLod level; 0 disables
+    void setLodErrorPixels(float px) { m_lodErrorPixels = px < 0.0f ? 0.0f : px; }
+    float getLodErrorPixels() const { return m_lodErrorPixels; }
+
     // raytracing
     void setDenoiseEnabled(bool enabled) { m_denoiseEnabled = enabled; }
     bool isDenoiseEnabled() const { return m_denoiseEnabled; }
     
-    // reflection samples per pixel for glossy reflections
-    void setReflectionSpp(int spp);
-    int getReflectionSpp() const;
     bool denoise(std::vector<glm::vec3>& color,
                 const std::vector<glm::vec3>* normal = nullptr,
                 const std::vector<glm::vec3>* albedo = nullptr);
     bool denoise(std::vector<glm::vec3>& color, int width, int height,
                 const std::vector<glm::vec3>* normal = nullptr,
                 const std::vector<glm::vec3>* albedo = nullptr);
+    // denoise a raytracer frame with the guides it recorded alongside it
+    bool denoiseRaytraced(std::vector<glm::vec3>& color, int width, int height);
 
     // gizmo support - forward declared, implemented in cpp
     class Gizmo* getGizmo() { return m_gizmo.get(); }
@@ -243,6 +267,10 @@ private:
     std::unique_ptr<RenderPipelineModeSelector> m_pipelineSelector;
     RenderPipelineMode m_activePipelineMode = RenderPipelineMode::Raster;
     RenderPipelineMode m_pipelineOverride = RenderPipelineMode::Auto;
+    RenderConfig m_renderConfig;
+    float m_lodErrorPixels = Defaults::LodErrorPixels;
+
+    InstanceBatcher m_instanceBatcher;   // instanced draws of duplicated meshes
 
     RenderTargetHandle m_activeRenderTarget = INVALID_HANDLE;
     TextureHandle m_activeOutputTexture = INVALID_HANDLE;
@@ -279,7 +307,8 @@ private:
     // raytracer
     std::unique_ptr<Raytracer> m_raytracer;
     bool m_denoiseEnabled = false;
-    int m_reflectionSpp = 8; // default reflection samples per pixel
+    std::unique_ptr<Denoiser> m_denoiser;   // OIDN device and filter, kept across frames
+    static constexpr int kInteractiveSamplesPerFrame = 1; // progressive refinement step while the view is still
     
     // raytracing screen quad resources
     GLuint m_screenQuadVAO = 0;
@@ -330,15 +359,24 @@ private:
     // renderLegacy() removed - now using renderUnified() with RenderGraph exclusively
     void renderRasterized(const SceneManager& scene, const Light& lights);
     void renderRaytraced(const SceneManager& scene, const Light& lights);
+    // Offline ray renders: adaptive sampling bounded by m_renderConfig and maxSamples
+    void renderRaytracedAdaptive(std::vector<glm::vec3>& out, int width, int height, const Light& lights, int maxSamples,
+                                 bool displayRange = true);
+    // Raster half of renderToEXR: linear color and G-buffer passes, bottom row first
+    bool renderRasterAOVs(const SceneManager& scene, const Light& lights, int width, int height,
+                          std::vector<glm::vec3>& color, raytracer::AuxiliaryOutputs& aovs);
     void renderObject(const SceneObject& obj, const Light& lights);
     void updateRenderStats(const SceneManager& scene);
+    // MeshLod level to draw obj at from the current camera; records it in obj.lodLevel
+    int selectLod(SceneObject& obj, int viewportHeight) const;
     
     // optimized rendering methods
     void renderDebugElements(const SceneManager& scene, const Light& lights);
     void renderSelectionOutline(const SceneManager& scene);
     void renderGizmo(const SceneManager& scene, const Light& lights);
     void renderObjectsBatched(const SceneManager& scene, const Light& lights);
-    void renderObjectsBatchedWithManagers(const SceneManager& scene, const Light& lights);  // new manager-based method
+    void renderObjectsBatchedWithManagers(const SceneManager& scene, const Light& lights, int viewportHeight);  // new manager-based method
+    void drawObjectWithManagers(SceneObject& obj);
     void setupCommonUniforms();
     void renderObjectFast(const SceneObject& obj, const Light& lights);
     
@@ -399,15 +437,16 @@ public:
 private:
     // note: m_rhi moved earlier in declaration order for proper cleanup sequencing
 
-    // render pass pipeline handles
-    PipelineHandle m_gBufferPipeline = INVALID_HANDLE;
+    // render pass shader and pipeline handles; g-buffer pipelines are per
+    // object (SceneObject::rhiPipelineGBuffer)
+    ShaderHandle m_gBufferShader = INVALID_HANDLE;
     PipelineHandle m_deferredLightingPipeline = INVALID_HANDLE;
 
     // screen quad for full-screen passes
     BufferHandle m_screenQuadVBORhi = INVALID_HANDLE;
 
     // helper methods for pass implementations
-    PipelineHandle getOrCreateGBufferPipeline();
+    ShaderHandle getOrCreateGBufferShader();
     PipelineHandle getOrCreateDeferredLightingPipeline();
     void createScreenQuad();
     std::string loadTextFileRhi(const std::string& path);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <algorithm>
+#include <cctype>
 #include <filesystem>
 #include <chrono>
 #include <iomanip>
@@ -72,6 +74,13 @@ namespace RenderUtils {
         return outputDir + "/" + outputFile;
     }
     
+    // Whether an output path asks for a multi-layer EXR instead of a PNG
+    inline bool isExrPath(const std::string& path) {
+        std::string ext = std::filesystem::path(path).extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return ext == ".exr";
+    }
+
     // Process output path - if empty or just filename, use default directory
     inline std::string processOutputPath(const std::string& inputPath) {
         if (inputPath.empty()) {
@@ -180,6 +180,10 @@ private:
         GLuint vao = 0;
         ShaderHandle shader = 0;
         PipelineDesc desc;
+        // GL 3.3 / WebGL2 have no base instance: draws with a firstInstance
+        // re-point the per-instance attributes of the VAO instead
+        bool hasInstanceBindings = false;
+        uint32_t instanceBase = 0;
     };
     
     struct GLRenderTarget {
@@ -277,6 +281,8 @@ private:
     bool compileShader(GLuint& program, const ShaderDesc& desc);
     void queryCapabilities();
     void setupVertexArray(GLuint vao, const PipelineDesc& desc);
+    // Point attr at vb's buffer, baseOffset bytes in, in the bound VAO
+    void pointVertexAttribute(const VertexAttribute& attr, const VertexBinding& vb, size_t baseOffset);
     GLenum attachmentTypeToGL(AttachmentType type) const;
     bool setupRenderTarget(GLuint fbo, const RenderTargetDesc& desc);
     void applyBindGroup(uint32_t index, BindGroupHandle group);
@@ -16,10 +16,10 @@ public:
     bool init(const RhiInit& desc) override { (void)desc; return true; }
     void shutdown() override {}
 
-    void beginFrame() override { m_drawCalls = 0; }
+    void beginFrame() override { m_drawCalls = 0; m_instances = 0; }
     void endFrame() override {}
 
-    void draw(const DrawDesc& desc) override { (void)desc; ++m_drawCalls; }
+    void draw(const DrawDesc& desc) override { ++m_drawCalls; m_instances += desc.instanceCount; }
     void readback(const ReadbackDesc& desc) override { (void)desc; }
 
     TextureHandle createTexture(const TextureDesc& desc) override { (void)desc; return ++m_nextHandle; }
@@ -97,6 +97,7 @@ public:
     BufferHandle getScreenQuadBuffer() override { return ++m_nextHandle; }
 
     uint32_t getDrawCallCount() const { return m_drawCalls; }
+    uint32_t getInstanceCount() const { return m_instances; }
 
 private:
     class NullPass : public RenderPassEncoder {
@@ -122,5 +123,6 @@ private:
     };
     uint32_t m_nextHandle = 1;
     uint32_t m_drawCalls = 0;
+    uint32_t m_instances = 0;
     NullQueue m_queue;
 };
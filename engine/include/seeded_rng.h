@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <random>
 
 class SeededRng {
@@ -14,3 +15,113 @@ private:
     std::mt19937 m_rng;
     std::uniform_real_distribution<float> m_uniform{0.0f, 1.0f};
 };
+
+// Low-discrepancy sampling: Owen-scrambled Sobol points, hash-based
+// (Burley 2020, "Practical Hash-based Owen Scrambling"). Stateless, so any
+// (pixel, sample, dimension) can be evaluated directly.
+namespace sampling {
+
+    // 32-bit integer hash (PCG output permutation)
+    inline uint32_t hash(uint32_t v) {
+        const uint32_t state = v * 747796405u + 2891336453u;
+        const uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+        return (word >> 22u) ^ word;
+    }
+
+    inline uint32_t hashCombine(uint32_t seed, uint32_t v) {
+        return seed ^ (hash(v) + 0x9e3779b9u + (seed << 6) + (seed >> 2));
+    }
+
+    inline uint32_t reverseBits(uint32_t x) {
+        x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+        x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+        x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+        x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+        return (x >> 16) | (x << 16);
+    }
+
+    // Random permutation that only lets higher bits depend on lower ones,
+    // which is what a nested uniform (Owen) scramble needs once bit-reversed
+    inline uint32_t laineKarrasPermutation(uint32_t x, uint32_t seed) {
+        x += seed;
+        x ^= x * 0x6c50b47cu;
+        x ^= x * 0xb82f1e52u;
+        x ^= x * 0xc7afe638u;
+        x ^= x * 0x8d22f6e6u;
+        return x;
+    }
+
+    inline uint32_t nestedUniformScramble(uint32_t x, uint32_t seed) {
+        return reverseBits(laineKarrasPermutation(reverseBits(x), seed));
+    }
+
+    namespace detail {
+        struct SobolDirections { uint32_t v[4][32]; };
+
+        // Dimension 0 is van der Corput; 1-3 use the Joe-Kuo primitive
+        // polynomials (degree s, coefficients a) and initial numbers m
+        constexpr SobolDirections makeSobolDirections() {
+            SobolDirections d{};
+            for (int i = 0; i < 32; ++i) d.v[0][i] = 1u << (31 - i);
+            const int s[3] = { 1, 2, 3 };
+            const uint32_t a[3] = { 0, 1, 1 };
+            const uint32_t m[3][3] = { { 1, 0, 0 }, { 1, 3, 0 }, { 1, 3, 1 } };
+            for (int dim = 1; dim < 4; ++dim) {
+                const int deg = s[dim - 1];
+                uint32_t* v = d.v[dim];
+                for (int i = 0; i < 32; ++i) {
+                    if (i < deg) {
+                        v[i] = m[dim - 1][i] << (31 - i);
+                        continue;
+                    }
+                    v[i] = v[i - deg] ^ (v[i - deg] >> deg);
+                    for (int k = 1; k < deg; ++k)
+                        v[i] ^= ((a[dim - 1] >> (deg - 1 - k)) & 1u) * v[i - k];
+                }
+            }
+            return d;
+        }
+
+        inline constexpr SobolDirections kSobolDirections = makeSobolDirections();
+    }
+
+    // Unscrambled Sobol point `index`, dimension 0-3, as a 0.32 fixed-point value
+    inline uint32_t sobol(uint32_t index, int dim) {
+        uint32_t x = 0;
+        for (int bit = 0; index; ++bit, index >>= 1)
+            if (index & 1u) x ^= detail::kSobolDirections.v[dim][bit];
+        return x;
+    }
+
+    // Map 32-bit fixed point to [0, 1)
+    inline float toUnitFloat(uint32_t x) {
+        return float(x >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // Dimensions 0-3 of the Owen-scrambled Sobol point `index`. The index
+    // itself is scrambled too, so sets with different seeds are shuffled
+    // against each other and can be padded together without correlation.
+    inline void scrambledSobol4D(uint32_t index, uint32_t seed, float out[4]) {
+        index = nestedUniformScramble(index, seed);
+        for (int dim = 0; dim < 4; ++dim)
+            out[dim] = toUnitFloat(nestedUniformScramble(sobol(index, dim), hashCombine(seed, uint32_t(dim))));
+    }
+}
+
+// Sample generator for one pixel sample. Dimensions are handed out in groups
+// of four (e.g. one group per path vertex); each group is an independently
+// scrambled and shuffled 4D Sobol set, so the first 2^k samples of a pixel
+// stratify every group. Deterministic in (seed, pixel, sample).
+class SobolSampler {
+public:
+    SobolSampler(uint32_t seed, uint32_t pixel, uint32_t sampleIndex)
+        : m_seed(sampling::hashCombine(sampling::hash(seed), pixel)), m_index(sampleIndex) {}
+
+    void get4D(uint32_t group, float out[4]) const {
+        sampling::scrambledSobol4D(m_index, sampling::hashCombine(m_seed, group), out);
+    }
+
+private:
+    uint32_t m_seed;
+    uint32_t m_index;
+};
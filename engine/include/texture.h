@@ -6,6 +6,14 @@
 
 namespace glint3d { class RHI; }
 #include <string>
+#include <vector>
+
+// 8-bit pixels decoded from an image file, waiting for Texture::upload
+struct TextureImage
+{
+    int width{0}, height{0}, channels{0};
+    std::vector<unsigned char> pixels;
+};
 
 class Texture
 {
@@ -15,6 +23,11 @@ public:
 
     bool loadFromFile(const std::string& filepath, bool flipY = false);
 
+    // Split form of loadFromFile for asset streaming: decode needs no RHI and
+    // may run on any thread; upload creates the RHI texture on the render thread
+    static bool decodeFile(const std::string& filepath, bool flipY, TextureImage& out);
+    bool upload(const TextureImage& image, const std::string& debugName);
+
     // Legacy bind method: now forwards to RHI
     void bind(GLuint unit = 0) const;
 
@@ -1,18 +1,87 @@
 #pragma once
-#include <unordered_map>
+#include <cstdint>
+#include <future>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "texture.h"
 
-// Simple global texture cache keyed by path + flip flag
+// Process-wide texture cache keyed by path + flip flag. All methods are
+// thread-safe; RHI textures are only ever created by get() and pumpUploads(),
+// which belong on the render thread.
+//
+// Textures are handed out as shared_ptr, so a holder keeps its texture alive
+// even after the cache lets go of it. The cache keeps up to budget() bytes of
+// textures resident; past that it evicts the least recently used entries that
+// nobody else references. prefetch() decodes on JobSystem workers ahead of
+// time, and pumpUploads() streams those decodes to the GPU under a byte budget.
 class TextureCache {
 public:
+    static constexpr size_t kDefaultBudgetBytes = size_t(1) << 30;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t textures = 0;        // resident
+        size_t residentBytes = 0;
+        size_t pendingDecodes = 0;  // prefetched, not uploaded yet
+    };
+
     static TextureCache& instance();
-    Texture* get(const std::string& path, bool flipY);
+
+    // Texture for path, uploading it now if needed (waiting for a prefetch in
+    // flight). Null if the file cannot be loaded.
+    std::shared_ptr<Texture> get(const std::string& path, bool flipY);
+
+    // Start decoding path on a worker unless it is cached or on its way
+    void prefetch(const std::string& path, bool flipY);
+
+    // Upload prefetches whose decode has finished until budgetBytes were sent
+    // (at least one, so large textures still progress); returns textures uploaded
+    size_t pumpUploads(size_t budgetBytes);
+
+    // Resident texture memory limit; shrinking evicts immediately
+    void setBudget(size_t bytes);
+    size_t budget() const;
+
+    Stats stats() const;
     void clear();
+
 private:
     struct Key { std::string path; bool flip; };
     struct KeyHash { size_t operator()(Key const& k) const; };
     struct KeyEq { bool operator()(Key const& a, Key const& b) const; };
-    std::unordered_map<Key, std::unique_ptr<Texture>, KeyHash, KeyEq> m_cache;
+
+    // Result of the file-system half of a load
+    struct Decoded {
+        std::string resolved;       // a .ktx2 sibling when present, else the path
+        TextureImage image;         // empty for .ktx2, which Texture reads at upload
+        bool ktx2 = false;
+        bool ok = false;
+    };
+
+    struct Entry {
+        std::shared_ptr<Texture> texture;                      // null while decoding
+        std::shared_future<std::shared_ptr<Decoded>> decode;   // valid while decoding
+        size_t bytes = 0;
+        std::list<Key>::iterator lru;                          // valid while resident
+    };
+
+    static std::shared_ptr<Decoded> decode(const std::string& path, bool flipY);
+    static std::shared_ptr<Texture> upload(const Decoded& decoded, bool flipY);
+    // Store an uploaded texture; returns it, or the one that got there first
+    std::shared_ptr<Texture> insertLocked(const Key& key, std::shared_ptr<Texture> texture);
+    void evictLocked();
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<Key, Entry, KeyHash, KeyEq> m_entries;
+    std::list<Key> m_lru;              // resident entries, most recently used first
+    std::vector<Key> m_pending;        // prefetches in submission order
+    size_t m_budget = kDefaultBudgetBytes;
+    size_t m_residentBytes = 0;
+    Stats m_stats;
 };
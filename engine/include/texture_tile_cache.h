@@ -0,0 +1,115 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace raytracer {
+
+    // CPU-side texture storage for the raytracer. Each texture is decoded once,
+    // on its first lookup, into a box-filtered MIP pyramid cut into 64x64 tiles
+    // that are spilled to an anonymous temporary file. Lookups page single tiles
+    // back in and keep them in memory under a global byte budget, evicting the
+    // least recently used ones, so a scene only holds the tiles and MIP levels
+    // its rays actually touch.
+    //
+    // Texels are stored as 8-bit RGBA in the layout the raster path uploads:
+    // v = 0 is the first row of the image file, and coordinates outside [0, 1]
+    // repeat. Color maps are decoded with the raster shader's 2.2 gamma before
+    // any filtering, so MIP levels and filtered lookups average linear values.
+    //
+    // acquire() and setBudget() must not run concurrently with sampling;
+    // sample() itself is safe to call from any number of threads.
+    class TextureTileCache {
+    public:
+        static constexpr uint32_t kNoTexture = UINT32_MAX;
+        static constexpr int kTileSize = 64;
+        static constexpr size_t kDefaultBudgetBytes = size_t(512) << 20;
+
+        TextureTileCache();
+        ~TextureTileCache();
+        TextureTileCache(const TextureTileCache&) = delete;
+        TextureTileCache& operator=(const TextureTileCache&) = delete;
+
+        // Handle for the image at path (resolved like other assets), with RGB
+        // gamma-encoded for color maps or linear data for everything else.
+        // Only the header is read here; returns kNoTexture if it is not a
+        // readable image.
+        uint32_t acquire(const std::string& path, bool gammaEncoded);
+
+        // Filtered linear RGBA in [0, 1] at uv. `footprint` is the width of the lookup
+        // in uv units; it selects a fractional MIP level (trilinear filtering),
+        // zero reads the full-resolution level bilinearly. Fails for unknown
+        // handles and textures that could not be decoded.
+        bool sample(uint32_t texture, const glm::vec2& uv, float footprint, glm::vec4& value) const;
+
+        // Resident tile memory limit; shrinking evicts immediately
+        void setBudget(size_t bytes);
+        size_t getBudget() const { return m_budget; }
+
+        // Diagnostics
+        size_t textureCount() const { return m_textures.size(); }
+        size_t residentBytes() const;
+        uint64_t tileLoads() const { return m_tileLoads.load(std::memory_order_relaxed); }
+
+    private:
+        // Texels of one tile plus a one-texel border copied from the tiles to
+        // the right and above (wrapping), so a bilinear footprint never
+        // straddles two tiles
+        struct Tile {
+            int stride = 0;                       // texels per row, border included
+            std::vector<uint8_t> texels;          // RGBA
+        };
+        using TilePtr = std::shared_ptr<const Tile>;
+
+        struct Level {
+            int width = 0, height = 0;
+            int tileWidth = 0, tileHeight = 0;    // texels per tile without the border
+            int tilesX = 0, tilesY = 0;
+            long long fileOffset = 0;             // first tile of the level in the spill file
+        };
+
+        struct Texture {
+            std::string path;
+            bool gammaEncoded = false;
+            int width = 0, height = 0;
+            std::vector<Level> levels;
+
+            // Filled on first use
+            std::mutex mutex;                     // guards the fields below and file reads
+            bool ready = false;
+            bool failed = false;
+            FILE* file = nullptr;
+        };
+
+        // Tiles live in independently locked shards so threads rarely contend
+        static constexpr int kShards = 16;
+        struct Shard {
+            mutable std::mutex mutex;
+            std::list<std::pair<uint64_t, TilePtr>> lru;   // most recent first
+            std::unordered_map<uint64_t, std::list<std::pair<uint64_t, TilePtr>>::iterator> index;
+            size_t bytes = 0;
+        };
+
+        static uint64_t tileKey(uint32_t texture, int level, int tile);
+        TilePtr tile(uint32_t texture, int level, int tx, int ty) const;
+        // Decode the image and write its tiled pyramid; caller holds tex.mutex
+        bool buildTiles(Texture& tex) const;
+        TilePtr readTile(Texture& tex, int level, int tx, int ty) const;
+        bool bilinear(uint32_t texture, int level, const glm::vec2& uv, glm::vec4& value) const;
+        void evict(Shard& shard, size_t limit) const;
+
+        std::vector<std::unique_ptr<Texture>> m_textures;
+        std::map<std::pair<std::string, bool>, uint32_t> m_byPath;
+        mutable Shard m_shards[kShards];
+        size_t m_budget = kDefaultBudgetBytes;
+        mutable std::atomic<uint64_t> m_tileLoads{ 0 };
+    };
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+// Persistent worker pool with work stealing, used for CPU rendering.
+// run() splits a batch of task indices into contiguous blocks, one per worker
+// (the calling thread is worker 0). Workers take tasks from the front of their
+// own block and steal from the back of others' when they run out, so uneven
+// tasks (e.g. glass-heavy tiles) don't leave cores idle.
+class ThreadPool
+{
+public:
+    using TaskFn = std::function<void(uint32_t task, unsigned worker)>;
+
+    // threadCount 0 = one worker per hardware thread
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of workers including the calling thread; worker indices passed
+    // to tasks are in [0, workerCount())
+    unsigned workerCount() const { return static_cast<unsigned>(m_queues.size()); }
+
+    // Execute fn(task, worker) for every task in [0, taskCount) and wait for
+    // completion. Tasks of one batch must not call run() again.
+    void run(uint32_t taskCount, const TaskFn& fn);
+
+    // Process-wide pool sized to the machine
+    static ThreadPool& shared();
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<uint32_t> tasks;
+    };
+
+    void workerMain(unsigned worker);
+    void drain(unsigned worker, const TaskFn& fn);
+    bool popLocal(unsigned worker, uint32_t& task);
+    bool steal(unsigned thief, uint32_t& task);
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_runMutex;                 // one batch at a time
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const TaskFn* m_job = nullptr;
+    uint64_t m_generation = 0;
+    unsigned m_busy = 0;
+    bool m_stop = false;
+};
@@ -1,87 +1,104 @@
-﻿#ifndef TRIANGLE_H
-#define TRIANGLE_H
-
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cmath>
 #include <glm/glm.hpp>
-#include "ray.h"                
-#include "material_core.h"          
 
+class ObjLoader;
+class BVH;
 
-class Triangle
+// Compact object-space triangle storage for the CPU raytracer.
+// Triangles are kept in precomputed-edge form (v0, e1 = v1 - v0, e2 = v2 - v0)
+// as structure-of-arrays so the intersection loop only streams floats.
+// Materials live outside the mesh (per instance in the raytracer).
+class TriangleMesh
 {
 public:
-    /* v0–v1–v2 can be in ANY order – normals are generated */
-    Triangle(const glm::vec3& a,
-        const glm::vec3& b,
-        const glm::vec3& c,
-        float refl = 0.0f,
-        const MaterialCore& mat = MaterialCore())    // <-- Added material param
-        : v0(a), v1(b), v2(c), reflectivity(refl), material(mat)
-    {
-        /* geometric normal (unit length) */
-        normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
-    }
-
-    // Möller–Trumbore -- TWO-SIDED intersection test
-    bool intersect(const Ray& r,
-        float& tOut,
-        glm::vec3& nOut) const
-    {
-        constexpr float EPS = 1e-6f;
-
-        glm::vec3 e1 = v1 - v0;
-        glm::vec3 e2 = v2 - v0;
-
-        /* calculate determinant */
-        glm::vec3 p = glm::cross(r.direction, e2);
-        float det = glm::dot(e1, p);
-
-        if (std::abs(det) < EPS) return false;  // ray ‖ triangle
-
-        float invDet = 1.0f / det;
-
-        /* calculate barycentric u */
-        glm::vec3 s = r.origin - v0;
-        float u = glm::dot(s, p) * invDet;
-        if (u < 0.0f || u > 1.0f) return false;
-
-        /* calculate barycentric v */
-        glm::vec3 q = glm::cross(s, e1);
-        float v = glm::dot(r.direction, q) * invDet;
-        if (v < 0.0f || u + v > 1.0f) return false;
-
-        /* distance to intersection */
-        float t = glm::dot(e2, q) * invDet;
-        if (t <= EPS) return false;  // behind ray start
-
-        /* hit! */
-        tOut = t;
-        
-        // Calculate hit point for smooth normal computation
-        glm::vec3 hitPoint = r.origin + t * r.direction;
-        
-        // For spherical objects, use smooth normal (normalized position from center)
-        // Check if this looks like a sphere by seeing if vertices are roughly equidistant from origin
-        float d0 = glm::length(v0);
-        float d1 = glm::length(v1);
-        float d2 = glm::length(v2);
-        float avgDist = (d0 + d1 + d2) / 3.0f;
-        float maxDiff = std::max({std::abs(d0 - avgDist), std::abs(d1 - avgDist), std::abs(d2 - avgDist)});
-        
-        if (maxDiff < avgDist * 0.1f && avgDist > 0.5f) { // Looks like sphere vertices
-            nOut = glm::normalize(hitPoint); // Smooth sphere normal
-        } else {
-            nOut = normal;  // Use face normal for other geometry
-        }
-        
-        return true;
-    }
+    // Copy geometry, vertex normals and texture coordinates out of a loaded mesh
+    void build(const ObjLoader& mesh);
 
-public:
-    // Data
-    glm::vec3 v0, v1, v2;
-    glm::vec3 normal;         // Face normal (unit vector)
-    float reflectivity = 0.0f; // 0 = matte, 1 = mirror
-    MaterialCore material;     // Unified material data
+    // Reorder triangles to match the BVH's primitive order so leaves address
+    // contiguous ranges; the BVH's primitive indices become the identity.
+    void adoptBVHOrder(BVH& bvh);
+
+    void clear();
+
+    size_t triangleCount() const { return m_triangleCount; }
+    size_t memoryBytes() const;
+
+    glm::vec3 vertex0(uint32_t tri) const { return glm::vec3(v0x[tri], v0y[tri], v0z[tri]); }
+    glm::vec3 vertex1(uint32_t tri) const { return vertex0(tri) + glm::vec3(e1x[tri], e1y[tri], e1z[tri]); }
+    glm::vec3 vertex2(uint32_t tri) const { return vertex0(tri) + glm::vec3(e2x[tri], e2y[tri], e2z[tri]); }
+
+    // Möller–Trumbore, two-sided. Returns distance and barycentrics (u, v)
+    // for hits in (kMinT, tMax).
+    bool intersect(uint32_t tri, const glm::vec3& orig, const glm::vec3& dir, float tMax,
+                   float& tOut, float& uOut, float& vOut) const;
+
+    // Unit face normal following the v0 -> v1 -> v2 winding
+    glm::vec3 geometricNormal(uint32_t tri) const;
+
+    // Interpolated vertex normal at barycentrics (u, v); falls back to the
+    // face normal when the mesh has no usable normals
+    glm::vec3 shadingNormal(uint32_t tri, float u, float v) const;
+
+    bool hasTexcoords() const { return !texcoords.empty(); }
+    // Texture coordinates of one corner (0-2) and interpolated at (u, v);
+    // only valid when hasTexcoords()
+    glm::vec2 texcoord(uint32_t tri, int corner) const { return texcoords[indices[tri * 3 + corner]]; }
+    glm::vec2 texcoord(uint32_t tri, float u, float v) const;
+
+    static constexpr float kMinT = 1e-6f;
+
+    // Zeroed entries appended to every SoA array so wide kernels can load a
+    // full 8-lane group at the end of a leaf without bounds checks
+    static constexpr uint32_t kSimdPadding = 8;
+
+    // Edge-form positions (one entry per triangle, plus padding)
+    std::vector<float> v0x, v0y, v0z;
+    std::vector<float> e1x, e1y, e1z;
+    std::vector<float> e2x, e2y, e2z;
+
+    // Shading data: three vertex indices per triangle into normals and
+    // texcoords (either may be empty)
+    std::vector<uint32_t>  indices;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texcoords;
+
+private:
+    size_t m_triangleCount = 0;
 };
 
-#endif /* TRIANGLE_H */
+inline bool TriangleMesh::intersect(uint32_t i, const glm::vec3& o, const glm::vec3& d, float tMax,
+                                    float& tOut, float& uOut, float& vOut) const
+{
+    const float ax = e1x[i], ay = e1y[i], az = e1z[i];
+    const float bx = e2x[i], by = e2y[i], bz = e2z[i];
+
+    // p = d x e2
+    const float px = d.y * bz - d.z * by;
+    const float py = d.z * bx - d.x * bz;
+    const float pz = d.x * by - d.y * bx;
+    const float det = ax * px + ay * py + az * pz;
+    if (std::abs(det) < 1e-12f) return false;   // ray parallel to triangle
+    const float invDet = 1.0f / det;
+
+    const float sx = o.x - v0x[i], sy = o.y - v0y[i], sz = o.z - v0z[i];
+    const float u = (sx * px + sy * py + sz * pz) * invDet;
+    if (u < 0.0f || u > 1.0f) return false;
+
+    // q = s x e1
+    const float qx = sy * az - sz * ay;
+    const float qy = sz * ax - sx * az;
+    const float qz = sx * ay - sy * ax;
+    const float v = (d.x * qx + d.y * qy + d.z * qz) * invDet;
+    if (v < 0.0f || u + v > 1.0f) return false;
+
+    const float t = (bx * qx + by * qy + bz * qz) * invDet;
+    if (t <= kMinT || t >= tMax) return false;
+
+    tOut = t;
+    uOut = u;
+    vOut = v;
+    return true;
+}
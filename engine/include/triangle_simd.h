@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class TriangleMesh;
+
+// Wide triangle intersection kernels for BVH leaves.
+// A leaf covers a contiguous range of a TriangleMesh (see adoptBVHOrder), so
+// the SoA arrays are already transposed for 4- or 8-wide loads. Kernels are
+// chosen once at startup from what the CPU supports; the AVX2 variant lives
+// in its own translation unit built with AVX2 flags.
+namespace simd
+{
+    enum class Isa
+    {
+        Scalar,
+        SSE,    // 4-wide
+        AVX2    // 8-wide
+    };
+
+    struct LeafHit
+    {
+        uint32_t triangle = 0;
+        float u = 0.0f;
+        float v = 0.0f;
+    };
+
+    // Closest hit of one ray against triangles [first, first + count).
+    // Shrinks tMax and fills hit when a closer triangle is found.
+    using IntersectLeafFn = bool (*)(const TriangleMesh& mesh, uint32_t first, uint32_t count,
+                                     const glm::vec3& orig, const glm::vec3& dir, float& tMax, LeafHit& hit);
+
+    // True if any triangle in [first, first + count) is hit before tMax
+    using OccludedLeafFn = bool (*)(const TriangleMesh& mesh, uint32_t first, uint32_t count,
+                                    const glm::vec3& orig, const glm::vec3& dir, float tMax);
+
+    struct Kernels
+    {
+        Isa isa = Isa::Scalar;
+        IntersectLeafFn intersect = nullptr;
+        OccludedLeafFn occluded = nullptr;
+    };
+
+    // Best kernels for this CPU (selected on first use; GLINT_SIMD=scalar|sse|avx2 overrides)
+    const Kernels& kernels();
+
+    // Specific kernel set, or nullptr when not compiled in / not supported by the CPU
+    const Kernels* kernelsFor(Isa isa);
+
+    const char* isaName(Isa isa);
+
+    namespace detail
+    {
+        const Kernels* avx2Kernels();   // defined in triangle_simd_avx2.cpp
+    }
+}
@@ -8,7 +8,7 @@ in vec2 vUV;
 layout(binding = 0) uniform sampler2D gBaseColor;  // RGB: base color, A: metallic
 layout(binding = 1) uniform sampler2D gNormal;     // RGB: world normal, A: roughness
 layout(binding = 2) uniform sampler2D gPosition;   // RGB: world position, A: depth
-layout(binding = 3) uniform sampler2D gMaterial;   // R: transmission, G: ior, B: thickness, A: unused
+layout(binding = 3) uniform sampler2D gMaterial;   // R: transmission, G: ior, B: thickness, A: object id
 
 // Light types
 #define LIGHT_POINT 0
@@ -70,25 +70,23 @@ float DistributionGGX(vec3 N, vec3 H, float roughness)
     return num / denom;
 }
 
-float GeometrySchlickGGX(float NdotV, float roughness)
+// Smith Lambda for GGX; matches brdf.cpp on the CPU path tracer
+float SmithLambdaGGX(float NdotX, float a)
 {
-    float r = (roughness + 1.0);
-    float k = (r * r) / 8.0;
-
-    float num = NdotV;
-    float denom = NdotV * (1.0 - k) + k;
-
-    return num / denom;
+    float cos2 = max(NdotX * NdotX, 1e-6);
+    float tan2 = max(1.0 - cos2, 0.0) / cos2;
+    return 0.5 * (sqrt(1.0 + a * a * tan2) - 1.0);
 }
 
+// Height-correlated Smith masking-shadowing
 float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
 {
     float NdotV = max(dot(N, V), 0.0);
     float NdotL = max(dot(N, L), 0.0);
-    float ggx2 = GeometrySchlickGGX(NdotV, roughness);
-    float ggx1 = GeometrySchlickGGX(NdotL, roughness);
+    if (NdotV <= 0.0 || NdotL <= 0.0) return 0.0;
 
-    return ggx1 * ggx2;
+    float a = roughness * roughness;
+    return 1.0 / (1.0 + SmithLambdaGGX(NdotV, a) + SmithLambdaGGX(NdotL, a));
 }
 
 vec3 fresnelSchlick(float cosTheta, vec3 F0)
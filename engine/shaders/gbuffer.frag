@@ -4,7 +4,7 @@
 layout (location = 0) out vec4 gBaseColor;    // RGB: base color, A: metallic
 layout (location = 1) out vec4 gNormal;       // RGB: world normal, A: roughness
 layout (location = 2) out vec4 gPosition;     // RGB: world position, A: depth
-layout (location = 3) out vec4 gMaterial;     // R: transmission, G: ior, B: thickness, A: unused
+layout (location = 3) out vec4 gMaterial;     // R: transmission, G: ior, B: thickness, A: object id
 
 in vec3 vWorldPos;
 in vec2 vUV;
@@ -36,6 +36,8 @@ layout(binding = 0) uniform sampler2D baseColorTex;
 layout(binding = 1) uniform sampler2D normalTex;
 layout(binding = 2) uniform sampler2D mrTex; // Metallic-Roughness texture
 
+uniform float objectId;   // SceneObject::id, 0 for background
+
 void main()
 {
     // Sample base color
@@ -66,5 +68,5 @@ void main()
     gBaseColor = vec4(baseColor.rgb, metallic);
     gNormal = vec4(normal * 0.5 + 0.5, roughness); // Encode normal to [0,1]
     gPosition = vec4(vWorldPos, gl_FragCoord.z);
-    gMaterial = vec4(transmission, ior, thickness, 1.0);
+    gMaterial = vec4(transmission, ior, thickness, objectId);
 }
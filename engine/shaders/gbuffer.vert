@@ -1,7 +1,8 @@
 #version 330 core
 
+// Quantized mesh streams, see pbr.vert
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
+layout (location = 1) in vec2 aNormal;
 layout (location = 2) in vec2 aUV;
 layout (location = 3) in vec3 aTangent;
 
@@ -17,6 +18,14 @@ layout(std140) uniform TransformBlock {
     mat4 lightSpaceMatrix;
 };
 
+// Octahedral unit vector, as packed by MeshOptimizer::octEncode
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+    return normalize(n);
+}
+
 void main()
 {
     vWorldPos = vec3(model * vec4(aPos, 1.0));
@@ -24,7 +33,7 @@ void main()
 
     // Calculate TBN matrix for normal mapping
     vec3 T = normalize(vec3(model * vec4(aTangent, 0.0)));
-    vec3 N = normalize(vec3(model * vec4(aNormal, 0.0)));
+    vec3 N = normalize(vec3(model * vec4(octDecode(aNormal), 0.0)));
     // Re-orthogonalize T with respect to N
     T = normalize(T - dot(T, N) * N);
     vec3 B = cross(N, T);
@@ -111,17 +111,19 @@ float DistributionGGX(vec3 N, vec3 H, float rough) {
     float denom = (NdotH2 * (a2 - 1.0) + 1.0);
     return a2 / max(PI * denom * denom, 1e-4);
 }
-float GeometrySchlickGGX(float NdotV, float rough) {
-    float r = rough + 1.0;
-    float k = (r*r) / 8.0;
-    return NdotV / (NdotV * (1.0 - k) + k);
+// Smith Lambda for GGX; matches brdf.cpp on the CPU path tracer
+float SmithLambdaGGX(float NdotX, float a) {
+    float cos2 = max(NdotX * NdotX, 1e-6);
+    float tan2 = max(1.0 - cos2, 0.0) / cos2;
+    return 0.5 * (sqrt(1.0 + a * a * tan2) - 1.0);
 }
+// Height-correlated Smith masking-shadowing
 float GeometrySmith(vec3 N, vec3 V, vec3 L, float rough) {
     float NdotV = max(dot(N, V), 0.0);
     float NdotL = max(dot(N, L), 0.0);
-    float ggx1 = GeometrySchlickGGX(NdotV, rough);
-    float ggx2 = GeometrySchlickGGX(NdotL, rough);
-    return ggx1 * ggx2;
+    if (NdotV <= 0.0 || NdotL <= 0.0) return 0.0;
+    float a = rough * rough;
+    return 1.0 / (1.0 + SmithLambdaGGX(NdotV, a) + SmithLambdaGGX(NdotL, a));
 }
 
 // Clearcoat lobe (second specular layer)
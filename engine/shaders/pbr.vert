@@ -1,9 +1,15 @@
 #version 330 core
 
+// Mesh positions are unorm16 in the mesh bounds; model includes the
+// dequantizing scale and offset. Normals are octahedral snorm16.
 layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec3 aNormal;
+layout(location = 1) in vec2 aNormal;
 layout(location = 2) in vec2 aUV;
 layout(location = 3) in vec3 aTangent;
+// Per-instance model matrix (locations 4-7), read instead of model for
+// instanced draws
+layout(location = 4) in mat4 aInstanceModel;
+uniform bool useInstancing;
 
 // Transform matrices uniform block
 layout(std140) uniform TransformBlock {
@@ -38,11 +44,20 @@ out vec3 vWorldPos;
 out vec2 vUV;
 out mat3 vTBN;
 
+// Octahedral unit vector, as packed by MeshOptimizer::octEncode
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+    return normalize(n);
+}
+
 void main() {
-    vec3 N = normalize(mat3(transpose(inverse(model))) * aNormal);
+    mat4 M = useInstancing ? aInstanceModel : model;
+    vec3 N = normalize(mat3(transpose(inverse(M))) * octDecode(aNormal));
     vec3 T;
     if (hasTangents) {
-        T = normalize(mat3(model) * aTangent);
+        T = normalize(mat3(M) * aTangent);
         // Orthonormalize T against N
         T = normalize(T - N * dot(N, T));
     } else {
@@ -54,6 +69,6 @@ void main() {
 
     vTBN = mat3(T, B, N);
     vUV = aUV;
-    vWorldPos = vec3(model * vec4(aPos, 1.0));
+    vWorldPos = vec3(M * vec4(aPos, 1.0));
     gl_Position = projection * view * vec4(vWorldPos, 1.0);
 }
@@ -10,6 +10,8 @@
 #include "ray_utils.h"
 #include "json_ops.h"
 #include "path_utils.h"
+#include "config_defaults.h"
+#include "texture_cache.h"
 #ifndef WEB_USE_HTML_UI
 #include "imgui.h"
 #endif
@@ -133,6 +135,10 @@ void ApplicationCore::frame()
     if (m_uiBridge) {
         m_requireRMBToMove = m_uiBridge->getRequireRMBToMove();
     }
+    // Add finished asynchronous loads and prefetched textures, a budgeted amount per frame
+    m_scene->pumpLoads(Defaults::AssetUploadBudgetBytes);
+    TextureCache::instance().pumpUploads(Defaults::AssetUploadBudgetBytes);
+
     // Update camera
     m_camera->update(dt);
     
@@ -216,6 +222,11 @@ bool ApplicationCore::renderToPNG(const std::string& path, int width, int height
     return m_renderer->renderToPNG(*m_scene, *m_lights, path, width, height);
 }
 
+bool ApplicationCore::renderToEXR(const std::string& path, int width, int height)
+{
+    return m_renderer->renderToEXR(*m_scene, *m_lights, path, width, height);
+}
+
 bool ApplicationCore::applyJsonOpsV1(const std::string& json, std::string& error)
 {
     if (m_ops) return m_ops->apply(json, error);
@@ -258,6 +269,12 @@ void ApplicationCore::setRenderSettings(const RenderSettings& settings)
         m_renderer->setGamma(settings.gamma);
         m_renderer->setSeed(settings.seed);
         m_renderer->setSampleCount(settings.samples);
+        m_renderer->setLodErrorPixels(settings.lodErrorPixels);
+
+        RenderConfig config = m_renderer->getRenderConfig();
+        config.qualityThreshold = settings.quality;
+        config.timeBudgetSeconds = settings.timeBudget;
+        m_renderer->setRenderConfig(config);
     }
     m_rng.setSeed(settings.seed);
 }
@@ -297,16 +314,6 @@ bool ApplicationCore::isRaytraceMode() const
     return m_renderer->getRenderMode() == RenderMode::Raytrace;
 }
 
-void ApplicationCore::setReflectionSpp(int spp) 
-{
-    m_renderer->setReflectionSpp(spp);
-}
-
-int ApplicationCore::getReflectionSpp() const 
-{
-    return m_renderer->getReflectionSpp();
-}
-
 void ApplicationCore::handleMouseMove(double xpos, double ypos) // Should this be moved?
 {
     if (m_firstMouse) {
@@ -352,6 +359,7 @@ void ApplicationCore::handleMouseMove(double xpos, double ypos) // Should this b
                 if (m_dragObjectIndex >= 0) {
                     auto& obj = m_scene->getObjects()[m_dragObjectIndex];
                     obj.modelMatrix = glm::translate(glm::mat4(1.0f), delta) * m_modelStart;
+                    m_scene->markTransformDirty(m_dragObjectIndex);
                 } else if (m_dragLightIndex >= 0 && m_dragLightIndex < (int)m_lights->m_lights.size()) {
                     m_lights->m_lights[(size_t)m_dragLightIndex].position = m_dragOriginWorld + delta;
                 }
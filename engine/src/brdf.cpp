@@ -7,38 +7,141 @@ namespace
     constexpr float PI = 3.14159265358979323846f;
     inline float saturate(float x) { return std::max(0.0f, std::min(1.0f, x)); }
 
-    // Beckmann normal distribution function (NDF)
-    // alpha is surface slope parameter (use roughness^2 as an approximation)
-    inline float D_Beckmann(float NdotH, float alpha)
+    // Tangent frame around N (tangent, bitangent, normal are right-handed)
+    inline void orthonormalBasis(const glm::vec3& N, glm::vec3& T, glm::vec3& B)
     {
-        NdotH = saturate(NdotH);
-        const float cos2 = NdotH * NdotH;
-        if (cos2 <= 0.0f) return 0.0f;
-        const float tan2 = (1.0f - cos2) / cos2;
+        const glm::vec3 up = (std::abs(N.y) < 0.999f) ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0);
+        T = glm::normalize(glm::cross(up, N));
+        B = glm::cross(N, T);
+    }
+
+    // Smith Lambda for GGX
+    inline float lambda(float NdotX, float alpha)
+    {
+        NdotX = std::max(1e-6f, NdotX);
+        const float cos2 = NdotX * NdotX;
+        const float tan2 = std::max(0.0f, 1.0f - cos2) / cos2;
+        return 0.5f * (std::sqrt(1.0f + alpha * alpha * tan2) - 1.0f);
+    }
+}
+
+namespace brdf
+{
+    float roughnessToAlpha(float roughness)
+    {
+        const float r = saturate(roughness);
+        return std::max(1e-3f, r * r);
+    }
+
+    float ggxD(float NdotH, float alpha)
+    {
+        if (NdotH <= 0.0f) return 0.0f;
         const float a2 = alpha * alpha;
-        const float denom = PI * a2 * cos2 * cos2;
-        if (denom <= 0.0f) return 0.0f;
-        return std::exp(-tan2 / a2) / denom;
+        const float d = NdotH * NdotH * (a2 - 1.0f) + 1.0f;
+        return a2 / (PI * d * d);
     }
 
-    // Cook–Torrance geometric attenuation term (also called Smith's for V and L in min form)
-    inline float G_CookTorrance(float NdotL, float NdotV, float NdotH, float VdotH)
+    float smithG1(float NdotX, float alpha)
     {
-        if (VdotH <= 0.0f) return 0.0f;
-        const float g1 = (2.0f * NdotH * NdotV) / VdotH;
-        const float g2 = (2.0f * NdotH * NdotL) / VdotH;
-        return std::min(1.0f, std::min(g1, g2));
+        return NdotX > 0.0f ? 1.0f / (1.0f + lambda(NdotX, alpha)) : 0.0f;
     }
 
-    inline glm::vec3 Fresnel_Schlick(float cosTheta, const glm::vec3& F0)
+    float smithG2(float NdotV, float NdotL, float alpha)
     {
-        cosTheta = saturate(cosTheta);
-        return F0 + (glm::vec3(1.0f) - F0) * std::pow(1.0f - cosTheta, 5.0f);
+        if (NdotV <= 0.0f || NdotL <= 0.0f) return 0.0f;
+        return 1.0f / (1.0f + lambda(NdotV, alpha) + lambda(NdotL, alpha));
+    }
+
+    glm::vec3 fresnelSchlick(float cosTheta, const glm::vec3& F0)
+    {
+        const float m = 1.0f - saturate(cosTheta);
+        const float m2 = m * m;
+        return F0 + (glm::vec3(1.0f) - F0) * (m2 * m2 * m);
+    }
+
+    glm::vec3 ggxSpecular(
+        const glm::vec3& N,
+        const glm::vec3& V,
+        const glm::vec3& L,
+        const glm::vec3& F0,
+        float alpha)
+    {
+        const float NdotL = glm::dot(N, L);
+        const float NdotV = glm::dot(N, V);
+        if (NdotL <= 0.0f || NdotV <= 0.0f)
+            return glm::vec3(0.0f);
+
+        const glm::vec3 H = glm::normalize(V + L);
+        const float D = ggxD(glm::dot(N, H), alpha);
+        const float G = smithG2(NdotV, NdotL, alpha);
+        const glm::vec3 F = fresnelSchlick(glm::dot(V, H), F0);
+        return (D * G / (4.0f * NdotL * NdotV)) * F;
+    }
+
+    glm::vec3 sampleVisibleNormal(const glm::vec3& N, const glm::vec3& V, float alpha, float u1, float u2)
+    {
+        glm::vec3 T, B;
+        orthonormalBasis(N, T, B);
+        const glm::vec3 Vl(glm::dot(V, T), glm::dot(V, B), glm::dot(V, N));
+
+        // Stretch the view direction into the hemisphere configuration
+        const glm::vec3 Vh = glm::normalize(glm::vec3(alpha * Vl.x, alpha * Vl.y, Vl.z));
+        const float lensq = Vh.x * Vh.x + Vh.y * Vh.y;
+        const glm::vec3 T1 = lensq > 0.0f ? glm::vec3(-Vh.y, Vh.x, 0.0f) / std::sqrt(lensq) : glm::vec3(1.0f, 0.0f, 0.0f);
+        const glm::vec3 T2 = glm::cross(Vh, T1);
+
+        // Uniform point on the projected half disk
+        const float r = std::sqrt(u1);
+        const float phi = 2.0f * PI * u2;
+        const float t1 = r * std::cos(phi);
+        const float s = 0.5f * (1.0f + Vh.z);
+        const float t2 = (1.0f - s) * std::sqrt(std::max(0.0f, 1.0f - t1 * t1)) + s * r * std::sin(phi);
+
+        // Reproject onto the hemisphere and unstretch
+        const glm::vec3 Nh = t1 * T1 + t2 * T2 + std::sqrt(std::max(0.0f, 1.0f - t1 * t1 - t2 * t2)) * Vh;
+        const glm::vec3 Hl = glm::normalize(glm::vec3(alpha * Nh.x, alpha * Nh.y, std::max(1e-6f, Nh.z)));
+        return glm::normalize(Hl.x * T + Hl.y * B + Hl.z * N);
+    }
+
+    float ggxReflectionPdf(const glm::vec3& N, const glm::vec3& V, const glm::vec3& L, float alpha)
+    {
+        const float NdotV = glm::dot(N, V);
+        if (NdotV <= 0.0f || glm::dot(N, L) <= 0.0f)
+            return 0.0f;
+
+        // D_V(H) / (4·V·H) with D_V(H) = G1(V)·D(H)·(V·H) / (N·V)
+        const glm::vec3 H = glm::normalize(V + L);
+        return smithG1(NdotV, alpha) * ggxD(glm::dot(N, H), alpha) / (4.0f * NdotV);
+    }
+
+    bool sampleGGXReflection(
+        const glm::vec3& N,
+        const glm::vec3& V,
+        const glm::vec3& F0,
+        float roughness,
+        float u1,
+        float u2,
+        GlossySample& sample)
+    {
+        const float NdotV = glm::dot(N, V);
+        if (NdotV <= 0.0f)
+            return false;
+
+        const float alpha = roughnessToAlpha(roughness);
+        const glm::vec3 H = sampleVisibleNormal(N, V, alpha, u1, u2);
+        const float VdotH = glm::dot(V, H);
+        sample.direction = glm::normalize(2.0f * VdotH * H - V);
+
+        const float NdotL = glm::dot(N, sample.direction);
+        if (NdotL <= 0.0f)
+            return false;
+
+        const float G1 = smithG1(NdotV, alpha);
+        sample.weight = fresnelSchlick(VdotH, F0) * (smithG2(NdotV, NdotL, alpha) / G1);
+        sample.pdf = G1 * ggxD(glm::dot(N, H), alpha) / (4.0f * NdotV);
+        return true;
     }
-}
 
-namespace brdf
-{
     glm::vec3 cookTorrance(
         const glm::vec3& N,
         const glm::vec3& V,
@@ -50,32 +153,20 @@ namespace brdf
         const glm::vec3 Nn = glm::normalize(N);
         const glm::vec3 Vn = glm::normalize(V);
         const glm::vec3 Ln = glm::normalize(L);
-        const glm::vec3 H = glm::normalize(Vn + Ln);
 
-        const float NdotL = std::max(0.0f, glm::dot(Nn, Ln));
-        const float NdotV = std::max(0.0f, glm::dot(Nn, Vn));
+        const float NdotL = glm::dot(Nn, Ln);
+        const float NdotV = glm::dot(Nn, Vn);
         if (NdotL <= 0.0f || NdotV <= 0.0f)
             return glm::vec3(0.0f);
 
-        const float NdotH = std::max(0.0f, glm::dot(Nn, H));
-        const float VdotH = std::max(0.0f, glm::dot(Vn, H));
-
-        // Map artist roughness to microfacet alpha; clamp to avoid singularities
-        const float r = std::max(0.001f, roughness);
-        const float alpha = r * r; // Beckmann often uses alpha = roughness^2
-
         // Dielectric base reflectance ~0.04; metals take baseColor as F0
         const glm::vec3 dielectricF0(0.04f);
         const glm::vec3 F0 = glm::mix(dielectricF0, baseColor, saturate(metallic));
 
-        const float D = D_Beckmann(NdotH, alpha);
-        const float G = G_CookTorrance(NdotL, NdotV, NdotH, VdotH);
-        const glm::vec3 F = Fresnel_Schlick(VdotH, F0);
-
-        const float denom = std::max(1e-6f, 4.0f * NdotL * NdotV);
-        const glm::vec3 spec = (D * G / denom) * F;
+        const glm::vec3 spec = ggxSpecular(Nn, Vn, Ln, F0, roughnessToAlpha(roughness));
 
         // Energy conservation: reduce diffuse by average Fresnel, and by (1 - metallic)
+        const glm::vec3 F = fresnelSchlick(glm::dot(Vn, glm::normalize(Vn + Ln)), F0);
         const float F_avg = (F.x + F.y + F.z) * (1.0f / 3.0f);
         const float kd = (1.0f - saturate(metallic)) * (1.0f - F_avg);
         const glm::vec3 diffuse = kd * baseColor * (1.0f / PI);
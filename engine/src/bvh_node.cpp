@@ -1,99 +1,283 @@
 #include "bvh_node.h"
-#include "ray_utils.h"
 #include <algorithm>
+#include <numeric>
 
-extern bool rayIntersectsAABB(const Ray& ray, const glm::vec3& minBound, const glm::vec3& maxBound, float& t);
+namespace
+{
+    constexpr int kBinCount = 16;
+
+    struct Bounds
+    {
+        glm::vec3 mn{ FLT_MAX };
+        glm::vec3 mx{ -FLT_MAX };
 
-BVHNode::~BVHNode()
+        void grow(const glm::vec3& p) { mn = glm::min(mn, p); mx = glm::max(mx, p); }
+        void grow(const Bounds& b) { mn = glm::min(mn, b.mn); mx = glm::max(mx, b.mx); }
+        float area() const
+        {
+            const glm::vec3 e = mx - mn;
+            return (e.x < 0.0f) ? 0.0f : (e.x * e.y + e.y * e.z + e.z * e.x);
+        }
+    };
+
+    struct Bin
+    {
+        Bounds bounds;
+        uint32_t count = 0;
+    };
+
+    struct BuildInput
+    {
+        const std::vector<glm::vec3>& primMin;
+        const std::vector<glm::vec3>& primMax;
+        std::vector<glm::vec3> centroids;
+        uint32_t leafWidth = 1;
+
+        // Intersection cost of count primitives tested leafWidth at a time
+        float leafCost(uint32_t count) const { return static_cast<float>((count + leafWidth - 1) / leafWidth); }
+    };
+
+    struct SplitCandidate
+    {
+        int axis = -1;
+        int bin = 0;            // primitives in bins [0, bin) go left
+        float cost = FLT_MAX;
+    };
+
+    inline int binIndex(float c, float cmin, float scale)
+    {
+        return std::min(kBinCount - 1, static_cast<int>((c - cmin) * scale));
+    }
+
+    // Evaluate binned SAH on every axis over the node's primitive range
+    SplitCandidate findBestSplit(const BuildInput& in, const uint32_t* prims, uint32_t count,
+                                 const Bounds& centroidBounds)
+    {
+        SplitCandidate best;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float cmin = centroidBounds.mn[axis];
+            const float extent = centroidBounds.mx[axis] - cmin;
+            if (extent <= 0.0f) continue;
+
+            Bin bins[kBinCount];
+            const float scale = kBinCount / extent;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const uint32_t p = prims[i];
+                Bin& b = bins[binIndex(in.centroids[p][axis], cmin, scale)];
+                b.count++;
+                b.bounds.grow(in.primMin[p]);
+                b.bounds.grow(in.primMax[p]);
+            }
+
+            // Sweep from both ends to get area/count on each side of every plane
+            float leftArea[kBinCount - 1], rightArea[kBinCount - 1];
+            uint32_t leftCount[kBinCount - 1], rightCount[kBinCount - 1];
+            Bounds lb, rb;
+            uint32_t lc = 0, rc = 0;
+            for (int i = 0; i < kBinCount - 1; ++i)
+            {
+                lc += bins[i].count;
+                lb.grow(bins[i].bounds);
+                leftCount[i] = lc;
+                leftArea[i] = lb.area();
+
+                rc += bins[kBinCount - 1 - i].count;
+                rb.grow(bins[kBinCount - 1 - i].bounds);
+                rightCount[kBinCount - 2 - i] = rc;
+                rightArea[kBinCount - 2 - i] = rb.area();
+            }
+
+            for (int i = 0; i < kBinCount - 1; ++i)
+            {
+                if (leftCount[i] == 0 || rightCount[i] == 0) continue;
+                const float cost = in.leafCost(leftCount[i]) * leftArea[i] + in.leafCost(rightCount[i]) * rightArea[i];
+                if (cost < best.cost)
+                {
+                    best.axis = axis;
+                    best.bin = i + 1;
+                    best.cost = cost;
+                }
+            }
+        }
+        return best;
+    }
+}
+
+void BVH::clear()
 {
-    delete left;
-    delete right;
+    m_nodes.clear();
+    m_primIndices.clear();
 }
 
-bool BVHNode::intersect(const Ray& ray, const Triangle*& outTri, float& outT, glm::vec3& outNormal) const
+void BVH::resetPrimitiveOrder()
 {
-    float tempT;
-    if (!rayIntersectsAABB(ray, boundsMin, boundsMax, tempT))
-        return false;
+    std::iota(m_primIndices.begin(), m_primIndices.end(), 0u);
+}
 
-    bool hit = false;
-    float closest = outT; // start with incoming outT
+void BVH::assign(BVHNodeArray nodes, std::vector<uint32_t> primIndices)
+{
+    m_nodes = std::move(nodes);
+    m_primIndices = std::move(primIndices);
+}
 
-    for (auto tri : triangles)
+void BVH::buildTriangles(const glm::vec3* positions, const uint32_t* indices, size_t triangleCount, uint32_t leafWidth)
+{
+    std::vector<glm::vec3> primMin(triangleCount), primMax(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t)
     {
-        float localT;
-        glm::vec3 localNormal;
-        if (tri->intersect(ray, localT, localNormal) && localT < closest)
-        {
-            closest = localT;
-            outTri = tri;
-            outNormal = localNormal;
-            hit = true;
-        }
+        const glm::vec3 a = positions[indices[t * 3 + 0]];
+        const glm::vec3 b = a + (positions[indices[t * 3 + 1]] - a);
+        const glm::vec3 c = a + (positions[indices[t * 3 + 2]] - a);
+        primMin[t] = glm::min(a, glm::min(b, c));
+        primMax[t] = glm::max(a, glm::max(b, c));
     }
+    build(primMin, primMax, leafWidth);
+}
+
+void BVH::build(const std::vector<glm::vec3>& primMin, const std::vector<glm::vec3>& primMax, uint32_t leafWidth)
+{
+    clear();
+    const uint32_t n = static_cast<uint32_t>(primMin.size());
+    if (n == 0 || primMax.size() != primMin.size()) return;
 
-    if (left)
+    BuildInput in{ primMin, primMax, {}, std::max(leafWidth, 1u) };
+    in.centroids.resize(n);
+    for (uint32_t i = 0; i < n; ++i)
+        in.centroids[i] = 0.5f * (primMin[i] + primMax[i]);
+
+    m_primIndices.resize(n);
+    std::iota(m_primIndices.begin(), m_primIndices.end(), 0u);
+
+    // Node 1 is left unused so sibling pairs start on even indices and, with the
+    // 64-byte aligned node array, share a cache line
+    m_nodes.reserve(2 * static_cast<size_t>(n));
+    m_nodes.resize(2);
+    m_nodes[0].leftFirst = 0;
+    m_nodes[0].primCount = n;
+
+    struct Task { uint32_t node; int depth; };
+    std::vector<Task> tasks;
+    tasks.push_back({ 0, 0 });
+
+    while (!tasks.empty())
     {
-        const Triangle* triLeft = nullptr;
-        glm::vec3 normalLeft;
-        float tLeft = closest;
-        if (left->intersect(ray, triLeft, tLeft, normalLeft) && tLeft < closest)
+        const Task task = tasks.back();
+        tasks.pop_back();
+
+        const uint32_t first = m_nodes[task.node].leftFirst;
+        const uint32_t count = m_nodes[task.node].primCount;
+        uint32_t* prims = m_primIndices.data() + first;
+
+        Bounds bounds, centroidBounds;
+        for (uint32_t i = 0; i < count; ++i)
         {
-            closest = tLeft;
-            outTri = triLeft;
-            outNormal = normalLeft;
-            hit = true;
+            bounds.grow(primMin[prims[i]]);
+            bounds.grow(primMax[prims[i]]);
+            centroidBounds.grow(in.centroids[prims[i]]);
         }
-    }
+        m_nodes[task.node].boundsMin = bounds.mn;
+        m_nodes[task.node].boundsMax = bounds.mx;
 
-    if (right)
-    {
-        const Triangle* triRight = nullptr;
-        glm::vec3 normalRight;
-        float tRight = closest;
-        if (right->intersect(ray, triRight, tRight, normalRight) && tRight < closest)
+        if (count <= 2 || task.depth >= kMaxDepth) continue;
+
+        // SAH with traversal and intersection cost both normalised to 1
+        const SplitCandidate split = findBestSplit(in, prims, count, centroidBounds);
+        const float parentArea = std::max(bounds.area(), 1e-20f);
+        const float splitCost = 1.0f + split.cost / parentArea;
+        const bool wantSplit = split.axis >= 0 && splitCost < in.leafCost(count);
+        if (!wantSplit && count <= static_cast<uint32_t>(kMaxLeafSize)) continue;
+
+        uint32_t leftCount = 0;
+        if (split.axis >= 0)
         {
-            closest = tRight;
-            outTri = triRight;
-            outNormal = normalRight;
-            hit = true;
+            const int axis = split.axis;
+            const float cmin = centroidBounds.mn[axis];
+            const float scale = kBinCount / (centroidBounds.mx[axis] - cmin);
+            uint32_t* mid = std::partition(prims, prims + count, [&](uint32_t p) {
+                return binIndex(in.centroids[p][axis], cmin, scale) < split.bin;
+            });
+            leftCount = static_cast<uint32_t>(mid - prims);
         }
-    }
 
-    if (hit)
-        outT = closest;
+        // Oversized leaf without a useful SAH plane: fall back to an object median split
+        if (leftCount == 0 || leftCount == count)
+        {
+            const glm::vec3 extent = centroidBounds.mx - centroidBounds.mn;
+            const int axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : (extent.y > extent.z ? 1 : 2);
+            leftCount = count / 2;
+            std::nth_element(prims, prims + leftCount, prims + count, [&](uint32_t a, uint32_t b) {
+                return in.centroids[a][axis] < in.centroids[b][axis];
+            });
+        }
+
+        const uint32_t leftChild = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+        m_nodes.emplace_back();
+        m_nodes[leftChild].leftFirst = first;
+        m_nodes[leftChild].primCount = leftCount;
+        m_nodes[leftChild + 1].leftFirst = first + leftCount;
+        m_nodes[leftChild + 1].primCount = count - leftCount;
+
+        m_nodes[task.node].leftFirst = leftChild;
+        m_nodes[task.node].primCount = 0;
+
+        tasks.push_back({ leftChild + 1, task.depth + 1 });
+        tasks.push_back({ leftChild, task.depth + 1 });
+    }
 
-    return hit;
+    m_nodes.shrink_to_fit();
 }
 
-bool BVHNode::intersectAny(const Ray& ray, const Triangle*& outTri, float& tOut) const
+void BVH::refit(const std::vector<glm::vec3>& primMin, const std::vector<glm::vec3>& primMax)
 {
-    float t;
-    if (!rayIntersectsAABB(ray, boundsMin, boundsMax, t))
-        return false;
+    if (m_nodes.empty()) return;
 
-    // If this is a leaf node, check triangles
-    if (!left && !right)
+    // Children are always stored after their parent, so a reverse sweep is bottom-up
+    for (size_t i = m_nodes.size(); i-- > 0;)
     {
-        for (const auto* tri : triangles)
+        if (i == 1) continue; // padding node
+        BVHNode& node = m_nodes[i];
+        Bounds b;
+        if (node.isLeaf())
         {
-            float localT;
-            glm::vec3 normal;
-            if (tri->intersect(ray, localT, normal))
+            for (uint32_t k = 0; k < node.primCount; ++k)
             {
-                outTri = tri;
-                tOut = localT;
-                return true;
+                const uint32_t p = m_primIndices[node.leftFirst + k];
+                b.grow(primMin[p]);
+                b.grow(primMax[p]);
             }
         }
-        return false;
+        else
+        {
+            const BVHNode& l = m_nodes[node.leftFirst];
+            const BVHNode& r = m_nodes[node.leftFirst + 1];
+            b.mn = glm::min(l.boundsMin, r.boundsMin);
+            b.mx = glm::max(l.boundsMax, r.boundsMax);
+        }
+        node.boundsMin = b.mn;
+        node.boundsMax = b.mx;
     }
+}
 
-    // Check children - return immediately if any child finds an intersection
-    if (left && left->intersectAny(ray, outTri, tOut))
-        return true;
-    if (right && right->intersectAny(ray, outTri, tOut))
-        return true;
+float BVH::sahCost() const
+{
+    if (m_nodes.empty()) return 0.0f;
+
+    auto area = [](const BVHNode& n) {
+        Bounds b;
+        b.mn = n.boundsMin;
+        b.mx = n.boundsMax;
+        return b.area();
+    };
 
-    return false;
+    float cost = 0.0f;
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        if (i == 1) continue;
+        const BVHNode& n = m_nodes[i];
+        cost += area(n) * (n.isLeaf() ? static_cast<float>(n.primCount) : 1.0f);
+    }
+    return cost / std::max(area(m_nodes[0]), 1e-20f);
 }
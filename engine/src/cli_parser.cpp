@@ -61,6 +61,7 @@ CLIParseResult CLIParser::parse(int argc, char** argv)
     result.options.enableDenoise = hasFlag("--denoise");
     result.options.forceRaytrace = hasFlag("--raytrace");
     result.options.strictSchema = hasFlag("--strict-schema");
+    result.options.deprecatedReflectionSpp = hasFlag("--refl-spp");
     
     // Parse values
     result.options.opsFile = getValue("--ops");
@@ -68,7 +69,6 @@ CLIParseResult CLIParser::parse(int argc, char** argv)
     result.options.assetRoot = getValue("--asset-root");
     result.options.outputWidth = getIntValue("--w", 1024);
     result.options.outputHeight = getIntValue("--h", 1024);
-    result.options.reflectionSpp = getIntValue("--refl-spp", 8);
     result.options.fixedTimestepMs = getIntValue("--fixed-timestep", 0);
     // New: render mode (raster|ray|auto)
     {
@@ -96,6 +96,9 @@ CLIParseResult CLIParser::parse(int argc, char** argv)
     std::string toneStr = getValue("--tone", "linear");
     std::string exposureStr = getValue("--exposure", "0.0");
     std::string gammaStr = getValue("--gamma", "2.2");
+    std::string qualityStr = getValue("--quality", "0.95");
+    std::string timeBudgetStr = getValue("--time-budget", "0");
+    std::string lodErrorStr = getValue("--lod-error", "1");
 
     // Validate samples when flag provided
     if (hasFlag("--samples")) {
@@ -242,6 +245,33 @@ CLIParseResult CLIParser::parse(int argc, char** argv)
         result.options.renderSettings.gamma = parseGamma(gammaStr);
     }
     
+    if (hasFlag("--quality")) {
+        if (qualityStr.empty() || !isValidQuality(qualityStr)) {
+            result.exitCode = CLIExitCode::UnknownFlag;
+            result.errorMessage = "Invalid quality value: " + qualityStr + " (must be a float in (0, 1])";
+            return result;
+        }
+        result.options.renderSettings.quality = std::stof(qualityStr);
+    }
+
+    if (hasFlag("--time-budget")) {
+        if (timeBudgetStr.empty() || !isValidTimeBudget(timeBudgetStr)) {
+            result.exitCode = CLIExitCode::UnknownFlag;
+            result.errorMessage = "Invalid time budget: " + timeBudgetStr + " (must be a non-negative number of seconds)";
+            return result;
+        }
+        result.options.renderSettings.timeBudget = std::stof(timeBudgetStr);
+    }
+
+    if (hasFlag("--lod-error")) {
+        if (lodErrorStr.empty() || !isValidLodError(lodErrorStr)) {
+            result.exitCode = CLIExitCode::UnknownFlag;
+            result.errorMessage = "Invalid LOD error: " + lodErrorStr + " (must be a non-negative number of pixels)";
+            return result;
+        }
+        result.options.renderSettings.lodErrorPixels = std::stof(lodErrorStr);
+    }
+    
     // Determine headless mode
     result.options.headlessMode = hasFlag("--ops") || hasFlag("--render");
     
@@ -275,13 +305,6 @@ CLIParseResult CLIParser::parse(int argc, char** argv)
         return result;
     }
     
-    // Validate reflection samples per pixel
-    if (result.options.reflectionSpp <= 0) {
-        result.exitCode = CLIExitCode::UnknownFlag;
-        result.errorMessage = "Reflection samples per pixel (--refl-spp) must be a positive integer";
-        return result;
-    }
-    
     return result;
 }
 
@@ -354,7 +377,10 @@ std::vector<std::string> CLIParser::getValidFlags()
         "--seed",
         "--tone",
         "--exposure",
-        "--gamma"
+        "--gamma",
+        "--quality",
+        "--time-budget",
+        "--lod-error"
     };
 }
 
@@ -393,6 +419,39 @@ bool CLIParser::isValidGamma(const std::string& gamma)
     }
 }
 
+bool CLIParser::isValidQuality(const std::string& quality)
+{
+    if (quality.empty()) return false;
+    try {
+        float val = std::stof(quality);
+        return val > 0.0f && val <= 1.0f;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool CLIParser::isValidTimeBudget(const std::string& seconds)
+{
+    if (seconds.empty()) return false;
+    try {
+        float val = std::stof(seconds);
+        return val >= 0.0f;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool CLIParser::isValidLodError(const std::string& pixels)
+{
+    if (pixels.empty()) return false;
+    try {
+        float val = std::stof(pixels);
+        return val >= 0.0f;
+    } catch (...) {
+        return false;
+    }
+}
+
 uint32_t CLIParser::parseSeed(const std::string& seed)
 {
     try {
@@ -0,0 +1,226 @@
+#include "denoiser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+#ifdef OIDN_ENABLED
+#include <OpenImageDenoise/oidn.hpp>
+#endif
+
+namespace
+{
+    // Used when the filter does not report its own tiling requirements
+    constexpr int kDefaultTileOverlap = 128;
+    constexpr int kDefaultTileAlignment = 16;
+
+    int roundUp(int value, int multiple)
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+}
+
+#ifdef OIDN_ENABLED
+struct Denoiser::Impl
+{
+    oidn::DeviceRef device;
+    oidn::FilterRef filter;
+    bool filterAlbedo = false;
+    bool filterNormal = false;
+    std::vector<glm::vec3> tileOutput;
+
+    // Reports and clears the device's pending error, if any
+    bool failed(const char* stage)
+    {
+        const char* errorMessage = nullptr;
+        if (device.getError(errorMessage) == oidn::Error::None)
+            return false;
+        std::cerr << "[Denoiser] OIDN " << stage << " error: " << (errorMessage ? errorMessage : "unknown") << "\n";
+        return true;
+    }
+};
+#else
+struct Denoiser::Impl
+{
+};
+#endif
+
+Denoiser::Denoiser()
+    : m_impl(std::make_unique<Impl>())
+{
+}
+
+Denoiser::~Denoiser() = default;
+
+bool Denoiser::isAvailable()
+{
+#ifdef OIDN_ENABLED
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::vector<Denoiser::Span> Denoiser::splitAxis(int size, int tileSize, int overlap, int alignment)
+{
+    std::vector<Span> spans;
+    if (size <= 0) return spans;
+    if (tileSize >= size)
+    {
+        spans.push_back({ 0, 0, size });
+        return spans;
+    }
+
+    alignment = std::max(1, alignment);
+    overlap = roundUp(std::max(0, overlap), alignment);
+    int step = (tileSize - 2 * overlap) / alignment * alignment;
+    if (step <= 0)
+    {
+        // Tiles too small for the context the filter wants; seams beat failing
+        overlap = 0;
+        step = tileSize;
+    }
+
+    // Once a tile reaches the image edge it keeps everything up to it
+    for (int begin = 0; begin < size;)
+    {
+        const int origin = std::clamp(begin - overlap, 0, size - tileSize);
+        const int end = origin + tileSize >= size ? size : begin + step;
+        spans.push_back({ origin, begin, end });
+        begin = end;
+    }
+    return spans;
+}
+
+bool Denoiser::denoise(std::vector<glm::vec3>& color, int width, int height,
+                       const std::vector<glm::vec3>* normal,
+                       const std::vector<glm::vec3>* albedo)
+{
+    if (color.empty())
+    {
+        std::cerr << "[Denoiser] Empty color buffer\n";
+        return false;
+    }
+    if (width <= 0 || height <= 0)
+    {
+        std::cerr << "[Denoiser] Invalid dimensions: " << width << "x" << height << "\n";
+        return false;
+    }
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    if (color.size() != pixelCount)
+    {
+        std::cerr << "[Denoiser] Buffer size " << color.size() << " doesn't match dimensions "
+                  << width << "x" << height << "\n";
+        return false;
+    }
+
+#ifdef OIDN_ENABLED
+    try
+    {
+        Impl& impl = *m_impl;
+        const auto start = std::chrono::steady_clock::now();
+
+        if (!impl.device)
+        {
+            impl.device = oidn::newDevice();
+            impl.device.commit();
+            if (impl.failed("device"))
+            {
+                impl.device = nullptr;
+                return false;
+            }
+        }
+
+        const bool useAlbedo = albedo && albedo->size() == pixelCount;
+        const bool useNormal = useAlbedo && normal && normal->size() == pixelCount;
+        if (!impl.filter || useAlbedo != impl.filterAlbedo || useNormal != impl.filterNormal)
+        {
+            impl.filter = impl.device.newFilter("RT");
+            impl.filter.set("hdr", true);    // radiance, not display values
+            impl.filter.set("srgb", false);  // linear space
+            impl.filterAlbedo = useAlbedo;
+            impl.filterNormal = useNormal;
+        }
+        oidn::FilterRef& filter = impl.filter;
+
+        constexpr size_t pixelBytes = sizeof(glm::vec3);
+        const size_t rowBytes = pixelBytes * width;
+        auto setInputs = [&](int x, int y, int w, int h) {
+            const size_t offset = static_cast<size_t>(y) * rowBytes + static_cast<size_t>(x) * pixelBytes;
+            filter.setImage("color", color.data(), oidn::Format::Float3, w, h, offset, pixelBytes, rowBytes);
+            if (useAlbedo)
+                filter.setImage("albedo", const_cast<glm::vec3*>(albedo->data()), oidn::Format::Float3, w, h, offset, pixelBytes, rowBytes);
+            if (useNormal)
+                filter.setImage("normal", const_cast<glm::vec3*>(normal->data()), oidn::Format::Float3, w, h, offset, pixelBytes, rowBytes);
+        };
+
+        const bool tiled = width > kMaxUntiledExtent || height > kMaxUntiledExtent;
+        size_t tileCount = 1;
+        if (!tiled)
+        {
+            // Whole frame, in place
+            setInputs(0, 0, width, height);
+            filter.setImage("output", color.data(), oidn::Format::Float3, width, height);
+            filter.commit();
+            if (impl.failed("filter setup")) return false;
+            filter.execute();
+            if (impl.failed("execution")) return false;
+        }
+        else
+        {
+            // Tiles read the original color around them, so results go to a
+            // separate frame that replaces the input at the end
+            const int overlap = filter.get<int>("tileOverlap");
+            const int alignment = filter.get<int>("tileAlignment");
+            const std::vector<Span> columns = splitAxis(width, kTileExtent,
+                overlap > 0 ? overlap : kDefaultTileOverlap, alignment > 0 ? alignment : kDefaultTileAlignment);
+            const std::vector<Span> rows = splitAxis(height, kTileExtent,
+                overlap > 0 ? overlap : kDefaultTileOverlap, alignment > 0 ? alignment : kDefaultTileAlignment);
+            const int tileW = std::min(width, kTileExtent);
+            const int tileH = std::min(height, kTileExtent);
+            tileCount = columns.size() * rows.size();
+
+            std::vector<glm::vec3> output(pixelCount);
+            impl.tileOutput.resize(static_cast<size_t>(tileW) * tileH);
+            for (const Span& row : rows)
+            {
+                for (const Span& column : columns)
+                {
+                    setInputs(column.origin, row.origin, tileW, tileH);
+                    filter.setImage("output", impl.tileOutput.data(), oidn::Format::Float3, tileW, tileH);
+                    filter.commit();
+                    if (impl.failed("filter setup")) return false;
+                    filter.execute();
+                    if (impl.failed("execution")) return false;
+
+                    for (int y = row.begin; y < row.end; ++y)
+                    {
+                        const glm::vec3* src = impl.tileOutput.data() +
+                            static_cast<size_t>(y - row.origin) * tileW + (column.begin - column.origin);
+                        std::memcpy(output.data() + static_cast<size_t>(y) * width + column.begin, src,
+                                    pixelBytes * (column.end - column.begin));
+                    }
+                }
+            }
+            color.swap(output);
+        }
+
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[Denoiser] Denoised " << width << "x" << height << " image"
+                  << (useNormal ? " with albedo and normal" : useAlbedo ? " with albedo" : "")
+                  << " (" << tileCount << (tileCount == 1 ? " tile" : " tiles") << ", " << ms << " ms)\n";
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "[Denoiser] Exception: " << e.what() << "\n";
+        return false;
+    }
+#else
+    (void)normal;
+    (void)albedo;
+    std::cout << "[Denoiser] Intel Open Image Denoise not available in this build\n";
+    return false;
+#endif
+}
@@ -0,0 +1,163 @@
+#include "emissive_lights.h"
+#include "triangle.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr float PI = 3.14159265358979323846f;
+
+    float luminance(const glm::vec3& c)
+    {
+        return 0.2126f * c.r + 0.7152f * c.g + 0.0722f * c.b;
+    }
+
+    bool emits(const glm::vec3& radiance)
+    {
+        return luminance(radiance) > 0.0f;
+    }
+}
+
+namespace raytracer {
+
+    void EmissiveLights::clear()
+    {
+        m_emitters.clear();
+        m_slot.clear();
+        m_power.build({});
+        m_dirty = false;
+    }
+
+    size_t EmissiveLights::emitterCount() const
+    {
+        return m_emitters.size();
+    }
+
+    size_t EmissiveLights::triangleCount() const
+    {
+        size_t count = 0;
+        for (const auto& emitter : m_emitters)
+            count += emitter.vertices.size() / 3;
+        return count;
+    }
+
+    glm::vec3 EmissiveLights::radiance(uint32_t instance) const
+    {
+        if (instance >= m_slot.size() || m_slot[instance] < 0) return glm::vec3(0.0f);
+        return m_emitters[m_slot[instance]].radiance;
+    }
+
+    void EmissiveLights::buildTriangles(Emitter& emitter, const TriangleMesh& mesh, const glm::mat4& objectToWorld)
+    {
+        const size_t count = mesh.triangleCount();
+        emitter.vertices.resize(3 * count);
+        std::vector<float> areas(count);
+        emitter.area = 0.0f;
+        for (uint32_t t = 0; t < count; ++t) {
+            glm::vec3* v = &emitter.vertices[3 * t];
+            v[0] = glm::vec3(objectToWorld * glm::vec4(mesh.vertex0(t), 1.0f));
+            v[1] = glm::vec3(objectToWorld * glm::vec4(mesh.vertex1(t), 1.0f));
+            v[2] = glm::vec3(objectToWorld * glm::vec4(mesh.vertex2(t), 1.0f));
+            areas[t] = 0.5f * glm::length(glm::cross(v[1] - v[0], v[2] - v[0]));
+            emitter.area += areas[t];
+        }
+        emitter.triangles.build(areas);
+    }
+
+    void EmissiveLights::setInstance(uint32_t instance, const TriangleMesh& mesh, const glm::mat4& objectToWorld,
+                                     const glm::vec3& radiance)
+    {
+        if (instance >= m_slot.size())
+            m_slot.resize(instance + 1, -1);
+
+        int32_t slot = m_slot[instance];
+        if (!emits(radiance)) {
+            if (slot < 0) return;
+            // Swap-remove so the emitter list stays dense
+            if (static_cast<size_t>(slot) + 1 != m_emitters.size()) {
+                m_emitters[slot] = std::move(m_emitters.back());
+                m_slot[m_emitters[slot].instance] = slot;
+            }
+            m_emitters.pop_back();
+            m_slot[instance] = -1;
+            m_dirty = true;
+            return;
+        }
+
+        if (slot < 0) {
+            slot = static_cast<int32_t>(m_emitters.size());
+            m_emitters.emplace_back();
+            m_slot[instance] = slot;
+        }
+        Emitter& emitter = m_emitters[slot];
+        emitter.instance = instance;
+        emitter.radiance = radiance;
+        buildTriangles(emitter, mesh, objectToWorld);
+        m_dirty = true;
+    }
+
+    void EmissiveLights::setRadiance(uint32_t instance, const TriangleMesh& mesh, const glm::mat4& objectToWorld,
+                                     const glm::vec3& radiance)
+    {
+        if (instance < m_slot.size() && m_slot[instance] >= 0 && emits(radiance)) {
+            m_emitters[m_slot[instance]].radiance = radiance;
+            m_dirty = true;
+            return;
+        }
+        setInstance(instance, mesh, objectToWorld, radiance);
+    }
+
+    void EmissiveLights::refresh()
+    {
+        if (!m_dirty) return;
+        // Two-sided Lambertian emitters radiate 2·pi·L·A
+        std::vector<float> power(m_emitters.size());
+        for (size_t i = 0; i < m_emitters.size(); ++i)
+            power[i] = 2.0f * PI * luminance(m_emitters[i].radiance) * m_emitters[i].area;
+        m_power.build(power);
+        m_dirty = false;
+    }
+
+    bool EmissiveLights::sample(const glm::vec3& p, const float u[4], EmissiveSample& sample) const
+    {
+        if (m_power.empty()) return false;
+
+        float emitterPmf;
+        const Emitter& emitter = m_emitters[m_power.sample(u[0], emitterPmf)];
+        if (emitter.triangles.empty()) return false;
+
+        // Triangle by area, then a uniform point on it: together a uniform
+        // density of 1 / area over the whole emitter
+        float trianglePmf;
+        const glm::vec3* v = &emitter.vertices[3 * emitter.triangles.sample(u[1], trianglePmf)];
+        const float su = std::sqrt(u[2]);
+        const float b1 = 1.0f - su, b2 = u[3] * su;
+        sample.point = v[0] + b1 * (v[1] - v[0]) + b2 * (v[2] - v[0]);
+
+        const glm::vec3 toLight = sample.point - p;
+        const float d2 = glm::dot(toLight, toLight);
+        const glm::vec3 cross = glm::cross(v[1] - v[0], v[2] - v[0]);
+        const float crossLength = glm::length(cross);
+        if (!(d2 > 1e-12f) || !(crossLength > 0.0f)) return false;
+
+        sample.distance = std::sqrt(d2);
+        sample.direction = toLight / sample.distance;
+        const float cosLight = std::abs(glm::dot(cross / crossLength, sample.direction));
+        if (!(cosLight > 1e-6f)) return false;
+
+        sample.radiance = emitter.radiance;
+        sample.pdf = emitterPmf / emitter.area * d2 / cosLight;
+        return true;
+    }
+
+    float EmissiveLights::pdf(uint32_t instance, const glm::vec3& p, const glm::vec3& point, const glm::vec3& normal) const
+    {
+        if (instance >= m_slot.size() || m_slot[instance] < 0 || m_power.empty()) return 0.0f;
+        const Emitter& emitter = m_emitters[m_slot[instance]];
+        const glm::vec3 toLight = point - p;
+        const float d2 = glm::dot(toLight, toLight);
+        const float cosLight = std::abs(glm::dot(normal, toLight)) / std::sqrt(d2);
+        if (!(cosLight > 1e-6f) || !(emitter.area > 0.0f)) return 0.0f;
+        return m_power.pmf(static_cast<uint32_t>(m_slot[instance])) / emitter.area * d2 / cosLight;
+    }
+}
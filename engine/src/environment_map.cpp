@@ -0,0 +1,217 @@
+#include "environment_map.h"
+#include "image_io.h"
+#include "path_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    constexpr float PI = 3.14159265358979323846f;
+
+    // The sampling distribution is built from the first MIP level at most
+    // this wide: light sampling only needs to find the bright regions, and
+    // radiance is still looked up at full resolution
+    constexpr int kMaxSamplingWidth = 1024;
+
+    float luminance(const glm::vec3& c)
+    {
+        return 0.2126f * c.r + 0.7152f * c.g + 0.0722f * c.b;
+    }
+
+    // Equirectangular coordinates of a unit direction, both in [0, 1]
+    glm::vec2 directionToUV(const glm::vec3& dir)
+    {
+        const float u = std::atan2(dir.z, dir.x) * (0.5f / PI) + 0.5f;
+        const float v = std::asin(std::clamp(dir.y, -1.0f, 1.0f)) * (1.0f / PI) + 0.5f;
+        return glm::vec2(u, v);
+    }
+}
+
+std::shared_ptr<const EnvironmentMap> EnvironmentMap::load(const std::string& hdrPath)
+{
+    static std::mutex cacheMutex;
+    static std::unordered_map<std::string, std::weak_ptr<const EnvironmentMap>> cache;
+
+    const std::string resolvedPath = PathUtils::resolveAssetPath(hdrPath);
+    if (resolvedPath.empty())
+    {
+        std::cerr << "Failed to resolve HDR/EXR path: " << hdrPath << std::endl;
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (auto cached = cache[resolvedPath].lock())
+        return cached;
+
+    const auto start = std::chrono::steady_clock::now();
+    ImageIO::ImageDataFloat img;
+    if (!ImageIO::LoadImageFloat(resolvedPath, img, /*flipY=*/true) || img.width <= 0 || img.height <= 0)
+    {
+        std::cerr << "Failed to load HDR/EXR image: " << resolvedPath << " (original: " << hdrPath << ")" << std::endl;
+        return nullptr;
+    }
+
+    auto environment = std::make_shared<const EnvironmentMap>(img.width, img.height, img.channels, img.pixels.data());
+    cache[resolvedPath] = environment;
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[EnvironmentMap] Loaded " << resolvedPath << " (" << img.width << "x" << img.height << ", "
+              << environment->levelCount() << " MIP levels, " << ms << " ms)\n";
+    return environment;
+}
+
+EnvironmentMap::EnvironmentMap(int width, int height, int channels, const float* pixels)
+{
+    Level base;
+    base.width = width;
+    base.height = height;
+    base.texels.resize(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < base.texels.size(); ++i)
+    {
+        const float* p = pixels + i * channels;
+        base.texels[i] = channels >= 3 ? glm::vec3(p[0], p[1], p[2]) : glm::vec3(p[0]);
+    }
+    m_levels.push_back(std::move(base));
+
+    // Box-filtered pyramid down to a single texel; odd edges repeat
+    while (m_levels.back().width > 1 || m_levels.back().height > 1)
+    {
+        const Level& src = m_levels.back();
+        Level dst;
+        dst.width = std::max(1, src.width / 2);
+        dst.height = std::max(1, src.height / 2);
+        dst.texels.resize(static_cast<size_t>(dst.width) * dst.height);
+        for (int y = 0; y < dst.height; ++y)
+        {
+            const int y0 = std::min(2 * y, src.height - 1), y1 = std::min(2 * y + 1, src.height - 1);
+            for (int x = 0; x < dst.width; ++x)
+            {
+                const int x0 = std::min(2 * x, src.width - 1), x1 = std::min(2 * x + 1, src.width - 1);
+                dst.texels[static_cast<size_t>(y) * dst.width + x] =
+                    0.25f * (texel(src, x0, y0) + texel(src, x1, y0) + texel(src, x0, y1) + texel(src, x1, y1));
+            }
+        }
+        m_levels.push_back(std::move(dst));
+    }
+
+    // Luminance times cos(latitude): each texel's share of the sphere
+    while (m_samplingLevel + 1 < levelCount() && m_levels[m_samplingLevel].width > kMaxSamplingWidth)
+        ++m_samplingLevel;
+    const Level& level = m_levels[m_samplingLevel];
+    std::vector<float> values(level.width);
+    std::vector<float> rowIntegrals(level.height);
+    m_conditional.resize(level.height);
+    for (int y = 0; y < level.height; ++y)
+    {
+        const float cosLatitude = std::cos(((y + 0.5f) / level.height - 0.5f) * PI);
+        for (int x = 0; x < level.width; ++x)
+            values[x] = std::max(0.0f, luminance(texel(level, x, y))) * cosLatitude;
+        m_conditional[y].build(values.data(), level.width);
+        rowIntegrals[y] = m_conditional[y].integral;
+    }
+    m_marginal.build(rowIntegrals.data(), level.height);
+}
+
+void EnvironmentMap::Distribution::build(const float* values, int count)
+{
+    func.assign(values, values + count);
+    cdf.resize(count + 1);
+    cdf[0] = 0.0f;
+    for (int i = 0; i < count; ++i)
+        cdf[i + 1] = cdf[i] + func[i] / count;
+    integral = cdf[count];
+
+    // A black row is never picked; keep its CDF well formed anyway
+    for (int i = 1; i <= count; ++i)
+        cdf[i] = integral > 0.0f ? cdf[i] / integral : float(i) / count;
+}
+
+float EnvironmentMap::Distribution::sample(float u, int& bin) const
+{
+    const int count = static_cast<int>(func.size());
+    bin = static_cast<int>(std::upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin()) - 1;
+    bin = std::clamp(bin, 0, count - 1);
+    const float width = cdf[bin + 1] - cdf[bin];
+    const float offset = width > 0.0f ? (u - cdf[bin]) / width : 0.0f;
+    return std::min((bin + std::clamp(offset, 0.0f, 1.0f)) / count, 0.99999994f);
+}
+
+glm::vec3 EnvironmentMap::texel(const Level& level, int x, int y) const
+{
+    return level.texels[static_cast<size_t>(y) * level.width + x];
+}
+
+glm::vec3 EnvironmentMap::bilinear(const Level& level, float u, float v) const
+{
+    const float x = u * level.width - 0.5f, y = v * level.height - 0.5f;
+    const float fx = std::floor(x), fy = std::floor(y);
+    const float tx = x - fx, ty = y - fy;
+
+    // Longitude wraps around, latitude clamps at the poles
+    auto wrap = [&](int i) { return ((i % level.width) + level.width) % level.width; };
+    const int x0 = wrap(static_cast<int>(fx)), x1 = wrap(static_cast<int>(fx) + 1);
+    const int y0 = std::clamp(static_cast<int>(fy), 0, level.height - 1);
+    const int y1 = std::clamp(static_cast<int>(fy) + 1, 0, level.height - 1);
+
+    const glm::vec3 bottom = glm::mix(texel(level, x0, y0), texel(level, x1, y0), tx);
+    const glm::vec3 top = glm::mix(texel(level, x0, y1), texel(level, x1, y1), tx);
+    return glm::mix(bottom, top, ty);
+}
+
+glm::vec3 EnvironmentMap::eval(const glm::vec3& dir, float lod) const
+{
+    const glm::vec2 uv = directionToUV(dir);
+    lod = std::clamp(lod, 0.0f, float(levelCount() - 1));
+    const int level = static_cast<int>(lod);
+    const float t = lod - float(level);
+    const glm::vec3 fine = bilinear(m_levels[level], uv.x, uv.y);
+    if (t <= 0.0f || level + 1 >= levelCount())
+        return fine;
+    return glm::mix(fine, bilinear(m_levels[level + 1], uv.x, uv.y), t);
+}
+
+float EnvironmentMap::lodForSolidAngle(float solidAngle) const
+{
+    // Average texel of level 0 covers 4pi / (width * height); every level
+    // up quadruples that
+    const float texelSolidAngle = 4.0f * PI / (float(width()) * float(height()));
+    if (!(solidAngle > texelSolidAngle)) return 0.0f;
+    return std::min(0.5f * std::log2(solidAngle / texelSolidAngle), float(levelCount() - 1));
+}
+
+bool EnvironmentMap::sample(float u1, float u2, glm::vec3& dir, float& pdf) const
+{
+    if (!(m_marginal.integral > 0.0f)) return false;
+
+    int row, column;
+    const float v = m_marginal.sample(u2, row);
+    const float u = m_conditional[row].sample(u1, column);
+
+    const float latitude = (v - 0.5f) * PI;
+    const float phi = (u - 0.5f) * 2.0f * PI;
+    const float cosLatitude = std::cos(latitude);
+    if (!(cosLatitude > 0.0f)) return false;
+
+    dir = glm::vec3(cosLatitude * std::cos(phi), std::sin(latitude), cosLatitude * std::sin(phi));
+    // Density over (u, v), then the Jacobian of the equirect mapping
+    pdf = m_conditional[row].func[column] / m_marginal.integral / (2.0f * PI * PI * cosLatitude);
+    return pdf > 0.0f;
+}
+
+float EnvironmentMap::pdf(const glm::vec3& dir) const
+{
+    if (!(m_marginal.integral > 0.0f)) return 0.0f;
+
+    const float cosLatitude = std::sqrt(dir.x * dir.x + dir.z * dir.z);
+    if (!(cosLatitude > 0.0f)) return 0.0f;
+
+    const Level& level = m_levels[m_samplingLevel];
+    const glm::vec2 uv = directionToUV(dir);
+    const int column = std::clamp(static_cast<int>(uv.x * level.width), 0, level.width - 1);
+    const int row = std::clamp(static_cast<int>(uv.y * level.height), 0, level.height - 1);
+    return m_conditional[row].func[column] / m_marginal.integral / (2.0f * PI * PI * cosLatitude);
+}
@@ -3,8 +3,7 @@
 // Human Summary: Handles loading HDR environments and generating the derived cubemaps plus LUTs, managing GPU state via the RHI.
 
 #include "ibl_system.h"
-#include "image_io.h"
-#include "path_utils.h"
+#include "environment_map.h"
 #include <iostream>
 #include <cmath>
 #include <glint3d/texture_slots.h>
@@ -392,28 +391,22 @@ glint3d::TextureHandle IBLSystem::loadHDRTexture(const std::string& path)
 {
     using namespace glint3d;
 
-    // Resolve path to handle different working directories
-    std::string resolvedPath = PathUtils::resolveAssetPath(path);
-    if (resolvedPath.empty()) {
-        std::cerr << "Failed to resolve HDR/EXR path: " << path << std::endl;
-        return INVALID_HANDLE;
-    }
-
-    ImageIO::ImageDataFloat img;
-    if (!ImageIO::LoadImageFloat(resolvedPath, img, /*flipY=*/true)) {
-        std::cerr << "Failed to load HDR/EXR image: " << resolvedPath << " (original: " << path << ")" << std::endl;
+    // Shared with the CPU raytracer, so the file is decoded once per path
+    std::shared_ptr<const EnvironmentMap> environment = EnvironmentMap::load(path);
+    if (!environment) {
         return INVALID_HANDLE;
     }
+    const std::vector<glm::vec3>& texels = environment->texels();
 
     // Create texture descriptor
     TextureDesc desc{};
     desc.type = TextureType::Texture2D;
-    desc.width = img.width;
-    desc.height = img.height;
-    desc.format = (img.channels == 3) ? TextureFormat::RGB16F : TextureFormat::RGBA16F;
+    desc.width = environment->width();
+    desc.height = environment->height();
+    desc.format = TextureFormat::RGB16F;
     desc.generateMips = false;
-    desc.initialData = img.pixels.data();
-    desc.initialDataSize = img.pixels.size() * sizeof(float);
+    desc.initialData = texels.data();
+    desc.initialDataSize = texels.size() * sizeof(glm::vec3);
 
     TextureHandle hdrTexture = m_rhi->createTexture(desc);
     return hdrTexture;
@@ -2,6 +2,9 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
 #include <string>
 
 // stb_image for LDR and Radiance .hdr
@@ -77,7 +80,7 @@ bool LoadImageFloat(const std::string& path, ImageDataFloat& out, bool flipY) {
 
     // .hdr via stb_image (float32 RGB(A))
     if (HasExtension(path, ".hdr")) {
-        stbi_set_flip_vertically_on_load(flipY ? 1 : 0);
+        stbi_set_flip_vertically_on_load_thread(flipY ? 1 : 0);
         int w = 0, h = 0, n = 0;
         float* data = stbi_loadf(path.c_str(), &w, &h, &n, 0);
         if (!data) return false;
@@ -91,7 +94,7 @@ bool LoadImageFloat(const std::string& path, ImageDataFloat& out, bool flipY) {
     }
 
     // Fallback: attempt float load via stb (for other formats, rarely used)
-    stbi_set_flip_vertically_on_load(flipY ? 1 : 0);
+    stbi_set_flip_vertically_on_load_thread(flipY ? 1 : 0);
     int w = 0, h = 0, n = 0;
     float* data = stbi_loadf(path.c_str(), &w, &h, &n, 0);
     if (!data) return false;
@@ -105,7 +108,7 @@ bool LoadImageFloat(const std::string& path, ImageDataFloat& out, bool flipY) {
 
 bool LoadImage8(const std::string& path, ImageData8& out, bool flipY, int desiredChannels) {
     out = {};
-    stbi_set_flip_vertically_on_load(flipY ? 1 : 0);
+    stbi_set_flip_vertically_on_load_thread(flipY ? 1 : 0);
     int w = 0, h = 0, n = 0;
     unsigned char* data = stbi_load(path.c_str(), &w, &h, &n, desiredChannels);
     if (!data) return false;
@@ -117,4 +120,80 @@ bool LoadImage8(const std::string& path, ImageData8& out, bool flipY, int desire
     return true;
 }
 
+bool SaveImageEXR(const std::string& path, int width, int height,
+                  std::vector<ExrChannel> channels, bool flipY) {
+#ifndef EXR_ENABLED
+    (void)path; (void)width; (void)height; (void)channels; (void)flipY;
+    std::cerr << "[ImageIO] EXR support is disabled in this build\n";
+    return false;
+#else
+    if (width <= 0 || height <= 0 || channels.empty()) return false;
+    for (const ExrChannel& c : channels) {
+        if (!c.data || c.stride <= 0 || c.name.empty() || c.name.size() > 255) {
+            std::cerr << "[ImageIO] Invalid EXR channel '" << c.name << "'\n";
+            return false;
+        }
+    }
+    std::sort(channels.begin(), channels.end(),
+              [](const ExrChannel& a, const ExrChannel& b) { return a.name < b.name; });
+
+    // TinyEXR takes one plane per channel; gathering it is where rows get
+    // flipped. Float and uint32 are both 4 bytes, so the gather is a copy.
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    std::vector<std::vector<uint32_t>> planes(channels.size());
+    std::vector<unsigned char*> planePointers(channels.size());
+    std::vector<EXRChannelInfo> infos(channels.size());
+    std::vector<int> inputTypes(channels.size());
+    std::vector<int> storedTypes(channels.size());
+    for (size_t c = 0; c < channels.size(); ++c) {
+        const ExrChannel& channel = channels[c];
+        const uint32_t* src = static_cast<const uint32_t*>(channel.data);
+        std::vector<uint32_t>& plane = planes[c];
+        plane.resize(pixelCount);
+        for (int y = 0; y < height; ++y) {
+            const size_t srcRow = static_cast<size_t>(flipY ? height - 1 - y : y) * width;
+            uint32_t* dst = plane.data() + static_cast<size_t>(y) * width;
+            if (channel.stride == 1) {
+                std::memcpy(dst, src + srcRow, sizeof(uint32_t) * width);
+            } else {
+                for (int x = 0; x < width; ++x)
+                    dst[x] = src[(srcRow + x) * channel.stride];
+            }
+        }
+        planePointers[c] = reinterpret_cast<unsigned char*>(plane.data());
+
+        std::memset(&infos[c], 0, sizeof(EXRChannelInfo));
+        std::strncpy(infos[c].name, channel.name.c_str(), sizeof(infos[c].name) - 1);
+        const bool isUint = channel.type == ExrPixelType::Uint;
+        inputTypes[c] = isUint ? TINYEXR_PIXELTYPE_UINT : TINYEXR_PIXELTYPE_FLOAT;
+        storedTypes[c] = isUint ? TINYEXR_PIXELTYPE_UINT
+                       : channel.type == ExrPixelType::Half ? TINYEXR_PIXELTYPE_HALF : TINYEXR_PIXELTYPE_FLOAT;
+    }
+
+    EXRImage image;
+    InitEXRImage(&image);
+    image.images = planePointers.data();
+    image.width = width;
+    image.height = height;
+    image.num_channels = static_cast<int>(channels.size());
+
+    EXRHeader header;
+    InitEXRHeader(&header);
+    header.num_channels = image.num_channels;
+    header.channels = infos.data();
+    header.pixel_types = inputTypes.data();
+    header.requested_pixel_types = storedTypes.data();
+    header.compression_type = TINYEXR_COMPRESSIONTYPE_ZIP;
+
+    const char* err = nullptr;
+    const int ret = SaveEXRImageToFile(&image, &header, path.c_str(), &err);
+    if (ret != TINYEXR_SUCCESS) {
+        std::cerr << "[ImageIO] Failed to write EXR " << path << ": " << (err ? err : "unknown error") << "\n";
+        if (err) FreeEXRErrorMessage(err);
+        return false;
+    }
+    return true;
+#endif
+}
+
 } // namespace ImageIO
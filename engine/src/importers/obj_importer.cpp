@@ -1,5 +1,6 @@
 #include "importer.h"
 #include "objloader.h"
+#include "obj_reader.h"
 #include <algorithm>
 #include <cctype>
 
@@ -22,7 +23,13 @@ public:
     bool Load(const std::string& path, MeshData& out, PBRMaterial* pbrOut, std::string* error, const ImporterOptions& opts) override {
         (void)opts;
         out = MeshData{};
-        ObjLoader l; l.load(path.c_str());
+        ObjReader::Mesh mesh;
+        std::string parseError;
+        if (!ObjReader::parseFile(path, mesh, &parseError)) {
+            if (error) *error = "OBJ import failed: " + parseError;
+            return false;
+        }
+        ObjLoader l; l.setFromParsed(std::move(mesh));
         int vc = l.getVertCount();
         int ic = l.getIndexCount();
         const float* pos = l.getPositions();
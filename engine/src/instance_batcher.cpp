@@ -0,0 +1,143 @@
+#include "instance_batcher.h"
+#include "managers/scene_manager.h"
+#include "managers/material_manager.h"
+#include "managers/pipeline_manager.h"
+
+#include <algorithm>
+#include <map>
+
+using namespace glint3d;
+
+InstanceBatcher::~InstanceBatcher()
+{
+    shutdown();
+}
+
+void InstanceBatcher::init(RHI* rhi, PipelineManager* pipelines)
+{
+    shutdown();
+    m_rhi = rhi;
+    m_pipelines = pipelines;
+}
+
+void InstanceBatcher::shutdown()
+{
+    if (m_rhi) {
+        releasePipelines();
+        if (m_transforms != INVALID_HANDLE) m_rhi->destroyBuffer(m_transforms);
+    }
+    m_meshPipelines.clear();
+    m_transforms = INVALID_HANDLE;
+    m_capacity = m_cursor = m_frameUsed = 0;
+    m_rhi = nullptr;
+    m_pipelines = nullptr;
+}
+
+std::vector<InstanceBatcher::Batch> InstanceBatcher::group(const std::vector<SceneObject*>& objects)
+{
+    std::vector<Batch> batches;
+    std::map<std::pair<const MeshBuffers*, int>, std::vector<size_t>> batchesByMesh;
+    for (SceneObject* obj : objects) {
+        bool batched = false;
+        if (obj->meshBuffers) {
+            auto& candidates = batchesByMesh[{ obj->meshBuffers.get(), obj->lodLevel }];
+            for (size_t b : candidates) {
+                if (MaterialManager::sameMaterial(*batches[b].front(), *obj)) {
+                    batches[b].push_back(obj);
+                    batched = true;
+                    break;
+                }
+            }
+            if (!batched) candidates.push_back(batches.size());
+        }
+        if (!batched) batches.push_back({ obj });
+    }
+    return batches;
+}
+
+void InstanceBatcher::beginFrame()
+{
+    if (m_frameUsed * kFramesInFlight > m_capacity) resize(m_frameUsed * kFramesInFlight);
+    m_frameUsed = 0;
+}
+
+bool InstanceBatcher::draw(const Batch& batch, const std::function<void(const SceneObject&, DrawDesc&)>& prepare)
+{
+    if (!m_rhi || !m_pipelines || batch.empty() || !batch.front()->meshBuffers) return false;
+    const SceneObject& first = *batch.front();
+    const size_t count = batch.size();
+
+    // A batch that does not fit the ring at all grows it now; otherwise it
+    // takes the next region, wrapping to the start
+    if (count > m_capacity) resize(std::max(count * kFramesInFlight, 2 * m_capacity));
+    if (m_transforms == INVALID_HANDLE) return false;
+    if (m_cursor + count > m_capacity) m_cursor = 0;
+
+    MeshPipeline& mp = m_meshPipelines[first.meshBuffers.get()];
+    if (mp.mesh.lock() != first.meshBuffers) {
+        // New mesh, or a freed one whose address was reused
+        m_rhi->destroyPipeline(mp.pipeline);
+        mp = MeshPipeline{};
+        mp.mesh = first.meshBuffers;
+    }
+    if (mp.pipeline == INVALID_HANDLE) {
+        mp.pipeline = m_pipelines->createInstancedPipeline(first, m_transforms);
+        if (mp.pipeline == INVALID_HANDLE) return false;
+    }
+
+    m_scratch.clear();
+    for (const SceneObject* obj : batch) m_scratch.push_back(obj->modelMatrix * obj->rhiDequantize);
+    m_rhi->updateBuffer(m_transforms, m_scratch.data(), count * sizeof(glm::mat4), m_cursor * sizeof(glm::mat4));
+
+    m_rhi->bindPipeline(mp.pipeline);
+    DrawDesc drawDesc{};
+    prepare(first, drawDesc);
+    drawDesc.pipeline = mp.pipeline;
+    drawDesc.instanceCount = static_cast<uint32_t>(count);
+    drawDesc.firstInstance = static_cast<uint32_t>(m_cursor);
+    m_rhi->setUniformBool("useInstancing", true);
+    m_rhi->draw(drawDesc);
+    m_rhi->setUniformBool("useInstancing", false);
+
+    m_cursor += count;
+    m_frameUsed += count;
+    return true;
+}
+
+void InstanceBatcher::endFrame()
+{
+    for (auto it = m_meshPipelines.begin(); it != m_meshPipelines.end();) {
+        if (it->second.mesh.expired()) {
+            if (m_rhi) m_rhi->destroyPipeline(it->second.pipeline);
+            it = m_meshPipelines.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void InstanceBatcher::resize(size_t capacity)
+{
+    if (!m_rhi) return;
+    // Pipelines reference the transform buffer, so they go with it
+    releasePipelines();
+    if (m_transforms != INVALID_HANDLE) m_rhi->destroyBuffer(m_transforms);
+
+    m_capacity = std::max(capacity, kMinCapacity);
+    BufferDesc bd{};
+    bd.type = BufferType::Vertex;
+    bd.usage = BufferUsage::Dynamic;
+    bd.size = m_capacity * sizeof(glm::mat4);
+    bd.debugName = "instance_transforms";
+    m_transforms = m_rhi->createBuffer(bd);
+    if (m_transforms == INVALID_HANDLE) m_capacity = 0;
+    m_cursor = 0;
+}
+
+void InstanceBatcher::releasePipelines()
+{
+    for (auto& entry : m_meshPipelines) {
+        if (entry.second.pipeline != INVALID_HANDLE) m_rhi->destroyPipeline(entry.second.pipeline);
+        entry.second.pipeline = INVALID_HANDLE;
+    }
+}
@@ -0,0 +1,63 @@
+#include "job_system.h"
+#include <algorithm>
+
+// Single-threaded web builds have no std::thread support; jobs run deferred
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define GLINT_JOBS_NO_THREADS 1
+#endif
+
+JobSystem::JobSystem(unsigned threadCount)
+{
+#ifdef GLINT_JOBS_NO_THREADS
+    threadCount = 0;
+#else
+    // Jobs are mostly I/O and single-threaded decode; large parses fan out
+    // on ThreadPool themselves, so a handful of workers keeps the disk busy
+    if (threadCount == 0) threadCount = std::clamp(std::thread::hardware_concurrency() / 2, 2u, 4u);
+#endif
+    for (unsigned i = 0; i < threadCount; ++i)
+        m_threads.emplace_back(&JobSystem::workerMain, this);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_threads)
+        t.join();
+}
+
+JobSystem& JobSystem::shared()
+{
+    static JobSystem jobs;
+    return jobs;
+}
+
+void JobSystem::enqueue(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_wake.notify_one();
+}
+
+void JobSystem::workerMain()
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || !m_jobs.empty(); });
+            // Queued jobs are finished before shutdown so no future is left broken
+            if (m_jobs.empty()) return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
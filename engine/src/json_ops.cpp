@@ -8,6 +8,7 @@
 #include "skybox.h"
 #include "schema_validator.h"
 #include "path_security.h"
+#include "render_utils.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -19,7 +20,12 @@
 #include <rapidjson/prettywriter.h>
 #include <algorithm>
 #include <cctype>
+#include <iterator>
 #include <limits>
+#include <chrono>
+#include <future>
+#include <utility>
+#include <vector>
 
 namespace {
     static bool getVec3(const rapidjson::Value& v, glm::vec3& out) {
@@ -29,6 +35,15 @@ namespace {
         return true;
     }
 
+    // Ops that never read scene objects, so pending loads need not finish first
+    static bool runsBeforeLoadsFinish(const std::string& op) {
+        static const char* const kOps[] = {
+            "load", "set_camera", "add_light", "set_background", "load_hdr_environment",
+            "set_skybox_intensity", "set_ibl_intensity", "exposure", "tone_map", "set_lod_threshold"
+        };
+        return std::any_of(std::begin(kOps), std::end(kOps), [&](const char* o) { return op == o; });
+    }
+
     static std::string deriveNameFromPath(const std::string& path) {
         std::string name = path;
         auto slash = name.find_last_of("/\\"); if (slash != std::string::npos) name = name.substr(slash+1);
@@ -195,6 +210,19 @@ bool JsonOpsExecutor::apply(const std::string& json, std::string& error)
         }
     }
 
+    // load ops only queue their work (SceneManager::loadObjectAsync), so
+    // consecutive loads overlap; they are joined before the first op that may
+    // read scene objects and before apply returns
+    std::vector<std::pair<std::string, std::shared_future<bool>>> pendingLoads;
+    auto joinLoads = [&]()->bool {
+        m_scene.finishLoads();
+        for (auto& load : pendingLoads) {
+            if (!load.second.get()) { error = std::string("load failed for '") + load.first + "'"; pendingLoads.clear(); return false; }
+        }
+        pendingLoads.clear();
+        return true;
+    };
+
     // Inner lambda that applies a single op object
     auto applyOp = [&](const Value& obj, int index)->bool {
         if (!obj.IsObject()) { error = "op at index " + std::to_string(index) + " is not an object"; return false; }
@@ -228,8 +256,12 @@ bool JsonOpsExecutor::apply(const std::string& json, std::string& error)
                     if (!getVec3(t["scale"], scale)) { error = "load: bad transform.scale"; return false; }
                 }
             }
-            bool okLoad = m_scene.loadObject(name, path, pos, scale);
-            if (!okLoad) { error = std::string("load failed for '") + name + "'"; return false; }
+            std::shared_future<bool> loaded = m_scene.loadObjectAsync(name, path, pos, scale);
+            // A taken name is known at once
+            if (loaded.wait_for(std::chrono::seconds(0)) == std::future_status::ready && !loaded.get()) {
+                error = std::string("load failed for '") + name + "'"; return false;
+            }
+            pendingLoads.emplace_back(name, std::move(loaded));
             return true;
         }
         else if (op == "set_camera") {
@@ -409,7 +441,7 @@ bool JsonOpsExecutor::apply(const std::string& json, std::string& error)
                 glm::vec3 baseRGB = glm::vec3(mutableObj->materialCore.baseColor);
                 mutableObj->materialCore.baseColor = glm::vec4(baseRGB * (1.0f + glm::length(ambient) * 0.1f), mutableObj->materialCore.baseColor.a);
             }
-
+            m_scene.markMaterialDirty(target);
 
             return true;
         }
@@ -480,7 +512,15 @@ bool JsonOpsExecutor::apply(const std::string& json, std::string& error)
             if (obj.HasMember("width") && obj["width"].IsInt()) width = obj["width"].GetInt();
             if (obj.HasMember("height") && obj["height"].IsInt()) height = obj["height"].GetInt();
             
-            bool ok = m_renderer.renderToPNG(m_scene, m_lights, path, width, height);
+            // .exr writes linear color plus albedo, normal, depth and object ID layers
+            bool ok;
+            if (RenderUtils::isExrPath(path)) {
+                bool halfFloat = true;
+                if (obj.HasMember("half") && obj["half"].IsBool()) halfFloat = obj["half"].GetBool();
+                ok = m_renderer.renderToEXR(m_scene, m_lights, path, width, height, halfFloat);
+            } else {
+                ok = m_renderer.renderToPNG(m_scene, m_lights, path, width, height);
+            }
             if (!ok) { error = std::string("render_image: failed to render to '") + path + "'"; return false; }
             return true;
         }
@@ -737,6 +777,13 @@ bool JsonOpsExecutor::apply(const std::string& json, std::string& error)
             m_renderer.setExposure(exposureValue);
             return true;
         }
+        else if (op == "set_lod_threshold") {
+            if (!obj.HasMember("value") || !obj["value"].IsNumber()) { error = "set_lod_threshold: missing 'value'"; return false; }
+            float pixels = (float)obj["value"].GetDouble();
+            if (pixels < 0.0f) { error = "set_lod_threshold: 'value' must be >= 0"; return false; }
+            m_renderer.setLodErrorPixels(pixels);
+            return true;
+        }
         else if (op == "tone_map") {
             if (!obj.HasMember("type") || !obj["type"].IsString()) { error = "tone_map: missing 'type'"; return false; }
             std::string toneMapType = obj["type"].GetString();
@@ -766,21 +813,29 @@ bool JsonOpsExecutor::apply(const std::string& json, std::string& error)
         return false;
     };
 
+    auto runOp = [&](const Value& obj, int index)->bool {
+        const bool independent = obj.IsObject() && obj.HasMember("op") && obj["op"].IsString() &&
+                                 runsBeforeLoadsFinish(obj["op"].GetString());
+        if (!independent && !pendingLoads.empty() && !joinLoads()) return false;
+        if (!applyOp(obj, index)) { m_scene.finishLoads(); return false; }
+        return true;
+    };
+
     // Accept: array of ops; single op object; or envelope { "ops": [...] }
     if (d.IsArray()) {
         for (rapidjson::SizeType i = 0; i < d.Size(); ++i) {
-            if (!applyOp(d[i], (int)i)) return false;
+            if (!runOp(d[i], (int)i)) return false;
         }
-        return true;
+        return joinLoads();
     } else if (d.IsObject()) {
         if (d.HasMember("ops") && d["ops"].IsArray()) {
             const auto& arr = d["ops"];
             for (rapidjson::SizeType i = 0; i < arr.Size(); ++i) {
-                if (!applyOp(arr[i], (int)i)) return false;
+                if (!runOp(arr[i], (int)i)) return false;
             }
-            return true;
+            return joinLoads();
         } else {
-            return applyOp(d, 0);
+            return runOp(d, 0) && joinLoads();
         }
     }
 
@@ -0,0 +1,267 @@
+#include "light_sampler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace
+{
+    constexpr float PI = 3.14159265358979323846f;
+    constexpr float kOneMinusEpsilon = 0.99999994f;
+
+    // Cone tests allow this much angular slack (radians) so lights right at
+    // the edge of a spot cone are never culled by rounding
+    constexpr float kConeSlack = 1e-3f;
+
+    float luminance(const glm::vec3& c)
+    {
+        return 0.2126f * c.r + 0.7152f * c.g + 0.0722f * c.b;
+    }
+
+    float safeAcos(float x)
+    {
+        return std::acos(std::clamp(x, -1.0f, 1.0f));
+    }
+
+    // Rotate v by angle around the unit axis k (Rodrigues)
+    glm::vec3 rotate(const glm::vec3& v, float angle, const glm::vec3& k)
+    {
+        const float c = std::cos(angle), s = std::sin(angle);
+        return v * c + glm::cross(k, v) * s + k * glm::dot(k, v) * (1.0f - c);
+    }
+
+    // Smallest cone containing both cones
+    void coneUnion(const raytracer::LightBounds& a, const raytracer::LightBounds& b,
+                   glm::vec3& axis, float& cosTheta)
+    {
+        axis = glm::vec3(0.0f, 0.0f, 1.0f);
+        cosTheta = -1.0f;
+        if (a.cosTheta <= -1.0f || b.cosTheta <= -1.0f) return;
+
+        const float thetaA = safeAcos(a.cosTheta);
+        const float thetaB = safeAcos(b.cosTheta);
+        const float thetaD = safeAcos(glm::dot(a.axis, b.axis));
+        if (std::min(thetaD + thetaB, PI) <= thetaA) { axis = a.axis; cosTheta = a.cosTheta; return; }
+        if (std::min(thetaD + thetaA, PI) <= thetaB) { axis = b.axis; cosTheta = b.cosTheta; return; }
+
+        const float thetaO = 0.5f * (thetaA + thetaD + thetaB);
+        const glm::vec3 k = glm::cross(a.axis, b.axis);
+        if (thetaO >= PI || glm::dot(k, k) < 1e-12f) return;
+
+        axis = glm::normalize(rotate(a.axis, thetaO - thetaA, glm::normalize(k)));
+        cosTheta = std::cos(thetaO);
+    }
+
+    raytracer::LightBounds merge(const raytracer::LightBounds& a, const raytracer::LightBounds& b)
+    {
+        raytracer::LightBounds m;
+        m.boundsMin = glm::min(a.boundsMin, b.boundsMin);
+        m.boundsMax = glm::max(a.boundsMax, b.boundsMax);
+        m.intensity = a.intensity + b.intensity;
+        coneUnion(a, b, m.axis, m.cosTheta);
+        return m;
+    }
+}
+
+namespace raytracer {
+
+    void AliasTable::build(const std::vector<float>& weights)
+    {
+        m_bins.clear();
+        const double sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+        if (weights.empty() || !(sum > 0.0)) return;
+
+        const size_t n = weights.size();
+        m_bins.resize(n);
+        std::vector<double> scaled(n);
+        std::vector<uint32_t> small, large;
+        for (size_t i = 0; i < n; ++i) {
+            m_bins[i] = { 1.0f, static_cast<uint32_t>(i), static_cast<float>(weights[i] / sum) };
+            scaled[i] = weights[i] / sum * double(n);
+            (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+        }
+
+        // Vose: pair each under-full bin with an over-full one
+        while (!small.empty() && !large.empty()) {
+            const uint32_t s = small.back(); small.pop_back();
+            const uint32_t l = large.back(); large.pop_back();
+            m_bins[s].threshold = static_cast<float>(scaled[s]);
+            m_bins[s].alias = l;
+            scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+            (scaled[l] < 1.0 ? small : large).push_back(l);
+        }
+        // Leftovers are full up to rounding
+    }
+
+    uint32_t AliasTable::sample(float u, float& pmf) const
+    {
+        const float scaled = u * float(m_bins.size());
+        const uint32_t i = std::min(static_cast<uint32_t>(scaled), static_cast<uint32_t>(m_bins.size() - 1));
+        const uint32_t index = (scaled - float(i)) < m_bins[i].threshold ? i : m_bins[i].alias;
+        pmf = m_bins[index].pmf;
+        return index;
+    }
+
+    float LightBounds::importance(const glm::vec3& p, const glm::vec3& n) const
+    {
+        const glm::vec3 center = 0.5f * (boundsMin + boundsMax);
+        const float radius = 0.5f * glm::length(boundsMax - boundsMin);
+        const glm::vec3 toPoint = p - center;
+        const float d2 = glm::dot(toPoint, toPoint);
+
+        // Inside the bounding sphere every direction is possible
+        if (d2 <= radius * radius)
+            return intensity;
+
+        const float d = std::sqrt(d2);
+        const glm::vec3 wi = toPoint / d;
+        const float thetaB = std::asin(std::min(1.0f, radius / d));
+
+        // p must lie inside the emission cone widened by the bounds' extent
+        if (cosTheta > -1.0f && safeAcos(glm::dot(axis, wi)) - safeAcos(cosTheta) - thetaB > kConeSlack)
+            return 0.0f;
+
+        // Two-sided cosine at the receiver, so callers may flip the normal
+        const float thetaI = safeAcos(std::abs(glm::dot(n, wi)));
+        const float cosI = std::cos(std::max(0.0f, thetaI - thetaB));
+        return intensity * cosI * distanceAttenuation(d - radius);
+    }
+
+    void LightSampler::build(const Light& lights, LightSampling mode, int lightsPerHit)
+    {
+        m_sampled.clear();
+        m_fixed.clear();
+        m_nodes.clear();
+        m_power.build({});
+        m_lightsPerHit = std::clamp(lightsPerHit, 1, LightSelection::kMaxLights);
+
+        std::vector<LightBounds> bounds;
+        std::vector<float> power;
+        for (size_t i = 0; i < lights.m_lights.size(); ++i) {
+            const LightSource& light = lights.m_lights[i];
+            if (!light.enabled) continue;
+            if (light.type == LightType::DIRECTIONAL) {
+                m_fixed.push_back(static_cast<uint32_t>(i));
+                continue;
+            }
+
+            LightBounds b;
+            b.boundsMin = b.boundsMax = light.position;
+            b.intensity = luminance(light.color) * light.intensity;
+            if (!(b.intensity > 0.0f)) continue;
+            if (light.type == LightType::SPOT) {
+                b.axis = glm::normalize(light.direction);
+                b.cosTheta = std::cos(glm::radians(light.outerConeDeg));
+            }
+
+            m_sampled.push_back(static_cast<uint32_t>(i));
+            bounds.push_back(b);
+            power.push_back(b.intensity * 2.0f * PI * (1.0f - b.cosTheta));
+        }
+
+        m_mode = mode;
+        if (m_mode == LightSampling::Auto)
+            m_mode = m_sampled.size() > size_t(kExhaustiveLightLimit) ? LightSampling::BVH : LightSampling::All;
+
+        if (m_mode == LightSampling::Power) {
+            m_power.build(power);
+        } else if (m_mode == LightSampling::BVH && !bounds.empty()) {
+            std::vector<uint32_t> order(bounds.size());
+            std::iota(order.begin(), order.end(), 0u);
+            m_nodes.reserve(2 * bounds.size() - 1);
+            buildNodes(order, 0, static_cast<uint32_t>(order.size()), bounds);
+        }
+    }
+
+    // Depth-first layout: an interior node's first child follows it directly.
+    // Splits at the centroid median of the widest axis.
+    uint32_t LightSampler::buildNodes(std::vector<uint32_t>& order, uint32_t begin, uint32_t end,
+                                      const std::vector<LightBounds>& bounds)
+    {
+        const uint32_t index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+        if (end - begin == 1) {
+            m_nodes[index].bounds = bounds[order[begin]];
+            m_nodes[index].offset = order[begin];
+            m_nodes[index].leaf = true;
+            return index;
+        }
+
+        glm::vec3 cmin(std::numeric_limits<float>::max()), cmax(-std::numeric_limits<float>::max());
+        for (uint32_t i = begin; i < end; ++i) {
+            const glm::vec3 c = 0.5f * (bounds[order[i]].boundsMin + bounds[order[i]].boundsMax);
+            cmin = glm::min(cmin, c);
+            cmax = glm::max(cmax, c);
+        }
+        const glm::vec3 extent = cmax - cmin;
+        const int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+
+        const uint32_t mid = (begin + end) / 2;
+        std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+                         [&](uint32_t a, uint32_t b) {
+                             return bounds[a].boundsMin[axis] + bounds[a].boundsMax[axis] <
+                                    bounds[b].boundsMin[axis] + bounds[b].boundsMax[axis];
+                         });
+
+        const uint32_t left = buildNodes(order, begin, mid, bounds);
+        const uint32_t right = buildNodes(order, mid, end, bounds);
+        m_nodes[index].bounds = merge(m_nodes[left].bounds, m_nodes[right].bounds);
+        m_nodes[index].offset = right;
+        return index;
+    }
+
+    bool LightSampler::sampleBVH(const glm::vec3& p, const glm::vec3& n, float u, uint32_t& light, float& pmf) const
+    {
+        if (m_nodes.empty()) return false;
+
+        pmf = 1.0f;
+        uint32_t node = 0;
+        if (m_nodes[0].leaf && !(m_nodes[0].bounds.importance(p, n) > 0.0f))
+            return false;
+
+        // Descend choosing each child in proportion to its importance,
+        // reusing the leftover fraction of u at the next level
+        while (!m_nodes[node].leaf) {
+            const uint32_t left = node + 1, right = m_nodes[node].offset;
+            const float importanceLeft = m_nodes[left].bounds.importance(p, n);
+            const float importanceRight = m_nodes[right].bounds.importance(p, n);
+            if (!(importanceLeft + importanceRight > 0.0f)) return false;
+
+            const float pLeft = importanceLeft / (importanceLeft + importanceRight);
+            if (u < pLeft) {
+                u = std::min(u / pLeft, kOneMinusEpsilon);
+                pmf *= pLeft;
+                node = left;
+            } else {
+                u = std::min((u - pLeft) / (1.0f - pLeft), kOneMinusEpsilon);
+                pmf *= 1.0f - pLeft;
+                node = right;
+            }
+        }
+
+        light = m_nodes[node].offset;
+        return true;
+    }
+
+    void LightSampler::select(const glm::vec3& p, const glm::vec3& n, const float u[4], LightSelection& selection) const
+    {
+        selection = LightSelection{};
+        if (m_mode == LightSampling::All) return;
+
+        selection.all = false;
+        selection.fixed = &m_fixed;
+        for (int k = 0; k < m_lightsPerHit; ++k) {
+            uint32_t sampled;
+            float pmf;
+            if (m_mode == LightSampling::Power) {
+                if (m_power.empty()) break;
+                sampled = m_power.sample(u[k], pmf);
+            } else if (!sampleBVH(p, n, u[k], sampled, pmf)) {
+                continue;
+            }
+            selection.index[selection.count] = m_sampled[sampled];
+            selection.weight[selection.count] = 1.0f / (float(m_lightsPerHit) * pmf);
+            ++selection.count;
+        }
+    }
+}
@@ -4,6 +4,8 @@
 #include <cstring>
 #include <iostream>
 
+using namespace glint3d;
+
 MaterialManager::MaterialManager()
 {
     setDefaultMaterial();
@@ -71,6 +73,20 @@ void MaterialManager::updateMaterialForObject(const SceneObject& obj)
     updateUBO();
 }
 
+bool MaterialManager::sameMaterial(const SceneObject& a, const SceneObject& b)
+{
+    // Exactly the fields updateMaterialForObject reads
+    const auto& x = a.materialCore;
+    const auto& y = b.materialCore;
+    return x.baseColor == y.baseColor && x.metallic == y.metallic && x.roughness == y.roughness &&
+           x.ior == y.ior && x.transmission == y.transmission && x.thickness == y.thickness &&
+           x.attenuationDistance == y.attenuationDistance && x.clearcoat == y.clearcoat &&
+           x.clearcoatRoughness == y.clearcoatRoughness &&
+           x.baseColorTex.empty() == y.baseColorTex.empty() && x.normalTex.empty() == y.normalTex.empty() &&
+           x.metallicRoughnessTex.empty() == y.metallicRoughnessTex.empty() &&
+           a.baseColorTex == b.baseColorTex && a.normalTex == b.normalTex && a.mrTex == b.mrTex;
+}
+
 void MaterialManager::updateMaterial(const MaterialCore& material)
 {
     if (!m_rhi) return;
@@ -8,6 +8,8 @@
 #include <fstream>
 #include <sstream>
 
+using namespace glint3d;
+
 PipelineManager::PipelineManager()
 {
 }
@@ -216,35 +218,7 @@ PipelineHandle PipelineManager::createBasicPipeline(const SceneObject& obj)
     pd.shader = m_basicShaderRhi;
     pd.debugName = obj.name + ":pipeline_basic";
 
-    // Set up vertex bindings based on available buffers
-    if (obj.rhiVboPositions != INVALID_HANDLE) {
-        VertexBinding bPos{};
-        bPos.binding = 0;
-        bPos.stride = 3 * sizeof(float);
-        bPos.buffer = obj.rhiVboPositions;
-        pd.vertexBindings.push_back(bPos);
-    }
-
-    if (obj.rhiVboNormals != INVALID_HANDLE) {
-        VertexBinding bNormal{};
-        bNormal.binding = 1;
-        bNormal.stride = 3 * sizeof(float);
-        bNormal.buffer = obj.rhiVboNormals;
-        pd.vertexBindings.push_back(bNormal);
-    }
-
-    if (obj.rhiVboTexCoords != INVALID_HANDLE) {
-        VertexBinding bTexCoord{};
-        bTexCoord.binding = 2;
-        bTexCoord.stride = 2 * sizeof(float);
-        bTexCoord.buffer = obj.rhiVboTexCoords;
-        pd.vertexBindings.push_back(bTexCoord);
-    }
-
-    // Set index buffer if available
-    if (obj.rhiEbo != INVALID_HANDLE) {
-        pd.indexBuffer = obj.rhiEbo;
-    }
+    addMeshLayout(pd, obj);
 
     return m_rhi->createPipeline(pd);
 }
@@ -260,30 +234,7 @@ PipelineHandle PipelineManager::createPbrPipeline(const SceneObject& obj)
     pd.shader = m_pbrShaderRhi;
     pd.debugName = obj.name + ":pipeline_pbr";
 
-    // Set up vertex bindings based on available buffers
-    if (obj.rhiVboPositions != INVALID_HANDLE) {
-        VertexBinding bPos{};
-        bPos.binding = 0;
-        bPos.stride = 3 * sizeof(float);
-        bPos.buffer = obj.rhiVboPositions;
-        pd.vertexBindings.push_back(bPos);
-    }
-
-    if (obj.rhiVboNormals != INVALID_HANDLE) {
-        VertexBinding bNormal{};
-        bNormal.binding = 1;
-        bNormal.stride = 3 * sizeof(float);
-        bNormal.buffer = obj.rhiVboNormals;
-        pd.vertexBindings.push_back(bNormal);
-    }
-
-    if (obj.rhiVboTexCoords != INVALID_HANDLE) {
-        VertexBinding bTexCoord{};
-        bTexCoord.binding = 2;
-        bTexCoord.stride = 2 * sizeof(float);
-        bTexCoord.buffer = obj.rhiVboTexCoords;
-        pd.vertexBindings.push_back(bTexCoord);
-    }
+    addMeshLayout(pd, obj);
 
     // PBR shaders might use tangent data
     if (obj.rhiVboTangents != INVALID_HANDLE) {
@@ -294,11 +245,64 @@ PipelineHandle PipelineManager::createPbrPipeline(const SceneObject& obj)
         pd.vertexBindings.push_back(bTangent);
     }
 
-    // Set index buffer if available
-    if (obj.rhiEbo != INVALID_HANDLE) {
-        pd.indexBuffer = obj.rhiEbo;
+    return m_rhi->createPipeline(pd);
+}
+
+void PipelineManager::addMeshLayout(PipelineDesc& pd, const SceneObject& obj)
+{
+    // Separate position, normal and uv streams at locations 0-2, in the
+    // formats SceneManager uploads: unorm16 positions padded to 8 bytes,
+    // octahedral snorm16 normals
+    const bool hasNormals = (obj.rhiVboNormals != INVALID_HANDLE);
+    const bool hasUVs = (obj.rhiVboTexCoords != INVALID_HANDLE);
+    VertexBinding bPos{}; bPos.binding = 0; bPos.stride = 4 * sizeof(uint16_t); bPos.buffer = obj.rhiVboPositions; pd.vertexBindings.push_back(bPos);
+    if (hasNormals) { VertexBinding bN{}; bN.binding = 1; bN.stride = 2 * sizeof(int16_t); bN.buffer = obj.rhiVboNormals; pd.vertexBindings.push_back(bN); }
+    if (hasUVs) { VertexBinding bUV{}; bUV.binding = 2; bUV.stride = obj.rhiHalfTexCoords ? 2 * sizeof(uint16_t) : 2 * sizeof(float); bUV.buffer = obj.rhiVboTexCoords; pd.vertexBindings.push_back(bUV); }
+
+    VertexAttribute aPos{}; aPos.location = 0; aPos.binding = 0; aPos.format = TextureFormat::RGBA16Unorm; aPos.offset = 0; pd.vertexAttributes.push_back(aPos);
+    if (hasNormals) { VertexAttribute aN{}; aN.location = 1; aN.binding = 1; aN.format = TextureFormat::RG16Snorm; aN.offset = 0; pd.vertexAttributes.push_back(aN); }
+    if (hasUVs) { VertexAttribute aUV{}; aUV.location = 2; aUV.binding = 2; aUV.format = obj.rhiHalfTexCoords ? TextureFormat::RG16F : TextureFormat::RG32F; aUV.offset = 0; pd.vertexAttributes.push_back(aUV); }
+
+    pd.indexBuffer = obj.rhiEbo;
+}
+
+PipelineHandle PipelineManager::createInstancedPipeline(const SceneObject& obj, BufferHandle transforms)
+{
+    if (!m_rhi || m_pbrShaderRhi == INVALID_HANDLE || obj.rhiVboPositions == INVALID_HANDLE) {
+        return INVALID_HANDLE;
+    }
+
+    PipelineDesc pd{};
+    pd.topology = PrimitiveTopology::Triangles;
+    pd.shader = m_pbrShaderRhi;
+    pd.debugName = obj.name + ":pipeline_pbr_instanced";
+    addMeshLayout(pd, obj);
+
+    VertexBinding bInst{}; bInst.binding = 4; bInst.stride = 16 * sizeof(float); bInst.perInstance = true; bInst.buffer = transforms; pd.vertexBindings.push_back(bInst);
+    // A mat4 attribute takes one location per column
+    for (uint32_t column = 0; column < 4; ++column) {
+        VertexAttribute aM{}; aM.location = 4 + column; aM.binding = 4; aM.format = TextureFormat::RGBA32F;
+        aM.offset = column * 4 * sizeof(float);
+        pd.vertexAttributes.push_back(aM);
+    }
+
+    return m_rhi->createPipeline(pd);
+}
+
+PipelineHandle PipelineManager::createGBufferPipeline(const SceneObject& obj, ShaderHandle shader)
+{
+    if (!m_rhi || shader == INVALID_HANDLE || obj.rhiVboPositions == INVALID_HANDLE) {
+        return INVALID_HANDLE;
     }
 
+    PipelineDesc pd{};
+    pd.topology = PrimitiveTopology::Triangles;
+    pd.shader = shader;
+    pd.debugName = obj.name + ":pipeline_gbuffer";
+    pd.depthTestEnable = true;
+    pd.depthWriteEnable = true;
+    addMeshLayout(pd, obj);
+
     return m_rhi->createPipeline(pd);
 }
 
@@ -308,7 +312,7 @@ std::string PipelineManager::generatePipelineKey(const SceneObject& obj, bool us
     key << (usePbr ? "pbr" : "basic");
     key << "_pos:" << (obj.rhiVboPositions != INVALID_HANDLE ? "1" : "0");
     key << "_norm:" << (obj.rhiVboNormals != INVALID_HANDLE ? "1" : "0");
-    key << "_tex:" << (obj.rhiVboTexCoords != INVALID_HANDLE ? "1" : "0");
+    key << "_tex:" << (obj.rhiVboTexCoords == INVALID_HANDLE ? "0" : obj.rhiHalfTexCoords ? "h" : "1");
     key << "_tang:" << (obj.rhiVboTangents != INVALID_HANDLE ? "1" : "0");
     key << "_idx:" << (obj.rhiEbo != INVALID_HANDLE ? "1" : "0");
     return key.str();
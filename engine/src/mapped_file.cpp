@@ -0,0 +1,125 @@
+#include "mapped_file.h"
+#include <iostream>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__EMSCRIPTEN__)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        std::cerr << "[MappedFile] cannot open " << path << "\n";
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        std::cerr << "[MappedFile] cannot stat " << path << "\n";
+        return false;
+    }
+    m_file = file;
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size > 0)
+    {
+        // Zero-length files cannot be mapped; they open with no data
+        m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* view = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view)
+        {
+            std::cerr << "[MappedFile] cannot map " << path << "\n";
+            close();
+            return false;
+        }
+        m_data = static_cast<const char*>(view);
+    }
+#elif defined(__EMSCRIPTEN__)
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        std::cerr << "[MappedFile] cannot open " << path << "\n";
+        return false;
+    }
+    m_buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!m_buffer.empty() && !file.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size())))
+    {
+        std::cerr << "[MappedFile] cannot read " << path << "\n";
+        m_buffer.clear();
+        return false;
+    }
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "[MappedFile] cannot open " << path << "\n";
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        std::cerr << "[MappedFile] cannot stat " << path << "\n";
+        return false;
+    }
+    m_size = static_cast<size_t>(st.st_size);
+    if (m_size > 0)
+    {
+        void* view = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED)
+        {
+            ::close(fd);
+            m_size = 0;
+            std::cerr << "[MappedFile] cannot map " << path << "\n";
+            return false;
+        }
+        madvise(view, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(view);
+    }
+    // The mapping stays valid without the descriptor
+    ::close(fd);
+#endif
+    m_open = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+#if defined(_WIN32)
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(static_cast<HANDLE>(m_mapping));
+    if (m_file) CloseHandle(static_cast<HANDLE>(m_file));
+    m_mapping = nullptr;
+    m_file = nullptr;
+#elif defined(__EMSCRIPTEN__)
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+#else
+    if (m_data) munmap(const_cast<char*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
@@ -0,0 +1,385 @@
+#include "mesh_cache.h"
+#include "bvh_node.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr char kMagic[8] = { 'G', '3', 'D', 'M', 'E', 'S', 'H', '\0' };
+    constexpr uint32_t kByteOrderMark = 0x01020304u;
+
+    enum Section : uint32_t
+    {
+        kPositions,
+        kNormals,
+        kTexcoords,
+        kTangents,
+        kIndices,
+        kBvhNodes,
+        kBvhPrimIndices,
+        kLodTable,      // LodEntry per level, finest first
+        kLodIndices,    // the levels' index buffers back to back
+        kSourcePath,    // absolute source path, guards against name hash collisions
+        kSectionCount
+    };
+
+    enum Flags : uint32_t
+    {
+        kNormalsFromSource = 1u << 0
+    };
+
+    struct SectionEntry
+    {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct LodEntry
+    {
+        uint32_t indexCount;
+        float    error;
+    };
+
+    struct FileHeader
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t byteOrderMark;
+        uint32_t flags;
+        uint32_t bvhNodeSize;   // sizeof(BVHNode) of the writer
+        uint64_t sourceSize;
+        int64_t  sourceMtime;
+        uint64_t vertexCount;
+        uint64_t indexCount;
+        uint64_t bvhNodeCount;
+        uint64_t lodCount;
+        float    minBound[3];
+        float    maxBound[3];
+        SectionEntry sections[kSectionCount];
+    };
+    static_assert(std::is_trivially_copyable<FileHeader>::value, "FileHeader is written as raw bytes");
+    static_assert(sizeof(LodEntry) == 8, "LodEntry is written as raw bytes");
+    static_assert(sizeof(glm::vec3) == 12 && sizeof(glm::vec2) == 8, "mesh arrays are written as raw bytes");
+
+    size_t alignUp(size_t n)
+    {
+        return (n + MeshCache::kSectionAlignment - 1) & ~(MeshCache::kSectionAlignment - 1);
+    }
+
+    // Every index below limit
+    bool indicesBelow(const uint32_t* indices, uint64_t count, uint64_t limit)
+    {
+        uint32_t largest = 0;
+        for (uint64_t i = 0; i < count; ++i) largest = std::max(largest, indices[i]);
+        return count == 0 || largest < limit;
+    }
+
+    // Leaves reached from the root stay inside the primitive index array and
+    // children come after their parent, so traversal of a damaged tree cannot
+    // leave the arrays or loop. Unreached nodes (the padding node) are ignored.
+    bool bvhInRange(const BVHNode* nodes, uint64_t nodeCount, uint64_t primCount)
+    {
+        std::vector<bool> reached(static_cast<size_t>(nodeCount), false);
+        if (nodeCount > 0) reached[0] = true;
+        for (uint64_t i = 0; i < nodeCount; ++i)
+        {
+            if (!reached[i]) continue;
+            const BVHNode& n = nodes[i];
+            if (n.isLeaf())
+            {
+                if (uint64_t(n.leftFirst) + n.primCount > primCount) return false;
+                continue;
+            }
+            if (n.leftFirst <= i || uint64_t(n.leftFirst) + 1 >= nodeCount) return false;
+            reached[n.leftFirst] = reached[n.leftFirst + 1] = true;
+        }
+        return true;
+    }
+
+    std::string absolutePath(const std::string& path)
+    {
+        std::error_code ec;
+        const fs::path abs = fs::absolute(path, ec);
+        return (ec ? fs::path(path) : abs).lexically_normal().generic_string();
+    }
+
+    // Size and modification time identify a source revision
+    bool sourceStamp(const std::string& path, uint64_t& size, int64_t& mtime)
+    {
+        std::error_code ec;
+        size = fs::file_size(path, ec);
+        if (ec) return false;
+        const auto time = fs::last_write_time(path, ec);
+        if (ec) return false;
+        mtime = static_cast<int64_t>(time.time_since_epoch().count());
+        return true;
+    }
+
+    uint64_t fnv1a(const std::string& s)
+    {
+        uint64_t h = 1469598103934665603ull;
+        for (unsigned char c : s) { h ^= c; h *= 1099511628211ull; }
+        return h;
+    }
+
+    std::string defaultDirectory()
+    {
+        if (const char* env = std::getenv("GLINT_MESH_CACHE"))
+            return env;
+#if defined(__EMSCRIPTEN__)
+        // No persistent file system to cache into
+        return {};
+#else
+        std::error_code ec;
+        const fs::path tmp = fs::temp_directory_path(ec);
+        return ec ? std::string() : (tmp / "glint3d-mesh-cache").string();
+#endif
+    }
+
+    std::mutex& directoryMutex()
+    {
+        static std::mutex m;
+        return m;
+    }
+
+    std::string& directoryStorage()
+    {
+        static std::string dir = defaultDirectory();
+        return dir;
+    }
+}
+
+namespace MeshCache {
+
+    std::string directory()
+    {
+        std::lock_guard<std::mutex> lock(directoryMutex());
+        return directoryStorage();
+    }
+
+    void setDirectory(const std::string& dir)
+    {
+        std::lock_guard<std::mutex> lock(directoryMutex());
+        directoryStorage() = dir;
+    }
+
+    std::string cachePathFor(const std::string& sourcePath)
+    {
+        const std::string dir = directory();
+        if (dir.empty()) return {};
+        const std::string abs = absolutePath(sourcePath);
+        char hash[17];
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(fnv1a(abs)));
+        const std::string stem = fs::path(abs).stem().string();
+        return (fs::path(dir) / (stem + "-" + hash + ".g3dmesh")).string();
+    }
+
+    bool open(const std::string& sourcePath, View& view)
+    {
+        view.close();
+        const std::string cachePath = cachePathFor(sourcePath);
+        uint64_t sourceSize = 0;
+        int64_t sourceMtime = 0;
+        std::error_code ec;
+        if (cachePath.empty() || !fs::is_regular_file(cachePath, ec) || !sourceStamp(sourcePath, sourceSize, sourceMtime))
+            return false;
+        if (!view.m_file.open(cachePath) || view.m_file.size() < sizeof(FileHeader))
+        {
+            view.close();
+            return false;
+        }
+
+        const char* base = view.m_file.data();
+        const size_t fileSize = view.m_file.size();
+        FileHeader h;
+        std::memcpy(&h, base, sizeof(h));
+
+        auto sectionOk = [&](Section s, uint64_t expected) {
+            const SectionEntry& e = h.sections[s];
+            return e.size == expected && e.offset % kSectionAlignment == 0 &&
+                   e.offset <= fileSize && e.size <= fileSize - e.offset;
+        };
+        auto optionalOk = [&](Section s, uint64_t expected) {
+            return h.sections[s].size == 0 || sectionOk(s, expected);
+        };
+        const std::string abs = absolutePath(sourcePath);
+        const uint64_t Nv = h.vertexCount, Ni = h.indexCount;
+        bool valid = std::memcmp(h.magic, kMagic, sizeof(kMagic)) == 0 && h.version == kVersion &&
+                     h.byteOrderMark == kByteOrderMark && h.bvhNodeSize == sizeof(BVHNode) &&
+                     h.sourceSize == sourceSize && h.sourceMtime == sourceMtime && Ni % 3 == 0 &&
+                     Nv <= fileSize && Ni <= fileSize && h.bvhNodeCount <= fileSize && h.lodCount <= fileSize &&
+                     sectionOk(kPositions, Nv * sizeof(glm::vec3)) &&
+                     optionalOk(kNormals, Nv * sizeof(glm::vec3)) &&
+                     optionalOk(kTexcoords, Nv * sizeof(glm::vec2)) &&
+                     optionalOk(kTangents, Nv * sizeof(glm::vec3)) &&
+                     sectionOk(kIndices, Ni * sizeof(uint32_t)) &&
+                     sectionOk(kBvhNodes, h.bvhNodeCount * sizeof(BVHNode)) &&
+                     sectionOk(kBvhPrimIndices, Ni / 3 * sizeof(uint32_t)) &&
+                     optionalOk(kLodTable, h.lodCount * sizeof(LodEntry)) &&
+                     sectionOk(kSourcePath, abs.size());
+        valid = valid && std::memcmp(base + h.sections[kSourcePath].offset, abs.data(), abs.size()) == 0;
+
+        // Level sizes come from the table, so the index section is checked
+        // against their sum
+        std::vector<LodEntry> lods(valid ? static_cast<size_t>(h.lodCount) : 0);
+        uint64_t lodIndexCount = 0;
+        if (!lods.empty())
+        {
+            std::memcpy(lods.data(), base + h.sections[kLodTable].offset, lods.size() * sizeof(LodEntry));
+            for (const LodEntry& e : lods)
+            {
+                valid = valid && e.indexCount % 3 == 0 && e.indexCount <= Ni;
+                lodIndexCount += e.indexCount;
+            }
+        }
+        valid = valid && optionalOk(kLodIndices, lodIndexCount * sizeof(uint32_t)) &&
+                (h.sections[kLodIndices].size != 0) == (lodIndexCount != 0);
+
+        // Contents that index other arrays are range-checked too, one linear
+        // pass each, so a damaged entry cannot send the optimizer, the BVH or
+        // the GPU upload out of bounds
+        auto words = [&](Section s) { return reinterpret_cast<const uint32_t*>(base + h.sections[s].offset); };
+        valid = valid && indicesBelow(words(kIndices), Ni, Nv) &&
+                indicesBelow(words(kLodIndices), lodIndexCount, Nv) &&
+                indicesBelow(words(kBvhPrimIndices), Ni / 3, Ni / 3) &&
+                bvhInRange(reinterpret_cast<const BVHNode*>(base + h.sections[kBvhNodes].offset), h.bvhNodeCount, Ni / 3);
+        if (!valid)
+        {
+            view.close();
+            return false;
+        }
+
+        auto at = [&](Section s) -> const char* {
+            return h.sections[s].size ? base + h.sections[s].offset : nullptr;
+        };
+        MeshArrays& a = view.m_arrays;
+        a = MeshArrays{};
+        a.positions = reinterpret_cast<const glm::vec3*>(at(kPositions));
+        a.normals = reinterpret_cast<const glm::vec3*>(at(kNormals));
+        a.texcoords = reinterpret_cast<const glm::vec2*>(at(kTexcoords));
+        a.tangents = reinterpret_cast<const glm::vec3*>(at(kTangents));
+        a.vertexCount = static_cast<size_t>(Nv);
+        a.indices = reinterpret_cast<const unsigned int*>(at(kIndices));
+        a.indexCount = static_cast<size_t>(Ni);
+        a.minBound = glm::vec3(h.minBound[0], h.minBound[1], h.minBound[2]);
+        a.maxBound = glm::vec3(h.maxBound[0], h.maxBound[1], h.maxBound[2]);
+        a.normalsFromSource = (h.flags & kNormalsFromSource) != 0;
+        view.m_bvhNodes = reinterpret_cast<const BVHNode*>(at(kBvhNodes));
+        view.m_bvhNodeCount = static_cast<size_t>(h.bvhNodeCount);
+        view.m_bvhPrimIndices = reinterpret_cast<const uint32_t*>(at(kBvhPrimIndices));
+        const uint32_t* lodIndices = reinterpret_cast<const uint32_t*>(at(kLodIndices));
+        view.m_lods.clear();
+        for (const LodEntry& e : lods)
+        {
+            view.m_lods.push_back({ lodIndices, e.indexCount, e.error });
+            lodIndices += e.indexCount;
+        }
+        return true;
+    }
+
+    bool store(const std::string& sourcePath, const MeshArrays& mesh, const BVH& bvh,
+               const std::vector<MeshLod::Level>& lods)
+    {
+        const std::string cachePath = cachePathFor(sourcePath);
+        FileHeader h{};
+        if (cachePath.empty() || !sourceStamp(sourcePath, h.sourceSize, h.sourceMtime) ||
+            bvh.primIndices().size() != mesh.indexCount / 3)
+            return false;
+
+        const std::string abs = absolutePath(sourcePath);
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.version = kVersion;
+        h.byteOrderMark = kByteOrderMark;
+        h.flags = mesh.normalsFromSource ? kNormalsFromSource : 0u;
+        h.bvhNodeSize = sizeof(BVHNode);
+        h.vertexCount = mesh.vertexCount;
+        h.indexCount = mesh.indexCount;
+        h.bvhNodeCount = bvh.nodeCount();
+        h.lodCount = lods.size();
+        for (int i = 0; i < 3; ++i) { h.minBound[i] = mesh.minBound[i]; h.maxBound[i] = mesh.maxBound[i]; }
+
+        std::vector<LodEntry> lodTable;
+        std::vector<uint32_t> lodIndices;
+        for (const MeshLod::Level& level : lods)
+        {
+            lodTable.push_back({ static_cast<uint32_t>(level.indices.size()), level.error });
+            lodIndices.insert(lodIndices.end(), level.indices.begin(), level.indices.end());
+        }
+
+        const void* data[kSectionCount] = {
+            mesh.positions, mesh.normals, mesh.texcoords, mesh.tangents, mesh.indices,
+            bvh.nodes().data(), bvh.primIndices().data(), lodTable.data(), lodIndices.data(), abs.data()
+        };
+        const size_t sizes[kSectionCount] = {
+            mesh.vertexCount * sizeof(glm::vec3),
+            mesh.normals ? mesh.vertexCount * sizeof(glm::vec3) : 0,
+            mesh.texcoords ? mesh.vertexCount * sizeof(glm::vec2) : 0,
+            mesh.tangents ? mesh.vertexCount * sizeof(glm::vec3) : 0,
+            mesh.indexCount * sizeof(uint32_t),
+            bvh.nodeCount() * sizeof(BVHNode),
+            bvh.primIndices().size() * sizeof(uint32_t),
+            lodTable.size() * sizeof(LodEntry),
+            lodIndices.size() * sizeof(uint32_t),
+            abs.size()
+        };
+        size_t offset = alignUp(sizeof(FileHeader));
+        for (uint32_t s = 0; s < kSectionCount; ++s)
+        {
+            h.sections[s] = { offset, sizes[s] };
+            offset = alignUp(offset + sizes[s]);
+        }
+
+        std::error_code ec;
+        fs::create_directories(fs::path(cachePath).parent_path(), ec);
+        // Written under a private name and renamed into place, so readers
+        // never map a partial file
+        const std::string tmpPath = cachePath + "." +
+            std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                std::cerr << "[MeshCache] cannot write " << tmpPath << "\n";
+                return false;
+            }
+            static const char zeros[kSectionAlignment] = {};
+            out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            size_t written = sizeof(h);
+            for (uint32_t s = 0; s < kSectionCount; ++s)
+            {
+                out.write(zeros, static_cast<std::streamsize>(h.sections[s].offset - written));
+                if (sizes[s]) out.write(static_cast<const char*>(data[s]), static_cast<std::streamsize>(sizes[s]));
+                written = static_cast<size_t>(h.sections[s].offset + sizes[s]);
+            }
+            if (!out)
+            {
+                out.close();
+                fs::remove(tmpPath, ec);
+                std::cerr << "[MeshCache] cannot write " << tmpPath << "\n";
+                return false;
+            }
+        }
+        fs::rename(tmpPath, cachePath, ec);
+        if (ec)
+        {
+            // e.g. another process has the old entry mapped on Windows
+            fs::remove(tmpPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+} // namespace MeshCache
@@ -1,6 +1,8 @@
 #include "mesh_loader.h"
 #include "importer_registry.h"
+#include "mesh_optimizer.h"
 #include <algorithm>
+#include <iostream>
 
 bool LoadMeshFromFile(const std::string& path, MeshData& out, PBRMaterial* pbrOut, std::string* error)
 {
@@ -11,6 +13,10 @@ bool LoadMeshFromFile(const std::string& path, MeshData& out, PBRMaterial* pbrOu
     for (const auto& imp : importers) {
         if (!imp || !imp->CanLoad(path)) continue;
         if (imp->Load(path, out, pbrOut, &lastErr, opts)) {
+            if (opts.optimize && !out.indices.empty()) {
+                const MeshOptimizer::Report report = MeshOptimizer::optimize(out);
+                std::cout << "[MeshOptimizer] " << path << ": " << MeshOptimizer::describe(report) << "\n";
+            }
             return true;
         }
     }
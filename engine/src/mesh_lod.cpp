@@ -0,0 +1,290 @@
+#include "mesh_lod.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+    // Boundary planes weigh this much more than surface planes, per unit area
+    constexpr double kBoundaryWeight = 10.0;
+    // A collapse may not turn a neighboring triangle further than this
+    // (cosine of the angle between its normals before and after)
+    constexpr double kMinNormalDot = 0.25;
+    constexpr int kMaxPasses = 64;
+
+    struct Quadric
+    {
+        double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+        double b0 = 0, b1 = 0, b2 = 0, c = 0;
+        double weight = 0;
+
+        // Squared distance to the plane n.p + d = 0, weighted
+        void addPlane(const glm::dvec3& n, double d, double w)
+        {
+            a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z;
+            a11 += w * n.y * n.y; a12 += w * n.y * n.z; a22 += w * n.z * n.z;
+            b0 += w * n.x * d; b1 += w * n.y * d; b2 += w * n.z * d;
+            c += w * d * d;
+            weight += w;
+        }
+        void add(const Quadric& q)
+        {
+            a00 += q.a00; a01 += q.a01; a02 += q.a02; a11 += q.a11; a12 += q.a12; a22 += q.a22;
+            b0 += q.b0; b1 += q.b1; b2 += q.b2; c += q.c; weight += q.weight;
+        }
+        double eval(const glm::dvec3& p) const
+        {
+            const double x = p.x, y = p.y, z = p.z;
+            return a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + a11 * y * y + 2 * a12 * y * z + a22 * z * z +
+                   2 * (b0 * x + b1 * y + b2 * z) + c;
+        }
+    };
+
+    // Root-mean-square distance of p to the planes of q and r together
+    float collapseError(const Quadric& q, const Quadric& r, const glm::dvec3& p)
+    {
+        Quadric sum = q;
+        sum.add(r);
+        if (sum.weight <= 0.0) return 0.0f;
+        return float(std::sqrt(std::max(0.0, sum.eval(p)) / sum.weight));
+    }
+
+    // Welded id per vertex: vertices at bit-identical positions share one
+    uint32_t weldPositions(const glm::vec3* positions, size_t vertexCount, std::vector<uint32_t>& wid, std::vector<uint32_t>& rep)
+    {
+        size_t tableSize = 1;
+        while (tableSize < vertexCount * 2) tableSize <<= 1;
+        std::vector<uint32_t> table(tableSize, UINT32_MAX);
+        wid.assign(vertexCount, 0);
+        rep.clear();
+        for (size_t v = 0; v < vertexCount; ++v) {
+            uint64_t h = 14695981039346656037ull;
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(&positions[v]);
+            for (size_t i = 0; i < sizeof(glm::vec3); ++i) { h ^= p[i]; h *= 1099511628211ull; }
+            size_t slot = size_t(h) & (tableSize - 1);
+            while (table[slot] != UINT32_MAX && std::memcmp(&positions[rep[table[slot]]], &positions[v], sizeof(glm::vec3)) != 0)
+                slot = (slot + 1) & (tableSize - 1);
+            if (table[slot] == UINT32_MAX) {
+                table[slot] = uint32_t(rep.size());
+                rep.push_back(uint32_t(v));
+            }
+            wid[v] = table[slot];
+        }
+        return uint32_t(rep.size());
+    }
+
+    struct Collapse
+    {
+        uint32_t from, to;   // welded ids
+        float error;
+    };
+}
+
+namespace MeshLod {
+
+size_t simplify(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+                const glm::vec3* positions, size_t vertexCount,
+                size_t targetIndexCount, float targetError, float* resultError)
+{
+    float maxError = 0.0f;
+    std::vector<uint32_t> idx(indices, indices + indexCount - indexCount % 3);
+    std::vector<uint32_t> wid, rep;
+    const uint32_t W = weldPositions(positions, vertexCount, wid, rep);
+    auto pos = [&](uint32_t w) { return glm::dvec3(positions[rep[w]]); };
+
+    // Plane quadrics of the surface, area weighted, and of open borders
+    std::vector<Quadric> quadrics(W);
+    std::unordered_map<uint64_t, uint32_t> edgeUses;
+    edgeUses.reserve(idx.size());
+    auto edgeKey = [](uint32_t a, uint32_t b) { return a < b ? (uint64_t(a) << 32 | b) : (uint64_t(b) << 32 | a); };
+    for (size_t t = 0; t < idx.size(); t += 3)
+        for (int k = 0; k < 3; ++k)
+            ++edgeUses[edgeKey(wid[idx[t + k]], wid[idx[t + (k + 1) % 3]])];
+    for (size_t t = 0; t < idx.size(); t += 3) {
+        const uint32_t w[3] = { wid[idx[t]], wid[idx[t + 1]], wid[idx[t + 2]] };
+        const glm::dvec3 p0 = pos(w[0]), p1 = pos(w[1]), p2 = pos(w[2]);
+        const glm::dvec3 cross = glm::cross(p1 - p0, p2 - p0);
+        const double len = glm::length(cross);
+        if (len <= 0.0) continue;
+        const glm::dvec3 n = cross / len;
+        const double area = 0.5 * len;
+        for (int k = 0; k < 3; ++k) quadrics[w[k]].addPlane(n, -glm::dot(n, p0), area);
+        for (int k = 0; k < 3; ++k) {
+            const uint32_t a = w[k], b = w[(k + 1) % 3];
+            if (edgeUses[edgeKey(a, b)] != 1) continue;
+            const glm::dvec3 edge = pos(b) - pos(a);
+            const glm::dvec3 side = glm::cross(edge, n);
+            const double sideLen = glm::length(side);
+            if (sideLen <= 0.0) continue;
+            const glm::dvec3 bn = side / sideLen;
+            const double weight = kBoundaryWeight * glm::dot(edge, edge);
+            quadrics[a].addPlane(bn, -glm::dot(bn, pos(a)), weight);
+            quadrics[b].addPlane(bn, -glm::dot(bn, pos(a)), weight);
+        }
+    }
+    edgeUses.clear();
+
+    std::vector<uint32_t> remap(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) remap[v] = uint32_t(v);
+    std::vector<uint32_t> adjStart(W + 1), adj;
+    std::vector<uint64_t> edges;
+    std::vector<Collapse> collapses;
+    std::vector<uint8_t> touched(W);
+    std::vector<std::pair<uint32_t, uint32_t>> wedgeMap;
+
+    for (int pass = 0; pass < kMaxPasses && idx.size() > targetIndexCount; ++pass) {
+        // Triangles around each welded vertex
+        std::fill(adjStart.begin(), adjStart.end(), 0u);
+        for (uint32_t v : idx) ++adjStart[wid[v] + 1];
+        for (uint32_t w = 0; w < W; ++w) adjStart[w + 1] += adjStart[w];
+        adj.resize(idx.size());
+        {
+            std::vector<uint32_t> fill(adjStart.begin(), adjStart.end() - 1);
+            for (size_t i = 0; i < idx.size(); ++i) adj[fill[wid[idx[i]]]++] = uint32_t(i / 3);
+        }
+
+        // Cheapest direction of every edge
+        edges.clear();
+        for (size_t t = 0; t < idx.size(); t += 3)
+            for (int k = 0; k < 3; ++k)
+                edges.push_back(edgeKey(wid[idx[t + k]], wid[idx[t + (k + 1) % 3]]));
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        collapses.clear();
+        for (uint64_t e : edges) {
+            const uint32_t a = uint32_t(e >> 32), b = uint32_t(e);
+            const float ab = collapseError(quadrics[a], quadrics[b], pos(b));
+            const float ba = collapseError(quadrics[a], quadrics[b], pos(a));
+            collapses.push_back(ab <= ba ? Collapse{ a, b, ab } : Collapse{ b, a, ba });
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) { return x.error < y.error; });
+
+        std::fill(touched.begin(), touched.end(), 0);
+        size_t triangles = idx.size() / 3;
+        const size_t targetTriangles = targetIndexCount / 3;
+        size_t applied = 0;
+        for (const Collapse& c : collapses) {
+            if (c.error > targetError || triangles <= targetTriangles) break;
+            if (touched[c.from] || touched[c.to]) continue;
+
+            // Each split vertex at 'from' must land on the vertex at 'to' that
+            // shares its attributes; that is the one beside it on a triangle
+            // containing both. Collapses across a seam have none and are skipped.
+            wedgeMap.clear();
+            bool ok = true;
+            size_t removed = 0;
+            for (uint32_t a = adjStart[c.from]; ok && a < adjStart[c.from + 1]; ++a) {
+                const size_t t = size_t(adj[a]) * 3;
+                uint32_t fromVertex = UINT32_MAX, toVertex = UINT32_MAX;
+                for (int k = 0; k < 3; ++k) {
+                    if (wid[idx[t + k]] == c.from) fromVertex = idx[t + k];
+                    if (wid[idx[t + k]] == c.to) toVertex = idx[t + k];
+                }
+                auto it = std::find_if(wedgeMap.begin(), wedgeMap.end(), [&](const auto& m) { return m.first == fromVertex; });
+                if (toVertex != UINT32_MAX) {
+                    ++removed;
+                    if (it == wedgeMap.end()) wedgeMap.push_back({ fromVertex, toVertex });
+                    else ok = it->second == toVertex;
+                }
+            }
+            for (uint32_t a = adjStart[c.from]; ok && a < adjStart[c.from + 1]; ++a) {
+                const size_t t = size_t(adj[a]) * 3;
+                int fromCorner = -1;
+                bool hasTo = false;
+                for (int k = 0; k < 3; ++k) {
+                    if (wid[idx[t + k]] == c.from) fromCorner = k;
+                    if (wid[idx[t + k]] == c.to) hasTo = true;
+                }
+                if (hasTo) continue;
+                ok = std::any_of(wedgeMap.begin(), wedgeMap.end(), [&](const auto& m) { return m.first == idx[t + fromCorner]; });
+
+                // Surviving triangles may not fold over
+                const glm::dvec3 p[3] = { pos(wid[idx[t]]), pos(wid[idx[t + 1]]), pos(wid[idx[t + 2]]) };
+                glm::dvec3 q[3] = { p[0], p[1], p[2] };
+                q[fromCorner] = pos(c.to);
+                const glm::dvec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                const glm::dvec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+                const double lb = glm::length(before), la = glm::length(after);
+                if (ok && lb > 0.0)
+                    ok = la > 0.0 && glm::dot(before, after) >= kMinNormalDot * lb * la;
+            }
+            if (!ok || wedgeMap.empty()) continue;
+
+            for (const auto& m : wedgeMap) remap[m.first] = m.second;
+            quadrics[c.to].add(quadrics[c.from]);
+            maxError = std::max(maxError, c.error);
+            triangles -= removed;
+            ++applied;
+            // Neighbors' triangles change under them; leave them for the next pass
+            touched[c.from] = touched[c.to] = 1;
+            for (uint32_t a = adjStart[c.from]; a < adjStart[c.from + 1]; ++a)
+                for (int k = 0; k < 3; ++k) touched[wid[idx[size_t(adj[a]) * 3 + k]]] = 1;
+        }
+        if (applied == 0) break;
+
+        // Rewrite, dropping triangles that collapsed
+        size_t out = 0;
+        for (size_t t = 0; t < idx.size(); t += 3) {
+            const uint32_t a = remap[idx[t]], b = remap[idx[t + 1]], c = remap[idx[t + 2]];
+            if (wid[a] == wid[b] || wid[b] == wid[c] || wid[a] == wid[c]) continue;
+            idx[out++] = a; idx[out++] = b; idx[out++] = c;
+        }
+        idx.resize(out);
+    }
+
+    std::copy(idx.begin(), idx.end(), destination);
+    if (resultError) *resultError = maxError;
+    return idx.size();
+}
+
+std::vector<Level> buildChain(const MeshArrays& mesh, int maxLevels)
+{
+    std::vector<Level> levels;
+    if (mesh.indexCount / 3 < kMinTriangles * 2 || !mesh.positions) return levels;
+
+    const float limit = kMaxRelativeError * glm::length(mesh.maxBound - mesh.minBound);
+    std::vector<uint32_t> source(mesh.indices, mesh.indices + mesh.indexCount);
+    float error = 0.0f;
+    for (int i = 0; i < maxLevels; ++i) {
+        const size_t target = size_t(float(source.size() / 3) * kLevelRatio) * 3;
+        if (target / 3 < kMinTriangles) break;
+        Level level;
+        level.indices.resize(source.size());
+        float levelError = 0.0f;
+        // Levels are simplified from the previous one, so errors add up
+        const size_t count = simplify(level.indices.data(), source.data(), source.size(),
+                                      mesh.positions, mesh.vertexCount, target, limit - error, &levelError);
+        // Not worth another index buffer when little was removed
+        if (count == 0 || count > source.size() * 4 / 5) break;
+        level.indices.resize(count);
+        error += levelError;
+        level.error = error;
+        source = level.indices;
+        levels.push_back(std::move(level));
+    }
+    return levels;
+}
+
+float pixelsPerUnit(const glm::mat4& projection, int viewportHeight)
+{
+    return 0.5f * float(std::max(viewportHeight, 1)) * std::abs(projection[1][1]);
+}
+
+int selectLevel(const float* errors, size_t count, float pixelScale, float thresholdPixels, int current)
+{
+    if (count == 0 || thresholdPixels <= 0.0f) return 0;
+    auto pixels = [&](int level) { return level == 0 ? 0.0f : errors[level - 1] * pixelScale; };
+
+    int level = std::clamp(current, 0, int(count));
+    // Refine at once when the current level shows
+    while (level > 0 && pixels(level) > thresholdPixels) --level;
+    if (level != current) return level;
+    // Coarsen only with margin
+    while (level < int(count) && pixels(level + 1) <= thresholdPixels * kHysteresis) ++level;
+    return level;
+}
+
+} // namespace MeshLod
@@ -0,0 +1,434 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <sstream>
+#include <glm/gtc/packing.hpp>
+
+namespace
+{
+    // Clusters smaller than this only split at hard cache boundaries
+    constexpr size_t kMinOverdrawCluster = 256;
+
+    inline uint64_t hashBytes(uint64_t h, const void* data, size_t size)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+        return h;
+    }
+
+    struct VertexKey
+    {
+        const MeshData& mesh;
+
+        uint64_t hash(size_t v) const
+        {
+            uint64_t h = 14695981039346656037ull;
+            h = hashBytes(h, &mesh.positions[v], sizeof(glm::vec3));
+            if (!mesh.normals.empty())  h = hashBytes(h, &mesh.normals[v], sizeof(glm::vec3));
+            if (!mesh.uvs.empty())      h = hashBytes(h, &mesh.uvs[v], sizeof(glm::vec2));
+            if (!mesh.tangents.empty()) h = hashBytes(h, &mesh.tangents[v], sizeof(glm::vec3));
+            return h;
+        }
+        bool equal(size_t a, size_t b) const
+        {
+            auto same = [](const auto& arr, size_t i, size_t j) {
+                return arr.empty() || std::memcmp(&arr[i], &arr[j], sizeof(arr[i])) == 0;
+            };
+            return same(mesh.positions, a, b) && same(mesh.normals, a, b) &&
+                   same(mesh.uvs, a, b) && same(mesh.tangents, a, b);
+        }
+    };
+
+    // Keep the entries of each attribute array selected by remap (old -> new)
+    template <typename T>
+    void applyRemap(std::vector<T>& arr, const std::vector<uint32_t>& remap, size_t newCount)
+    {
+        if (arr.empty()) return;
+        std::vector<T> out(newCount);
+        for (size_t i = 0; i < remap.size(); ++i)
+            if (remap[i] != UINT32_MAX) out[remap[i]] = arr[i];
+        arr.swap(out);
+    }
+
+    void remapMesh(MeshData& mesh, const std::vector<uint32_t>& remap, size_t newCount)
+    {
+        applyRemap(mesh.positions, remap, newCount);
+        applyRemap(mesh.normals, remap, newCount);
+        applyRemap(mesh.uvs, remap, newCount);
+        applyRemap(mesh.tangents, remap, newCount);
+        for (unsigned& i : mesh.indices) i = remap[i];
+    }
+
+    // FIFO cache misses for each triangle of indices
+    std::vector<uint8_t> simulateMisses(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+    {
+        std::vector<uint8_t> misses(indexCount / 3, 0);
+        std::vector<uint32_t> stamp(vertexCount, 0);
+        uint32_t time = cacheSize + 1;
+        for (size_t i = 0; i < indexCount; ++i) {
+            const uint32_t v = indices[i];
+            if (time - stamp[v] > cacheSize) {
+                stamp[v] = time++;
+                ++misses[i / 3];
+            }
+        }
+        return misses;
+    }
+
+    size_t layoutBytes(const MeshArrays& mesh, bool quantized, bool index16, bool halfTexcoords)
+    {
+        size_t bytes = mesh.vertexCount * (quantized ? 4 * sizeof(uint16_t) : sizeof(glm::vec3));
+        if (mesh.normals) bytes += mesh.vertexCount * (quantized ? 2 * sizeof(int16_t) : sizeof(glm::vec3));
+        if (mesh.texcoords) bytes += mesh.vertexCount * (halfTexcoords ? 2 * sizeof(uint16_t) : sizeof(glm::vec2));
+        bytes += mesh.indexCount * (index16 ? sizeof(uint16_t) : sizeof(uint32_t));
+        return bytes;
+    }
+
+    int16_t snorm16(float v) { return int16_t(std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f)); }
+}
+
+namespace MeshOptimizer {
+
+CacheStats analyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+{
+    CacheStats stats;
+    if (indexCount < 3 || vertexCount == 0) return stats;
+    const std::vector<uint8_t> misses = simulateMisses(indices, indexCount, vertexCount, cacheSize);
+    const size_t total = std::accumulate(misses.begin(), misses.end(), size_t(0));
+    stats.acmr = float(total) / float(indexCount / 3);
+    stats.atvr = float(total) / float(vertexCount);
+    return stats;
+}
+
+size_t dedupVertices(MeshData& mesh)
+{
+    const size_t n = mesh.positions.size();
+    if (n == 0) return 0;
+
+    // Open-addressed table of first occurrences
+    size_t tableSize = 1;
+    while (tableSize < n * 2) tableSize <<= 1;
+    std::vector<uint32_t> table(tableSize, UINT32_MAX);
+    std::vector<uint32_t> remap(n);     // vertex -> merged vertex
+    std::vector<uint32_t> keep(n, UINT32_MAX);   // first occurrences -> merged vertex
+    const VertexKey key{ mesh };
+    size_t unique = 0;
+    for (size_t v = 0; v < n; ++v) {
+        size_t slot = size_t(key.hash(v)) & (tableSize - 1);
+        while (table[slot] != UINT32_MAX && !key.equal(table[slot], v))
+            slot = (slot + 1) & (tableSize - 1);
+        if (table[slot] == UINT32_MAX) {
+            table[slot] = uint32_t(v);
+            keep[v] = remap[v] = uint32_t(unique++);
+        } else {
+            remap[v] = remap[table[slot]];
+        }
+    }
+    if (unique == n) return 0;
+
+    applyRemap(mesh.positions, keep, unique);
+    applyRemap(mesh.normals, keep, unique);
+    applyRemap(mesh.uvs, keep, unique);
+    applyRemap(mesh.tangents, keep, unique);
+    for (unsigned& i : mesh.indices) i = remap[i];
+    return n - unique;
+}
+
+void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+{
+    const size_t triCount = indexCount / 3;
+    if (triCount == 0 || vertexCount == 0) return;
+
+    // Triangles around each vertex
+    std::vector<uint32_t> live(vertexCount, 0);
+    for (size_t i = 0; i < triCount * 3; ++i) ++live[indices[i]];
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + live[v];
+    std::vector<uint32_t> adjacency(offsets.back());
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < triCount * 3; ++i) adjacency[fill[indices[i]]++] = uint32_t(i / 3);
+    }
+
+    std::vector<uint32_t> stamp(vertexCount, 0);
+    std::vector<uint8_t> emitted(triCount, 0);
+    std::vector<uint32_t> deadEnd, candidates;
+    std::vector<uint32_t> out;
+    out.reserve(triCount * 3);
+    uint32_t time = cacheSize + 1;
+    size_t cursor = 0;
+
+    auto skipDeadEnd = [&]() -> int64_t {
+        while (!deadEnd.empty()) {
+            const uint32_t d = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[d] > 0) return d;
+        }
+        for (; cursor < vertexCount; ++cursor)
+            if (live[cursor] > 0) return int64_t(cursor);
+        return -1;
+    };
+
+    int64_t fan = skipDeadEnd();
+    while (fan >= 0) {
+        // Emit every remaining triangle around the fanning vertex
+        candidates.clear();
+        for (uint32_t a = offsets[fan]; a < offsets[fan + 1]; ++a) {
+            const uint32_t t = adjacency[a];
+            if (emitted[t]) continue;
+            emitted[t] = 1;
+            for (int k = 0; k < 3; ++k) {
+                const uint32_t v = indices[3 * t + k];
+                out.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                if (time - stamp[v] > cacheSize) stamp[v] = time++;
+            }
+        }
+
+        // Next fan: the candidate that stays in cache longest while it is
+        // still used, so its remaining triangles hit
+        int64_t best = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t v : candidates) {
+            if (live[v] == 0) continue;
+            int64_t priority = 0;
+            if (int64_t(time) - stamp[v] + 2 * int64_t(live[v]) <= int64_t(cacheSize))
+                priority = int64_t(time) - stamp[v];
+            if (priority > bestPriority) { bestPriority = priority; best = v; }
+        }
+        fan = best >= 0 ? best : skipDeadEnd();
+    }
+    std::copy(out.begin(), out.end(), indices);
+}
+
+void optimizeOverdraw(uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t vertexCount,
+                      float threshold, uint32_t cacheSize)
+{
+    const size_t triCount = indexCount / 3;
+    if (triCount < 2 || vertexCount == 0) return;
+
+    // Split into clusters where the cache restarts anyway: a triangle that
+    // misses on every vertex, or on two once the cluster is large enough
+    const std::vector<uint8_t> misses = simulateMisses(indices, indexCount, vertexCount, cacheSize);
+    std::vector<size_t> starts;
+    for (size_t t = 0; t < triCount; ++t) {
+        const size_t clusterSize = starts.empty() ? 0 : t - starts.back();
+        if (starts.empty() || misses[t] == 3 || (misses[t] >= 2 && clusterSize >= kMinOverdrawCluster))
+            starts.push_back(t);
+    }
+    if (starts.size() < 2) return;
+    starts.push_back(triCount);
+
+    // Mesh centroid, area weighted
+    glm::dvec3 meshCenter(0.0);
+    double meshArea = 0.0;
+    std::vector<float> keys(starts.size() - 1);
+    std::vector<glm::dvec3> centers(keys.size()), normals(keys.size());
+    for (size_t c = 0; c + 1 < starts.size(); ++c) {
+        glm::dvec3 center(0.0), normal(0.0);
+        double area = 0.0;
+        for (size_t t = starts[c]; t < starts[c + 1]; ++t) {
+            const glm::dvec3 a = positions[indices[3 * t + 0]];
+            const glm::dvec3 b = positions[indices[3 * t + 1]];
+            const glm::dvec3 d = positions[indices[3 * t + 2]];
+            const glm::dvec3 n = glm::cross(b - a, d - a);
+            const double w = glm::length(n) * 0.5;
+            center += (a + b + d) * (w / 3.0);
+            normal += n;
+            area += w;
+        }
+        meshCenter += center;
+        meshArea += area;
+        centers[c] = area > 0.0 ? center / area : center;
+        normals[c] = normal;
+    }
+    if (meshArea > 0.0) meshCenter /= meshArea;
+
+    // Clusters far out along their own facing are likely occluders: draw first
+    for (size_t c = 0; c < keys.size(); ++c) {
+        const double len = glm::length(normals[c]);
+        keys[c] = len > 0.0 ? float(glm::dot(centers[c] - meshCenter, normals[c] / len)) : 0.0f;
+    }
+    std::vector<uint32_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+    std::vector<uint32_t> sorted;
+    sorted.reserve(triCount * 3);
+    for (uint32_t c : order)
+        sorted.insert(sorted.end(), indices + 3 * starts[c], indices + 3 * starts[c + 1]);
+
+    const float before = analyzeVertexCache(indices, triCount * 3, vertexCount, cacheSize).acmr;
+    const float after = analyzeVertexCache(sorted.data(), sorted.size(), vertexCount, cacheSize).acmr;
+    if (after <= before * threshold)
+        std::copy(sorted.begin(), sorted.end(), indices);
+}
+
+void optimizeVertexFetch(MeshData& mesh)
+{
+    std::vector<uint32_t> remap(mesh.positions.size(), UINT32_MAX);
+    uint32_t next = 0;
+    for (unsigned i : mesh.indices)
+        if (remap[i] == UINT32_MAX) remap[i] = next++;
+    remapMesh(mesh, remap, next);
+}
+
+GpuLayout gpuLayout(const MeshArrays& mesh, bool compact)
+{
+    GpuLayout layout;
+    if (compact) {
+        layout.quantized = true;
+        layout.index16 = mesh.vertexCount > 0 && mesh.vertexCount <= 65536;
+        layout.halfTexcoords = mesh.texcoords != nullptr;
+        for (size_t i = 0; layout.halfTexcoords && i < mesh.vertexCount; ++i) {
+            const glm::vec2 uv = mesh.texcoords[i];
+            const glm::vec2 back = glm::unpackHalf2x16(glm::packHalf2x16(uv));
+            layout.halfTexcoords = std::abs(back.x - uv.x) <= kHalfTexcoordTolerance &&
+                                   std::abs(back.y - uv.y) <= kHalfTexcoordTolerance;
+        }
+    }
+    layout.bytes = layoutBytes(mesh, layout.quantized, layout.index16, layout.halfTexcoords);
+    return layout;
+}
+
+std::vector<uint16_t> packIndices16(const unsigned int* indices, size_t count)
+{
+    return std::vector<uint16_t>(indices, indices + count);
+}
+
+std::vector<uint16_t> packHalfTexcoords(const glm::vec2* texcoords, size_t count)
+{
+    std::vector<uint16_t> out(count * 2);
+    for (size_t i = 0; i < count; ++i) {
+        out[2 * i + 0] = glm::packHalf1x16(texcoords[i].x);
+        out[2 * i + 1] = glm::packHalf1x16(texcoords[i].y);
+    }
+    return out;
+}
+
+glm::vec2 octEncode(const glm::vec3& n)
+{
+    const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (l1 == 0.0f) return glm::vec2(0.0f);
+    glm::vec2 e = glm::vec2(n.x, n.y) / l1;
+    if (n.z < 0.0f) {
+        const glm::vec2 s(e.x >= 0.0f ? 1.0f : -1.0f, e.y >= 0.0f ? 1.0f : -1.0f);
+        e = (glm::vec2(1.0f) - glm::abs(glm::vec2(e.y, e.x))) * s;
+    }
+    return e;
+}
+
+glm::vec3 octDecode(const glm::vec2& e)
+{
+    glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+    const float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+glm::mat4 QuantizedMesh::dequantize() const
+{
+    glm::mat4 m(positionScale);
+    m[3] = glm::vec4(positionOffset, 1.0f);
+    return m;
+}
+
+QuantizedMesh quantize(const MeshArrays& mesh)
+{
+    QuantizedMesh q;
+    const size_t n = mesh.vertexCount;
+
+    glm::vec3 lo(0.0f), hi(0.0f);
+    if (n > 0) {
+        lo = hi = mesh.positions[0];
+        for (size_t i = 1; i < n; ++i) { lo = glm::min(lo, mesh.positions[i]); hi = glm::max(hi, mesh.positions[i]); }
+    }
+    // One scale for all axes keeps dequantize() free of shear; a mesh that
+    // collapses to a point keeps scale 1 so the matrix stays invertible
+    const float extent = std::max(hi.x - lo.x, std::max(hi.y - lo.y, hi.z - lo.z));
+    q.positionOffset = lo;
+    q.positionScale = extent > 0.0f ? extent : 1.0f;
+    q.positions.resize(n * 4, 0);
+    for (size_t i = 0; i < n; ++i)
+        for (int c = 0; c < 3; ++c) {
+            const float t = (mesh.positions[i][c] - lo[c]) / q.positionScale * 65535.0f;
+            q.positions[4 * i + c] = uint16_t(std::lround(std::clamp(t, 0.0f, 65535.0f)));
+        }
+
+    if (mesh.normals) {
+        q.normals.resize(n * 2);
+        for (size_t i = 0; i < n; ++i) {
+            const glm::vec2 e = octEncode(mesh.normals[i]);
+            q.normals[2 * i + 0] = snorm16(e.x);
+            q.normals[2 * i + 1] = snorm16(e.y);
+        }
+    }
+    return q;
+}
+
+Report optimize(MeshData& mesh)
+{
+    Report r;
+    r.verticesBefore = mesh.positions.size();
+    r.before = analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.positions.size());
+    r.bytesBefore = gpuLayout(arraysOf(mesh), false).bytes;
+
+    dedupVertices(mesh);
+    optimizeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.positions.size());
+    optimizeOverdraw(mesh.indices.data(), mesh.indices.size(), mesh.positions.data(), mesh.positions.size());
+    optimizeVertexFetch(mesh);
+
+    const MeshArrays after = arraysOf(mesh);
+    r.verticesAfter = mesh.positions.size();
+    r.after = analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.positions.size());
+    r.bytesAfter = gpuLayout(after).bytes;
+    return r;
+}
+
+std::string describe(const Report& r)
+{
+    std::ostringstream s;
+    s.setf(std::ios::fixed);
+    s.precision(3);
+    s << r.verticesBefore << " -> " << r.verticesAfter << " vertices, ACMR " << r.before.acmr << " -> " << r.after.acmr
+      << ", ATVR " << r.before.atvr << " -> " << r.after.atvr;
+    s.precision(2);
+    s << ", " << r.bytesBefore / 1024.0 << " KB -> " << r.bytesAfter / 1024.0 << " KB uploaded";
+    return s.str();
+}
+
+MeshData toMeshData(const MeshArrays& a)
+{
+    MeshData m;
+    m.positions.assign(a.positions, a.positions + a.vertexCount);
+    if (a.normals) m.normals.assign(a.normals, a.normals + a.vertexCount);
+    if (a.texcoords) m.uvs.assign(a.texcoords, a.texcoords + a.vertexCount);
+    if (a.tangents) m.tangents.assign(a.tangents, a.tangents + a.vertexCount);
+    m.indices.assign(a.indices, a.indices + a.indexCount);
+    m.minBound = a.minBound;
+    m.maxBound = a.maxBound;
+    return m;
+}
+
+MeshArrays arraysOf(const MeshData& m)
+{
+    MeshArrays a;
+    a.positions = m.positions.data();
+    a.normals = m.normals.empty() ? nullptr : m.normals.data();
+    a.texcoords = m.uvs.empty() ? nullptr : m.uvs.data();
+    a.tangents = m.tangents.empty() ? nullptr : m.tangents.data();
+    a.vertexCount = m.positions.size();
+    a.indices = m.indices.data();
+    a.indexCount = m.indices.size();
+    a.minBound = m.minBound;
+    a.maxBound = m.maxBound;
+    return a;
+}
+
+} // namespace MeshOptimizer
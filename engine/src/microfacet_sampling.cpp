@@ -26,12 +26,16 @@ namespace microfacet
 {
     glm::vec3 sampleBeckmannNormal(const glm::vec3& normal, float roughness, SeededRNG& rng)
     {
-        // Clamp roughness to avoid singularities
-        const float alpha = std::max(0.001f, roughness * roughness);
-        
         // Generate two uniform random numbers
         const float u1 = rng.uniform();
         const float u2 = rng.uniform();
+        return sampleBeckmannNormal(normal, roughness, u1, u2);
+    }
+
+    glm::vec3 sampleBeckmannNormal(const glm::vec3& normal, float roughness, float u1, float u2)
+    {
+        // Clamp roughness to avoid singularities
+        const float alpha = std::max(0.001f, roughness * roughness);
         
         // Sample Beckmann distribution in spherical coordinates
         // theta is the angle from the normal (polar angle)
@@ -68,39 +72,16 @@ namespace microfacet
     {
         std::vector<glm::vec3> samples;
         samples.reserve(sampleCount);
-        
-        // Clamp roughness to avoid singularities
-        const float alpha = std::max(0.001f, roughness * roughness);
-        
-        // Create orthonormal basis around the surface normal
-        glm::vec3 tangent, bitangent;
-        createOrthonormalBasis(normal, tangent, bitangent);
-        
-        // Generate stratified samples
+
+        // Owen-scrambled 2D Sobol points are stratified in both dimensions
+        // jointly, unlike independently jittered 1D strata
+        const uint32_t seed = static_cast<uint32_t>(rng.uniform() * 4294967040.0f);
         for (int i = 0; i < sampleCount; ++i) {
-            // Stratified sampling with jitter
-            const float jitter1 = rng.uniform();
-            const float jitter2 = rng.uniform();
-            
-            const float u1 = rng.stratified(i, sampleCount, jitter1);
-            const float u2 = rng.stratified(i, sampleCount, jitter2);
-            
-            // Sample Beckmann distribution
-            const float tan2Theta = -alpha * alpha * std::log(std::max(1e-6f, u1));
-            const float cosTheta = 1.0f / std::sqrt(1.0f + tan2Theta);
-            const float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
-            
-            const float phi = 2.0f * PI * u2;
-            const float cosPhi = std::cos(phi);
-            const float sinPhi = std::sin(phi);
-            
-            // Convert to Cartesian coordinates in tangent space
-            const glm::vec3 microfacetTangent(sinTheta * cosPhi, sinTheta * sinPhi, cosTheta);
-            
-            // Transform to world space and add to samples
-            samples.push_back(glm::normalize(tangentToWorld(microfacetTangent, normal, tangent, bitangent)));
+            float u[4];
+            sampling::scrambledSobol4D(static_cast<uint32_t>(i), seed, u);
+            samples.push_back(sampleBeckmannNormal(normal, roughness, u[0], u[1]));
         }
-        
+
         return samples;
     }
 }
\ No newline at end of file
@@ -0,0 +1,411 @@
+#include "obj_reader.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+    // Position, texcoord and normal index of a triangle corner
+    struct Corner
+    {
+        uint32_t v, vt, vn;
+    };
+
+    struct Chunk
+    {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texcoords;
+        std::vector<glm::vec3> normals;
+        std::vector<Corner> corners;          // 3 per triangle
+        // Components written from negative OBJ indices, as corner * 3 + {0: v, 1: vt, 2: vn};
+        // they hold an index relative to this chunk until the merge adds its offset
+        std::vector<uint64_t> relative;
+        bool allTexcoords = true;
+        bool allNormals = true;
+        glm::vec3 minBound{ std::numeric_limits<float>::max() };
+        glm::vec3 maxBound{ std::numeric_limits<float>::lowest() };
+
+        const char* errorAt = nullptr;         // first malformed statement
+        const char* errorWhat = nullptr;
+    };
+
+    inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    inline const char* skipBlanks(const char* p, const char* end)
+    {
+        while (p < end && isBlank(*p)) ++p;
+        return p;
+    }
+
+    inline bool parseFloat(const char*& p, const char* end, float& value)
+    {
+        p = skipBlanks(p, end);
+        if (p < end && *p == '+') ++p;    // from_chars takes no leading plus
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        const std::from_chars_result r = std::from_chars(p, end, value);
+        if (r.ec != std::errc()) return false;
+        p = r.ptr;
+        return true;
+#else
+        // Standard libraries without floating-point from_chars: strtof on a
+        // terminated copy of the token, since the mapping is not terminated
+        char token[64];
+        size_t n = 0;
+        while (p + n < end && n + 1 < sizeof(token) && !isBlank(p[n]) && p[n] != '\n') { token[n] = p[n]; ++n; }
+        token[n] = '\0';
+        char* tokenEnd = nullptr;
+        value = std::strtof(token, &tokenEnd);
+        if (tokenEnd == token) return false;
+        p += tokenEnd - token;
+        return true;
+#endif
+    }
+
+    inline bool parseIndex(const char*& p, const char* end, long long& value)
+    {
+        if (p < end && *p == '+') ++p;
+        const std::from_chars_result r = std::from_chars(p, end, value);
+        if (r.ec != std::errc()) return false;
+        p = r.ptr;
+        return true;
+    }
+
+    // OBJ indices are 1-based, or negative to count back from the latest
+    // element; the latter are stored relative to the chunk and fixed up later
+    inline bool resolveIndex(long long index, size_t chunkCount, uint32_t& out, bool& relative)
+    {
+        if (index > 0 && index <= static_cast<long long>(kNone))
+        {
+            out = static_cast<uint32_t>(index - 1);
+            relative = false;
+            return true;
+        }
+        if (index < 0)
+        {
+            out = static_cast<uint32_t>(static_cast<long long>(chunkCount) + index);   // wraps below the chunk
+            relative = true;
+            return true;
+        }
+        return false;
+    }
+
+    // One face statement: corners up to the end of the line, fanned into triangles
+    bool parseFace(Chunk& chunk, const char* p, const char* end)
+    {
+        Corner polygon[3];
+        unsigned polygonRelative[3] = { 0, 0, 0 };
+        size_t count = 0;
+        for (;;)
+        {
+            p = skipBlanks(p, end);
+            if (p == end || *p == '#') break;
+
+            Corner c{ 0, kNone, kNone };
+            unsigned rel = 0;
+            bool isRelative = false, hasTexcoord = false, hasNormal = false;
+            long long index = 0;
+            if (!parseIndex(p, end, index) || !resolveIndex(index, chunk.positions.size(), c.v, isRelative))
+                return false;
+            rel |= isRelative ? 1u : 0u;
+            if (p < end && *p == '/')
+            {
+                ++p;
+                if (p < end && *p != '/')
+                {
+                    if (!parseIndex(p, end, index) || !resolveIndex(index, chunk.texcoords.size(), c.vt, isRelative))
+                        return false;
+                    rel |= isRelative ? 2u : 0u;
+                    hasTexcoord = true;
+                }
+                if (p < end && *p == '/')
+                {
+                    ++p;
+                    if (!parseIndex(p, end, index) || !resolveIndex(index, chunk.normals.size(), c.vn, isRelative))
+                        return false;
+                    rel |= isRelative ? 4u : 0u;
+                    hasNormal = true;
+                }
+            }
+            if (p < end && !isBlank(*p)) return false;
+
+            // Relative indices may still wrap to any value, so presence is tracked apart
+            chunk.allTexcoords = chunk.allTexcoords && hasTexcoord;
+            chunk.allNormals = chunk.allNormals && hasNormal;
+
+            // Fan around the first corner: (0, i - 1, i)
+            if (count < 2)
+            {
+                polygon[count] = c;
+                polygonRelative[count] = rel;
+            }
+            else
+            {
+                polygon[2] = c;
+                polygonRelative[2] = rel;
+                for (int k = 0; k < 3; ++k)
+                {
+                    const uint64_t slot = static_cast<uint64_t>(chunk.corners.size()) * 3;
+                    for (unsigned component = 0; component < 3; ++component)
+                        if (polygonRelative[k] & (1u << component))
+                            chunk.relative.push_back(slot + component);
+                    chunk.corners.push_back(polygon[k]);
+                }
+                polygon[1] = polygon[2];
+                polygonRelative[1] = polygonRelative[2];
+            }
+            ++count;
+        }
+        return true;
+    }
+
+    void parseChunk(Chunk& chunk)
+    {
+        const char* p = chunk.begin;
+        while (p < chunk.end)
+        {
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+            if (!lineEnd) lineEnd = chunk.end;
+            const char* s = skipBlanks(p, lineEnd);
+
+            bool ok = true;
+            if (lineEnd - s >= 2 && s[0] == 'v')
+            {
+                if (isBlank(s[1]))
+                {
+                    glm::vec3 v;
+                    const char* q = s + 1;
+                    ok = parseFloat(q, lineEnd, v.x) && parseFloat(q, lineEnd, v.y) && parseFloat(q, lineEnd, v.z);
+                    if (ok)
+                    {
+                        chunk.positions.push_back(v);
+                        chunk.minBound = glm::min(chunk.minBound, v);
+                        chunk.maxBound = glm::max(chunk.maxBound, v);
+                    }
+                }
+                else if (s[1] == 't' && lineEnd - s >= 3 && isBlank(s[2]))
+                {
+                    glm::vec2 uv(0.0f);
+                    const char* q = s + 2;
+                    ok = parseFloat(q, lineEnd, uv.x);
+                    if (ok) parseFloat(q, lineEnd, uv.y);   // v is optional
+                    if (ok) chunk.texcoords.push_back(uv);
+                }
+                else if (s[1] == 'n' && lineEnd - s >= 3 && isBlank(s[2]))
+                {
+                    glm::vec3 n;
+                    const char* q = s + 2;
+                    ok = parseFloat(q, lineEnd, n.x) && parseFloat(q, lineEnd, n.y) && parseFloat(q, lineEnd, n.z);
+                    if (ok) chunk.normals.push_back(n);
+                }
+            }
+            else if (lineEnd - s >= 2 && s[0] == 'f' && isBlank(s[1]))
+            {
+                ok = parseFace(chunk, s + 1, lineEnd);
+            }
+
+            if (!ok && !chunk.errorAt)
+            {
+                chunk.errorAt = s;
+                chunk.errorWhat = s[0] == 'f' ? "malformed face" : "malformed vertex data";
+            }
+            p = lineEnd + 1;
+        }
+    }
+
+    // Chunk boundaries just past a newline, so no statement is split
+    std::vector<Chunk> splitChunks(const char* data, size_t size, size_t chunkBytes, unsigned workers)
+    {
+        const size_t wanted = std::max<size_t>(1, std::min<size_t>(size / std::max<size_t>(1, chunkBytes), size_t(workers) * 4));
+        std::vector<Chunk> chunks;
+        chunks.reserve(wanted);
+        const char* end = data + size;
+        const char* begin = data;
+        for (size_t i = 1; i <= wanted && begin < end; ++i)
+        {
+            const char* cut = end;
+            if (i < wanted)
+            {
+                cut = std::max(data + size / wanted * i, begin);
+                const char* newline = static_cast<const char*>(std::memchr(cut, '\n', end - cut));
+                cut = newline ? newline + 1 : end;
+            }
+            if (cut == begin) continue;
+            Chunk chunk;
+            chunk.begin = begin;
+            chunk.end = cut;
+            chunks.push_back(std::move(chunk));
+            begin = cut;
+        }
+        return chunks;
+    }
+
+    bool fail(std::string* error, const std::string& message)
+    {
+        if (error) *error = message;
+        return false;
+    }
+}
+
+namespace ObjReader {
+
+bool parseFile(const std::string& path, Mesh& out, std::string* error, Stats* stats)
+{
+    MappedFile file;
+    if (!file.open(path))
+        return fail(error, "cannot open " + path);
+    return parseBuffer(file.data(), file.size(), out, error, stats);
+}
+
+bool parseBuffer(const char* data, size_t size, Mesh& out, std::string* error, Stats* stats, size_t chunkBytes)
+{
+    const auto start = std::chrono::steady_clock::now();
+    out = Mesh{};
+
+    ThreadPool& pool = ThreadPool::shared();
+    std::vector<Chunk> chunks = size ? splitChunks(data, size, chunkBytes, pool.workerCount()) : std::vector<Chunk>{};
+    const uint32_t chunkCount = static_cast<uint32_t>(chunks.size());
+    pool.run(chunkCount, [&](uint32_t i, unsigned) { parseChunk(chunks[i]); });
+
+    for (const Chunk& chunk : chunks)
+    {
+        if (chunk.errorAt)
+            return fail(error, std::string(chunk.errorWhat) + " at byte " + std::to_string(chunk.errorAt - data));
+    }
+
+    // Where each chunk's elements start in the merged arrays
+    struct Offsets { size_t v = 0, vt = 0, vn = 0, corner = 0; };
+    std::vector<Offsets> offsets(chunks.size() + 1);
+    bool useTexcoords = true, useNormals = true;
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        offsets[i + 1].v = offsets[i].v + chunks[i].positions.size();
+        offsets[i + 1].vt = offsets[i].vt + chunks[i].texcoords.size();
+        offsets[i + 1].vn = offsets[i].vn + chunks[i].normals.size();
+        offsets[i + 1].corner = offsets[i].corner + chunks[i].corners.size();
+        useTexcoords = useTexcoords && chunks[i].allTexcoords;
+        useNormals = useNormals && chunks[i].allNormals;
+        if (!chunks[i].positions.empty())
+        {
+            out.minBound = offsets[i].v == 0 ? chunks[i].minBound : glm::min(out.minBound, chunks[i].minBound);
+            out.maxBound = offsets[i].v == 0 ? chunks[i].maxBound : glm::max(out.maxBound, chunks[i].maxBound);
+        }
+    }
+    const Offsets& total = offsets.back();
+    if (total.v > kNone || total.corner / 3 > kNone / 3)
+        return fail(error, "mesh too large for 32-bit indices");
+    useTexcoords = useTexcoords && total.corner > 0;
+    useNormals = useNormals && total.corner > 0;
+
+    // Gather vertex data and make relative indices absolute, chunk by chunk
+    std::vector<glm::vec3> positions(total.v);
+    std::vector<glm::vec2> texcoords(useTexcoords ? total.vt : 0);
+    std::vector<glm::vec3> normals(useNormals ? total.vn : 0);
+    std::vector<char> badIndex(chunks.size(), 0);
+    pool.run(chunkCount, [&](uint32_t i, unsigned) {
+        Chunk& chunk = chunks[i];
+        const Offsets& o = offsets[i];
+        std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + o.v);
+        if (useTexcoords) std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), texcoords.begin() + o.vt);
+        if (useNormals) std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + o.vn);
+        chunk.positions = {};
+        chunk.texcoords = {};
+        chunk.normals = {};
+
+        const uint32_t base[3] = { static_cast<uint32_t>(o.v), static_cast<uint32_t>(o.vt), static_cast<uint32_t>(o.vn) };
+        for (uint64_t slot : chunk.relative)
+        {
+            Corner& c = chunk.corners[slot / 3];
+            uint32_t& index = slot % 3 == 0 ? c.v : slot % 3 == 1 ? c.vt : c.vn;
+            index += base[slot % 3];
+        }
+        for (const Corner& c : chunk.corners)
+        {
+            if (c.v >= total.v || (useTexcoords && c.vt >= total.vt) || (useNormals && c.vn >= total.vn))
+            {
+                badIndex[i] = 1;
+                break;
+            }
+        }
+    });
+    if (std::find(badIndex.begin(), badIndex.end(), 1) != badIndex.end())
+        return fail(error, "face references a vertex that does not exist");
+
+    out.indices.resize(total.corner);
+    if (!useTexcoords && !useNormals)
+    {
+        // Output vertices are the OBJ positions themselves
+        pool.run(chunkCount, [&](uint32_t i, unsigned) {
+            uint32_t* dst = out.indices.data() + offsets[i].corner;
+            for (const Corner& c : chunks[i].corners) *dst++ = c.v;
+            chunks[i].corners = {};
+        });
+        out.positions = std::move(positions);
+    }
+    else
+    {
+        // One output vertex per distinct (v, vt, vn): vertices sharing a
+        // position are chained from it, and the chains are short
+        const uint32_t vtMask = useTexcoords ? kNone : 0;
+        const uint32_t vnMask = useNormals ? kNone : 0;
+        std::vector<uint32_t> first(total.v, kNone);
+        std::vector<uint32_t> next;
+        std::vector<Corner> vertices;
+        size_t n = 0;
+        for (Chunk& chunk : chunks)
+        {
+            for (const Corner& c : chunk.corners)
+            {
+                const uint32_t vt = c.vt & vtMask, vn = c.vn & vnMask;
+                uint32_t u = first[c.v];
+                while (u != kNone && (vertices[u].vt != vt || vertices[u].vn != vn))
+                    u = next[u];
+                if (u == kNone)
+                {
+                    u = static_cast<uint32_t>(vertices.size());
+                    vertices.push_back({ c.v, vt, vn });
+                    next.push_back(first[c.v]);
+                    first[c.v] = u;
+                }
+                out.indices[n++] = u;
+            }
+            chunk.corners = {};
+        }
+
+        out.positions.resize(vertices.size());
+        out.sourcePositions.resize(vertices.size());
+        if (useTexcoords) out.texcoords.resize(vertices.size());
+        if (useNormals) out.normals.resize(vertices.size());
+        bool identity = vertices.size() == positions.size();
+        for (size_t u = 0; u < vertices.size(); ++u)
+        {
+            const Corner& c = vertices[u];
+            out.positions[u] = positions[c.v];
+            out.sourcePositions[u] = c.v;
+            if (useTexcoords) out.texcoords[u] = texcoords[c.vt];
+            if (useNormals) out.normals[u] = normals[c.vn];
+            identity = identity && c.v == u;
+        }
+        if (identity) out.sourcePositions.clear();
+    }
+
+    if (stats)
+    {
+        stats->bytes = size;
+        stats->chunks = chunks.size();
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return true;
+}
+
+} // namespace ObjReader
@@ -1,77 +1,98 @@
 ﻿#include "objloader.h"
 
 #include <iostream>
-#include <fstream>
-#include <sstream>
+#include <cstring>
 #include <limits>
+#include <algorithm>
 #include "path_utils.h"
+#include "obj_reader.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/component_wise.hpp>   // glm::min / glm::max
 
 ObjLoader::ObjLoader()
-    : minBound(std::numeric_limits<float>::max()),
-      maxBound(std::numeric_limits<float>::lowest()),
-      m_normalsProvidedFromSource(false)
+    : m_data(std::make_shared<Data>())
 {}
 
+const ObjLoader::Data& ObjLoader::data() const
+{
+    // A moved-from loader reads as empty
+    static const Data empty;
+    return m_data ? *m_data : empty;
+}
+
+ObjLoader::Data& ObjLoader::edit()
+{
+    if (!m_data)
+        m_data = std::make_shared<Data>();
+    else if (m_data.use_count() > 1)
+        m_data = std::make_shared<Data>(*m_data);
+    return *m_data;
+}
+
 void ObjLoader::load(const char* filename)
 {
     // Resolve asset path
     std::string resolvedPath = PathUtils::resolveAssetPath(filename);
 
-    std::ifstream file(resolvedPath);
-    if (!file.is_open())
+    ObjReader::Mesh mesh;
+    ObjReader::Stats stats;
+    std::string error;
+    if (!ObjReader::parseFile(resolvedPath, mesh, &error, &stats))
     {
-        std::cerr << "[ObjLoader] cannot open " << filename << '\n';
+        std::cerr << "[ObjLoader] cannot load " << filename << ": " << error << '\n';
         return;
     }
+    std::cout << "[ObjLoader] Parsed " << filename << ": " << stats.bytes / (1024.0 * 1024.0) << " MB in "
+              << stats.seconds * 1000.0 << " ms (" << stats.megabytesPerSecond() << " MB/s, "
+              << stats.chunks << (stats.chunks == 1 ? " chunk)\n" : " chunks)\n");
 
-    Positions.clear();
-    Faces.clear();
-    Normals.clear();
+    setFromParsed(std::move(mesh));
+}
 
-    std::string line;
-    while (std::getline(file, line))
-    {
-        std::istringstream ss(line);
-        std::string type;  ss >> type;
+void ObjLoader::setFromParsed(ObjReader::Mesh&& mesh)
+{
+    // Replaces everything, so other copies keep the old arrays untouched
+    m_data = std::make_shared<Data>();
+    Data& d = *m_data;
 
-        if (type == "v")                               // vertex
-        {
-            glm::vec3 v;  ss >> v.x >> v.y >> v.z;
-            Positions.push_back(v);
+    d.Positions = std::move(mesh.positions);
+    d.Normals = std::move(mesh.normals);
+    d.Texcoords = std::move(mesh.texcoords);
+    d.Faces.resize(mesh.indices.size() / 3);
+    for (size_t i = 0; i < d.Faces.size(); ++i)
+        d.Faces[i] = { mesh.indices[3 * i + 0], mesh.indices[3 * i + 1], mesh.indices[3 * i + 2] };
+    mesh.indices = {};
+    d.minBound = mesh.minBound;
+    d.maxBound = mesh.maxBound;
 
-            minBound = glm::min(minBound, v);
-            maxBound = glm::max(maxBound, v);
+    d.normalsProvidedFromSource = !d.Normals.empty();
+    if (!d.normalsProvidedFromSource)
+    {
+        if (mesh.sourcePositions.empty())
+        {
+            computeNormals(d);
         }
-        else if (type == "f")                          // face
+        else
         {
-            Face f;
-            std::string v1, v2, v3;
-            ss >> v1 >> v2 >> v3;
-            
-            // Parse vertex indices (handle v, v/vt, or v/vt/vn format)
-            auto parseVertexIndex = [](const std::string& s) -> unsigned {
-                size_t slash = s.find('/');
-                if (slash != std::string::npos) {
-                    return std::stoul(s.substr(0, slash));
-                }
-                return std::stoul(s);
-            };
-            
-            f.a = parseVertexIndex(v1);
-            f.b = parseVertexIndex(v2);
-            f.c = parseVertexIndex(v3);
-            
-            --f.a; --f.b; --f.c;                      // OBJ is 1-based
-            Faces.push_back(f);
+            // Vertices split only by texture coordinates share the normal of
+            // the OBJ vertex they came from, so UV seams stay smooth
+            const uint32_t sourceCount = *std::max_element(mesh.sourcePositions.begin(), mesh.sourcePositions.end()) + 1;
+            std::vector<glm::vec3> welded(sourceCount, glm::vec3(0.0f));
+            for (const Face& f : d.Faces)
+            {
+                const glm::vec3 n = glm::normalize(glm::cross(d.Positions[f.b] - d.Positions[f.a], d.Positions[f.c] - d.Positions[f.a]));
+                welded[mesh.sourcePositions[f.a]] += n;
+                welded[mesh.sourcePositions[f.b]] += n;
+                welded[mesh.sourcePositions[f.c]] += n;
+            }
+            d.Normals.resize(d.Positions.size());
+            for (size_t i = 0; i < d.Normals.size(); ++i)
+                d.Normals[i] = glm::normalize(welded[mesh.sourcePositions[i]]);
         }
     }
-    file.close();
-
-    m_normalsProvidedFromSource = false; // no VN parsed by this loader
-    computeNormals();
+    if (!d.Texcoords.empty())
+        computeTangents(d);
 }
 
 void ObjLoader::setFromRaw(const std::vector<glm::vec3>& positions,
@@ -80,82 +101,111 @@ void ObjLoader::setFromRaw(const std::vector<glm::vec3>& positions,
                            const std::vector<glm::vec2>& uvs,
                            const std::vector<glm::vec3>& tangents)
 {
-    Positions = positions;
-    Faces.clear();
-    Faces.reserve(indices.size() / 3);
+    m_data = std::make_shared<Data>();
+    Data& d = *m_data;
+
+    d.Positions = positions;
+    d.Faces.reserve(indices.size() / 3);
     for (size_t i = 0; i + 2 < indices.size(); i += 3)
     {
         Face f{ indices[i + 0], indices[i + 1], indices[i + 2] };
-        Faces.push_back(f);
+        d.Faces.push_back(f);
     }
 
     // Bounds
-    minBound = glm::vec3(std::numeric_limits<float>::max());
-    maxBound = glm::vec3(std::numeric_limits<float>::lowest());
-    for (const auto& v : Positions)
+    for (const auto& v : d.Positions)
     {
-        minBound = glm::min(minBound, v);
-        maxBound = glm::max(maxBound, v);
+        d.minBound = glm::min(d.minBound, v);
+        d.maxBound = glm::max(d.maxBound, v);
     }
 
     // Normals
-    if (!normals.empty() && normals.size() == Positions.size())
+    if (!normals.empty() && normals.size() == d.Positions.size())
     {
-        Normals = normals;
-        m_normalsProvidedFromSource = true;
+        d.Normals = normals;
+        d.normalsProvidedFromSource = true;
     }
     else
     {
-        computeNormals();
-        m_normalsProvidedFromSource = false;
+        computeNormals(d);
     }
 
     // UVs and tangents
-    Texcoords = uvs;
-    if (!tangents.empty() && tangents.size() == Positions.size())
-        Tangents = tangents;
-    else if (!Texcoords.empty() && !Normals.empty())
-        computeTangents();
+    d.Texcoords = uvs;
+    if (!tangents.empty() && tangents.size() == d.Positions.size())
+        d.Tangents = tangents;
+    else if (!d.Texcoords.empty() && !d.Normals.empty())
+        computeTangents(d);
+}
+
+void ObjLoader::copyFrom(const MeshArrays& a)
+{
+    m_data = std::make_shared<Data>();
+    Data& d = *m_data;
+
+    d.Positions.assign(a.positions, a.positions + a.vertexCount);
+    d.Normals.assign(a.normals, a.normals ? a.normals + a.vertexCount : nullptr);
+    d.Texcoords.assign(a.texcoords, a.texcoords ? a.texcoords + a.vertexCount : nullptr);
+    d.Tangents.assign(a.tangents, a.tangents ? a.tangents + a.vertexCount : nullptr);
+    d.Faces.resize(a.indexCount / 3);
+    if (!d.Faces.empty())
+        std::memcpy(d.Faces.data(), a.indices, d.Faces.size() * sizeof(Face));
+    d.minBound = a.minBound;
+    d.maxBound = a.maxBound;
+    d.normalsProvidedFromSource = a.normalsFromSource;
+}
+
+MeshArrays ObjLoader::arrays() const
+{
+    const Data& d = data();
+    MeshArrays a;
+    a.positions = d.Positions.data();
+    a.normals = d.Normals.empty() ? nullptr : d.Normals.data();
+    a.texcoords = d.Texcoords.empty() ? nullptr : d.Texcoords.data();
+    a.tangents = d.Tangents.empty() ? nullptr : d.Tangents.data();
+    a.vertexCount = d.Positions.size();
+    a.indices = getFaces();
+    a.indexCount = d.Faces.size() * 3;
+    a.minBound = d.minBound;
+    a.maxBound = d.maxBound;
+    a.normalsFromSource = d.normalsProvidedFromSource;
+    return a;
 }
 
 void ObjLoader::reset()
 {
-    Positions.clear();
-    Faces.clear();
-    Normals.clear();
-    minBound = glm::vec3(std::numeric_limits<float>::max());
-    maxBound = glm::vec3(std::numeric_limits<float>::lowest());
+    m_data = std::make_shared<Data>();
 }
 
 /* ------------------------------------------------------------ */
-void ObjLoader::computeNormals()
+void ObjLoader::computeNormals(Data& d)
 {
-    Normals.assign(Positions.size(), glm::vec3(0.0f));
+    d.Normals.assign(d.Positions.size(), glm::vec3(0.0f));
 
-    for (const Face& f : Faces)
+    for (const Face& f : d.Faces)
     {
-        const glm::vec3& v0 = Positions[f.a];
-        const glm::vec3& v1 = Positions[f.b];
-        const glm::vec3& v2 = Positions[f.c];
+        const glm::vec3& v0 = d.Positions[f.a];
+        const glm::vec3& v1 = d.Positions[f.b];
+        const glm::vec3& v2 = d.Positions[f.c];
 
         glm::vec3 n = glm::normalize(glm::cross(v1 - v0, v2 - v0));
-        Normals[f.a] += n;
-        Normals[f.b] += n;
-        Normals[f.c] += n;
+        d.Normals[f.a] += n;
+        d.Normals[f.b] += n;
+        d.Normals[f.c] += n;
     }
-    for (glm::vec3& n : Normals) n = glm::normalize(n);
-    m_normalsProvidedFromSource = false;
+    for (glm::vec3& n : d.Normals) n = glm::normalize(n);
+    d.normalsProvidedFromSource = false;
 }
 
-void ObjLoader::computeTangents()
+void ObjLoader::computeTangents(Data& d)
 {
-    Tangents.assign(Positions.size(), glm::vec3(0.0f));
-    if (Texcoords.empty()) return;
-    for (const Face& f : Faces)
+    d.Tangents.assign(d.Positions.size(), glm::vec3(0.0f));
+    if (d.Texcoords.empty()) return;
+    for (const Face& f : d.Faces)
     {
         unsigned ia=f.a, ib=f.b, ic=f.c;
-        const glm::vec3 &v0=Positions[ia], &v1=Positions[ib], &v2=Positions[ic];
-        const glm::vec2 &uv0=Texcoords[ia], &uv1=Texcoords[ib], &uv2=Texcoords[ic];
+        const glm::vec3 &v0=d.Positions[ia], &v1=d.Positions[ib], &v2=d.Positions[ic];
+        const glm::vec2 &uv0=d.Texcoords[ia], &uv1=d.Texcoords[ib], &uv2=d.Texcoords[ic];
 
         glm::vec3 e1 = v1 - v0;
         glm::vec3 e2 = v2 - v0;
@@ -164,61 +214,62 @@ void ObjLoader::computeTangents()
         float denom = dUV1.x * dUV2.y - dUV2.x * dUV1.y;
         float r = (fabs(denom) < 1e-8f) ? 0.0f : 1.0f / denom;
         glm::vec3 t = (e1 * dUV2.y - e2 * dUV1.y) * r;
-        Tangents[ia] += t;
-        Tangents[ib] += t;
-        Tangents[ic] += t;
+        d.Tangents[ia] += t;
+        d.Tangents[ib] += t;
+        d.Tangents[ic] += t;
     }
-    for (size_t i=0;i<Tangents.size();++i)
+    for (size_t i=0;i<d.Tangents.size();++i)
     {
-        glm::vec3 n = Normals.size()==Tangents.size()? Normals[i] : glm::vec3(0,0,1);
-        Tangents[i] = glm::normalize(Tangents[i] - n * glm::dot(n, Tangents[i]));
+        glm::vec3 n = d.Normals.size()==d.Tangents.size()? d.Normals[i] : glm::vec3(0,0,1);
+        d.Tangents[i] = glm::normalize(d.Tangents[i] - n * glm::dot(n, d.Tangents[i]));
     }
 }
 
-glm::vec3            ObjLoader::getMinBounds()  const { return minBound; }
-glm::vec3            ObjLoader::getMaxBounds()  const { return maxBound; }
+glm::vec3            ObjLoader::getMinBounds()  const { return data().minBound; }
+glm::vec3            ObjLoader::getMaxBounds()  const { return data().maxBound; }
 
-int  ObjLoader::getVertCount()  const { return static_cast<int>(Positions.size()); }
-int  ObjLoader::getIndexCount() const { return static_cast<int>(Faces.size() * 3); }
+int  ObjLoader::getVertCount()  const { return static_cast<int>(data().Positions.size()); }
+int  ObjLoader::getIndexCount() const { return static_cast<int>(data().Faces.size() * 3); }
 
 const float* ObjLoader::getPositions() const
 {
-    return reinterpret_cast<const float*>(Positions.data());
+    return reinterpret_cast<const float*>(data().Positions.data());
 }
 
 const unsigned int* ObjLoader::getFaces() const
 {
-    return reinterpret_cast<const unsigned int*>(Faces.data());
+    return reinterpret_cast<const unsigned int*>(data().Faces.data());
 }
 
 const float* ObjLoader::getNormals() const
 {
-    return reinterpret_cast<const float*>(Normals.data());
+    return reinterpret_cast<const float*>(data().Normals.data());
 }
 
 const float* ObjLoader::getTexcoords() const
 {
-    return reinterpret_cast<const float*>(Texcoords.data());
+    return reinterpret_cast<const float*>(data().Texcoords.data());
 }
 
 const float* ObjLoader::getTangents() const
 {
-    return reinterpret_cast<const float*>(Tangents.data());
+    return reinterpret_cast<const float*>(data().Tangents.data());
 }
 
 void ObjLoader::computeNormalsAngleWeighted()
 {
-    Normals.assign(Positions.size(), glm::vec3(0.0f));
+    Data& d = edit();
+    d.Normals.assign(d.Positions.size(), glm::vec3(0.0f));
     auto angleBetween = [](const glm::vec3& a, const glm::vec3& b){
         float la = glm::length(a); float lb = glm::length(b);
         if (la <= 1e-20f || lb <= 1e-20f) return 0.0f;
-        float d = glm::clamp(glm::dot(a, b) / (la * lb), -1.0f, 1.0f);
-        return std::acos(d);
+        float c = glm::clamp(glm::dot(a, b) / (la * lb), -1.0f, 1.0f);
+        return std::acos(c);
     };
-    for (const Face& f : Faces)
+    for (const Face& f : d.Faces)
     {
         unsigned ia=f.a, ib=f.b, ic=f.c;
-        const glm::vec3 &v0=Positions[ia], &v1=Positions[ib], &v2=Positions[ic];
+        const glm::vec3 &v0=d.Positions[ia], &v1=d.Positions[ib], &v2=d.Positions[ic];
         glm::vec3 e01 = v1 - v0;
         glm::vec3 e02 = v2 - v0;
         glm::vec3 e10 = v0 - v1;
@@ -229,18 +280,19 @@ void ObjLoader::computeNormalsAngleWeighted()
         float a0 = angleBetween(e01, e02);
         float a1 = angleBetween(e12, e10);
         float a2 = angleBetween(e20, e21);
-        Normals[ia] += fn * a0;
-        Normals[ib] += fn * a1;
-        Normals[ic] += fn * a2;
+        d.Normals[ia] += fn * a0;
+        d.Normals[ib] += fn * a1;
+        d.Normals[ic] += fn * a2;
     }
-    for (glm::vec3& n : Normals) n = glm::normalize(n);
-    m_normalsProvidedFromSource = false;
+    for (glm::vec3& n : d.Normals) n = glm::normalize(n);
+    d.normalsProvidedFromSource = false;
 }
 
 void ObjLoader::flipWindingAndNormals()
 {
-    for (auto& f : Faces) std::swap(f.b, f.c);
-    if (!Normals.empty()) {
-        for (auto& n : Normals) n = -n;
+    Data& d = edit();
+    for (auto& f : d.Faces) std::swap(f.b, f.c);
+    if (!d.Normals.empty()) {
+        for (auto& n : d.Normals) n = -n;
     }
 }
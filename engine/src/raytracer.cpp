@@ -3,139 +3,491 @@
 #include <glm/glm.hpp>
 #include <iostream>
 #include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cstring>
+#include <limits>
 #include "brdf.h"
+#include "triangle_simd.h"
+#include "thread_pool.h"
+#include "managers/scene_manager.h"
 
-Raytracer::Raytracer()
-    : lightPos(glm::vec3(-2.0f, 4.0f, -3.0f)),
-    lightColor(glm::vec3(1.0f, 1.0f, 1.0f)),
-    bvhRoot(nullptr)
-{}
-
-// Build BVH
-static BVHNode* buildBVH(std::vector<const Triangle*>& tris, int depth = 0)
+namespace
 {
-    if (tris.empty())
-        return nullptr;
+    const glm::vec3 kBackground(0.05f);   // slightly dark background
 
-    BVHNode* node = new BVHNode();
+    // Per-sample radiance cap. Only extreme fireflies are clipped per sample;
+    // the display range is applied to the pixel mean, so estimators with
+    // large per-sample weights (light selection) stay unbiased.
+    constexpr float kMaxSampleRadiance = 16.0f;
 
-    glm::vec3 minBox(FLT_MAX), maxBox(-FLT_MAX);
-    for (auto tri : tris)
+    glm::vec3 toDisplay(const glm::vec3& c)
     {
-        for (const glm::vec3& v : { tri->v0, tri->v1, tri->v2 })
+        return glm::clamp(c, 0.0f, 1.0f);
+    }
+
+    // Hash of everything in the light rig that affects shading
+    uint64_t lightsFingerprint(const Light& lights)
+    {
+        uint64_t h = 1469598103934665603ull;   // FNV-1a
+        auto mix = [&](const void* data, size_t size) {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) { h ^= bytes[i]; h *= 1099511628211ull; }
+        };
+        mix(&lights.m_globalAmbient, sizeof(glm::vec4));
+        for (const auto& l : lights.m_lights)
         {
-            minBox = glm::min(minBox, v);
-            maxBox = glm::max(maxBox, v);
+            const int type = static_cast<int>(l.type);
+            const float values[] = { l.position.x, l.position.y, l.position.z, l.direction.x, l.direction.y, l.direction.z,
+                                     l.color.x, l.color.y, l.color.z, l.intensity, l.enabled ? 1.0f : 0.0f,
+                                     l.innerConeDeg, l.outerConeDeg };
+            mix(&type, sizeof(type));
+            mix(values, sizeof(values));
         }
+        return h;
     }
-    node->boundsMin = minBox;
-    node->boundsMax = maxBox;
 
-    if (tris.size() <= 4)
+    float luminance(const glm::vec3& c)
     {
-        node->triangles = tris;
-        return node;
+        return 0.2126f * c.r + 0.7152f * c.g + 0.0722f * c.b;
     }
 
-    int axis = depth % 3;
-    std::sort(tris.begin(), tris.end(), [axis](const Triangle* a, const Triangle* b)
+    // Reflectivity derived from the unified material (metals reflect more)
+    float reflectivityFor(const MaterialCore& mc)
+    {
+        return mc.metallic > 0.1f ? 0.3f + mc.metallic * 0.7f : 0.1f;
+    }
+
+    // Smallest cosine between a ray and the surface used to stretch texture
+    // footprints; grazing hits beyond it read the same (blurry) level
+    constexpr float kMinFootprintCosine = 0.01f;
+
+    // Relative standard error of a tile's pixel means after n samples each,
+    // RMS over the tile. Dark pixels are measured against a floor so black
+    // regions don't demand endless samples.
+    float tileNoise(const glm::vec3* mean, const glm::vec3* m2, int W, int H,
+                    int x0, int y0, int x1, int y1, int n)
+    {
+        constexpr float kLuminanceFloor = 0.1f;
+        const float varianceOfMean = 1.0f / (float(n - 1) * float(n));
+        double sum = 0.0;
+        for (int y = y0; y < y1; ++y)
         {
-            float centerA = (a->v0[axis] + a->v1[axis] + a->v2[axis]) / 3.0f;
-            float centerB = (b->v0[axis] + b->v1[axis] + b->v2[axis]) / 3.0f;
-            return centerA < centerB;
+            const size_t row = static_cast<size_t>(H - 1 - y) * W;
+            for (int x = x0; x < x1; ++x)
+            {
+                const float error2 = luminance(m2[row + x]) * varianceOfMean;
+                const float level = std::max(luminance(mean[row + x]), kLuminanceFloor);
+                sum += error2 / (level * level);
+            }
+        }
+        return float(std::sqrt(sum / (double(x1 - x0) * (y1 - y0))));
+    }
+
+    // Interleave the bits of x and y (tile scheduling order)
+    uint32_t mortonCode(uint32_t x, uint32_t y)
+    {
+        auto spread = [](uint32_t v) {
+            v &= 0x0000ffff;
+            v = (v | (v << 8)) & 0x00ff00ff;
+            v = (v | (v << 4)) & 0x0f0f0f0f;
+            v = (v | (v << 2)) & 0x33333333;
+            v = (v | (v << 1)) & 0x55555555;
+            return v;
+        };
+        return spread(x) | (spread(y) << 1);
+    }
+
+    // Tile indices (row-major) sorted along a Z curve, so neighbouring
+    // (coherent) tiles end up in the same worker's block
+    std::vector<uint32_t> mortonTileOrder(int tilesX, int tilesY)
+    {
+        std::vector<uint32_t> order(static_cast<size_t>(tilesX) * tilesY);
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return mortonCode(a % tilesX, a / tilesX) < mortonCode(b % tilesX, b / tilesX);
+        });
+        return order;
+    }
+}
+
+Raytracer::Raytracer() = default;
+
+// Closest hit over the two-level hierarchy: TLAS over instance bounds, then the
+// instance's BLAS with the ray transformed into object space
+bool Raytracer::intersectClosest(const Ray& ray, HitRecord& hit) const
+{
+    const simd::Kernels& kernels = simd::kernels();
+    return m_tlas.intersect(ray, hit.t, [&](uint32_t instIndex, float& tMax) {
+        const Instance& inst = m_instances[instIndex];
+        const MeshBlas& blas = m_blas[inst.blas];
+
+        // Object-space ray; t is rescaled because Ray normalizes its direction
+        const glm::vec3 localDir = glm::mat3(inst.worldToObject) * ray.direction;
+        const float dirScale = glm::length(localDir);
+        if (dirScale <= 0.0f) return false;
+        const Ray localRay(glm::vec3(inst.worldToObject * glm::vec4(ray.origin, 1.0f)), localDir);
+
+        // BLAS leaves are contiguous triangle ranges (adoptBVHOrder), tested 4/8 at a time
+        float tLocal = tMax * dirScale;
+        simd::LeafHit leafHit;
+        const bool found = blas.bvh.intersectRanges(localRay, tLocal, [&](uint32_t first, uint32_t count, float& tBest) {
+            return kernels.intersect(blas.mesh, first, count, localRay.origin, localRay.direction, tBest, leafHit);
+        });
+        if (!found) return false;
+
+        tMax = tLocal / dirScale;
+        hit.u = leafHit.u;
+        hit.v = leafHit.v;
+        hit.triangle = leafHit.triangle;
+        hit.instance = instIndex;
+        return true;
+    });
+}
+
+// Packet version of intersectClosest for coherent primary rays. Lanes whose
+// hit.t starts negative are inactive. Returns a bitmask of lanes that hit.
+int Raytracer::intersectClosest(const Ray (&rays)[kPacketSize], HitRecord (&hits)[kPacketSize]) const
+{
+    const simd::Kernels& kernels = simd::kernels();
+    float tMax[kPacketSize];
+    for (int i = 0; i < kPacketSize; ++i) tMax[i] = hits[i].t;
+    int hitMask = 0;
+
+    m_tlas.intersectPacket(BVHRayPacket(rays), tMax, [&](uint32_t first, uint32_t count, float (&tWorld)[kPacketSize]) {
+        for (uint32_t k = first; k < first + count; ++k)
+        {
+            const uint32_t instIndex = m_tlas.primIndices()[k];
+            const Instance& inst = m_instances[instIndex];
+            const MeshBlas& blas = m_blas[inst.blas];
+
+            // Per-lane object-space rays; inactive lanes keep a negative tMax
+            Ray localRays[kPacketSize];
+            float dirScale[kPacketSize];
+            float tLocal[kPacketSize];
+            for (int i = 0; i < kPacketSize; ++i)
+            {
+                const glm::vec3 localDir = glm::mat3(inst.worldToObject) * rays[i].direction;
+                dirScale[i] = glm::length(localDir);
+                if (dirScale[i] <= 0.0f) { tLocal[i] = -1.0f; continue; }
+                localRays[i] = Ray(glm::vec3(inst.worldToObject * glm::vec4(rays[i].origin, 1.0f)), localDir);
+                tLocal[i] = tWorld[i] * dirScale[i];
+            }
+
+            simd::LeafHit leafHit[kPacketSize];
+            int instMask = 0;
+            blas.bvh.intersectPacket(BVHRayPacket(localRays), tLocal, [&](uint32_t tri, uint32_t triCount, float (&tBest)[kPacketSize]) {
+                for (int i = 0; i < kPacketSize; ++i)
+                    if (tBest[i] > 0.0f &&
+                        kernels.intersect(blas.mesh, tri, triCount, localRays[i].origin, localRays[i].direction, tBest[i], leafHit[i]))
+                        instMask |= 1 << i;
+            });
+
+            for (int i = 0; i < kPacketSize; ++i)
+            {
+                if (!(instMask & (1 << i))) continue;
+                tWorld[i] = tLocal[i] / dirScale[i];
+                hits[i].t = tWorld[i];
+                hits[i].u = leafHit[i].u;
+                hits[i].v = leafHit[i].v;
+                hits[i].triangle = leafHit[i].triangle;
+                hits[i].instance = instIndex;
+            }
+            hitMask |= instMask;
+        }
+    });
+    return hitMask;
+}
+
+bool Raytracer::occluded(const Ray& ray, float maxDistance) const
+{
+    const simd::Kernels& kernels = simd::kernels();
+    return m_tlas.intersectAny(ray, maxDistance, [&](uint32_t instIndex, float tMax) {
+        const Instance& inst = m_instances[instIndex];
+        const MeshBlas& blas = m_blas[inst.blas];
+
+        const glm::vec3 localDir = glm::mat3(inst.worldToObject) * ray.direction;
+        const float dirScale = glm::length(localDir);
+        if (dirScale <= 0.0f) return false;
+        const Ray localRay(glm::vec3(inst.worldToObject * glm::vec4(ray.origin, 1.0f)), localDir);
+
+        return blas.bvh.intersectAnyRanges(localRay, tMax * dirScale, [&](uint32_t first, uint32_t count, float tLocal) {
+            return kernels.occluded(blas.mesh, first, count, localRay.origin, localRay.direction, tLocal);
         });
+    });
+}
 
-    size_t mid = tris.size() / 2;
-    std::vector<const Triangle*> leftTris(tris.begin(), tris.begin() + mid);
-    std::vector<const Triangle*> rightTris(tris.begin() + mid, tris.end());
+// Shadow rays from one point are coherent near the origin, so they share the
+// packet traversal: each node is fetched once for up to four lights
+void Raytracer::traceShadowRays(const glm::vec3& origin, ShadowQuery* queries, int count) const
+{
+    const simd::Kernels& kernels = simd::kernels();
 
-    node->left = buildBVH(leftTris, depth + 1);
-    node->right = buildBVH(rightTris, depth + 1);
+    for (int base = 0; base < count; base += kPacketSize)
+    {
+        const int lanes = std::min(kPacketSize, count - base);
+        if (lanes == 1)
+        {
+            ShadowQuery& q = queries[base];
+            q.blocked = occluded(Ray(origin, q.direction), q.maxDistance);
+            continue;
+        }
 
-    return node;
+        Ray rays[kPacketSize];
+        float tMax[kPacketSize];
+        for (int i = 0; i < kPacketSize; ++i)
+        {
+            if (i < lanes) { rays[i] = Ray(origin, queries[base + i].direction); tMax[i] = queries[base + i].maxDistance; }
+            else tMax[i] = -1.0f;
+        }
+
+        const int blocked = m_tlas.intersectAnyPacket(BVHRayPacket(rays), tMax, [&](uint32_t first, uint32_t n, float (&tWorld)[kPacketSize]) {
+            int found = 0;
+            for (uint32_t k = first; k < first + n; ++k)
+            {
+                const Instance& inst = m_instances[m_tlas.primIndices()[k]];
+                const MeshBlas& blas = m_blas[inst.blas];
+
+                const glm::vec3 localOrigin(inst.worldToObject * glm::vec4(origin, 1.0f));
+                Ray localRays[kPacketSize];
+                float tLocal[kPacketSize];
+                for (int i = 0; i < kPacketSize; ++i)
+                {
+                    const glm::vec3 localDir = glm::mat3(inst.worldToObject) * rays[i].direction;
+                    const float dirScale = glm::length(localDir);
+                    if (tWorld[i] < 0.0f || (found & (1 << i)) || dirScale <= 0.0f) { tLocal[i] = -1.0f; continue; }
+                    localRays[i] = Ray(localOrigin, localDir);
+                    tLocal[i] = tWorld[i] * dirScale;
+                }
+
+                found |= blas.bvh.intersectAnyPacket(BVHRayPacket(localRays), tLocal, [&](uint32_t tri, uint32_t triCount, float (&tBest)[kPacketSize]) {
+                    int mask = 0;
+                    for (int i = 0; i < kPacketSize; ++i)
+                        if (tBest[i] >= 0.0f &&
+                            kernels.occluded(blas.mesh, tri, triCount, localRays[i].origin, localRays[i].direction, tBest[i]))
+                            mask |= 1 << i;
+                    return mask;
+                });
+            }
+            return found;
+        });
+
+        for (int i = 0; i < lanes; ++i)
+            queries[base + i].blocked = (blocked & (1 << i)) != 0;
+    }
 }
 
-// --- Simplified Ray Tracer ---
+// --- Path integrator ---
 glm::vec3 Raytracer::traceRay(const Ray& ray, const Light& lights, int depth) const
 {
-    if (depth > 2)
+    if (depth >= m_maxDepth)
         return glm::vec3(0.0f);
 
-    float tMin = FLT_MAX;
-    glm::vec3 hitNormal;
-    const Triangle* hitObject = nullptr;
+    HitRecord hit;
+    if (!intersectClosest(ray, hit))
+        return background(ray.direction, 0.0f);
 
-    // BVH or brute-force
-    if (bvhRoot)
-        bvhRoot->intersect(ray, hitObject, tMin, hitNormal);
-    else
+    // Callers outside the image loop get a sample stream keyed by the ray itself
+    uint32_t key = 0;
+    const float components[6] = { ray.origin.x, ray.origin.y, ray.origin.z, ray.direction.x, ray.direction.y, ray.direction.z };
+    for (float c : components)
     {
-        for (const auto& tri : triangles)
+        uint32_t bits;
+        std::memcpy(&bits, &c, sizeof(bits));
+        key = sampling::hashCombine(key, bits);
+    }
+    return tracePath(ray, hit, lights, depth, SobolSampler(m_seed, key, 0), nullptr, 0.0f, nullptr);
+}
+
+glm::vec3 Raytracer::tracePath(Ray ray, HitRecord hit, const Light& lights, int depth,
+                               const SobolSampler& sampler, const raytracer::LightSampler* lightSampler,
+                               float pixelSpread, FirstHit* firstHit) const
+{
+    glm::vec3 radiance(0.0f);
+    glm::vec3 throughput(1.0f);
+    // Density of the glossy bounce that reached this vertex (or missed the
+    // scene) and where it started; zero after the camera or a refraction,
+    // which light sampling cannot reproduce
+    float bouncePdf = 0.0f;
+    glm::vec3 bounceOrigin(0.0f);
+    // Ray cone for texture filtering: footprint width at the ray origin and
+    // how fast it grows with distance
+    float coneWidth = 0.0f;
+    float coneSpread = pixelSpread;
+    MaterialCore textured;
+
+    for (;;)
+    {
+        const Instance& inst = m_instances[hit.instance];
+        const TriangleMesh& mesh = m_blas[inst.blas].mesh;
+        const glm::vec3 hitPoint = ray.origin + hit.t * ray.direction;
+        const glm::vec3 viewDir = glm::normalize(-ray.direction);
+        glm::vec3 normal = glm::normalize(inst.normalToWorld * mesh.shadingNormal(hit.triangle, hit.u, hit.v));
+        const float footprintWidth = coneWidth + coneSpread * hit.t;
+        const MaterialCore& mat = applyTextures(inst, hit, ray.direction, footprintWidth, normal, textured);
+
+        // Emission found by the path. After a glossy bounce the previous
+        // vertex may also have sampled this point directly, so the two
+        // strategies share it by the power heuristic.
+        const glm::vec3 emitted = m_emissive.radiance(hit.instance);
+        if (emitted != glm::vec3(0.0f))
         {
-            float t;
-            glm::vec3 normal;
-            if (tri.intersect(ray, t, normal) && t < tMin)
+            float weight = 1.0f;
+            if (bouncePdf > 0.0f)
             {
-                tMin = t;
-                hitNormal = normal;
-                hitObject = &tri;
+                const glm::vec3 lightNormal = glm::normalize(inst.normalToWorld * mesh.geometricNormal(hit.triangle));
+                const float lightPdf = m_emissive.pdf(hit.instance, bounceOrigin, hitPoint, lightNormal);
+                weight = bouncePdf * bouncePdf / (bouncePdf * bouncePdf + lightPdf * lightPdf);
             }
+            radiance += throughput * emitted * weight;
         }
-    }
 
-    if (!hitObject)
-        return glm::vec3(0.05f); // slightly dark background
+        // Lobe weights: surface shading, refraction and reflection blend as
+        // mix(mix(direct, refraction, transmission), reflection, strength)
+        const float transmission = mat.transmission > 0.01f ? mat.transmission : 0.0f;
+        const float reflectivity = &mat == &textured ? reflectivityFor(mat) : inst.reflectivity;
+        float reflection = std::max(reflectivity, mat.metallic * 0.9f);
+        if (reflection > 0.01f)
+        {
+            // Metals reflect more; transparent materials less, to avoid over-brightening
+            if (mat.metallic > 0.5f) reflection = std::min(1.0f, reflection * 1.5f);
+            if (transmission > 0.0f) reflection *= (1.0f - transmission * 0.5f);
+        }
+        else
+        {
+            reflection = 0.0f;
+        }
+        const float refractionWeight = (1.0f - reflection) * transmission;
+        const float surfaceWeight = (1.0f - reflection) * (1.0f - transmission);
+        const glm::vec3 tint = glm::mix(glm::vec3(1.0f), glm::vec3(mat.baseColor), mat.metallic);
 
-    glm::vec3 hitPoint = ray.origin + tMin * ray.direction;
-    glm::vec3 viewDir = glm::normalize(-ray.direction);
-    glm::vec3 normal = glm::normalize(hitNormal);
+        // Denoiser guides: the lobes' colors blended like the lobes, with
+        // refraction passing everything through
+        if (firstHit)
+        {
+            firstHit->albedo = glm::clamp(surfaceWeight * raytracer::material::getBaseColor(mat) + reflection * tint +
+                                          glm::vec3(refractionWeight), 0.0f, 1.0f);
+            firstHit->normal = normal;
+            firstHit = nullptr;
+        }
 
-    const MaterialCore& mat = hitObject->material;
+        // Diffuse and glossy direct lighting share one light selection, one
+        // point on emissive geometry and one environment direction
+        raytracer::LightSelection selection;
+        raytracer::EmissiveSample areaSamples[2];
+        int areaSampleCount = 0;
+        if (surfaceWeight + reflection > 0.0f)
+        {
+            float u[4];
+            if (lightSampler)
+            {
+                sampler.get4D(static_cast<uint32_t>(4 * depth + 1), u);
+                lightSampler->select(hitPoint, normal, u, selection);
+            }
+            if (!m_emissive.empty())
+            {
+                sampler.get4D(static_cast<uint32_t>(4 * depth + 2), u);
+                if (m_emissive.sample(hitPoint, u, areaSamples[areaSampleCount]))
+                    ++areaSampleCount;
+            }
+            if (m_environment)
+            {
+                sampler.get4D(static_cast<uint32_t>(4 * depth + 3), u);
+                raytracer::EmissiveSample& sample = areaSamples[areaSampleCount];
+                if (m_environment->sample(u[0], u[1], sample.direction, sample.pdf))
+                {
+                    sample.distance = std::numeric_limits<float>::infinity();
+                    sample.point = hitPoint;
+                    sample.radiance = m_environment->eval(sample.direction) * m_environmentIntensity;
+                    ++areaSampleCount;
+                }
+            }
+        }
 
-    // Use the new modular lighting system
-    glm::vec3 color = raytracer::LightingSystem::computeLighting(
-        hitPoint, normal, viewDir, mat, lights, *this
-    );
+        if (surfaceWeight > 0.0f)
+        {
+            const glm::vec3 direct = raytracer::LightingSystem::computeLighting(
+                hitPoint, normal, viewDir, mat, lights, *this, selection, areaSamples, areaSampleCount);
+            radiance += throughput * surfaceWeight * direct;
+        }
 
-    // Handle transparent materials (refraction)
-    if (mat.transmission > 0.01f) {
-        glm::vec3 refractedColor = computeRefraction(hitPoint, ray.direction, normal, mat, lights, depth);
-        
-        // Mix base color with refracted color based on transmission
-        color = glm::mix(color, refractedColor, mat.transmission);
-    }
-    
-    // Reflective contribution based on material properties
-    float effectiveReflectivity = std::max(hitObject->reflectivity, mat.metallic * 0.9f);
-    if (effectiveReflectivity > 0.01f)
-    {
-        // Create RNG for this pixel (deterministic based on ray origin and direction)
-        uint32_t pixelSeed = m_seed;
-        // Mix in ray origin and direction for deterministic per-pixel seeds
-        pixelSeed ^= std::hash<float>{}(hitPoint.x + hitPoint.y + hitPoint.z);
-        pixelSeed ^= std::hash<float>{}(ray.direction.x + ray.direction.y + ray.direction.z);
-        SeededRng rng(pixelSeed);
-        
-        glm::vec3 reflectedColor = sampleGlossyReflection(
-            hitPoint, viewDir, normal, mat, lights, depth, rng
-        );
-
-        // For metals, reflection is more prominent
-        float reflectionStrength = effectiveReflectivity;
-        if (mat.metallic > 0.5f) {
-            reflectionStrength = std::min(1.0f, effectiveReflectivity * 1.5f);
+        // The reflection lobe is GGX about the side facing the viewer. Its
+        // weight already says how much the surface reflects, so Fresnel only
+        // adds the metal tint and its whitening at grazing angles.
+        const glm::vec3 facing = glm::dot(normal, viewDir) < 0.0f ? -normal : normal;
+        if (reflection > 0.0f)
+        {
+            // A bounce follows exactly when this vertex is not the last one
+            const bool lobeSampled = depth + 1 < m_maxDepth;
+            const glm::vec3 glossy = raytracer::LightingSystem::computeGlossyLighting(
+                hitPoint, facing, viewDir, tint, mat.roughness, lights, *this, selection, areaSamples, areaSampleCount, lobeSampled);
+            radiance += throughput * reflection * glossy;
         }
 
-        // For transparent materials, reduce reflection strength to avoid over-brightening
-        if (mat.transmission > 0.01f) {
-            reflectionStrength *= (1.0f - mat.transmission * 0.5f);
+        // One continuation per vertex, picked in proportion to its weight;
+        // the path ends with the probability that no lobe is taken
+        const float continueWeight = reflection + refractionWeight;
+        if (++depth >= m_maxDepth || continueWeight <= 0.0f)
+            break;
+        throughput *= continueWeight;
+
+        // One 4D sample group per bounce. The direction gets dimensions 0-1,
+        // the only pair that is a (0,2) net; lobe choice and roulette take
+        // the remaining two.
+        float u[4];
+        sampler.get4D(static_cast<uint32_t>(4 * depth), u);
+
+        if (u[2] * continueWeight < reflection)
+        {
+            // Sampled in proportion to the visible normals, the estimator
+            // weight is F·G2/G1; directions below the surface end the path
+            brdf::GlossySample glossy;
+            if (!brdf::sampleGGXReflection(facing, viewDir, tint, mat.roughness, u[0], u[1], glossy))
+                break;
+            throughput *= glossy.weight;
+            ray = Ray(hitPoint + facing * 0.001f, glossy.direction);
+            bouncePdf = glossy.pdf;
+            bounceOrigin = hitPoint;
+            // The lobe spreads over about 1 / pdf steradians, i.e. an angle
+            // of sqrt(1 / pdf); mirrors keep the incoming cone
+            coneSpread = std::max(coneSpread, std::sqrt(1.0f / glossy.pdf));
+        }
+        else
+        {
+            ray = sampleRefraction(hitPoint, ray.direction, normal, mat, u[0]);
+            bouncePdf = 0.0f;
+        }
+        coneWidth = footprintWidth;
+
+        // Russian roulette once the path has bounced a few times
+        if (depth >= kRouletteDepth)
+        {
+            const float survive = std::min(0.95f, std::max(throughput.r, std::max(throughput.g, throughput.b)));
+            if (u[3] >= survive)
+                break;
+            throughput /= survive;
         }
 
-        color = glm::mix(color, reflectedColor, reflectionStrength);
+        hit = HitRecord{};
+        if (!intersectClosest(ray, hit))
+        {
+            // The environment seen by a glossy bounce is shared with its
+            // light sample the same way as emission, and read from a MIP
+            // level as wide as the bounce's footprint (1 / pdf steradians)
+            float weight = 1.0f, lod = 0.0f;
+            if (m_environment && bouncePdf > 0.0f)
+            {
+                const float lightPdf = m_environment->pdf(ray.direction);
+                weight = bouncePdf * bouncePdf / (bouncePdf * bouncePdf + lightPdf * lightPdf);
+                lod = m_environment->lodForSolidAngle(1.0f / bouncePdf);
+            }
+            radiance += throughput * weight * background(ray.direction, lod);
+            break;
+        }
     }
 
     // Leave color in linear space; screen shader applies tone mapping and gamma
-    return glm::clamp(color, 0.0f, 1.0f);
+    return glm::clamp(radiance, 0.0f, kMaxSampleRadiance);
 }
 
 void Raytracer::renderImage(std::vector<glm::vec3>& out,
@@ -144,7 +496,225 @@ void Raytracer::renderImage(std::vector<glm::vec3>& out,
     glm::vec3 camFront,
     glm::vec3 camUp,
     float fovDeg,
-    const Light& lights)
+    const Light& lights,
+    int samplesPerPixel)
+{
+    resetAccumulation();
+    accumulate(out, W, H, camPos, camFront, camUp, fovDeg, lights, samplesPerPixel);
+}
+
+void Raytracer::setEnvironment(std::shared_ptr<const EnvironmentMap> environment, float intensity)
+{
+    if (environment == m_environment && intensity == m_environmentIntensity) return;
+    m_environment = std::move(environment);
+    m_environmentIntensity = intensity;
+    resetAccumulation();
+}
+
+glm::vec3 Raytracer::background(const glm::vec3& direction, float lod) const
+{
+    if (!m_environment) return kBackground;
+    return m_environment->eval(direction, lod) * m_environmentIntensity;
+}
+
+void Raytracer::setMaxDepth(int depth)
+{
+    depth = std::max(1, depth);
+    if (depth != m_maxDepth)
+    {
+        m_maxDepth = depth;
+        resetAccumulation();
+    }
+}
+
+void Raytracer::setLightSampling(raytracer::LightSampling mode, int lightsPerHit)
+{
+    lightsPerHit = std::clamp(lightsPerHit, 1, raytracer::LightSelection::kMaxLights);
+    if (mode != m_lightSampling || lightsPerHit != m_lightsPerHit)
+    {
+        m_lightSampling = mode;
+        m_lightsPerHit = lightsPerHit;
+        m_lightSamplerValid = false;
+        resetAccumulation();
+    }
+}
+
+void Raytracer::updateLightSampler(const Light& lights, uint64_t lightsKey)
+{
+    if (m_lightSamplerValid && lightsKey == m_lightSamplerKey) return;
+    m_lightSampler.build(lights, m_lightSampling, m_lightsPerHit);
+    m_lightSamplerKey = lightsKey;
+    m_lightSamplerValid = true;
+}
+
+int Raytracer::accumulate(std::vector<glm::vec3>& out,
+    int W, int H,
+    glm::vec3 camPos,
+    glm::vec3 camFront,
+    glm::vec3 camUp,
+    float fovDeg,
+    const Light& lights,
+    int samples,
+    int maxSamples)
+{
+    if (W <= 0 || H <= 0) return 0;
+    out.resize(static_cast<size_t>(W) * H);
+
+    // Anything that changes the image invalidates the running estimate
+    const uint64_t lightsKey = lightsFingerprint(lights);
+    if (W != m_accumWidth || H != m_accumHeight || camPos != m_accumCamPos || camFront != m_accumCamFront ||
+        camUp != m_accumCamUp || fovDeg != m_accumFov || lightsKey != m_accumLightsKey)
+    {
+        m_accumWidth = W;
+        m_accumHeight = H;
+        m_accumCamPos = camPos;
+        m_accumCamFront = camFront;
+        m_accumCamUp = camUp;
+        m_accumFov = fovDeg;
+        m_accumLightsKey = lightsKey;
+        m_accumSamples = 0;
+    }
+    updateLightSampler(lights, lightsKey);
+    if (m_accumSamples == 0)
+    {
+        m_accumMean.assign(out.size(), glm::vec3(0.0f));
+        m_accumM2.assign(out.size(), glm::vec3(0.0f));
+        m_aux.reset(m_auxiliaryOutputs ? out.size() : 0);
+    }
+
+    samples = std::min(samples, maxSamples - m_accumSamples);
+    if (samples <= 0)
+    {
+        std::transform(m_accumMean.begin(), m_accumMean.end(), out.begin(), toDisplay);
+        return 0;
+    }
+
+    const CameraRays camera = makeCameraRays(W, H, camPos, camFront, camUp, fovDeg);
+    const int tilesX = (W + kTileSize - 1) / kTileSize;
+    const std::vector<uint32_t> tileOrder = mortonTileOrder(tilesX, (H + kTileSize - 1) / kTileSize);
+
+    m_tilesTotal.store(static_cast<uint32_t>(tileOrder.size()), std::memory_order_relaxed);
+    m_tilesDone.store(0, std::memory_order_relaxed);
+    const int firstSample = m_accumSamples;
+    AuxiliaryOutputs* aux = m_aux.empty() ? nullptr : &m_aux;
+
+    ThreadPool& pool = ThreadPool::shared();
+    pool.run(static_cast<uint32_t>(tileOrder.size()), [&](uint32_t task, unsigned) {
+        const int x0 = static_cast<int>(tileOrder[task] % tilesX) * kTileSize;
+        const int y0 = static_cast<int>(tileOrder[task] / tilesX) * kTileSize;
+        const int x1 = std::min(x0 + kTileSize, W);
+        const int y1 = std::min(y0 + kTileSize, H);
+
+        traceTileSamples(camera, x0, y0, x1, y1, firstSample, samples, lights, m_accumMean.data(), m_accumM2.data(), aux);
+        for (int y = y0; y < y1; ++y)
+        {
+            const size_t row = static_cast<size_t>(H - 1 - y) * W;
+            std::transform(m_accumMean.begin() + row + x0, m_accumMean.begin() + row + x1, out.begin() + row + x0, toDisplay);
+        }
+
+        m_tilesDone.fetch_add(1, std::memory_order_relaxed);
+    });
+    m_accumSamples += samples;
+    return samples;
+}
+
+float Raytracer::renderAdaptive(std::vector<glm::vec3>& out,
+    int W, int H,
+    glm::vec3 camPos,
+    glm::vec3 camFront,
+    glm::vec3 camUp,
+    float fovDeg,
+    const Light& lights,
+    const AdaptiveSampling& settings)
+{
+    resetAccumulation();
+    if (W <= 0 || H <= 0) return 0.0f;
+    updateLightSampler(lights, lightsFingerprint(lights));
+
+    const int maxSamples = std::max(1, settings.maxSamples);
+    const int minSamples = std::clamp(settings.minSamples, 1, maxSamples);
+
+    // Independent estimate: every tile carries its own sample count, so this
+    // does not feed the progressive buffers
+    std::vector<glm::vec3> mean(static_cast<size_t>(W) * H, glm::vec3(0.0f));
+    std::vector<glm::vec3> m2(mean.size(), glm::vec3(0.0f));
+    AuxiliaryOutputs aux;
+    aux.reset(m_auxiliaryOutputs ? mean.size() : 0);
+
+    const CameraRays camera = makeCameraRays(W, H, camPos, camFront, camUp, fovDeg);
+    const int tilesX = (W + kTileSize - 1) / kTileSize;
+    const std::vector<uint32_t> tileOrder = mortonTileOrder(tilesX, (H + kTileSize - 1) / kTileSize);
+    std::vector<int> tileSamples(tileOrder.size(), 0);
+    std::vector<uint32_t> active(tileOrder.size());
+    std::iota(active.begin(), active.end(), 0u);
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool hasDeadline = settings.timeBudgetSeconds > 0.0f;
+    const auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(settings.timeBudgetSeconds));
+    auto outOfTime = [&] { return hasDeadline && std::chrono::steady_clock::now() >= deadline; };
+
+    m_tilesTotal.store(static_cast<uint32_t>(tileOrder.size()), std::memory_order_relaxed);
+    m_tilesDone.store(0, std::memory_order_relaxed);
+
+    // Fewer samples give too unreliable a variance to stop on
+    constexpr int kMinNoiseSamples = 4;
+
+    // Rounds double each active tile's sample count, so a tile's noise
+    // estimate is refreshed after a constant fraction of extra work. The first
+    // round always completes so every pixel gets at least minSamples.
+    ThreadPool& pool = ThreadPool::shared();
+    int rounds = 0;
+    while (!active.empty() && (rounds == 0 || !outOfTime()))
+    {
+        const bool firstRound = rounds++ == 0;
+        std::vector<uint8_t> done(active.size(), 0);
+        pool.run(static_cast<uint32_t>(active.size()), [&](uint32_t task, unsigned) {
+            const uint32_t tile = active[task];
+            const int x0 = static_cast<int>(tileOrder[tile] % tilesX) * kTileSize;
+            const int y0 = static_cast<int>(tileOrder[tile] / tilesX) * kTileSize;
+            const int x1 = std::min(x0 + kTileSize, W);
+            const int y1 = std::min(y0 + kTileSize, H);
+
+            int& n = tileSamples[tile];
+            const int target = firstRound ? minSamples : std::min(maxSamples, n * 2);
+            while (n < target && (firstRound || !outOfTime()))
+            {
+                traceTileSamples(camera, x0, y0, x1, y1, n, 1, lights, mean.data(), m2.data(), aux.empty() ? nullptr : &aux);
+                ++n;
+            }
+
+            if (n >= maxSamples || (n >= kMinNoiseSamples && tileNoise(mean.data(), m2.data(), W, H, x0, y0, x1, y1, n) <= settings.noiseThreshold))
+            {
+                done[task] = 1;
+                m_tilesDone.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+        std::vector<uint32_t> stillActive;
+        for (size_t i = 0; i < active.size(); ++i)
+            if (!done[i]) stillActive.push_back(active[i]);
+        active.swap(stillActive);
+    }
+
+    if (settings.displayRange)
+        std::transform(mean.begin(), mean.end(), mean.begin(), toDisplay);
+    out.swap(mean);
+    std::swap(m_aux, aux);
+
+    uint64_t totalSamples = 0;
+    for (size_t t = 0; t < tileOrder.size(); ++t)
+    {
+        const int x0 = static_cast<int>(tileOrder[t] % tilesX) * kTileSize;
+        const int y0 = static_cast<int>(tileOrder[t] / tilesX) * kTileSize;
+        totalSamples += uint64_t(tileSamples[t]) * (std::min(x0 + kTileSize, W) - x0) * (std::min(y0 + kTileSize, H) - y0);
+    }
+    const float averageSpp = float(double(totalSamples) / (double(W) * H));
+    return averageSpp;
+}
+
+Raytracer::CameraRays Raytracer::makeCameraRays(int W, int H, const glm::vec3& camPos, const glm::vec3& camFront,
+                                                const glm::vec3& camUp, float fovDeg)
 {
     const float aspect = float(W) / float(H);
     const float scale = tan(glm::radians(fovDeg * 0.5f));
@@ -152,178 +722,466 @@ void Raytracer::renderImage(std::vector<glm::vec3>& out,
     glm::vec3 right = glm::normalize(glm::cross(camFront, camUp));
     glm::vec3 up = glm::normalize(glm::cross(right, camFront));
 
-    glm::vec3 imageCenter = camFront;
-    glm::vec3 imageRight = right * aspect * scale;
-    glm::vec3 imageUp = up * scale;
+    CameraRays camera;
+    camera.origin = camPos;
+    camera.center = camFront;
+    camera.right = right * aspect * scale;
+    camera.up = up * scale;
+    camera.width = W;
+    camera.height = H;
+    camera.pixelSpread = 2.0f * scale / float(H);
+    return camera;
+}
 
-    // Use proper OpenMP parallelization with atomic progress reporting
-#pragma omp parallel for schedule(dynamic, 8)
-    for (int y = 0; y < H; ++y)
+void Raytracer::traceTileSamples(const CameraRays& camera, int x0, int y0, int x1, int y1,
+                                 int firstSample, int samples, const Light& lights,
+                                 glm::vec3* mean, glm::vec3* m2, AuxiliaryOutputs* aux) const
+{
+    const int W = camera.width, H = camera.height;
+    const glm::vec3 viewAxis = glm::normalize(camera.center);
+
+    // Primary rays are traced as 2x2 pixel packets; secondary rays stay scalar
+    for (int y = y0; y < y1; y += 2)
     {
-        // Thread-safe progress reporting
-        if (y % 50 == 0) {
-            #pragma omp critical
+        for (int x = x0; x < x1; x += 2)
+        {
+            for (int sample = firstSample; sample < firstSample + samples; ++sample)
             {
-                std::cout << "[DEBUG] Tracing row " << y << " of " << H << "\n";
+                Ray rays[kPacketSize];
+                HitRecord hits[kPacketSize];
+                SobolSampler samplers[kPacketSize] = { { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 } };
+                for (int i = 0; i < kPacketSize; ++i)
+                {
+                    const int px = x + (i & 1), py = y + (i >> 1);
+                    if (px >= x1 || py >= y1) { hits[i].t = -1.0f; continue; }   // odd image edge
+
+                    // Sample 0 goes through the pixel center so single-sample
+                    // renders match the classic pinhole image
+                    float jitter[4] = { 0.5f, 0.5f, 0.5f, 0.5f };
+                    samplers[i] = SobolSampler(m_seed, static_cast<uint32_t>(py * W + px), static_cast<uint32_t>(sample));
+                    if (sample > 0) samplers[i].get4D(0, jitter);
+                    float u = (px + jitter[0]) / W * 2.0f - 1.0f;
+                    float v = 1.0f - (py + jitter[1]) / H * 2.0f;
+                    rays[i] = Ray(camera.origin, glm::normalize(camera.center + u * camera.right + v * camera.up));
+                }
+
+                const int hitMask = intersectClosest(rays, hits);
+                for (int i = 0; i < kPacketSize; ++i)
+                {
+                    const int px = x + (i & 1), py = y + (i >> 1);
+                    if (px >= x1 || py >= y1) continue;
+
+                    // Misses guide the denoiser with the background itself
+                    const bool hit = (hitMask & (1 << i)) != 0;
+                    FirstHit firstHit;
+                    glm::vec3 color;
+                    if (hit)
+                    {
+                        color = tracePath(rays[i], hits[i], lights, 0, samplers[i], &m_lightSampler, camera.pixelSpread,
+                                          aux ? &firstHit : nullptr);
+                    }
+                    else
+                    {
+                        color = glm::min(background(rays[i].direction, 0.0f), glm::vec3(kMaxSampleRadiance));
+                        firstHit.albedo = toDisplay(color);
+                    }
+
+                    // Welford update; buffers use the flipped output layout
+                    const size_t outputIndex = static_cast<size_t>(H - 1 - py) * W + px;
+                    const float weight = 1.0f / float(sample + 1);
+                    const glm::vec3 delta = color - mean[outputIndex];
+                    mean[outputIndex] += delta * weight;
+                    m2[outputIndex] += delta * (color - mean[outputIndex]);
+                    if (aux)
+                    {
+                        aux->albedo[outputIndex] += (firstHit.albedo - aux->albedo[outputIndex]) * weight;
+                        aux->normal[outputIndex] += (firstHit.normal - aux->normal[outputIndex]) * weight;
+                        // Depth and identity are not blended: they come from
+                        // the pixel center (sample 0) alone
+                        if (sample == 0 && hit)
+                        {
+                            aux->depth[outputIndex] = hits[i].t * glm::dot(rays[i].direction, viewAxis);
+                            aux->objectId[outputIndex] = m_instances[hits[i].instance].objectId;
+                        }
+                    }
+                }
             }
         }
+    }
+}
+
+void Raytracer::getAccumulatedVariance(std::vector<glm::vec3>& out) const
+{
+    out.assign(m_accumM2.size(), glm::vec3(0.0f));
+    if (m_accumSamples < 2) return;
+    const float norm = 1.0f / float(m_accumSamples - 1);
+    for (size_t i = 0; i < out.size(); ++i)
+        out[i] = m_accumM2[i] * norm;
+}
+
+void raytracer::AuxiliaryOutputs::reset(size_t pixels)
+{
+    albedo.assign(pixels, glm::vec3(0.0f));
+    normal.assign(pixels, glm::vec3(0.0f));
+    depth.assign(pixels, std::numeric_limits<float>::infinity());
+    objectId.assign(pixels, 0u);
+}
+
+void Raytracer::setAuxiliaryOutputs(bool enabled)
+{
+    if (enabled == m_auxiliaryOutputs) return;
+    m_auxiliaryOutputs = enabled;
+    if (enabled)
+        resetAccumulation();
+    else
+        m_aux = AuxiliaryOutputs{};
+}
+
+namespace
+{
+    // Objects without geometry never reach the raytracer
+    bool hasGeometry(const SceneObject& obj)
+    {
+        return obj.objLoader.getVertCount() > 0 && obj.objLoader.getIndexCount() >= 3;
+    }
+}
+
+void Raytracer::clearScene()
+{
+    m_blas.clear();
+    m_blasByMesh.clear();
+    m_instances.clear();
+    m_materials.clear();
+    m_materialTextures.clear();
+    m_tlas.clear();
+    m_emissive.clear();
+    m_builtTlasCost = 0.0f;
+    m_syncedScene = nullptr;
+    m_syncedRevision = 0;
+}
+
+size_t Raytracer::getTriangleCount() const
+{
+    size_t count = 0;
+    for (const auto& blas : m_blas)
+        count += blas.mesh.triangleCount();
+    return count;
+}
 
-        for (int x = 0; x < W; ++x)
+size_t Raytracer::getAccelMemoryBytes() const
+{
+    size_t bytes = m_tlas.memoryBytes() + m_instances.capacity() * sizeof(Instance)
+                 + m_materials.capacity() * sizeof(MaterialCore)
+                 + m_materialTextures.capacity() * sizeof(MaterialTextures);
+    for (const auto& blas : m_blas)
+        bytes += blas.bvh.memoryBytes() + blas.mesh.memoryBytes();
+    return bytes;
+}
+
+void Raytracer::syncScene(const SceneManager& scene)
+{
+    if (m_syncedScene == &scene && m_syncedRevision == scene.getRevision())
+        return;
+    resetAccumulation();
+
+    const auto& objects = scene.getObjects();
+
+    // Same objects in the same order means per-instance updates are enough
+    bool sameLayout = (m_syncedScene == &scene);
+    size_t instIndex = 0;
+    for (size_t i = 0; sameLayout && i < objects.size(); ++i)
+    {
+        if (!hasGeometry(objects[i])) continue;
+        sameLayout = instIndex < m_instances.size() && m_instances[instIndex].objectId == objects[i].id;
+        ++instIndex;
+    }
+    sameLayout = sameLayout && instIndex == m_instances.size();
+
+    m_syncedScene = &scene;
+    m_syncedRevision = scene.getRevision();
+
+    if (!sameLayout)
+    {
+        rebuildScene(objects);
+        return;
+    }
+
+    bool moved = false;
+    instIndex = 0;
+    for (const auto& obj : objects)
+    {
+        if (!hasGeometry(obj)) continue;
+        const uint32_t index = static_cast<uint32_t>(instIndex++);
+        Instance& inst = m_instances[index];
+        const bool transformChanged = inst.transformVersion != obj.transformVersion;
+        const bool materialChanged = inst.materialVersion != obj.materialVersion;
+        if (transformChanged)
         {
-            float u = (x + 0.5f) / W * 2.0f - 1.0f;
-            float v = 1.0f - (y + 0.5f) / H * 2.0f;
-
-            glm::vec3 dir = glm::normalize(imageCenter + u * imageRight + v * imageUp);
-            Ray r(camPos, dir);
-            
-            // Calculate output index correctly for flipped image
-            int outputIndex = (H - 1 - y) * W + x;
-            out[outputIndex] = traceRay(r, lights, 0);
+            updateInstanceTransform(inst, obj);
+            moved = true;
         }
+        if (materialChanged)
+            updateInstanceMaterial(inst, obj);
+        if (transformChanged || materialChanged)
+            updateInstanceEmission(index, obj, transformChanged);
     }
 
-    std::cout << "[DEBUG] renderImage() finished!\n";
+    if (moved)
+        refitTLAS();
+    m_emissive.refresh();
 }
 
-void Raytracer::loadModel(const ObjLoader& obj, const glm::mat4& M, float refl, const MaterialCore& mat)
+void Raytracer::rebuildScene(const std::vector<SceneObject>& objects)
 {
-    const float* pos = obj.getPositions();
-    const unsigned int* idx = obj.getFaces();
-    const size_t Nv = obj.getVertCount();
-    const size_t Nt = obj.getIndexCount() / 3;
+    const auto start = std::chrono::steady_clock::now();
 
-    std::vector<glm::vec3> wPos(Nv);
-    for (size_t i = 0; i < Nv; ++i)
+    // Keep BLASes whose mesh is still referenced, build the ones that are new
+    std::vector<MeshBlas> previous = std::move(m_blas);
+    std::unordered_map<uint32_t, uint32_t> previousByMesh = std::move(m_blasByMesh);
+    m_blas.clear();
+    m_blasByMesh.clear();
+    m_instances.clear();
+    m_materials.clear();
+    m_materialTextures.clear();
+    m_emissive.clear();
+
+    size_t builtMeshes = 0;
+    for (const auto& obj : objects)
     {
-        glm::vec4 p(pos[i * 3 + 0],
-            pos[i * 3 + 1],
-            pos[i * 3 + 2], 1.0f);
-        wPos[i] = glm::vec3(M * p);
+        if (!hasGeometry(obj)) continue;
+
+        if (m_blasByMesh.find(obj.meshId) == m_blasByMesh.end())
+        {
+            auto prev = previousByMesh.find(obj.meshId);
+            if (prev != previousByMesh.end())
+            {
+                m_blasByMesh[obj.meshId] = static_cast<uint32_t>(m_blas.size());
+                m_blas.push_back(std::move(previous[prev->second]));
+            }
+            else
+            {
+                acquireBlas(obj);
+                ++builtMeshes;
+            }
+        }
+
+        Instance inst;
+        inst.objectId = obj.id;
+        inst.blas = m_blasByMesh[obj.meshId];
+        inst.material = static_cast<uint32_t>(m_materials.size());
+        m_materials.emplace_back();
+        m_materialTextures.emplace_back();
+        updateInstanceTransform(inst, obj);
+        updateInstanceMaterial(inst, obj);
+        m_instances.push_back(inst);
+        updateInstanceEmission(static_cast<uint32_t>(m_instances.size() - 1), obj, true);
     }
 
-    for (size_t i = 0; i < Nt; ++i)
+    buildTLAS();
+    m_emissive.refresh();
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[Raytracer] Rebuilt scene: " << m_instances.size() << " instances of "
+              << m_blas.size() << " meshes (" << builtMeshes << " new BLAS, "
+              << getTriangleCount() << " triangles, " << m_emissive.triangleCount() << " emissive, "
+              << ms << " ms)\n";
+}
+
+// Build the object-space BLAS for a mesh seen for the first time
+uint32_t Raytracer::acquireBlas(const SceneObject& obj)
+{
+    MeshBlas blas;
+    blas.meshId = obj.meshId;
+    blas.mesh.build(obj.objLoader);
+
+    // Meshes from the mesh cache come with their tree already built
+    const size_t Nt = blas.mesh.triangleCount();
+    if (obj.meshBvh && obj.meshBvh->primIndices().size() == Nt)
+        blas.bvh = *obj.meshBvh;
+    else
+        blas.bvh.buildTriangles(reinterpret_cast<const glm::vec3*>(obj.objLoader.getPositions()),
+                                obj.objLoader.getFaces(), Nt);
+    blas.mesh.adoptBVHOrder(blas.bvh);
+
+    const uint32_t index = static_cast<uint32_t>(m_blas.size());
+    m_blas.push_back(std::move(blas));
+    m_blasByMesh[obj.meshId] = index;
+    return index;
+}
+
+void Raytracer::updateInstanceTransform(Instance& inst, const SceneObject& obj)
+{
+    const glm::mat4& M = obj.modelMatrix;
+    inst.worldToObject = glm::inverse(M);
+    inst.normalToWorld = glm::transpose(glm::mat3(inst.worldToObject));
+    inst.vectorToWorld = glm::mat3(M);
+    inst.transformVersion = obj.transformVersion;
+
+    // World bounds from the eight corners of the object-space BLAS root
+    const BVHNode& root = m_blas[inst.blas].bvh.nodes()[0];
+    inst.worldMin = glm::vec3(FLT_MAX);
+    inst.worldMax = glm::vec3(-FLT_MAX);
+    for (int c = 0; c < 8; ++c)
     {
-        glm::vec3 v0 = wPos[idx[i * 3 + 0]];
-        glm::vec3 v1 = wPos[idx[i * 3 + 1]];
-        glm::vec3 v2 = wPos[idx[i * 3 + 2]];
-        triangles.emplace_back(v0, v1, v2, refl, mat);
+        const glm::vec3 corner((c & 1) ? root.boundsMax.x : root.boundsMin.x,
+                               (c & 2) ? root.boundsMax.y : root.boundsMin.y,
+                               (c & 4) ? root.boundsMax.z : root.boundsMin.z);
+        const glm::vec3 w = glm::vec3(M * glm::vec4(corner, 1.0f));
+        inst.worldMin = glm::min(inst.worldMin, w);
+        inst.worldMax = glm::max(inst.worldMax, w);
     }
+}
 
-    // Build BVH
-    std::vector<const Triangle*> triPtrs;
-    for (const auto& tri : triangles)
-        triPtrs.push_back(&tri);
+void Raytracer::updateInstanceMaterial(Instance& inst, const SceneObject& obj)
+{
+    const MaterialCore& mc = obj.materialCore;
+    MaterialTextures& maps = m_materialTextures[inst.material];
+    maps = MaterialTextures{};
+    if (m_blas[inst.blas].mesh.hasTexcoords())
+    {
+        maps.baseColor = m_textures.acquire(mc.baseColorTex, /*gammaEncoded=*/true);
+        maps.normal = m_textures.acquire(mc.normalTex, /*gammaEncoded=*/false);
+        maps.metallicRoughness = m_textures.acquire(mc.metallicRoughnessTex, /*gammaEncoded=*/false);
+    }
 
-    bvhRoot = buildBVH(triPtrs);
+    // Paths are resolved to cache handles once; without them copying the
+    // material for textured shading never allocates
+    MaterialCore& mat = m_materials[inst.material];
+    mat = mc;
+    for (std::string* path : { &mat.baseColorTex, &mat.normalTex, &mat.metallicRoughnessTex, &mat.emissiveTex,
+                               &mat.occlusionTex, &mat.transmissionTex, &mat.thicknessTex, &mat.clearcoatTex,
+                               &mat.clearcoatRoughnessTex, &mat.clearcoatNormalTex, &mat.name })
+        path->clear();
+
+    inst.reflectivity = reflectivityFor(mc);
+    inst.materialVersion = obj.materialVersion;
 }
 
-glm::vec3 Raytracer::sampleGlossyReflection(
-    const glm::vec3& hitPoint,
-    const glm::vec3& viewDir,
-    const glm::vec3& normal,
-    const MaterialCore& material,
-    const Light& lights,
-    int depth,
-        SeededRng& rng) const
+const MaterialCore& Raytracer::applyTextures(const Instance& inst, const HitRecord& hit, const glm::vec3& direction,
+                                             float footprintWidth, glm::vec3& normal, MaterialCore& textured) const
 {
-    // Check for perfect mirror fallback
-    if (microfacet::shouldUsePerfectMirror(material.roughness))
+    const MaterialCore& mat = m_materials[inst.material];
+    const MaterialTextures& maps = m_materialTextures[inst.material];
+    if (!maps.any())
+        return mat;
+
+    const TriangleMesh& mesh = m_blas[inst.blas].mesh;
+    const uint32_t t = hit.triangle;
+    const glm::vec2 uv = mesh.texcoord(t, hit.u, hit.v);
+
+    // Ray cone footprint mapped to uv units: the triangle's uv-to-world area
+    // ratio scales it, and the cone stretches over a tilted surface
+    const glm::vec3 e1 = inst.vectorToWorld * glm::vec3(mesh.e1x[t], mesh.e1y[t], mesh.e1z[t]);
+    const glm::vec3 e2 = inst.vectorToWorld * glm::vec3(mesh.e2x[t], mesh.e2y[t], mesh.e2z[t]);
+    const glm::vec2 duv1 = mesh.texcoord(t, 1) - mesh.texcoord(t, 0);
+    const glm::vec2 duv2 = mesh.texcoord(t, 2) - mesh.texcoord(t, 0);
+    const glm::vec3 faceCross = glm::cross(e1, e2);
+    const float worldArea = glm::length(faceCross);
+    const float uvDet = duv1.x * duv2.y - duv2.x * duv1.y;
+    float footprint = 0.0f;
+    if (worldArea > 0.0f && footprintWidth > 0.0f)
+    {
+        const float cosine = std::max(std::abs(glm::dot(faceCross, direction)) / worldArea, kMinFootprintCosine);
+        footprint = footprintWidth / cosine * std::sqrt(std::abs(uvDet) / worldArea);
+    }
+
+    // Same conventions as the raster shader: maps replace the factors,
+    // roughness is G and metallic is B
+    textured = mat;
+    glm::vec4 texel;
+    if (m_textures.sample(maps.baseColor, uv, footprint, texel))
+        textured.baseColor = glm::vec4(glm::vec3(texel), mat.baseColor.a);
+    if (m_textures.sample(maps.metallicRoughness, uv, footprint, texel))
     {
-        // Perfect mirror reflection
-        glm::vec3 reflectedDir = glm::reflect(-viewDir, normal);
-        Ray reflectedRay(hitPoint + normal * 0.001f, glm::normalize(reflectedDir));
-        return traceRay(reflectedRay, lights, depth + 1);
+        textured.roughness = glm::clamp(texel.g, 0.04f, 1.0f);
+        textured.metallic = texel.b;
     }
-    
-    // Glossy reflection with multiple samples
-    glm::vec3 totalReflectedColor(0.0f);
-    int validSamples = 0;
-    
-    // Generate stratified microfacet normals
-    std::vector<glm::vec3> microfacetNormals = microfacet::sampleBeckmannNormalsStratified(
-        normal, material.roughness, m_reflectionSpp, rng
-    );
-    
-    for (const glm::vec3& microfacetNormal : microfacetNormals)
+
+    // Tangent frame from the triangle's uv gradients, handedness included
+    if (std::abs(uvDet) > 1e-12f && m_textures.sample(maps.normal, uv, footprint, texel))
     {
-        // Compute reflection direction using the microfacet normal
-        glm::vec3 reflectedDir = microfacet::reflect(-viewDir, microfacetNormal);
-        
-        // Ensure the reflected ray is above the surface (avoid self-intersection)
-        if (glm::dot(reflectedDir, normal) > 0.0f)
+        const glm::vec3 dpdu = (e1 * duv2.y - e2 * duv1.y) / uvDet;
+        const glm::vec3 dpdv = (e2 * duv1.x - e1 * duv2.x) / uvDet;
+        glm::vec3 tangent = dpdu - normal * glm::dot(normal, dpdu);
+        const float tangentLength = glm::length(tangent);
+        if (tangentLength > 1e-12f)
         {
-            Ray reflectedRay(hitPoint + normal * 0.001f, glm::normalize(reflectedDir));
-            glm::vec3 sampleColor = traceRay(reflectedRay, lights, depth + 1);
-            
-            // Weight the sample (in a full implementation, this would include the BRDF weight)
-            // For now, we use equal weighting for all valid samples
-            totalReflectedColor += sampleColor;
-            validSamples++;
+            tangent /= tangentLength;
+            glm::vec3 bitangent = glm::cross(normal, tangent);
+            if (glm::dot(bitangent, dpdv) < 0.0f) bitangent = -bitangent;
+
+            glm::vec3 local = glm::vec3(texel) * 2.0f - 1.0f;
+            local.x *= mat.normalStrength;
+            local.y *= mat.normalStrength;
+            const glm::vec3 bent = tangent * local.x + bitangent * local.y + normal * local.z;
+            if (glm::dot(bent, bent) > 1e-12f)
+                normal = glm::normalize(bent);
         }
     }
-    
-    // Average the samples by valid sample count
-    if (validSamples > 0)
+    return textured;
+}
+
+void Raytracer::updateInstanceEmission(uint32_t index, const SceneObject& obj, bool geometryChanged)
+{
+    const Instance& inst = m_instances[index];
+    const MaterialCore& mat = m_materials[inst.material];
+    const glm::vec3 radiance = mat.isEmissive() ? mat.emissive : glm::vec3(0.0f);
+    const TriangleMesh& mesh = m_blas[inst.blas].mesh;
+    if (geometryChanged)
+        m_emissive.setInstance(index, mesh, obj.modelMatrix, radiance);
+    else
+        m_emissive.setRadiance(index, mesh, obj.modelMatrix, radiance);
+}
+
+void Raytracer::buildTLAS()
+{
+    std::vector<glm::vec3> primMin(m_instances.size()), primMax(m_instances.size());
+    for (size_t i = 0; i < m_instances.size(); ++i)
+    {
+        primMin[i] = m_instances[i].worldMin;
+        primMax[i] = m_instances[i].worldMax;
+    }
+    m_tlas.build(primMin, primMax);
+    m_builtTlasCost = m_tlas.sahCost();
+}
+
+// Refit after instances moved; rebuild once quality has degraded too far
+void Raytracer::refitTLAS()
+{
+    std::vector<glm::vec3> primMin(m_instances.size()), primMax(m_instances.size());
+    for (size_t i = 0; i < m_instances.size(); ++i)
     {
-        totalReflectedColor /= float(validSamples);
+        primMin[i] = m_instances[i].worldMin;
+        primMax[i] = m_instances[i].worldMax;
     }
-    else
+    m_tlas.refit(primMin, primMax);
+    if (m_tlas.sahCost() > m_builtTlasCost * 1.5f)
     {
-        // Fallback to perfect mirror if no valid samples
-        glm::vec3 reflectedDir = glm::reflect(-viewDir, normal);
-        Ray reflectedRay(hitPoint + normal * 0.001f, glm::normalize(reflectedDir));
-        totalReflectedColor = traceRay(reflectedRay, lights, depth + 1);
+        m_tlas.build(primMin, primMax);
+        m_builtTlasCost = m_tlas.sahCost();
     }
-    
-    return totalReflectedColor;
 }
 
-glm::vec3 Raytracer::computeRefraction(
+Ray Raytracer::sampleRefraction(
     const glm::vec3& hitPoint,
     const glm::vec3& incident,
     const glm::vec3& normal,
     const MaterialCore& material,
-    const Light& lights,
-    int depth) const
+    float u) const
 {
     // Determine media transition (entering or exiting material)
     float ior1, ior2;
     glm::vec3 adjustedNormal;
     refraction::determineMediaTransition(incident, normal, material.ior, ior1, ior2, adjustedNormal);
-    
-    // Calculate Fresnel reflectance
-    float cosTheta = std::abs(glm::dot(-incident, adjustedNormal));
-    float fresnelReflectance = refraction::fresnelSchlick(cosTheta, ior1, ior2);
-    
-    // Attempt refraction
+
+    // Fresnel reflectance is the probability of taking the reflected branch;
+    // total internal reflection always reflects
+    const float cosTheta = std::abs(glm::dot(-incident, adjustedNormal));
+    const float fresnelReflectance = refraction::fresnelSchlick(cosTheta, ior1, ior2);
+
     glm::vec3 refractedDir;
-    bool hasRefraction = refraction::refract(incident, adjustedNormal, ior1, ior2, refractedDir);
-    
-    glm::vec3 finalColor(0.0f);
-    
-    if (hasRefraction) {
-        // Compute refracted ray contribution
-        Ray refractedRay(hitPoint - adjustedNormal * 0.001f, refractedDir);
-        glm::vec3 refractedColor = traceRay(refractedRay, lights, depth + 1);
-        
-        // Mix reflection and refraction based on Fresnel
-        if (fresnelReflectance < 1.0f) {
-            // Compute reflection ray
-            glm::vec3 reflectedDir = glm::reflect(incident, adjustedNormal);
-            Ray reflectedRay(hitPoint + adjustedNormal * 0.001f, reflectedDir);
-            glm::vec3 reflectedColor = traceRay(reflectedRay, lights, depth + 1);
-            
-            // Blend reflection and refraction
-            finalColor = fresnelReflectance * reflectedColor + (1.0f - fresnelReflectance) * refractedColor;
-        } else {
-            finalColor = refractedColor;
-        }
-    } else {
-        // Total internal reflection - only reflection
-        glm::vec3 reflectedDir = glm::reflect(incident, adjustedNormal);
-        Ray reflectedRay(hitPoint + adjustedNormal * 0.001f, reflectedDir);
-        finalColor = traceRay(reflectedRay, lights, depth + 1);
-    }
-    
-    return finalColor;
+    if (u >= fresnelReflectance && refraction::refract(incident, adjustedNormal, ior1, ior2, refractedDir))
+        return Ray(hitPoint - adjustedNormal * 0.001f, refractedDir);
+
+    return Ray(hitPoint + adjustedNormal * 0.001f, glm::reflect(incident, adjustedNormal));
 }
@@ -11,12 +11,89 @@
 
 namespace raytracer {
 
+    // Shadow ray origin offset, keeps rays from re-hitting their own surface
+    constexpr float kShadowBias = 1e-3f;
+
+    namespace {
+        // Calls shade(sample) for every selected light that faces the
+        // surface and is not occluded, with sampled lights' color scaled by
+        // their estimator weight. Every such light is above the surface, so a
+        // single origin offset along the normal works for all shadow rays and
+        // they can be traced together.
+        template <typename Shade>
+        void forEachVisibleLight(
+            const glm::vec3& hitPoint,
+            const glm::vec3& normal,
+            const Light& lights,
+            const LightSelection& selection,
+            const EmissiveSample* areaSamples,
+            int areaSampleCount,
+            const Raytracer& raytracer,
+            Shade&& shade)
+        {
+            constexpr int kBatch = 16;
+            LightSample samples[kBatch];
+            Raytracer::ShadowQuery queries[kBatch];
+            int pending = 0;
+            const glm::vec3 shadowOrigin = hitPoint + normal * kShadowBias;
+
+            auto flush = [&]() {
+                raytracer.traceShadowRays(shadowOrigin, queries, pending);
+                for (int i = 0; i < pending; ++i) {
+                    if (!queries[i].blocked)
+                        shade(samples[i]);
+                }
+                pending = 0;
+            };
+
+            auto add = [&](const LightSource& light, float weight) {
+                LightSample sample = LightingSystem::sampleLight(light, hitPoint, normal);
+                if (!sample.valid) return;
+
+                sample.color *= weight;
+                samples[pending] = sample;
+                queries[pending].direction = sample.direction;
+                queries[pending].maxDistance = sample.distance - kShadowBias;
+                if (++pending == kBatch) flush();
+            };
+
+            // The emitter's own surface must not count as a blocker
+            for (int i = 0; i < areaSampleCount; ++i) {
+                const EmissiveSample& area = areaSamples[i];
+                if (glm::dot(area.direction, normal) <= 0.0f) continue;
+                LightSample& sample = samples[pending];
+                sample.direction = area.direction;
+                sample.distance = area.distance;
+                sample.color = area.radiance / area.pdf;
+                sample.pdf = area.pdf;
+                sample.valid = true;
+                queries[pending].direction = sample.direction;
+                queries[pending].maxDistance = sample.distance * 0.999f - kShadowBias;
+                if (++pending == kBatch) flush();
+            }
+
+            if (selection.all) {
+                for (const auto& light : lights.m_lights)
+                    add(light, 1.0f);
+            } else {
+                if (selection.fixed) {
+                    for (uint32_t index : *selection.fixed)
+                        add(lights.m_lights[index], 1.0f);
+                }
+                for (int i = 0; i < selection.count; ++i)
+                    add(lights.m_lights[selection.index[i]], selection.weight[i]);
+            }
+            if (pending > 0) flush();
+        }
+    }
+
     LightSample LightingSystem::sampleLight(
         const LightSource& light,
         const glm::vec3& hitPoint,
         const glm::vec3& normal)
     {
         LightSample sample;
+        sample.pdf = 0.0f;
         sample.valid = false;
 
         if (!light.enabled) {
@@ -37,8 +114,7 @@ namespace raytracer {
                 sample.distance = glm::length(lightVec);
                 if (sample.distance > 1e-6f) {
                     sample.direction = lightVec / sample.distance;
-                    // Inverse square falloff for point lights
-                    float attenuation = 1.0f / (1.0f + 0.1f * sample.distance + 0.01f * sample.distance * sample.distance);
+                    float attenuation = distanceAttenuation(sample.distance);
                     sample.color = light.color * light.intensity * attenuation;
                     sample.valid = glm::dot(sample.direction, normal) > 0.0f;
                 }
@@ -57,7 +133,7 @@ namespace raytracer {
                     float outerCone = std::cos(glm::radians(light.outerConeDeg));
                     
                     if (cosTheta > outerCone) {
-                        float attenuation = 1.0f / (1.0f + 0.1f * sample.distance + 0.01f * sample.distance * sample.distance);
+                        float attenuation = distanceAttenuation(sample.distance);
                         
                         // Smooth falloff between inner and outer cone
                         if (cosTheta < innerCone) {
@@ -128,12 +204,8 @@ namespace raytracer {
         const Raytracer& raytracer)
     {
         // Offset to avoid self-intersection
-        Ray shadowRay(hitPoint + lightDir * 0.001f, lightDir);
-        
-        // Check intersection - implementation depends on raytracer's public interface
-        // For now, we'll return false (no shadows) to focus on lighting
-        // TODO: Add proper shadow ray intersection
-        return false;
+        Ray shadowRay(hitPoint + lightDir * kShadowBias, lightDir);
+        return raytracer.occluded(shadowRay, lightDistance - kShadowBias);
     }
 
     glm::vec3 LightingSystem::computeLighting(
@@ -142,28 +214,52 @@ namespace raytracer {
         const glm::vec3& viewDir,
         const MaterialCore& material,
         const Light& lights,
-        const Raytracer& raytracer)
+        const Raytracer& raytracer,
+        const LightSelection& selection,
+        const EmissiveSample* areaSamples,
+        int areaSampleCount)
     {
         glm::vec3 color(0.0f);
 
         // Add ambient lighting
         color += computeAmbient(material, lights.m_globalAmbient);
 
-        // Process each light
-        for (const auto& light : lights.m_lights) {
-            LightSample sample = sampleLight(light, hitPoint, normal);
-            
-            if (sample.valid) {
-                // Check for shadows (currently disabled for debugging)
-                bool inShadow = false; // isInShadow(hitPoint, sample.direction, sample.distance, raytracer);
-                
-                if (!inShadow) {
-                    MaterialEval eval = evaluateMaterial(material, normal, viewDir, sample.direction, sample.color);
-                    color += eval.color;
-                }
-            }
-        }
+        forEachVisibleLight(hitPoint, normal, lights, selection, areaSamples, areaSampleCount, raytracer, [&](const LightSample& sample) {
+            color += evaluateMaterial(material, normal, viewDir, sample.direction, sample.color).color;
+        });
+
+        return color;
+    }
 
+    glm::vec3 LightingSystem::computeGlossyLighting(
+        const glm::vec3& hitPoint,
+        const glm::vec3& normal,
+        const glm::vec3& viewDir,
+        const glm::vec3& F0,
+        float roughness,
+        const Light& lights,
+        const Raytracer& raytracer,
+        const LightSelection& selection,
+        const EmissiveSample* areaSamples,
+        int areaSampleCount,
+        bool lobeSampled)
+    {
+        // Point, spot and directional lights are deltas that sampled
+        // reflection rays can never hit, so light sampling carries their full
+        // contribution (MIS weight 1). Emissive geometry and the environment
+        // can also be found by the reflection ray, which the path tracer
+        // weights the other way.
+        const float alpha = brdf::roughnessToAlpha(roughness);
+        glm::vec3 color(0.0f);
+        forEachVisibleLight(hitPoint, normal, lights, selection, areaSamples, areaSampleCount, raytracer, [&](const LightSample& sample) {
+            const float NdotL = glm::dot(normal, sample.direction);
+            float weight = 1.0f;
+            if (lobeSampled && sample.pdf > 0.0f) {
+                const float bsdfPdf = brdf::ggxReflectionPdf(normal, viewDir, sample.direction, alpha);
+                weight = sample.pdf * sample.pdf / (sample.pdf * sample.pdf + bsdfPdf * bsdfPdf);
+            }
+            color += brdf::ggxSpecular(normal, viewDir, sample.direction, F0, alpha) * sample.color * (NdotL * weight);
+        });
         return color;
     }
 
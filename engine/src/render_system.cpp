@@ -11,11 +11,17 @@
 #include "gizmo.h"
 #include "skybox.h"
 #include "ibl_system.h"
+#include "environment_map.h"
 #include "raytracer.h"
+#include "denoiser.h"
+#include "image_io.h"
 #include "texture.h"
+#include "texture_cache.h"
 #include "material_core.h"
 #include "render_mode_selector.h"
 #include "render_pass.h"
+#include "mesh_lod.h"
+#include "instance_batcher.h"
 #include <glint3d/rhi.h>
 #include <glint3d/rhi_types.h>
 #include <glint3d/texture_slots.h>
@@ -24,6 +30,7 @@
 #include <iostream>
 #include <vector>
 #include <cstdint>
+#include <cmath>
 #include <cstring>
 #include <unordered_set>
 #include <unordered_map>
@@ -58,8 +65,6 @@ void RenderSystem::bindUniformBlocks()
 void RenderSystem::ensureObjectPipeline(SceneObject& obj, bool usePbr)
 {
     if (!m_rhi) return;
-    bool hasNormals = (obj.rhiVboNormals != INVALID_HANDLE);
-    bool hasUVs = (obj.rhiVboTexCoords != INVALID_HANDLE);
 
     // Always use PBR pipeline (standard shader eliminated)
     PipelineHandle& target = obj.rhiPipelinePbr;
@@ -86,15 +91,7 @@ void RenderSystem::ensureObjectPipeline(SceneObject& obj, bool usePbr)
         pd.depthWriteEnable = false; // Disable depth writes for transparency
     }
 
-    VertexBinding bPos{}; bPos.binding = 0; bPos.stride = 3 * sizeof(float); bPos.buffer = obj.rhiVboPositions; pd.vertexBindings.push_back(bPos);
-    if (hasNormals) { VertexBinding bN{}; bN.binding = 1; bN.stride = 3 * sizeof(float); bN.buffer = obj.rhiVboNormals; pd.vertexBindings.push_back(bN); }
-    if (hasUVs) { VertexBinding bUV{}; bUV.binding = 2; bUV.stride = 2 * sizeof(float); bUV.buffer = obj.rhiVboTexCoords; pd.vertexBindings.push_back(bUV); }
-
-    VertexAttribute aPos{}; aPos.location = 0; aPos.binding = 0; aPos.format = TextureFormat::RGB32F; aPos.offset = 0; pd.vertexAttributes.push_back(aPos);
-    if (hasNormals) { VertexAttribute aN{}; aN.location = 1; aN.binding = 1; aN.format = TextureFormat::RGB32F; aN.offset = 0; pd.vertexAttributes.push_back(aN); }
-    if (hasUVs) { VertexAttribute aUV{}; aUV.location = 2; aUV.binding = 2; aUV.format = TextureFormat::RG32F; aUV.offset = 0; pd.vertexAttributes.push_back(aUV); }
-
-    pd.indexBuffer = obj.rhiEbo;
+    PipelineManager::addMeshLayout(pd, obj);
     target = m_rhi->createPipeline(pd);
     // Bind immediately so subsequent uniform calls apply to correct program
     m_rhi->bindPipeline(target);
@@ -110,10 +107,6 @@ void RenderSystem::ensureObjectPipeline(SceneObject& obj, bool usePbr)
 #include "stb_image_write.h"
 #endif
 
-#ifdef OIDN_ENABLED
-#include <OpenImageDenoise/oidn.hpp>
-#endif
-
 RenderSystem::RenderSystem()
     : m_activePipelineMode(RenderPipelineMode::Raster)
 {
@@ -121,6 +114,7 @@ RenderSystem::RenderSystem()
     m_axisRenderer = std::make_unique<AxisRenderer>();
     m_grid = std::make_unique<Grid>();
     m_raytracer = std::make_unique<Raytracer>();
+    m_denoiser = std::make_unique<Denoiser>();
     m_gizmo = std::make_unique<Gizmo>();
     m_skybox = std::make_unique<Skybox>();
     m_iblSystem = std::make_unique<IBLSystem>();
@@ -158,6 +152,7 @@ bool RenderSystem::init(int windowWidth, int windowHeight)
                 std::cerr << "Failed to initialize PipelineManager" << std::endl;
                 return false;
             }
+            m_instanceBatcher.init(m_rhi.get(), &m_pipelineManager);
 
             if (!m_transformManager.init(m_rhi.get())) {
                 std::cerr << "Failed to initialize TransformManager" << std::endl;
@@ -327,6 +322,9 @@ void RenderSystem::shutdown()
     // m_basicShader, m_pbrShader, m_gridShader removed - using RHI shaders exclusively
     // Note: m_dummyShadowTexRhi cleanup handled by RHI shutdown
 
+    m_instanceBatcher.shutdown();
+    if (m_rhi && m_gBufferShader != INVALID_HANDLE) { m_rhi->destroyShader(m_gBufferShader); m_gBufferShader = INVALID_HANDLE; }
+
     // Shutdown managers (will handle UBO cleanup)
     m_lightingManager.shutdown();
     m_materialManager.shutdown();
@@ -370,7 +368,7 @@ void RenderSystem::renderUnified(const SceneManager& scene, const Light& lights)
     for (const auto& obj : scene.getObjects()) {
         materials.push_back(obj.materialCore);
     }
-    RenderConfig config;
+    RenderConfig config = m_renderConfig;
     config.mode = m_pipelineOverride;
     RenderPipelineMode mode = m_pipelineSelector->selectMode(materials, config);
     m_activePipelineMode = mode;
@@ -449,7 +447,14 @@ void RenderSystem::setBackgroundHDR(const std::string& hdrPath)
 bool RenderSystem::loadHDREnvironment(const std::string& hdrPath)
 {
     if (!m_iblSystem) return false;
-    
+
+    // The raytracer lights with the same CPU data the IBL upload below reads;
+    // holding it here keeps the cache from decoding the file twice
+    std::shared_ptr<const EnvironmentMap> environment = EnvironmentMap::load(hdrPath);
+    if (environment && m_raytracer) {
+        m_raytracer->setEnvironment(environment, m_iblSystem->getIntensity());
+    }
+
     if (m_iblSystem->loadHDREnvironment(hdrPath)) {
         // Generate IBL maps
         m_iblSystem->generateIrradianceMap();
@@ -468,6 +473,9 @@ void RenderSystem::setIBLIntensity(float intensity)
     if (m_iblSystem) {
         m_iblSystem->setIntensity(intensity);
     }
+    if (m_raytracer) {
+        m_raytracer->setEnvironmentIntensity(intensity);
+    }
 }
 
 // renderToTexture() REMOVED (FEAT-0253 completion - opengl_migration task)
@@ -515,15 +523,10 @@ bool RenderSystem::renderToPNG(const SceneManager& scene, const Light& lights,
                 rb.destinationSize = pixels.size();
                 m_rhi->readback(rb);
 
-                // Flip vertically for conventional image orientation
-                std::vector<std::uint8_t> flipped(height * rowStride);
-                for (int y = 0; y < height; ++y) {
-                    std::memcpy(flipped.data() + (height - 1 - y) * rowStride,
-                                pixels.data() + y * rowStride,
-                                rowStride);
-                }
-
-                int writeOK = stbi_write_png(path.c_str(), width, height, comp, flipped.data(), rowStride);
+                // Readback is bottom row first; the writer flips it on the way out
+                stbi_flip_vertically_on_write(1);
+                int writeOK = stbi_write_png(path.c_str(), width, height, comp, pixels.data(), rowStride);
+                stbi_flip_vertically_on_write(0);
 
                 // Viewport restoration handled by RenderSystem internally
                 // No framebuffer restoration needed since we used RHI render targets
@@ -572,14 +575,9 @@ bool RenderSystem::renderToPNG(const SceneManager& scene, const Light& lights,
     rb.destinationSize = pixels.size();
     m_rhi->readback(rb);
 
-    std::vector<std::uint8_t> flipped(height * rowStride);
-    for (int y = 0; y < height; ++y) {
-        std::memcpy(flipped.data() + (height - 1 - y) * rowStride,
-                    pixels.data() + y * rowStride,
-                    rowStride);
-    }
-
-    int writeOK = stbi_write_png(path.c_str(), width, height, comp, flipped.data(), rowStride);
+    stbi_flip_vertically_on_write(1);
+    int writeOK = stbi_write_png(path.c_str(), width, height, comp, pixels.data(), rowStride);
+    stbi_flip_vertically_on_write(0);
 
     // Cleanup RHI texture
     m_rhi->destroyTexture(colorTexHandle);
@@ -588,6 +586,184 @@ bool RenderSystem::renderToPNG(const SceneManager& scene, const Light& lights,
 #endif
 }
 
+bool RenderSystem::renderToEXR(const SceneManager& scene, const Light& lights,
+                               const std::string& path, int width, int height, bool halfFloat)
+{
+#ifdef __EMSCRIPTEN__
+    (void)scene; (void)lights; (void)path; (void)width; (void)height; (void)halfFloat;
+    std::cerr << "renderToEXR is not supported on Web builds.\n";
+    return false;
+#else
+    if (width <= 0 || height <= 0) return false;
+
+    // All passes come out of a single render, bottom row first
+    std::vector<glm::vec3> color;
+    raytracer::AuxiliaryOutputs rasterAovs;
+    const raytracer::AuxiliaryOutputs* aovs = nullptr;
+    // The raytracer fills AOVs only for this export; its previous setting
+    // comes back once they are written, on every return path
+    struct AuxiliaryOutputsRestore {
+        Raytracer* raytracer = nullptr;
+        bool enabled = false;
+        ~AuxiliaryOutputsRestore() { if (raytracer) raytracer->setAuxiliaryOutputs(enabled); }
+    } restoreAux;
+    if (m_renderMode == RenderMode::Raytrace) {
+        if (!m_raytracer) {
+            std::cerr << "[RenderSystem] Raytracer not initialized\n";
+            return false;
+        }
+        m_raytracer->setSeed(m_seed);
+        m_raytracer->syncScene(scene);
+        m_raytracer->setMaxDepth(m_renderConfig.maxRayDepth);
+        restoreAux.raytracer = m_raytracer.get();
+        restoreAux.enabled = m_raytracer->getAuxiliaryOutputsEnabled();
+        m_raytracer->setAuxiliaryOutputs(true);
+        renderRaytracedAdaptive(color, width, height, lights, m_renderConfig.maxSamples, /*displayRange=*/false);
+        if (m_denoiseEnabled && !denoiseRaytraced(color, width, height)) {
+            std::cerr << "[RenderSystem] Denoising failed, writing raw raytraced color\n";
+        }
+        aovs = &m_raytracer->getAuxiliaryOutputs();
+    } else {
+        if (!m_rhi) {
+            std::cerr << "[RenderSystem] renderToEXR requires RHI initialization\n";
+            return false;
+        }
+        if (!renderRasterAOVs(scene, lights, width, height, color, rasterAovs))
+            return false;
+        aovs = &rasterAovs;
+    }
+
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    if (color.size() != pixelCount || aovs->albedo.size() != pixelCount) {
+        std::cerr << "[RenderSystem] renderToEXR: render produced no AOVs\n";
+        return false;
+    }
+
+    // Depth keeps full precision for reprojection; IDs are exact integers
+    using ImageIO::ExrPixelType;
+    const ExrPixelType colorType = halfFloat ? ExrPixelType::Half : ExrPixelType::Float;
+    std::vector<ImageIO::ExrChannel> channels = {
+        { "R", &color[0].r, 3, colorType },
+        { "G", &color[0].g, 3, colorType },
+        { "B", &color[0].b, 3, colorType },
+        { "albedo.R", &aovs->albedo[0].r, 3, colorType },
+        { "albedo.G", &aovs->albedo[0].g, 3, colorType },
+        { "albedo.B", &aovs->albedo[0].b, 3, colorType },
+        { "normal.X", &aovs->normal[0].x, 3, colorType },
+        { "normal.Y", &aovs->normal[0].y, 3, colorType },
+        { "normal.Z", &aovs->normal[0].z, 3, colorType },
+        { "Z", aovs->depth.data(), 1, ExrPixelType::Float },
+        { "objectId", aovs->objectId.data(), 1, ExrPixelType::Uint },
+    };
+    return ImageIO::SaveImageEXR(path, width, height, std::move(channels), /*flipY=*/true);
+#endif
+}
+
+bool RenderSystem::renderRasterAOVs(const SceneManager& scene, const Light& lights, int width, int height,
+                                    std::vector<glm::vec3>& color, raytracer::AuxiliaryOutputs& aovs)
+{
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    std::vector<glm::vec4> pixels(pixelCount);
+    auto readback = [&](TextureHandle texture) {
+        ReadbackDesc rb{};
+        rb.sourceTexture = texture;
+        rb.format = TextureFormat::RGBA32F;
+        rb.width = width; rb.height = height;
+        rb.destination = pixels.data();
+        rb.destinationSize = pixels.size() * sizeof(glm::vec4);
+        m_rhi->readback(rb);
+    };
+
+    TextureDesc td{};
+    td.type = TextureType::Texture2D;
+    td.format = TextureFormat::RGBA32F;
+    td.width = width; td.height = height; td.depth = 1;
+    td.generateMips = false;
+
+    // Linear color: the forward pass without tone mapping and gamma, and
+    // without MSAA so its edges line up with the G-buffer passes
+    td.debugName = "renderToEXR_color";
+    TextureHandle colorTex = m_rhi->createTexture(td);
+    if (colorTex == INVALID_HANDLE) {
+        std::cerr << "[RenderSystem] renderToEXR: failed to create color texture\n";
+        return false;
+    }
+    const int samples = m_samples;
+    m_samples = 1;
+    m_renderingManager.updateRenderingState(m_exposure, 1.0f, RenderToneMapMode::Linear, m_shadingMode, m_iblSystem.get());
+    const bool colorOk = renderToTextureRHI(scene, lights, colorTex, width, height);
+    m_renderingManager.updateRenderingState(m_exposure, m_gamma, m_tonemap, m_shadingMode, m_iblSystem.get());
+    m_samples = samples;
+    if (colorOk) {
+        readback(colorTex);
+        color.resize(pixelCount);
+        std::transform(pixels.begin(), pixels.end(), color.begin(), [](const glm::vec4& p) { return glm::vec3(p); });
+    }
+    m_rhi->destroyTexture(colorTex);
+    if (!colorOk) return false;
+
+    // G-buffer at full float precision, with object IDs in the material alpha
+    const char* names[4] = { "renderToEXR_gBaseColor", "renderToEXR_gNormal", "renderToEXR_gPosition", "renderToEXR_gMaterial" };
+    TextureHandle gTex[4];
+    RenderTargetDesc rtDesc{};
+    rtDesc.width = width; rtDesc.height = height;
+    rtDesc.debugName = "renderToEXR_gBufferRT";
+    for (int i = 0; i < 4; ++i) {
+        td.debugName = names[i];
+        gTex[i] = m_rhi->createTexture(td);
+        RenderTargetAttachment attachment{};
+        attachment.type = static_cast<AttachmentType>(static_cast<int>(AttachmentType::Color0) + i);
+        attachment.texture = gTex[i];
+        rtDesc.colorAttachments.push_back(attachment);
+    }
+    td.format = TextureFormat::Depth24Stencil8;
+    td.debugName = "renderToEXR_gDepth";
+    TextureHandle depthTex = m_rhi->createTexture(td);
+    rtDesc.depthAttachment.type = AttachmentType::Depth;
+    rtDesc.depthAttachment.texture = depthTex;
+    RenderTargetHandle gBufferRT = m_rhi->createRenderTarget(rtDesc);
+
+    bool ok = gBufferRT != INVALID_HANDLE;
+    if (ok) {
+        const glm::mat4 prevProj = m_cameraManager.projectionMatrix();
+        updateProjectionMatrix(width, height);
+        PassContext ctx;
+        ctx.rhi = m_rhi.get();
+        ctx.scene = &scene;
+        ctx.lights = &lights;
+        ctx.renderer = this;
+        ctx.viewportWidth = width;
+        ctx.viewportHeight = height;
+        passGBuffer(ctx, gBufferRT);
+        m_rhi->bindRenderTarget(INVALID_HANDLE);
+        m_cameraManager.setProjectionMatrix(prevProj);
+
+        aovs.reset(pixelCount);
+        readback(gTex[3]);
+        for (size_t i = 0; i < pixelCount; ++i)
+            aovs.objectId[i] = static_cast<uint32_t>(std::lround(std::max(pixels[i].a, 0.0f)));
+        readback(gTex[0]);
+        for (size_t i = 0; i < pixelCount; ++i)
+            aovs.albedo[i] = glm::vec3(pixels[i]);
+        readback(gTex[1]);
+        for (size_t i = 0; i < pixelCount; ++i)
+            if (aovs.objectId[i]) aovs.normal[i] = glm::vec3(pixels[i]) * 2.0f - 1.0f;
+        const CameraState& camera = m_cameraManager.camera();
+        const glm::vec3 viewAxis = glm::normalize(camera.front);
+        readback(gTex[2]);
+        for (size_t i = 0; i < pixelCount; ++i)
+            if (aovs.objectId[i]) aovs.depth[i] = glm::dot(glm::vec3(pixels[i]) - camera.position, viewAxis);
+    } else {
+        std::cerr << "[RenderSystem] renderToEXR: failed to create G-buffer render target\n";
+    }
+
+    if (gBufferRT != INVALID_HANDLE) m_rhi->destroyRenderTarget(gBufferRT);
+    for (TextureHandle t : gTex)
+        if (t != INVALID_HANDLE) m_rhi->destroyTexture(t);
+    if (depthTex != INVALID_HANDLE) m_rhi->destroyTexture(depthTex);
+    return ok;
+}
+
 bool RenderSystem::renderToTextureRHI(const SceneManager& scene, const Light& lights,
                                      TextureHandle textureHandle, int width, int height)
 {
@@ -685,194 +861,35 @@ void RenderSystem::updateProjectionMatrix(int windowWidth, int windowHeight)
 }
 
 
-void RenderSystem::setReflectionSpp(int spp)
-{
-    m_reflectionSpp = std::max(1, spp); // Ensure at least 1 sample
-    if (m_raytracer) {
-        m_raytracer->setReflectionSpp(m_reflectionSpp);
-    }
-}
-
-int RenderSystem::getReflectionSpp() const
-{
-    return m_reflectionSpp;
-}
-
 bool RenderSystem::denoise(std::vector<glm::vec3>& color,
                           const std::vector<glm::vec3>* normal,
                           const std::vector<glm::vec3>* albedo)
 {
-#ifdef OIDN_ENABLED
-    try {
-        if (color.empty()) {
-            std::cerr << "[RenderSystem::denoise] Empty color buffer\n";
-            return false;
-        }
-
-        // Create OIDN device
-        oidn::DeviceRef device = oidn::newDevice();
-        device.commit();
-        
-        // Check for errors
-        const char* errorMessage;
-        if (device.getError(errorMessage) != oidn::Error::None) {
-            std::cerr << "[RenderSystem::denoise] OIDN device error: " << errorMessage << "\n";
-            return false;
-        }
-
-        // Try to guess square dimensions (common for raytracer)
-        int width = static_cast<int>(std::sqrt(color.size()));
-        int height = width;
-        
-        // Verify we have a proper square image
-        if (width * height != static_cast<int>(color.size())) {
-            std::cerr << "[RenderSystem::denoise] Cannot determine image dimensions from buffer size " 
-                      << color.size() << ". Use the overload with explicit width/height.\n";
-            return false;
-        }
-
-        // Create the filter for ray tracing denoising
-        oidn::FilterRef filter = device.newFilter("RT"); // Ray tracing filter
-        
-        // Set input images
-        filter.setImage("color", const_cast<void*>(static_cast<const void*>(color.data())), oidn::Format::Float3, width, height);
-        
-        // Optional: Set auxiliary buffers if available
-        if (normal && normal->size() == color.size()) {
-            filter.setImage("normal", const_cast<void*>(static_cast<const void*>(normal->data())), oidn::Format::Float3, width, height);
-        }
-        
-        if (albedo && albedo->size() == color.size()) {
-            filter.setImage("albedo", const_cast<void*>(static_cast<const void*>(albedo->data())), oidn::Format::Float3, width, height);
-        }
-        
-        // Set output image (in-place denoising)
-        filter.setImage("output", static_cast<void*>(color.data()), oidn::Format::Float3, width, height);
-        
-        // Set filter quality (optional - can be "fast", "balanced", "high")
-        filter.set("hdr", true); // Enable HDR processing for better quality
-        filter.set("srgb", false); // We're working in linear space
-        
-        // Commit the filter
-        filter.commit();
-        
-        // Check for errors
-        if (device.getError(errorMessage) != oidn::Error::None) {
-            std::cerr << "[RenderSystem::denoise] OIDN filter setup error: " << errorMessage << "\n";
-            return false;
-        }
-
-        // Execute the filter
-        filter.execute();
-        
-        // Check for errors after execution
-        if (device.getError(errorMessage) != oidn::Error::None) {
-            std::cerr << "[RenderSystem::denoise] OIDN execution error: " << errorMessage << "\n";
-            return false;
-        }
-
-        std::cout << "[RenderSystem::denoise] Successfully denoised " 
-                  << width << "x" << height << " image\n";
-        return true;
-    }
-    catch (const std::exception& e) {
-        std::cerr << "[RenderSystem::denoise] Exception: " << e.what() << "\n";
+    // Try to guess square dimensions (common for raytracer)
+    const int side = static_cast<int>(std::sqrt(static_cast<double>(color.size())));
+    if (static_cast<size_t>(side) * side != color.size()) {
+        std::cerr << "[RenderSystem::denoise] Cannot determine image dimensions from buffer size "
+                  << color.size() << ". Use the overload with explicit width/height.\n";
         return false;
     }
-#else
-    // Fallback for builds without OIDN - just return false to indicate no denoising was done
-    std::cout << "[RenderSystem::denoise] Intel Open Image Denoise not available in this build\n";
-    return false;
-#endif
+    return denoise(color, side, side, normal, albedo);
 }
 
 bool RenderSystem::denoise(std::vector<glm::vec3>& color, int width, int height,
                           const std::vector<glm::vec3>* normal,
                           const std::vector<glm::vec3>* albedo)
 {
-#ifdef OIDN_ENABLED
-    try {
-        if (color.empty()) {
-            std::cerr << "[RenderSystem::denoise] Empty color buffer\n";
-            return false;
-        }
-        
-        if (width <= 0 || height <= 0) {
-            std::cerr << "[RenderSystem::denoise] Invalid dimensions: " << width << "x" << height << "\n";
-            return false;
-        }
-
-        // Verify buffer size matches dimensions
-        if (static_cast<int>(color.size()) != width * height) {
-            std::cerr << "[RenderSystem::denoise] Buffer size " << color.size() 
-                      << " doesn't match dimensions " << width << "x" << height << "\n";
-            return false;
-        }
-
-        // Create OIDN device
-        oidn::DeviceRef device = oidn::newDevice();
-        device.commit();
-        
-        // Check for errors
-        const char* errorMessage;
-        if (device.getError(errorMessage) != oidn::Error::None) {
-            std::cerr << "[RenderSystem::denoise] OIDN device error: " << errorMessage << "\n";
-            return false;
-        }
-
-        // Create the filter for ray tracing denoising
-        oidn::FilterRef filter = device.newFilter("RT"); // Ray tracing filter
-        
-        // Set input images
-        filter.setImage("color", const_cast<void*>(static_cast<const void*>(color.data())), oidn::Format::Float3, width, height);
-        
-        // Optional: Set auxiliary buffers if available
-        if (normal && static_cast<int>(normal->size()) == width * height) {
-            filter.setImage("normal", const_cast<void*>(static_cast<const void*>(normal->data())), oidn::Format::Float3, width, height);
-        }
-        
-        if (albedo && static_cast<int>(albedo->size()) == width * height) {
-            filter.setImage("albedo", const_cast<void*>(static_cast<const void*>(albedo->data())), oidn::Format::Float3, width, height);
-        }
-        
-        // Set output image (in-place denoising)
-        filter.setImage("output", static_cast<void*>(color.data()), oidn::Format::Float3, width, height);
-        
-        // Set filter quality
-        filter.set("hdr", true); // Enable HDR processing for better quality
-        filter.set("srgb", false); // We're working in linear space
-        
-        // Commit the filter
-        filter.commit();
-        
-        // Check for errors
-        if (device.getError(errorMessage) != oidn::Error::None) {
-            std::cerr << "[RenderSystem::denoise] OIDN filter setup error: " << errorMessage << "\n";
-            return false;
-        }
-
-        // Execute the filter
-        filter.execute();
-        
-        // Check for errors after execution
-        if (device.getError(errorMessage) != oidn::Error::None) {
-            std::cerr << "[RenderSystem::denoise] OIDN execution error: " << errorMessage << "\n";
-            return false;
-        }
+    // The denoiser keeps its OIDN device and filter between frames
+    return m_denoiser && m_denoiser->denoise(color, width, height, normal, albedo);
+}
 
-        std::cout << "[RenderSystem::denoise] Successfully denoised " 
-                  << width << "x" << height << " image with explicit dimensions\n";
-        return true;
-    }
-    catch (const std::exception& e) {
-        std::cerr << "[RenderSystem::denoise] Exception: " << e.what() << "\n";
-        return false;
-    }
-#else
-    // Fallback for builds without OIDN
-    std::cout << "[RenderSystem::denoise] Intel Open Image Denoise not available in this build (explicit dimensions version)\n";
-    return false;
-#endif
+bool RenderSystem::denoiseRaytraced(std::vector<glm::vec3>& color, int width, int height)
+{
+    // Guides are skipped when they do not match the frame (e.g. disabled)
+    if (!m_raytracer)
+        return denoise(color, width, height);
+    const Raytracer::AuxiliaryOutputs& aux = m_raytracer->getAuxiliaryOutputs();
+    return denoise(color, width, height, &aux.normal, &aux.albedo);
 }
 
 void RenderSystem::renderRasterized(const SceneManager& scene, const Light& lights)
@@ -887,6 +904,21 @@ void RenderSystem::renderRasterized(const SceneManager& scene, const Light& ligh
     renderObjectsBatched(scene, lights);
 }
 
+void RenderSystem::renderRaytracedAdaptive(std::vector<glm::vec3>& out, int width, int height,
+                                           const Light& lights, int maxSamples, bool displayRange)
+{
+    Raytracer::AdaptiveSampling sampling;
+    sampling.maxSamples = std::max(1, maxSamples);
+    sampling.minSamples = std::min(std::max(1, m_renderConfig.minSamples), sampling.maxSamples);
+    sampling.noiseThreshold = std::max(0.0f, 1.0f - m_renderConfig.qualityThreshold);
+    sampling.timeBudgetSeconds = m_renderConfig.timeBudgetSeconds;
+    sampling.displayRange = displayRange;
+
+    const auto& cameraState = m_cameraManager.camera();
+    m_raytracer->renderAdaptive(out, width, height, cameraState.position, cameraState.front, cameraState.up,
+                                cameraState.fov, lights, sampling);
+}
+
 void RenderSystem::renderRaytraced(const SceneManager& scene, const Light& lights)
 {
     if (!m_raytracer) {
@@ -904,39 +936,11 @@ void RenderSystem::renderRaytraced(const SceneManager& scene, const Light& light
     if (!m_raytraceTexture)
         initRaytraceTexture();
 
-    // Clear existing raytracer data and load all scene objects
-    m_raytracer = std::make_unique<Raytracer>();
-    
     // Set the seed for deterministic rendering
     m_raytracer->setSeed(m_seed);
-    
-    // Set reflection samples per pixel for glossy reflections
-    m_raytracer->setReflectionSpp(m_reflectionSpp);
-    
-    const auto& objects = scene.getObjects();
-    std::cout << "[RenderSystem] Loading " << objects.size() << " objects into raytracer\n";
-    
-    for (const auto& obj : objects) {
-        if (obj.objLoader.getVertCount() == 0) continue; // Skip objects with no geometry
-        
-        // Load object into raytracer with its transform and material
-        // Calculate reflectivity from unified MaterialCore
-        const auto& mc = obj.materialCore;
-        float reflectivity = 0.1f; // Default reflectivity
-
-        // For metallic materials, use metallic value as reflectivity multiplier
-        if (mc.metallic > 0.1f) {
-            reflectivity = 0.3f + (mc.metallic * 0.7f); // Range 0.3 to 1.0 based on metallic
-        }
-
-        // ðŸš¨ DEPRECATED CONVERSION: MaterialCore â†’ legacy Material for raytracer API
-        // TODO CLEANUP: Update Raytracer::loadModel() to accept MaterialCore directly
-        // CLEANUP TASK: Modify raytracer.h signature and eliminate this conversion
-        // Using MaterialCore directly (no conversion needed)
-        
 
-        m_raytracer->loadModel(obj.objLoader, obj.modelMatrix, reflectivity, mc);
-    }
+    // Persistent raytracer scene: only objects changed since the last sync are updated
+    m_raytracer->syncScene(scene);
 
     // Create output buffer for raytraced image
     std::vector<glm::vec3> raytraceBuffer(m_raytraceWidth * m_raytraceHeight);
@@ -947,14 +951,14 @@ void RenderSystem::renderRaytraced(const SceneManager& scene, const Light& light
     if (m_raytracer) {
         m_raytracer->setSeed(m_seed);
     }
-    m_raytracer->renderImage(raytraceBuffer, m_raytraceWidth, m_raytraceHeight,
-                            m_cameraManager.camera().position, m_cameraManager.camera().front, m_cameraManager.camera().up, 
-                            m_cameraManager.camera().fov, lights);
+    m_raytracer->setMaxDepth(m_renderConfig.maxRayDepth);
+    m_raytracer->setAuxiliaryOutputs(m_denoiseEnabled && Denoiser::isAvailable());
+    renderRaytracedAdaptive(raytraceBuffer, m_raytraceWidth, m_raytraceHeight, lights, m_renderConfig.maxSamples);
     
-    // Apply OIDN denoising if enabled
+    // Apply OIDN denoising if enabled, guided by the first-hit albedo and normal
     if (m_denoiseEnabled) {
         std::cout << "[RenderSystem] Applying OIDN denoising...\n";
-        if (!denoise(raytraceBuffer, m_raytraceWidth, m_raytraceHeight)) {
+        if (!denoiseRaytraced(raytraceBuffer, m_raytraceWidth, m_raytraceHeight)) {
             std::cerr << "[RenderSystem] Denoising failed, using raw raytraced image\n";
         }
     }
@@ -1010,7 +1014,7 @@ void RenderSystem::renderObject(const SceneObject& obj, const Light& lights)
 
     // FEAT-0249: Update UBOs for this object via managers
     // Update transform UBO with object-specific model matrix
-    m_transformManager.updateTransforms(obj.modelMatrix, m_cameraManager.viewMatrix(), m_cameraManager.projectionMatrix());
+    m_transformManager.updateTransforms(obj.modelMatrix * obj.rhiDequantize, m_cameraManager.viewMatrix(), m_cameraManager.projectionMatrix());
 
     // Update material UBO for this object
     m_materialManager.updateMaterialForObject(obj);
@@ -1043,6 +1047,7 @@ void RenderSystem::renderObject(const SceneObject& obj, const Light& lights)
     bool hasIndex = (obj.rhiEbo != INVALID_HANDLE);
     if (hasIndex) {
         dd.indexBuffer = obj.rhiEbo;
+        dd.indexFormat = obj.rhiIndexFormat;
         dd.indexCount = obj.objLoader.getIndexCount();
     } else {
         dd.vertexCount = obj.objLoader.getVertCount();
@@ -1052,6 +1057,36 @@ void RenderSystem::renderObject(const SceneObject& obj, const Light& lights)
     m_stats.drawCalls += 1;
 }
 
+int RenderSystem::selectLod(SceneObject& obj, int viewportHeight) const
+{
+    if (!obj.meshLods || obj.rhiLodEbos.size() != obj.meshLods->size() || m_lodErrorPixels <= 0.0f || viewportHeight <= 0) {
+        obj.lodLevel = 0;
+        return 0;
+    }
+
+    // Object-space error scales with the largest axis of the model matrix; a
+    // perspective view divides it by the distance to the nearest point of the
+    // bounding sphere, so the camera inside the bounds always gets full detail
+    const glm::mat4& proj = m_cameraManager.projectionMatrix();
+    const glm::mat4& model = obj.modelMatrix;
+    const float scale = std::max(glm::length(glm::vec3(model[0])),
+                                 std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    float pixelScale = MeshLod::pixelsPerUnit(proj, viewportHeight) * scale;
+    if (proj[3][3] != 1.0f) {
+        const glm::vec3 eye = m_cameraManager.camera().position;
+        const glm::vec3 lo = obj.objLoader.getMinBounds(), hi = obj.objLoader.getMaxBounds();
+        const glm::vec3 center = glm::vec3(model * glm::vec4(0.5f * (lo + hi), 1.0f));
+        const float distance = glm::length(eye - center) - 0.5f * glm::length(hi - lo) * scale;
+        pixelScale /= std::max(distance, 1e-4f);
+    }
+
+    float errors[MeshLod::kMaxLevels];
+    const size_t count = std::min(obj.meshLods->size(), size_t(MeshLod::kMaxLevels));
+    for (size_t i = 0; i < count; ++i) errors[i] = (*obj.meshLods)[i].error;
+    obj.lodLevel = MeshLod::selectLevel(errors, count, pixelScale, m_lodErrorPixels, obj.lodLevel);
+    return obj.lodLevel;
+}
+
 void RenderSystem::updateRenderStats(const SceneManager& scene)
 {
     // Update rendering statistics (non-invasive; keep existing drawCalls accumulated during render)
@@ -1068,7 +1103,7 @@ void RenderSystem::updateRenderStats(const SceneManager& scene)
     std::unordered_set<const Texture*> uniqueTex;
     size_t textureBytes = 0;
     for (const auto& obj : objects) {
-        const Texture* texes[4] = { obj.texture, obj.baseColorTex, obj.normalTex, obj.mrTex };
+        const Texture* texes[4] = { obj.texture.get(), obj.baseColorTex.get(), obj.normalTex.get(), obj.mrTex.get() };
         for (const Texture* t : texes) {
             if (!t) continue;
             if (uniqueTex.insert(t).second) {
@@ -1083,27 +1118,30 @@ void RenderSystem::updateRenderStats(const SceneManager& scene)
     m_stats.uniqueTextures = uniqueTex.size();
     m_stats.texturesMB = static_cast<float>(textureBytes) / (1024.0f * 1024.0f);
 
-    // Geometry memory estimate (positions + normals + uvs + tangents + indices)
+    // Geometry memory as uploaded (positions + normals + uvs + indices), in
+    // the formats SceneManager chose for each mesh
     size_t geoBytes = 0;
+    std::unordered_set<const MeshBuffers*> countedMeshes;   // duplicates share their source's buffers
     for (const auto& obj : objects) {
+        if (obj.meshBuffers && !countedMeshes.insert(obj.meshBuffers.get()).second) continue;
         const size_t vcount = static_cast<size_t>(obj.objLoader.getVertCount());
         const size_t icount = static_cast<size_t>(obj.objLoader.getIndexCount());
-        // positions (3 floats)
-        geoBytes += vcount * 3u * sizeof(float);
-        // normals if present
-        if (obj.objLoader.getNormals()) {
-            geoBytes += vcount * 3u * sizeof(float);
-        }
-        // uvs if present
-        if (obj.objLoader.hasTexcoords()) {
-            geoBytes += vcount * 2u * sizeof(float);
+        // positions (unorm16 xyz + padding)
+        geoBytes += vcount * 4u * sizeof(uint16_t);
+        // normals if present (octahedral snorm16)
+        if (obj.rhiVboNormals != INVALID_HANDLE) {
+            geoBytes += vcount * 2u * sizeof(int16_t);
         }
-        // tangents if present
-        if (obj.objLoader.hasTangents()) {
-            geoBytes += vcount * 3u * sizeof(float);
+        // uvs if present (half or float)
+        if (obj.rhiVboTexCoords != INVALID_HANDLE) {
+            geoBytes += vcount * 2u * (obj.rhiHalfTexCoords ? sizeof(uint16_t) : sizeof(float));
         }
-        // indices (uint32)
-        geoBytes += icount * sizeof(unsigned int);
+        // indices in the mesh's index format, including every level of detail
+        size_t lodIndices = 0;
+        if (obj.meshLods)
+            for (const MeshLod::Level& level : *obj.meshLods) lodIndices += level.indices.size();
+        const size_t indexSize = obj.rhiIndexFormat == IndexFormat::Uint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+        geoBytes += (icount + lodIndices) * indexSize;
     }
     m_stats.geometryMB = static_cast<float>(geoBytes) / (1024.0f * 1024.0f);
 
@@ -1143,6 +1181,12 @@ void RenderSystem::updateRenderStats(const SceneManager& scene)
 
     // Final VRAM estimate
     m_stats.vramMB = m_stats.texturesMB + m_stats.geometryMB;
+
+    const TextureCache::Stats texCache = TextureCache::instance().stats();
+    m_stats.textureCacheHits = texCache.hits;
+    m_stats.textureCacheMisses = texCache.misses;
+    m_stats.textureCacheEvictions = texCache.evictions;
+    m_stats.textureCacheMB = static_cast<float>(texCache.residentBytes) / (1024.0f * 1024.0f);
 }
 
 void RenderSystem::initScreenQuad()
@@ -1215,7 +1259,7 @@ void RenderSystem::renderSelectionOutline(const SceneManager& scene)
             // Post-processing uniforms for standard shader (selection overlay respects gamma/exposure) - RHI only
             // Update per-object data in UBOs
             // Update transform and rendering state using managers
-            m_transformManager.updateTransforms(obj.modelMatrix, m_cameraManager.viewMatrix(), m_cameraManager.projectionMatrix());
+            m_transformManager.updateTransforms(obj.modelMatrix * obj.rhiDequantize, m_cameraManager.viewMatrix(), m_cameraManager.projectionMatrix());
 
             // Set object color for selection
             m_renderingManager.setObjectColor(glm::vec3(0.2f, 0.7f, 1.0f)); // cyan-ish for selection
@@ -1251,17 +1295,7 @@ void RenderSystem::renderSelectionOutline(const SceneManager& scene)
                     pd.polygonOffsetFactor = -1.0f;
                     pd.polygonOffsetUnits = -1.0f;
 
-                    bool hasNormals = (obj.rhiVboNormals != INVALID_HANDLE);
-                    bool hasUVs = (obj.rhiVboTexCoords != INVALID_HANDLE);
-                    VertexBinding bPos{}; bPos.binding = 0; bPos.stride = 3 * sizeof(float); bPos.buffer = obj.rhiVboPositions; pd.vertexBindings.push_back(bPos);
-                    if (hasNormals) { VertexBinding bN{}; bN.binding = 1; bN.stride = 3 * sizeof(float); bN.buffer = obj.rhiVboNormals; pd.vertexBindings.push_back(bN); }
-                    if (hasUVs) { VertexBinding bUV{}; bUV.binding = 2; bUV.stride = 2 * sizeof(float); bUV.buffer = obj.rhiVboTexCoords; pd.vertexBindings.push_back(bUV); }
-
-                    VertexAttribute aPos{}; aPos.location = 0; aPos.binding = 0; aPos.format = TextureFormat::RGB32F; aPos.offset = 0; pd.vertexAttributes.push_back(aPos);
-                    if (hasNormals) { VertexAttribute aN{}; aN.location = 1; aN.binding = 1; aN.format = TextureFormat::RGB32F; aN.offset = 0; pd.vertexAttributes.push_back(aN); }
-                    if (hasUVs) { VertexAttribute aUV{}; aUV.location = 2; aUV.binding = 2; aUV.format = TextureFormat::RG32F; aUV.offset = 0; pd.vertexAttributes.push_back(aUV); }
-
-                    pd.indexBuffer = obj.rhiEbo;
+                    PipelineManager::addMeshLayout(pd, obj);
                     wireframePipeline = m_rhi->createPipeline(pd);
                     m_wireframePipelines[&obj] = wireframePipeline;
                 }
@@ -1270,6 +1304,7 @@ void RenderSystem::renderSelectionOutline(const SceneManager& scene)
                 dd.pipeline = wireframePipeline;
                 if (obj.rhiEbo != INVALID_HANDLE) {
                     dd.indexBuffer = obj.rhiEbo;
+                    dd.indexFormat = obj.rhiIndexFormat;
                     dd.indexCount = obj.objLoader.getIndexCount();
                 } else {
                     dd.vertexCount = obj.objLoader.getVertCount();
@@ -1373,6 +1408,7 @@ void RenderSystem::renderObjectFast(const SceneObject& obj, const Light& lights)
     if (m_rhi) {
         ensureObjectPipeline(const_cast<SceneObject&>(obj), true); // Always use PBR
         // FEAT-0249: model matrix now part of TransformBlock UBO, updated per-object
+        m_transformManager.updateModel(obj.modelMatrix * obj.rhiDequantize);
     }
 
     // FEAT-0249: PBR material data uses MaterialBlock UBO instead of individual uniforms
@@ -1397,6 +1433,7 @@ void RenderSystem::renderObjectFast(const SceneObject& obj, const Light& lights)
     bool hasIndex = (obj.rhiEbo != INVALID_HANDLE);
     if (hasIndex) {
         dd.indexBuffer = obj.rhiEbo;
+        dd.indexFormat = obj.rhiIndexFormat;
         dd.indexCount = obj.objLoader.getIndexCount();
     } else {
         dd.vertexCount = obj.objLoader.getVertCount();
@@ -1558,7 +1595,7 @@ void RenderSystem::passRaster(const PassContext& ctx)
     }
 
     // Render scene objects with batched approach using manager pipeline
-    renderObjectsBatchedWithManagers(*ctx.scene, *ctx.lights);
+    renderObjectsBatchedWithManagers(*ctx.scene, *ctx.lights, ctx.viewportHeight);
 }
 
 void RenderSystem::passRaytrace(const PassContext& ctx, int sampleCount, int maxDepth)
@@ -1580,39 +1617,11 @@ void RenderSystem::passRaytrace(const PassContext& ctx, int sampleCount, int max
     if (!m_raytraceTexture)
         initRaytraceTexture();
 
-    // Clear existing raytracer data and load all scene objects
-    m_raytracer = std::make_unique<Raytracer>();
-
     // Set the seed for deterministic rendering
     m_raytracer->setSeed(m_seed);
 
-    // Set reflection samples per pixel for glossy reflections
-    m_raytracer->setReflectionSpp(m_reflectionSpp);
-
-    const auto& objects = ctx.scene->getObjects();
-    std::cout << "[RenderSystem] Loading " << objects.size() << " objects into raytracer\n";
-
-    for (const auto& obj : objects) {
-        if (obj.objLoader.getVertCount() == 0) continue; // Skip objects with no geometry
-
-        // Load object into raytracer with its transform and material
-        // Calculate reflectivity from unified MaterialCore
-        const auto& mc = obj.materialCore;
-        float reflectivity = 0.1f; // Default reflectivity
-
-        // For metallic materials, use metallic value as reflectivity multiplier
-        if (mc.metallic > 0.1f) {
-            reflectivity = 0.3f + (mc.metallic * 0.7f); // Range 0.3 to 1.0 based on metallic
-        }
-
-        // 🚨 DEPRECATED CONVERSION: MaterialCore → legacy Material for raytracer API
-        // TODO CLEANUP: Update Raytracer::loadModel() to accept MaterialCore directly
-        // CLEANUP TASK: Modify raytracer.h signature and eliminate this conversion
-        // Using MaterialCore directly (no conversion needed)
-        
-
-        m_raytracer->loadModel(obj.objLoader, obj.modelMatrix, reflectivity, mc);
-    }
+    // Persistent raytracer scene: only objects changed since the last sync are updated
+    m_raytracer->syncScene(*ctx.scene);
 
     // Create output buffer for raytraced image
     std::vector<glm::vec3> raytraceBuffer(m_raytraceWidth * m_raytraceHeight);
@@ -1627,20 +1636,30 @@ void RenderSystem::passRaytrace(const PassContext& ctx, int sampleCount, int max
     // Use camera from CameraManager directly
     const auto& cameraState = m_cameraManager.camera();
 
-    m_raytracer->renderImage(raytraceBuffer, m_raytraceWidth, m_raytraceHeight,
-                            cameraState.position, cameraState.front, cameraState.up,
-                            cameraState.fov, *ctx.lights);
+    // Interactive frames refine the accumulated image a little at a time while
+    // the view is unchanged; offline frames render every sample at once
+    m_raytracer->setMaxDepth(maxDepth);
+    m_raytracer->setAuxiliaryOutputs(m_denoiseEnabled && Denoiser::isAvailable());
+    int added = 0;
+    if (ctx.interactive) {
+        added = m_raytracer->accumulate(raytraceBuffer, m_raytraceWidth, m_raytraceHeight,
+                                        cameraState.position, cameraState.front, cameraState.up,
+                                        cameraState.fov, *ctx.lights, kInteractiveSamplesPerFrame, sampleCount);
+    } else {
+        renderRaytracedAdaptive(raytraceBuffer, m_raytraceWidth, m_raytraceHeight, *ctx.lights, sampleCount);
+        added = sampleCount;
+    }
 
     // Apply OIDN denoising if enabled
-    if (m_denoiseEnabled) {
+    if (added > 0 && m_denoiseEnabled) {
         std::cout << "[RenderSystem] Applying OIDN denoising...\n";
-        if (!denoise(raytraceBuffer, m_raytraceWidth, m_raytraceHeight)) {
+        if (!denoiseRaytraced(raytraceBuffer, m_raytraceWidth, m_raytraceHeight)) {
             std::cerr << "[RenderSystem] Denoising failed, using raw raytraced image\n";
         }
     }
 
-    // Upload raytraced image to RHI texture
-    if (m_rhi && m_raytraceTextureRhi != INVALID_HANDLE) {
+    // Upload raytraced image to RHI texture (unchanged once converged)
+    if (added > 0 && m_rhi && m_raytraceTextureRhi != INVALID_HANDLE) {
         m_rhi->updateTexture(m_raytraceTextureRhi, raytraceBuffer.data(),
                            m_raytraceWidth, m_raytraceHeight, TextureFormat::RGB32F);
     }
@@ -1766,28 +1785,33 @@ void RenderSystem::passGBuffer(const PassContext& ctx, RenderTargetHandle gBuffe
     // Clear G-buffer attachments
     m_rhi->clear(glm::vec4(0.0f, 0.0f, 0.0f, 0.0f), 1.0f, 0);
 
-    // Get or create G-buffer pipeline
-    PipelineHandle gBufferPipeline = getOrCreateGBufferPipeline();
-    if (gBufferPipeline == INVALID_HANDLE) {
-        std::cerr << "RenderSystem::passGBuffer: Failed to create G-buffer pipeline" << std::endl;
+    // The g-buffer shader is shared; each object gets a pipeline over its own mesh buffers
+    ShaderHandle gBufferShader = getOrCreateGBufferShader();
+    if (gBufferShader == INVALID_HANDLE) {
+        std::cerr << "RenderSystem::passGBuffer: Failed to create G-buffer shader" << std::endl;
         return;
     }
 
-    // Bind the G-buffer pipeline
-    m_rhi->bindPipeline(gBufferPipeline);
-    bindUniformBlocks();
-
     // Render all objects to G-buffer using the managers for uniform data
     const auto& objects = ctx.scene->getObjects();
     for (const auto& obj : objects) {
         if (obj.rhiVboPositions == INVALID_HANDLE) continue;
 
+        SceneObject& mutableObj = const_cast<SceneObject&>(obj);
+        if (obj.rhiPipelineGBuffer == INVALID_HANDLE) {
+            mutableObj.rhiPipelineGBuffer = m_pipelineManager.createGBufferPipeline(obj, gBufferShader);
+            if (obj.rhiPipelineGBuffer == INVALID_HANDLE) continue;
+        }
+        m_rhi->bindPipeline(obj.rhiPipelineGBuffer);
+        bindUniformBlocks();
+
         // Update material for this object via MaterialManager
         m_materialManager.updateMaterialForObject(obj);
 
         // Update per-object transform (model matrix)
-        glm::mat4 model = obj.modelMatrix;
+        glm::mat4 model = obj.modelMatrix * obj.rhiDequantize;
         m_transformManager.updateTransforms(model, m_cameraManager.viewMatrix(), m_cameraManager.projectionMatrix());
+        m_rhi->setUniformFloat("objectId", static_cast<float>(obj.id));
 
         // Bind textures if available
         if (obj.baseColorTex && obj.baseColorTex->rhiHandle() != INVALID_HANDLE) {
@@ -1804,10 +1828,12 @@ void RenderSystem::passGBuffer(const PassContext& ctx, RenderTargetHandle gBuffe
 
         // Draw the object
         DrawDesc drawDesc{};
-        drawDesc.pipeline = gBufferPipeline;
+        drawDesc.pipeline = obj.rhiPipelineGBuffer;
         if (obj.rhiEbo != INVALID_HANDLE) {
-            drawDesc.indexBuffer = obj.rhiEbo;
-            drawDesc.indexCount = obj.objLoader.getIndexCount();
+            const int lod = selectLod(mutableObj, ctx.viewportHeight);
+            drawDesc.indexBuffer = lod > 0 ? obj.rhiLodEbos[lod - 1] : obj.rhiEbo;
+            drawDesc.indexFormat = obj.rhiIndexFormat;
+            drawDesc.indexCount = lod > 0 ? (*obj.meshLods)[lod - 1].indices.size() : obj.objLoader.getIndexCount();
             drawDesc.vertexCount = 0;
         } else {
             drawDesc.vertexCount = obj.objLoader.getVertCount();
@@ -1817,7 +1843,7 @@ void RenderSystem::passGBuffer(const PassContext& ctx, RenderTargetHandle gBuffe
 
         // Update stats
         m_stats.drawCalls++;
-        m_stats.totalTriangles += obj.objLoader.getIndexCount() / 3;
+        m_stats.totalTriangles += drawDesc.indexCount / 3;
     }
 }
 
@@ -1915,33 +1941,11 @@ void RenderSystem::passRayIntegrator(const PassContext& ctx, TextureHandle outpu
         return;
     }
 
-    // Clear existing raytracer data and load all scene objects
-    m_raytracer = std::make_unique<Raytracer>();
-
     // Set the seed for deterministic rendering
     m_raytracer->setSeed(m_seed);
 
-    // Set reflection samples per pixel for glossy reflections
-    m_raytracer->setReflectionSpp(m_reflectionSpp);
-
-    const auto& objects = ctx.scene->getObjects();
-    std::cout << "[RenderSystem::passRayIntegrator] Loading " << objects.size() << " objects into raytracer\n";
-
-    for (const auto& obj : objects) {
-        if (obj.objLoader.getVertCount() == 0) continue; // Skip objects with no geometry
-
-        // Load object into raytracer with its transform and material
-        // Calculate reflectivity from unified MaterialCore
-        const auto& mc = obj.materialCore;
-        float reflectivity = 0.1f; // Default reflectivity
-
-        // For metallic materials, use metallic value as reflectivity multiplier
-        if (mc.metallic > 0.1f) {
-            reflectivity = 0.3f + (mc.metallic * 0.7f); // Range 0.3 to 1.0 based on metallic
-        }
-
-        m_raytracer->loadModel(obj.objLoader, obj.modelMatrix, reflectivity, mc);
-    }
+    // Persistent raytracer scene: only objects changed since the last sync are updated
+    m_raytracer->syncScene(*ctx.scene);
 
     // Create output buffer for raytraced image
     std::vector<glm::vec3> raytraceBuffer(ctx.viewportWidth * ctx.viewportHeight);
@@ -1956,9 +1960,16 @@ void RenderSystem::passRayIntegrator(const PassContext& ctx, TextureHandle outpu
     // Use camera from CameraManager directly
     const auto& cameraState = m_cameraManager.camera();
 
-    m_raytracer->renderImage(raytraceBuffer, ctx.viewportWidth, ctx.viewportHeight,
-                            cameraState.position, cameraState.front, cameraState.up,
-                            cameraState.fov, *ctx.lights);
+    m_raytracer->setMaxDepth(maxDepth);
+    if (ctx.interactive) {
+        const int added = m_raytracer->accumulate(raytraceBuffer, ctx.viewportWidth, ctx.viewportHeight,
+                                                  cameraState.position, cameraState.front, cameraState.up,
+                                                  cameraState.fov, *ctx.lights, kInteractiveSamplesPerFrame, sampleCount);
+        if (added == 0)
+            return;   // converged; the output texture already holds the final image
+    } else {
+        renderRaytracedAdaptive(raytraceBuffer, ctx.viewportWidth, ctx.viewportHeight, *ctx.lights, sampleCount);
+    }
 
     // Upload raytraced image to output texture using RHI
     m_rhi->updateTexture(outputTexture, raytraceBuffer.data(),
@@ -1967,14 +1978,14 @@ void RenderSystem::passRayIntegrator(const PassContext& ctx, TextureHandle outpu
     std::cout << "[RenderSystem::passRayIntegrator] Ray integration complete\n";
 }
 
-PipelineHandle RenderSystem::getOrCreateGBufferPipeline()
+ShaderHandle RenderSystem::getOrCreateGBufferShader()
 {
-    if (m_gBufferPipeline != INVALID_HANDLE) {
-        return m_gBufferPipeline;
+    if (m_gBufferShader != INVALID_HANDLE) {
+        return m_gBufferShader;
     }
 
     if (!m_rhi) {
-        std::cerr << "RenderSystem::getOrCreateGBufferPipeline: RHI is null" << std::endl;
+        std::cerr << "RenderSystem::getOrCreateGBufferShader: RHI is null" << std::endl;
         return INVALID_HANDLE;
     }
 
@@ -1987,45 +1998,20 @@ PipelineHandle RenderSystem::getOrCreateGBufferPipeline()
         return INVALID_HANDLE;
     }
 
-    // Create shader using both vertex and fragment sources
+    // Create shader using both vertex and fragment sources. It outlives the
+    // per-object pipelines built on it, so it is kept until shutdown
     ShaderDesc gBufferShaderDesc{};
     gBufferShaderDesc.stages = shaderStageBits(ShaderStage::Vertex) | shaderStageBits(ShaderStage::Fragment);
     gBufferShaderDesc.vertexSource = vertexSource;
     gBufferShaderDesc.fragmentSource = fragmentSource;
     gBufferShaderDesc.debugName = "GBufferShader";
 
-    ShaderHandle gBufferShader = m_rhi->createShader(gBufferShaderDesc);
-    if (gBufferShader == INVALID_HANDLE) {
+    m_gBufferShader = m_rhi->createShader(gBufferShaderDesc);
+    if (m_gBufferShader == INVALID_HANDLE) {
         std::cerr << "Failed to create G-buffer shader" << std::endl;
-        return INVALID_HANDLE;
-    }
-
-    // Create pipeline descriptor
-    PipelineDesc pipelineDesc{};
-    pipelineDesc.shader = gBufferShader;
-
-    // Set vertex attributes to match gbuffer.vert
-    pipelineDesc.vertexAttributes = {
-        {0, 0, TextureFormat::RGB32F, 0},  // aPos (vec3) at location 0
-        {1, 0, TextureFormat::RGB32F, 12}, // aNormal (vec3) at location 1, offset 3*4 bytes
-        {2, 0, TextureFormat::RG32F, 24},  // aUV (vec2) at location 2, offset 6*4 bytes
-        {3, 0, TextureFormat::RGB32F, 32}  // aTangent (vec3) at location 3, offset 8*4 bytes
-    };
-
-    // Enable depth testing for G-buffer pass
-    pipelineDesc.depthTestEnable = true;
-    pipelineDesc.depthWriteEnable = true;
-
-    m_gBufferPipeline = m_rhi->createPipeline(pipelineDesc);
-
-    // Clean up shader handle (pipeline holds references)
-    m_rhi->destroyShader(gBufferShader);
-
-    if (m_gBufferPipeline == INVALID_HANDLE) {
-        std::cerr << "Failed to create G-buffer pipeline" << std::endl;
     }
 
-    return m_gBufferPipeline;
+    return m_gBufferShader;
 }
 
 std::string RenderSystem::loadTextFileRhi(const std::string& path)
@@ -2123,67 +2109,111 @@ PipelineHandle RenderSystem::getOrCreateDeferredLightingPipeline()
     return m_deferredLightingPipeline;
 }
 
-void RenderSystem::renderObjectsBatchedWithManagers(const SceneManager& scene, const Light& lights)
+static void bindObjectTextures(RHI* rhi, const SceneObject& obj)
+{
+    if (obj.baseColorTex && obj.baseColorTex->rhiHandle() != INVALID_HANDLE) {
+        rhi->bindTexture(obj.baseColorTex->rhiHandle(), Slots::BaseColor);
+    }
+
+    if (obj.normalTex && obj.normalTex->rhiHandle() != INVALID_HANDLE) {
+        rhi->bindTexture(obj.normalTex->rhiHandle(), Slots::Normal);
+    }
+
+    if (obj.mrTex && obj.mrTex->rhiHandle() != INVALID_HANDLE) {
+        rhi->bindTexture(obj.mrTex->rhiHandle(), Slots::MetallicRoughness);
+    }
+}
+
+// Index buffer and count of the level of detail selectLod picked, or the
+// vertex count for non-indexed meshes
+static void setObjectGeometry(DrawDesc& drawDesc, const SceneObject& obj)
+{
+    if (obj.rhiEbo != INVALID_HANDLE) {
+        const int lod = obj.lodLevel;
+        drawDesc.indexBuffer = lod > 0 ? obj.rhiLodEbos[lod - 1] : obj.rhiEbo;
+        drawDesc.indexFormat = obj.rhiIndexFormat;
+        drawDesc.indexCount = lod > 0 ? (*obj.meshLods)[lod - 1].indices.size() : obj.objLoader.getIndexCount();
+        drawDesc.vertexCount = 0;  // Not used for indexed drawing
+    } else {
+        // Non-indexed drawing
+        drawDesc.vertexCount = obj.objLoader.getVertCount();
+        drawDesc.indexCount = 0;  // Not used for non-indexed drawing
+    }
+}
+
+void RenderSystem::renderObjectsBatchedWithManagers(const SceneManager& scene, const Light& lights, int viewportHeight)
 {
     if (!m_rhi) return;
 
     const auto& objects = scene.getObjects();
     if (objects.empty()) return;
 
-    // Batch objects by material/pipeline to minimize state changes
+    // Select each object's level of detail, then group objects that share mesh
+    // buffers, level and material so each group goes out as one instanced draw
+    std::vector<SceneObject*> drawable;
+    drawable.reserve(objects.size());
     for (const auto& obj : objects) {
         if (obj.rhiVboPositions == INVALID_HANDLE) continue; // Skip objects without valid geometry
 
-        // Ensure the object has a valid pipeline using PipelineManager
-        // Cast away const since we need to modify pipeline handles
+        // Cast away const since we need to modify pipeline handles and LOD state
         SceneObject& mutableObj = const_cast<SceneObject&>(obj);
-        m_pipelineManager.ensureObjectPipeline(mutableObj, true);  // Use PBR pipeline
-
-        // Update material for this specific object
-        m_materialManager.updateMaterialForObject(obj);
+        // Indexed drawing, at the coarsest level of detail that stays under the pixel error
+        if (obj.rhiEbo != INVALID_HANDLE) selectLod(mutableObj, viewportHeight);
+        else mutableObj.lodLevel = 0;
+        drawable.push_back(&mutableObj);
+    }
 
-        // Use the object's PBR pipeline
-        PipelineHandle pipeline = m_pipelineManager.getObjectPipeline(obj, true);
-        if (pipeline == INVALID_HANDLE) {
-            continue;  // Skip if no valid pipeline
+    m_instanceBatcher.beginFrame();
+    size_t batchIndexCount = 0;
+    auto prepare = [&](const SceneObject& first, DrawDesc& drawDesc) {
+        // Every object in the batch has first's material; model matrices are per instance
+        m_materialManager.updateMaterialForObject(first);
+        bindUniformBlocks();
+        m_transformManager.updateTransforms(glm::mat4(1.0f), m_cameraManager.viewMatrix(), m_cameraManager.projectionMatrix());
+        bindObjectTextures(m_rhi.get(), first);
+        setObjectGeometry(drawDesc, first);
+        batchIndexCount = drawDesc.indexCount;
+    };
+    for (const auto& batch : InstanceBatcher::group(drawable)) {
+        if (batch.size() >= InstanceBatcher::kMinBatch && m_instanceBatcher.draw(batch, prepare)) {
+            m_stats.drawCalls++;
+            m_stats.totalTriangles += batchIndexCount / 3 * batch.size();
+            m_stats.instancedObjects += static_cast<int>(batch.size());
+            continue;
         }
+        for (SceneObject* obj : batch) drawObjectWithManagers(*obj);
+    }
+    m_instanceBatcher.endFrame();
+}
 
-        // Bind pipeline and render
-        m_rhi->bindPipeline(pipeline);
-        bindUniformBlocks();
+void RenderSystem::drawObjectWithManagers(SceneObject& obj)
+{
+    // Ensure the object has a valid pipeline using PipelineManager
+    m_pipelineManager.ensureObjectPipeline(obj, true);  // Use PBR pipeline
 
-        // Set per-object transform via TransformManager
-        m_transformManager.updateTransforms(obj.modelMatrix, m_cameraManager.viewMatrix(), m_cameraManager.projectionMatrix());
+    // Update material for this specific object
+    m_materialManager.updateMaterialForObject(obj);
 
-        // Bind textures if available
-        if (obj.baseColorTex && obj.baseColorTex->rhiHandle() != INVALID_HANDLE) {
-            m_rhi->bindTexture(obj.baseColorTex->rhiHandle(), Slots::BaseColor);
-        }
+    // Use the object's PBR pipeline
+    PipelineHandle pipeline = m_pipelineManager.getObjectPipeline(obj, true);
+    if (pipeline == INVALID_HANDLE) {
+        return;  // Skip if no valid pipeline
+    }
 
-        if (obj.normalTex && obj.normalTex->rhiHandle() != INVALID_HANDLE) {
-            m_rhi->bindTexture(obj.normalTex->rhiHandle(), Slots::Normal);
-        }
+    // Bind pipeline and render
+    m_rhi->bindPipeline(pipeline);
+    bindUniformBlocks();
 
-        if (obj.mrTex && obj.mrTex->rhiHandle() != INVALID_HANDLE) {
-            m_rhi->bindTexture(obj.mrTex->rhiHandle(), Slots::MetallicRoughness);
-        }
+    // Set per-object transform via TransformManager
+    m_transformManager.updateTransforms(obj.modelMatrix * obj.rhiDequantize, m_cameraManager.viewMatrix(), m_cameraManager.projectionMatrix());
+    bindObjectTextures(m_rhi.get(), obj);
 
-        // Draw the object using RHI draw command
-        DrawDesc drawDesc{};
-        drawDesc.pipeline = pipeline;
-        if (obj.rhiEbo != INVALID_HANDLE) {
-            // Indexed drawing
-            drawDesc.indexBuffer = obj.rhiEbo;
-            drawDesc.indexCount = obj.objLoader.getIndexCount();
-            drawDesc.vertexCount = 0;  // Not used for indexed drawing
-        } else {
-            // Non-indexed drawing
-            drawDesc.vertexCount = obj.objLoader.getVertCount();
-            drawDesc.indexCount = 0;  // Not used for non-indexed drawing
-        }
-        m_rhi->draw(drawDesc);
+    // Draw the object using RHI draw command
+    DrawDesc drawDesc{};
+    drawDesc.pipeline = pipeline;
+    setObjectGeometry(drawDesc, obj);
+    m_rhi->draw(drawDesc);
 
-        m_stats.drawCalls++;
-        m_stats.totalTriangles += obj.objLoader.getIndexCount() / 3;  // Convert indices to triangles
-    }
+    m_stats.drawCalls++;
+    m_stats.totalTriangles += drawDesc.indexCount / 3;  // Convert indices to triangles
 }
@@ -124,16 +124,27 @@ void RhiGL::draw(const DrawDesc& desc) {
             std::cerr << "[RhiGL] Invalid pipeline handle in draw call\n";
             return;
         }
-        const auto& pipeline = pipelineIt->second;
+        auto& pipeline = pipelineIt->second;
         vaoToUse = pipeline.vao;
         topology = primitiveTopologyToGL(pipeline.desc.topology);
+        if (vaoToUse != 0) glBindVertexArray(vaoToUse);
+
+        // Emulated base instance: per-instance streams start firstInstance elements in
+        if (pipeline.hasInstanceBindings && pipeline.instanceBase != desc.firstInstance) {
+            for (const auto& attr : pipeline.desc.vertexAttributes) {
+                for (const auto& binding : pipeline.desc.vertexBindings) {
+                    if (binding.binding == attr.binding && binding.perInstance) {
+                        pointVertexAttribute(attr, binding, size_t(desc.firstInstance) * binding.stride);
+                    }
+                }
+            }
+            pipeline.instanceBase = desc.firstInstance;
+        }
     } else {
         // Fallback: use GL_TRIANGLES and current VAO
         topology = GL_TRIANGLES;
     }
 
-    if (vaoToUse != 0) glBindVertexArray(vaoToUse);
-
     // Apply pipeline state
     if (desc.pipeline != INVALID_HANDLE) {
         auto pipelineIt = m_pipelines.find(desc.pipeline);
@@ -191,8 +202,10 @@ void RhiGL::draw(const DrawDesc& desc) {
         auto indexIt = m_buffers.find(desc.indexBuffer);
         if (indexIt != m_buffers.end()) {
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexIt->second.id);
-            glDrawElementsInstanced(topology, desc.indexCount, GL_UNSIGNED_INT,
-                                    reinterpret_cast<void*>(static_cast<uintptr_t>(desc.firstIndex * sizeof(uint32_t))),
+            const bool index16 = desc.indexFormat == IndexFormat::Uint16;
+            const size_t indexSize = index16 ? sizeof(uint16_t) : sizeof(uint32_t);
+            glDrawElementsInstanced(topology, desc.indexCount, index16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                                    reinterpret_cast<void*>(static_cast<uintptr_t>(desc.firstIndex * indexSize)),
                                     desc.instanceCount);
         }
     } else if (desc.vertexCount > 0) {
@@ -218,8 +231,8 @@ void RhiGL::readback(const ReadbackDesc& desc) {
     glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture.id, 0);
     
     if (glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE) {
-        GLenum format = textureFormatToGL(desc.format);
-        GLenum type = GL_UNSIGNED_BYTE; // Simplified for now
+        GLenum format, type;
+        getTextureFormatAndType(desc.format, format, type);
         
         glReadPixels(desc.x, desc.y, desc.width, desc.height, format, type, desc.destination);
     } else {
@@ -321,6 +334,9 @@ PipelineHandle RhiGL::createPipeline(const PipelineDesc& desc) {
     if (!desc.vertexAttributes.empty()) {
         glGenVertexArrays(1, &glPipeline.vao);
         setupVertexArray(glPipeline.vao, desc);
+        for (const auto& binding : desc.vertexBindings) {
+            glPipeline.hasInstanceBindings = glPipeline.hasInstanceBindings || binding.perInstance;
+        }
     } else {
         glPipeline.vao = 0;
     }
@@ -890,9 +906,7 @@ void RhiGL::queryCapabilities() {
     glGetIntegerv(GL_MAX_SAMPLES, &m_maxSamples);
 }
 
-void RhiGL::setupVertexArray(GLuint vao, const PipelineDesc& desc) {
-    glBindVertexArray(vao);
-    
+void RhiGL::pointVertexAttribute(const VertexAttribute& attr, const VertexBinding& vb, size_t baseOffset) {
     auto componentsFromFormat = [](TextureFormat fmt) -> GLint {
         switch (fmt) {
             case TextureFormat::R32F:
@@ -900,12 +914,14 @@ void RhiGL::setupVertexArray(GLuint vao, const PipelineDesc& desc) {
             case TextureFormat::R8: return 1;
             case TextureFormat::RG32F:
             case TextureFormat::RG16F:
+            case TextureFormat::RG16Snorm:
             case TextureFormat::RG8: return 2;
             case TextureFormat::RGB32F:
             case TextureFormat::RGB16F:
             case TextureFormat::RGB8: return 3;
             case TextureFormat::RGBA32F:
             case TextureFormat::RGBA16F:
+            case TextureFormat::RGBA16Unorm:
             case TextureFormat::RGBA8: return 4;
             default: return 3;
         }
@@ -916,10 +932,37 @@ void RhiGL::setupVertexArray(GLuint vao, const PipelineDesc& desc) {
             case TextureFormat::RGB8:
             case TextureFormat::RG8:
             case TextureFormat::R8: return GL_UNSIGNED_BYTE;
+            case TextureFormat::RGBA16F:
+            case TextureFormat::RGB16F:
+            case TextureFormat::RG16F:
+            case TextureFormat::R16F: return GL_HALF_FLOAT;
+            case TextureFormat::RGBA16Unorm: return GL_UNSIGNED_SHORT;
+            case TextureFormat::RG16Snorm: return GL_SHORT;
             default: return GL_FLOAT;
         }
     };
 
+    // Bind buffer for this attribute
+    auto bufIt = m_buffers.find(vb.buffer);
+    if (bufIt != m_buffers.end()) {
+        glBindBuffer(GL_ARRAY_BUFFER, bufIt->second.id);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    glEnableVertexAttribArray(attr.location);
+    const GLint comps = componentsFromFormat(attr.format);
+    const GLenum glType = typeFromFormat(attr.format);
+    const GLboolean normalized = (glType == GL_UNSIGNED_BYTE || glType == GL_UNSIGNED_SHORT || glType == GL_SHORT) ? GL_TRUE : GL_FALSE;
+    glVertexAttribPointer(attr.location, comps, glType, normalized, vb.stride,
+                          reinterpret_cast<void*>(static_cast<uintptr_t>(baseOffset + attr.offset)));
+    // Instancing support
+    glVertexAttribDivisor(attr.location, vb.perInstance ? 1 : 0);
+}
+
+void RhiGL::setupVertexArray(GLuint vao, const PipelineDesc& desc) {
+    glBindVertexArray(vao);
+
     // Configure vertex attributes with bound buffers per binding
     for (const auto& attr : desc.vertexAttributes) {
         // Find the binding parameters and buffer
@@ -928,23 +971,7 @@ void RhiGL::setupVertexArray(GLuint vao, const PipelineDesc& desc) {
             if (binding.binding == attr.binding) { vb = &binding; break; }
         }
         if (!vb) continue;
-
-        // Bind buffer for this attribute
-        auto bufIt = m_buffers.find(vb->buffer);
-        if (bufIt != m_buffers.end()) {
-            glBindBuffer(GL_ARRAY_BUFFER, bufIt->second.id);
-        } else {
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-        }
-
-        glEnableVertexAttribArray(attr.location);
-        const GLint comps = componentsFromFormat(attr.format);
-        const GLenum glType = typeFromFormat(attr.format);
-        const GLboolean normalized = (glType != GL_FLOAT) ? GL_TRUE : GL_FALSE;
-        glVertexAttribPointer(attr.location, comps, glType, normalized, vb->stride,
-                              reinterpret_cast<void*>(static_cast<uintptr_t>(attr.offset)));
-        // Instancing support
-        glVertexAttribDivisor(attr.location, vb->perInstance ? 1 : 0);
+        pointVertexAttribute(attr, *vb, 0);
     }
 
     // Bind index buffer to VAO if provided
@@ -1,6 +1,13 @@
 #include "managers/scene_manager.h"
 #include "mesh_loader.h"
 #include "texture_cache.h"
+#include "mesh_cache.h"
+#include "mesh_optimizer.h"
+#include "mesh_lod.h"
+#include "config_defaults.h"
+#include "bvh_node.h"
+#include "path_utils.h"
+#include "job_system.h"
 #include <iostream>
 #include <algorithm>
 #include <fstream>
@@ -10,6 +17,8 @@
 #include <rapidjson/writer.h>
 #include <rapidjson/prettywriter.h>
 #include <cmath>
+#include <chrono>
+#include <filesystem>
 #include <glm/gtc/matrix_transform.hpp>
 
 using namespace glint3d;
@@ -23,60 +32,207 @@ SceneManager::~SceneManager()
     clear();
 }
 
-bool SceneManager::loadObject(const std::string& name, const std::string& path, 
-                             const glm::vec3& position, const glm::vec3& scale)
+struct SceneManager::AssetLoad
 {
-    // Check if object with this name already exists
-    if (findObjectByName(name) != nullptr) {
-        std::cerr << "Object with name '" << name << "' already exists\n";
-        return false;
+    ObjLoader objLoader;
+    std::shared_ptr<const BVH> meshBvh;
+    std::shared_ptr<const std::vector<MeshLod::Level>> meshLods;
+    MeshCache::View cached;       // open when the mesh came from the cache; gpu buffers read from it
+    std::string texturePath;      // first texture name variant that exists; prefetched
+
+    size_t uploadBytes() const
+    {
+        const MeshOptimizer::GpuLayout layout = MeshOptimizer::gpuLayout(cached.isOpen() ? cached.arrays() : objLoader.arrays());
+        size_t bytes = layout.bytes;
+        if (meshLods)
+            for (const MeshLod::Level& level : *meshLods)
+                bytes += level.indices.size() * (layout.index16 ? sizeof(uint16_t) : sizeof(uint32_t));
+        return bytes;
     }
+};
 
-    SceneObject obj;
-    obj.name = name;
-    
-    // Load mesh data
-    obj.objLoader.load(path.c_str());
+std::shared_ptr<SceneManager::AssetLoad> SceneManager::loadAssetData(const std::string& path)
+{
+    auto asset = std::make_shared<AssetLoad>();
+    const std::string resolved = PathUtils::resolveAssetPath(path);
 
-    // Set transform (initially same for both local and world since it's a root object)
-    glm::mat4 translateMat = glm::translate(glm::mat4(1.0f), position);
-    glm::mat4 scaleMat = glm::scale(glm::mat4(1.0f), scale);
-    obj.localMatrix = translateMat * scaleMat;
-    obj.modelMatrix = obj.localMatrix;  // World = local for root objects
+    if (MeshCache::open(resolved, asset->cached))
+    {
+        // The gpu buffers are filled straight from the mapping; the cpu copy
+        // is what the raytracer and picking read
+        const MeshArrays& mesh = asset->cached.arrays();
+        asset->objLoader.copyFrom(mesh);
+        auto bvh = std::make_shared<BVH>();
+        bvh->assign(BVHNodeArray(asset->cached.bvhNodes(), asset->cached.bvhNodes() + asset->cached.bvhNodeCount()),
+                    std::vector<uint32_t>(asset->cached.bvhPrimIndices(), asset->cached.bvhPrimIndices() + mesh.indexCount / 3));
+        asset->meshBvh = std::move(bvh);
+        if (!asset->cached.lods().empty()) {
+            auto lods = std::make_shared<std::vector<MeshLod::Level>>();
+            for (const MeshCache::View::Lod& l : asset->cached.lods())
+                lods->push_back({ std::vector<uint32_t>(l.indices, l.indices + l.indexCount), l.error });
+            asset->meshLods = std::move(lods);
+        }
+        std::cout << "[MeshCache] " << path << ": " << mesh.vertexCount << " vertices from "
+                  << MeshCache::cachePathFor(resolved) << "\n";
+    }
+    else
+    {
+        asset->objLoader.load(path.c_str());
+        if (Defaults::OptimizeImportedMeshes && asset->objLoader.getIndexCount() > 0)
+        {
+            // Reordered once here; the cache below stores the optimized mesh
+            const MeshArrays source = asset->objLoader.arrays();
+            MeshData mesh = MeshOptimizer::toMeshData(source);
+            const MeshOptimizer::Report report = MeshOptimizer::optimize(mesh);
+            MeshArrays optimized = MeshOptimizer::arraysOf(mesh);
+            optimized.normalsFromSource = source.normalsFromSource;
+            asset->objLoader.copyFrom(optimized);
+            std::cout << "[MeshOptimizer] " << path << ": " << MeshOptimizer::describe(report) << "\n";
+        }
+
+        // Simplified on this worker so the render thread only uploads; small
+        // meshes get no levels
+        std::vector<MeshLod::Level> lods;
+        if (Defaults::GenerateMeshLods)
+        {
+            lods = MeshLod::buildChain(asset->objLoader.arrays());
+            if (!lods.empty())
+                std::cout << "[MeshLod] " << path << ": " << lods.size() << " levels down to "
+                          << lods.back().indices.size() / 3 << " triangles\n";
+        }
 
-    // Setup OpenGL resources
-    setupObjectOpenGL(obj);
+        // Derived data is only worth building here when it can be cached
+        const size_t triangleCount = asset->objLoader.getIndexCount() / 3;
+        if (triangleCount > 0 && !MeshCache::directory().empty())
+        {
+            auto bvh = std::make_shared<BVH>();
+            bvh->buildTriangles(reinterpret_cast<const glm::vec3*>(asset->objLoader.getPositions()),
+                                asset->objLoader.getFaces(), triangleCount);
+            if (!MeshCache::store(resolved, asset->objLoader.arrays(), *bvh, lods))
+                std::cerr << "[MeshCache] could not cache " << path << "\n";
+            asset->meshBvh = std::move(bvh);
+        }
+        if (!lods.empty())
+            asset->meshLods = std::make_shared<const std::vector<MeshLod::Level>>(std::move(lods));
+    }
 
-    // Load textures if they exist
+    // Look for common texture naming patterns next to the mesh
     std::string directory = path.substr(0, path.find_last_of('/'));
     if (directory == path) directory = "."; // No directory found
-    
-    // Try to find and load associated textures
-    TextureCache& texCache = TextureCache::instance();
-    
-    // Look for common texture naming patterns
     std::string baseName = path.substr(path.find_last_of('/') + 1);
     baseName = baseName.substr(0, baseName.find_last_of('.'));
-    
+
     // Try diffuse/albedo texture
-    std::vector<std::string> diffuseNames = {
+    const std::string diffuseNames[] = {
         directory + "/" + baseName + "_diffuse.png",
-        directory + "/" + baseName + "_albedo.png", 
+        directory + "/" + baseName + "_albedo.png",
         directory + "/" + baseName + "_basecolor.png",
         directory + "/" + baseName + ".png",
         directory + "/" + baseName + ".jpg"
     };
-    
+    std::error_code ec;
     for (const auto& texPath : diffuseNames) {
-        if (std::ifstream(texPath).good()) {
-            obj.baseColorTex = texCache.get(texPath, false);
-            obj.texture = obj.baseColorTex; // legacy fallback
+        if (std::filesystem::is_regular_file(texPath, ec)) {
+            asset->texturePath = texPath;
+            TextureCache::instance().prefetch(texPath, false);
             break;
         }
     }
-    
+    return asset;
+}
+
+bool SceneManager::loadObject(const std::string& name, const std::string& path, 
+                             const glm::vec3& position, const glm::vec3& scale)
+{
+    std::shared_future<bool> loaded = loadObjectAsync(name, path, position, scale);
+    finishLoads();
+    return loaded.get();
+}
+
+std::shared_future<bool> SceneManager::loadObjectAsync(const std::string& name, const std::string& path,
+                                                       const glm::vec3& position, const glm::vec3& scale)
+{
+    PendingLoad load;
+    std::shared_future<bool> done = load.done.get_future().share();
+
+    // Check if object with this name already exists or is on its way
+    const bool pending = std::any_of(m_pendingLoads.begin(), m_pendingLoads.end(),
+                                     [&](const PendingLoad& p) { return p.name == name; });
+    if (pending || findObjectByName(name) != nullptr) {
+        std::cerr << "Object with name '" << name << "' already exists\n";
+        load.done.set_value(false);
+        return done;
+    }
+
+    load.name = name;
+    // Set transform (initially same for both local and world since it's a root object)
+    glm::mat4 translateMat = glm::translate(glm::mat4(1.0f), position);
+    glm::mat4 scaleMat = glm::scale(glm::mat4(1.0f), scale);
+    load.localMatrix = translateMat * scaleMat;
+    load.job = JobSystem::shared().submit([path]() { return loadAssetData(path); });
+    m_pendingLoads.push_back(std::move(load));
+    return done;
+}
+
+size_t SceneManager::pumpLoads(size_t budgetBytes)
+{
+    size_t added = 0, uploaded = 0;
+    while (!m_pendingLoads.empty() && (added == 0 || uploaded < budgetBytes)) {
+        PendingLoad& front = m_pendingLoads.front();
+        if (front.job.wait_for(std::chrono::seconds(0)) == std::future_status::timeout)
+            break;
+        uploaded += finishLoad(front);
+        m_pendingLoads.pop_front();
+        ++added;
+    }
+    return added;
+}
+
+void SceneManager::finishLoads()
+{
+    while (!m_pendingLoads.empty()) {
+        finishLoad(m_pendingLoads.front());
+        m_pendingLoads.pop_front();
+    }
+}
+
+size_t SceneManager::finishLoad(PendingLoad& load)
+{
+    std::shared_ptr<AssetLoad> asset;
+    try {
+        asset = load.job.get();
+    } catch (const std::exception& e) {
+        std::cerr << "Loading '" << load.name << "' failed: " << e.what() << "\n";
+        load.done.set_value(false);
+        return 0;
+    }
+
+    SceneObject obj;
+    obj.name = load.name;
+    obj.localMatrix = load.localMatrix;
+    obj.modelMatrix = obj.localMatrix;  // World = local for root objects
+
+    size_t bytes = asset->uploadBytes();
+    // Create GPU buffers, then keep the cpu copy for the raytracer and picking
+    obj.meshLods = std::move(asset->meshLods);
+    setupObjectOpenGL(obj, asset->cached.isOpen() ? asset->cached.arrays() : asset->objLoader.arrays());
+    obj.objLoader = std::move(asset->objLoader);
+    obj.meshBvh = std::move(asset->meshBvh);
+    obj.id = m_nextObjectId++;
+    obj.meshId = obj.id;
+
+    if (!asset->texturePath.empty()) {
+        obj.baseColorTex = TextureCache::instance().get(asset->texturePath, false);
+        obj.texture = obj.baseColorTex; // legacy fallback
+        obj.materialCore.baseColorTex = asset->texturePath; // for the raytracer's own texture cache
+    }
+
+    if (obj.baseColorTex)
+        bytes += size_t(obj.baseColorTex->width()) * obj.baseColorTex->height() * obj.baseColorTex->channels();
     m_objects.push_back(std::move(obj));
-    return true;
+    ++m_revision;
+    load.done.set_value(true);
+    return bytes;
 }
 
 bool SceneManager::removeObject(const std::string& name)
@@ -137,6 +293,7 @@ bool SceneManager::removeObject(const std::string& name)
     }
     
     m_objects.erase(it);
+    ++m_revision;
     return true;
 }
 
@@ -156,6 +313,7 @@ bool SceneManager::duplicateObject(const std::string& sourceName, const std::str
     
     SceneObject newObj = *source; // Copy construct
     newObj.name = newName;
+    newObj.id = m_nextObjectId++;
     
     // Apply deltas to transform
     if (deltaPos || deltaScale || deltaRotDeg) {
@@ -179,10 +337,14 @@ bool SceneManager::duplicateObject(const std::string& sourceName, const std::str
         newObj.modelMatrix = transform;  // For root objects, world = local
     }
     
-    // Setup new OpenGL resources (don't share VAO/VBO)
-    setupObjectOpenGL(newObj);
+    // Mesh buffers are shared with the source; pipelines are per object and
+    // rebuilt on first draw
+    newObj.rhiPipelineBasic = INVALID_HANDLE;
+    newObj.rhiPipelinePbr = INVALID_HANDLE;
+    newObj.rhiPipelineGBuffer = INVALID_HANDLE;
     
     m_objects.push_back(std::move(newObj));
+    ++m_revision;
     return true;
 }
 
@@ -237,6 +399,8 @@ bool SceneManager::assignMaterialToObject(const std::string& objectName, const s
     }
     
     obj->materialCore = it->second;
+    obj->materialVersion++;
+    ++m_revision;
     return true;
 }
 
@@ -283,6 +447,7 @@ bool SceneManager::deleteObject(const std::string& name)
         
         // Remove from vector
         m_objects.erase(it);
+        ++m_revision;
         return true;
     }
     return false;
@@ -303,45 +468,55 @@ bool SceneManager::duplicateObject(const std::string& sourceName, const std::str
     // Copy the source object
     SceneObject newObj = *source;
     newObj.name = newName;
+    newObj.id = m_nextObjectId++;
     
     // Set new position (for root objects, local = world)
     newObj.localMatrix[3] = glm::vec4(newPosition, 1.0f);
     newObj.modelMatrix[3] = glm::vec4(newPosition, 1.0f);
     
-    // Clear RHI handles (they will be regenerated in pure RHI implementation)
-    newObj.rhiVboPositions = INVALID_HANDLE;
-    newObj.rhiVboNormals = INVALID_HANDLE;
-    newObj.rhiVboTexCoords = INVALID_HANDLE;
-    newObj.rhiEbo = INVALID_HANDLE;
+    // Mesh buffers are shared with the source; pipelines are per object and
+    // rebuilt on first draw
+    newObj.rhiPipelineBasic = INVALID_HANDLE;
+    newObj.rhiPipelinePbr = INVALID_HANDLE;
+    newObj.rhiPipelineGBuffer = INVALID_HANDLE;
     
     // Add to scene
-    m_objects.push_back(newObj);
-    
-    // Setup OpenGL for the new object
-    setupObjectOpenGL(m_objects.back());
+    m_objects.push_back(std::move(newObj));
+    ++m_revision;
     
     return true;
 }
 
 void SceneManager::clear()
 {
+    // Loads still in flight are dropped; their jobs finish on their own
+    for (auto& load : m_pendingLoads) {
+        load.done.set_value(false);
+    }
+    m_pendingLoads.clear();
     for (auto& obj : m_objects) {
         cleanupObjectOpenGL(obj);
     }
     m_objects.clear();
     m_materials.clear();
     m_selectedObjectIndex = -1;
+    ++m_revision;
 }
 
 void SceneManager::setupObjectOpenGL(SceneObject& obj)
 {
-    if (obj.objLoader.getVertCount() == 0) {
+    setupObjectOpenGL(obj, obj.objLoader.arrays());
+}
+
+void SceneManager::setupObjectOpenGL(SceneObject& obj, const MeshArrays& mesh)
+{
+    if (mesh.vertexCount == 0) {
         return;
     }
 
-    const size_t Nv = obj.objLoader.getVertCount();
-    const bool hasNormals = (obj.objLoader.getNormals() != nullptr);
-    const bool hasUVs = obj.objLoader.hasTexcoords();
+    const size_t Nv = mesh.vertexCount;
+    const bool hasNormals = (mesh.normals != nullptr);
+    const bool hasUVs = (mesh.texcoords != nullptr);
 
     // Pure RHI implementation - legacy VAO/VBO system removed
     if (!m_rhi) {
@@ -349,32 +524,64 @@ void SceneManager::setupObjectOpenGL(SceneObject& obj)
         return;
     }
 
-    // RHI path: create buffers
+    // RHI path: create buffers with quantized positions and normals, 16-bit
+    // indices and half texcoords where lossless enough
+    const MeshOptimizer::GpuLayout layout = MeshOptimizer::gpuLayout(mesh);
+    const MeshOptimizer::QuantizedMesh quantized = MeshOptimizer::quantize(mesh);
+    obj.rhiIndexFormat = layout.index16 ? IndexFormat::Uint16 : IndexFormat::Uint32;
+    obj.rhiHalfTexCoords = layout.halfTexcoords;
+    obj.rhiDequantize = quantized.dequantize();
+    auto buffers = std::make_shared<MeshBuffers>();
+    buffers->rhi = m_rhi;
     {
         BufferDesc bd{}; bd.type = BufferType::Vertex; bd.usage = BufferUsage::Static;
-        bd.size = Nv * 3 * sizeof(float); bd.initialData = obj.objLoader.getPositions();
+        bd.size = quantized.positions.size() * sizeof(uint16_t); bd.initialData = quantized.positions.data();
         bd.debugName = obj.name + ":positions";
-        obj.rhiVboPositions = m_rhi->createBuffer(bd);
+        buffers->positions = m_rhi->createBuffer(bd);
     }
     if (hasNormals) {
         BufferDesc bd{}; bd.type = BufferType::Vertex; bd.usage = BufferUsage::Static;
-        bd.size = Nv * 3 * sizeof(float); bd.initialData = obj.objLoader.getNormals();
+        bd.size = quantized.normals.size() * sizeof(int16_t); bd.initialData = quantized.normals.data();
         bd.debugName = obj.name + ":normals";
-        obj.rhiVboNormals = m_rhi->createBuffer(bd);
+        buffers->normals = m_rhi->createBuffer(bd);
     }
     if (hasUVs) {
+        std::vector<uint16_t> halfUVs;
+        if (layout.halfTexcoords) halfUVs = MeshOptimizer::packHalfTexcoords(mesh.texcoords, Nv);
         BufferDesc bd{}; bd.type = BufferType::Vertex; bd.usage = BufferUsage::Static;
-        bd.size = Nv * 2 * sizeof(float); bd.initialData = obj.objLoader.getTexcoords();
+        bd.size = layout.halfTexcoords ? halfUVs.size() * sizeof(uint16_t) : Nv * 2 * sizeof(float);
+        bd.initialData = layout.halfTexcoords ? static_cast<const void*>(halfUVs.data()) : mesh.texcoords;
         bd.debugName = obj.name + ":uvs";
-        obj.rhiVboTexCoords = m_rhi->createBuffer(bd);
+        buffers->texCoords = m_rhi->createBuffer(bd);
     }
-    if (obj.objLoader.getIndexCount() > 0) {
+    if (mesh.indexCount > 0) {
+        std::vector<uint16_t> indices16;
+        if (layout.index16) indices16 = MeshOptimizer::packIndices16(mesh.indices, mesh.indexCount);
         BufferDesc bd{}; bd.type = BufferType::Index; bd.usage = BufferUsage::Static;
-        bd.size = obj.objLoader.getIndexCount() * sizeof(unsigned int);
-        bd.initialData = obj.objLoader.getFaces();
+        bd.size = mesh.indexCount * (layout.index16 ? sizeof(uint16_t) : sizeof(unsigned int));
+        bd.initialData = layout.index16 ? static_cast<const void*>(indices16.data()) : mesh.indices;
         bd.debugName = obj.name + ":indices";
-        obj.rhiEbo = m_rhi->createBuffer(bd);
+        buffers->indices = m_rhi->createBuffer(bd);
+    }
+    if (obj.meshLods && mesh.indexCount > 0) {
+        for (size_t i = 0; i < obj.meshLods->size(); ++i) {
+            const std::vector<uint32_t>& lod = (*obj.meshLods)[i].indices;
+            std::vector<uint16_t> indices16;
+            if (layout.index16) indices16 = MeshOptimizer::packIndices16(lod.data(), lod.size());
+            BufferDesc bd{}; bd.type = BufferType::Index; bd.usage = BufferUsage::Static;
+            bd.size = lod.size() * (layout.index16 ? sizeof(uint16_t) : sizeof(uint32_t));
+            bd.initialData = layout.index16 ? static_cast<const void*>(indices16.data()) : lod.data();
+            bd.debugName = obj.name + ":lod" + std::to_string(i + 1);
+            buffers->lodIndices.push_back(m_rhi->createBuffer(bd));
+        }
     }
+    obj.rhiVboPositions = buffers->positions;
+    obj.rhiVboNormals = buffers->normals;
+    obj.rhiVboTexCoords = buffers->texCoords;
+    obj.rhiEbo = buffers->indices;
+    obj.rhiLodEbos = buffers->lodIndices;
+    obj.lodLevel = 0;
+    obj.meshBuffers = std::move(buffers);
 
     // Do not build pipelines here; RenderSystem will build per-shader pipelines
 }
@@ -386,10 +593,13 @@ void SceneManager::cleanupObjectOpenGL(SceneObject& obj)
         std::cerr << "ERROR: RHI not initialized - cannot cleanup scene objects" << std::endl;
         return;
     }
-    if (m_rhi && obj.rhiVboPositions != INVALID_HANDLE) { m_rhi->destroyBuffer(obj.rhiVboPositions); obj.rhiVboPositions = INVALID_HANDLE; }
-    if (m_rhi && obj.rhiVboNormals != INVALID_HANDLE) { m_rhi->destroyBuffer(obj.rhiVboNormals); obj.rhiVboNormals = INVALID_HANDLE; }
-    if (m_rhi && obj.rhiVboTexCoords != INVALID_HANDLE) { m_rhi->destroyBuffer(obj.rhiVboTexCoords); obj.rhiVboTexCoords = INVALID_HANDLE; }
-    if (m_rhi && obj.rhiEbo != INVALID_HANDLE) { m_rhi->destroyBuffer(obj.rhiEbo); obj.rhiEbo = INVALID_HANDLE; }
+    // Mesh buffers go with the last object referencing them
+    obj.meshBuffers.reset();
+    obj.rhiVboPositions = INVALID_HANDLE;
+    obj.rhiVboNormals = INVALID_HANDLE;
+    obj.rhiVboTexCoords = INVALID_HANDLE;
+    obj.rhiEbo = INVALID_HANDLE;
+    obj.rhiLodEbos.clear();
     if (m_rhi && obj.rhiPipelineGBuffer != INVALID_HANDLE) { m_rhi->destroyPipeline(obj.rhiPipelineGBuffer); obj.rhiPipelineGBuffer = INVALID_HANDLE; }
     if (m_rhi && obj.rhiPipelinePbr != INVALID_HANDLE) { m_rhi->destroyPipeline(obj.rhiPipelinePbr); obj.rhiPipelinePbr = INVALID_HANDLE; }
 }
@@ -637,6 +847,8 @@ void SceneManager::updateWorldTransform(int objectIndex)
         const glm::mat4& parentWorld = getWorldMatrix(obj.parentIndex);
         obj.modelMatrix = parentWorld * obj.localMatrix;
     }
+    obj.transformVersion++;
+    ++m_revision;
     
     // Recursively update all children
     for (int childIndex : obj.childIndices) {
@@ -677,3 +889,26 @@ glm::mat4 SceneManager::getLocalMatrix(int objectIndex) const
     }
     return m_objects[objectIndex].localMatrix;
 }
+
+void SceneManager::markTransformDirty(int objectIndex)
+{
+    if (objectIndex < 0 || objectIndex >= static_cast<int>(m_objects.size())) {
+        return;
+    }
+    m_objects[objectIndex].transformVersion++;
+    ++m_revision;
+}
+
+void SceneManager::markMaterialDirty(int objectIndex)
+{
+    if (objectIndex < 0 || objectIndex >= static_cast<int>(m_objects.size())) {
+        return;
+    }
+    m_objects[objectIndex].materialVersion++;
+    ++m_revision;
+}
+
+void SceneManager::markMaterialDirty(const std::string& name)
+{
+    markMaterialDirty(findObjectIndex(name));
+}
@@ -363,6 +363,15 @@ std::string SchemaValidator::getEmbeddedSchemaV1_3() { // make sure everything i
       },
       "additionalProperties": false
     },
+    "opSetLodThreshold": {
+      "type": "object",
+      "required": ["op", "value"],
+      "properties": {
+        "op": { "const": "set_lod_threshold" },
+        "value": { "type": "number", "minimum": 0 }
+      },
+      "additionalProperties": false
+    },
     "opRenderImage": {
       "type": "object",
       "required": ["op", "path"],
@@ -370,7 +379,8 @@ std::string SchemaValidator::getEmbeddedSchemaV1_3() { // make sure everything i
         "op": { "const": "render_image" },
         "path": { "type": "string" },
         "width": { "type": "integer", "minimum": 1 },
-        "height": { "type": "integer", "minimum": 1 }
+        "height": { "type": "integer", "minimum": 1 },
+        "half": { "type": "boolean" }
       },
       "additionalProperties": false
     },
@@ -391,6 +401,7 @@ std::string SchemaValidator::getEmbeddedSchemaV1_3() { // make sure everything i
         { "$ref": "#/definitions/opSetBackground" },
         { "$ref": "#/definitions/opExposure" },
         { "$ref": "#/definitions/opToneMap" },
+        { "$ref": "#/definitions/opSetLodThreshold" },
         { "$ref": "#/definitions/opRenderImage" }
       ]
     }
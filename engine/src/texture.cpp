@@ -64,26 +64,46 @@ bool Texture::loadFromFile(const std::string& filepath, bool flipY)
         std::cerr << "[Texture] KTX2 load failed or unsupported for '" << ktx2Path.string() << "'. Falling back to STB." << std::endl;
     }
 
-    // Load image data
-    int width, height, channels;
-    stbi_set_flip_vertically_on_load(flipY ? 1 : 0);
-    unsigned char* data = stbi_load(filepath.c_str(), &width, &height, &channels, 0);
-    if (!data)
+    TextureImage image;
+    if (!decodeFile(filepath, flipY, image))
     {
         std::cerr << "[Texture] Failed to load texture: " << filepath << std::endl;
         return false;
     }
+    return upload(image, filepath);
+}
+
+bool Texture::decodeFile(const std::string& filepath, bool flipY, TextureImage& out)
+{
+    // The per-thread flag keeps concurrent decodes from flipping each other's images
+    stbi_set_flip_vertically_on_load_thread(flipY ? 1 : 0);
+    unsigned char* data = stbi_load(filepath.c_str(), &out.width, &out.height, &out.channels, 0);
+    if (!data)
+        return false;
+    out.pixels.assign(data, data + size_t(out.width) * out.height * out.channels);
+    stbi_image_free(data);
+    return true;
+}
+
+bool Texture::upload(const TextureImage& image, const std::string& debugName)
+{
+    using namespace glint3d;
+
+    if (!s_rhi) {
+        std::cerr << "[Texture] RHI not initialized. Cannot upload texture." << std::endl;
+        return false;
+    }
 
     // Store dims for perf HUD
-    m_width = width; m_height = height; m_channels = channels;
+    m_width = image.width; m_height = image.height; m_channels = image.channels;
 
     // Create texture via RHI
     TextureDesc desc{};
     desc.type = TextureType::Texture2D;
-    desc.width = width;
-    desc.height = height;
+    desc.width = image.width;
+    desc.height = image.height;
 
-    switch (channels) {
+    switch (image.channels) {
         case 4: desc.format = TextureFormat::RGBA8; break;
         case 3: desc.format = TextureFormat::RGB8; break;
         case 2: desc.format = TextureFormat::RG8; break;
@@ -91,15 +111,14 @@ bool Texture::loadFromFile(const std::string& filepath, bool flipY)
     }
 
     desc.generateMips = true;
-    desc.initialData = data;
-    desc.initialDataSize = width * height * channels;
-    desc.debugName = filepath;
+    desc.initialData = image.pixels.data();
+    desc.initialDataSize = image.pixels.size();
+    desc.debugName = debugName;
 
     m_rhiTex = s_rhi->createTexture(desc);
-    stbi_image_free(data);
 
     if (m_rhiTex == INVALID_HANDLE) {
-        std::cerr << "[Texture] RHI texture creation failed for '" << filepath << "'." << std::endl;
+        std::cerr << "[Texture] RHI texture creation failed for '" << debugName << "'." << std::endl;
         return false;
     }
 
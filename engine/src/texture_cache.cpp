@@ -1,11 +1,25 @@
 #include "texture_cache.h"
+#include "job_system.h"
 #include <glint3d/rhi.h>
 #include <glint3d/rhi_types.h>
 #include "image_io.h"
+#include <algorithm>
+#include <chrono>
 #include <functional>
 #include <filesystem>
+#include <iostream>
 #include <system_error>
 
+namespace
+{
+    // GPU footprint estimate: base level plus a full MIP chain
+    size_t textureBytes(const Texture& t)
+    {
+        const size_t base = size_t(std::max(0, t.width())) * size_t(std::max(0, t.height())) * size_t(std::max(1, t.channels()));
+        return base + base / 3;
+    }
+}
+
 TextureCache& TextureCache::instance() { static TextureCache inst; return inst; }
 
 size_t TextureCache::KeyHash::operator()(Key const& k) const {
@@ -15,35 +29,173 @@ bool TextureCache::KeyEq::operator()(Key const& a, Key const& b) const {
     return a.flip == b.flip && a.path == b.path;
 }
 
-Texture* TextureCache::get(const std::string& path, bool flipY)
+std::shared_ptr<TextureCache::Decoded> TextureCache::decode(const std::string& path, bool flipY)
 {
-    // Resolve to .ktx2 if present so cache keys reflect the actual loaded asset
-    std::string resolved = path;
-    try {
-        std::error_code ec;
-        std::filesystem::path p(path);
-        std::filesystem::path ktx2 = p; ktx2.replace_extension(".ktx2");
-        if (std::filesystem::exists(ktx2, ec) && !ec) {
-            resolved = ktx2.string();
+    auto out = std::make_shared<Decoded>();
+    out->resolved = path;
+
+    // Resolve to .ktx2 if present; those are read by Texture::loadFromFile
+    std::error_code ec;
+    std::filesystem::path ktx2(path);
+    ktx2.replace_extension(".ktx2");
+    if (std::filesystem::exists(ktx2, ec) && !ec) {
+        out->resolved = ktx2.string();
+        out->ktx2 = out->ok = true;
+        return out;
+    }
+    out->ok = Texture::decodeFile(path, flipY, out->image);
+    return out;
+}
+
+std::shared_ptr<Texture> TextureCache::upload(const Decoded& decoded, bool flipY)
+{
+    if (!decoded.ok) {
+        std::cerr << "[TextureCache] Failed to load texture: " << decoded.resolved << std::endl;
+        return nullptr;
+    }
+    auto tex = std::make_shared<Texture>();
+    const bool ok = decoded.ktx2 ? tex->loadFromFile(decoded.resolved, flipY)
+                                 : tex->upload(decoded.image, decoded.resolved);
+    return ok ? tex : nullptr;
+}
+
+std::shared_ptr<Texture> TextureCache::get(const std::string& path, bool flipY)
+{
+    const Key key{path, flipY};
+    std::shared_future<std::shared_ptr<Decoded>> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it != m_entries.end() && it->second.texture) {
+            ++m_stats.hits;
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+            return it->second.texture;
         }
-    } catch (...) {
-        // ignore and use original path
+        ++m_stats.misses;
+        if (it != m_entries.end()) pending = it->second.decode;
     }
 
-    Key key{resolved, flipY};
-    auto it = m_cache.find(key);
-    if (it != m_cache.end()) return it->second.get();
+    // Decode and upload without holding the lock
+    const std::shared_ptr<Decoded> decoded = pending.valid() ? pending.get() : decode(path, flipY);
+    std::shared_ptr<Texture> tex = upload(*decoded, flipY);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (pending.valid()) {
+        m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(),
+                                       [&](const Key& k) { return KeyEq()(k, key); }), m_pending.end());
+    }
+    if (!tex) {
+        auto it = m_entries.find(key);
+        if (it != m_entries.end() && !it->second.texture) m_entries.erase(it);
+        return nullptr;
+    }
+    return insertLocked(key, std::move(tex));
+}
 
-    // Create texture via Texture class (which now uses RHI internally)
-    auto tex = std::make_unique<Texture>();
-    if (!tex->loadFromFile(resolved, flipY)) return nullptr;
+void TextureCache::prefetch(const std::string& path, bool flipY)
+{
+    const Key key{path, flipY};
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_entries.count(key)) return;
+    Entry& e = m_entries[key];
+    e.decode = JobSystem::shared().submit([path, flipY]() { return decode(path, flipY); }).share();
+    m_pending.push_back(key);
+}
 
-    Texture* out = tex.get();
-    m_cache.emplace(std::move(key), std::move(tex));
-    return out;
+size_t TextureCache::pumpUploads(size_t budgetBytes)
+{
+    size_t uploaded = 0, sent = 0;
+    for (;;) {
+        Key key;
+        std::shared_future<std::shared_ptr<Decoded>> ready;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (uploaded > 0 && sent >= budgetBytes) break;
+            // Oldest prefetch whose decode has finished
+            auto it = std::find_if(m_pending.begin(), m_pending.end(), [&](const Key& k) {
+                auto e = m_entries.find(k);
+                return e == m_entries.end() || e->second.texture ||
+                       e->second.decode.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            });
+            if (it == m_pending.end()) break;
+            key = *it;
+            m_pending.erase(it);
+            auto e = m_entries.find(key);
+            if (e == m_entries.end() || e->second.texture) continue;   // already taken by get()
+            ready = e->second.decode;
+        }
+
+        std::shared_ptr<Texture> tex = upload(*ready.get(), key.flip);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!tex) {
+            auto e = m_entries.find(key);
+            if (e != m_entries.end() && !e->second.texture) m_entries.erase(e);
+            continue;
+        }
+        sent += textureBytes(*tex);
+        insertLocked(key, std::move(tex));
+        ++uploaded;
+    }
+    return uploaded;
+}
+
+std::shared_ptr<Texture> TextureCache::insertLocked(const Key& key, std::shared_ptr<Texture> texture)
+{
+    Entry& e = m_entries[key];
+    if (e.texture) return e.texture;   // clear() or another upload raced us
+    e.texture = std::move(texture);
+    e.decode = {};
+    e.bytes = textureBytes(*e.texture);
+    m_lru.push_front(key);
+    e.lru = m_lru.begin();
+    m_residentBytes += e.bytes;
+    std::shared_ptr<Texture> result = e.texture;   // held here, so it is not evicted itself
+    evictLocked();
+    return result;
+}
+
+void TextureCache::evictLocked()
+{
+    // Only textures nobody else holds can go; the rest stay resident and count
+    for (auto it = m_lru.end(); m_residentBytes > m_budget && it != m_lru.begin();) {
+        --it;
+        auto e = m_entries.find(*it);
+        if (e->second.texture.use_count() > 1) continue;
+        m_residentBytes -= e->second.bytes;
+        m_entries.erase(e);
+        it = m_lru.erase(it);
+        ++m_stats.evictions;
+    }
+}
+
+void TextureCache::setBudget(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = bytes;
+    evictLocked();
+}
+
+size_t TextureCache::budget() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_budget;
+}
+
+TextureCache::Stats TextureCache::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats s = m_stats;
+    s.textures = m_lru.size();
+    s.residentBytes = m_residentBytes;
+    s.pendingDecodes = m_pending.size();
+    return s;
 }
 
 void TextureCache::clear()
 {
-    m_cache.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_pending.clear();
+    m_residentBytes = 0;
 }
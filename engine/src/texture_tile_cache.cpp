@@ -0,0 +1,313 @@
+#include "texture_tile_cache.h"
+#include "image_io.h"
+#include "path_utils.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    // Pyramids are built one image at a time, bounding the transient memory
+    // of decoding to a single full-resolution image
+    std::mutex g_decodeMutex;
+
+    bool seekTo(FILE* file, long long offset)
+    {
+#ifdef _WIN32
+        return _fseeki64(file, offset, SEEK_SET) == 0;
+#else
+        return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+    }
+
+    size_t tileBytes(int tileWidth, int tileHeight)
+    {
+        return static_cast<size_t>(tileWidth + 1) * (tileHeight + 1) * 4;
+    }
+
+    // 8-bit gamma-encoded value to linear, as the raster shader decodes it
+    const float* gammaToLinear()
+    {
+        static const auto table = [] {
+            std::array<float, 256> t{};
+            for (int i = 0; i < 256; ++i)
+                t[i] = std::pow(i / 255.0f, 2.2f);
+            return t;
+        }();
+        return table.data();
+    }
+
+    uint8_t linearToGamma(float linear)
+    {
+        return static_cast<uint8_t>(std::lround(std::pow(std::clamp(linear, 0.0f, 1.0f), 1.0f / 2.2f) * 255.0f));
+    }
+}
+
+namespace raytracer {
+
+    TextureTileCache::TextureTileCache() = default;
+
+    TextureTileCache::~TextureTileCache()
+    {
+        for (auto& tex : m_textures)
+            if (tex->file) std::fclose(tex->file);
+    }
+
+    uint32_t TextureTileCache::acquire(const std::string& path, bool gammaEncoded)
+    {
+        if (path.empty()) return kNoTexture;
+        const auto key = std::make_pair(PathUtils::resolveAssetPath(path), gammaEncoded);
+        auto it = m_byPath.find(key);
+        if (it != m_byPath.end()) return it->second;
+
+        const std::string& resolved = key.first;
+        int width = 0, height = 0, channels = 0;
+        if (!stbi_info(resolved.c_str(), &width, &height, &channels) || width <= 0 || height <= 0) {
+            std::cerr << "[TextureTileCache] Cannot read texture: " << path << std::endl;
+            m_byPath[key] = kNoTexture;
+            return kNoTexture;
+        }
+
+        // Lay out the pyramid now; the tiles themselves are written on first use
+        auto tex = std::make_unique<Texture>();
+        tex->path = resolved;
+        tex->gammaEncoded = gammaEncoded;
+        tex->width = width;
+        tex->height = height;
+        long long offset = 0;
+        for (int w = width, h = height;; w = std::max(1, w / 2), h = std::max(1, h / 2)) {
+            Level level;
+            level.width = w;
+            level.height = h;
+            level.tileWidth = std::min(w, kTileSize);
+            level.tileHeight = std::min(h, kTileSize);
+            level.tilesX = (w + level.tileWidth - 1) / level.tileWidth;
+            level.tilesY = (h + level.tileHeight - 1) / level.tileHeight;
+            level.fileOffset = offset;
+            offset += static_cast<long long>(level.tilesX) * level.tilesY * tileBytes(level.tileWidth, level.tileHeight);
+            tex->levels.push_back(level);
+            if (w == 1 && h == 1) break;
+        }
+
+        const uint32_t handle = static_cast<uint32_t>(m_textures.size());
+        m_textures.push_back(std::move(tex));
+        m_byPath[key] = handle;
+        return handle;
+    }
+
+    bool TextureTileCache::buildTiles(Texture& tex) const
+    {
+        std::lock_guard<std::mutex> decodeLock(g_decodeMutex);
+        const auto start = std::chrono::steady_clock::now();
+
+        ImageIO::ImageData8 img;
+        if (!ImageIO::LoadImage8(tex.path, img, /*flipY=*/false, /*desiredChannels=*/4) ||
+            img.width != tex.width || img.height != tex.height) {
+            std::cerr << "[TextureTileCache] Failed to load texture: " << tex.path << std::endl;
+            return false;
+        }
+        tex.file = std::tmpfile();
+        if (!tex.file) {
+            std::cerr << "[TextureTileCache] Cannot create tile file for " << tex.path << std::endl;
+            return false;
+        }
+
+        std::vector<uint8_t> texels = std::move(img.pixels);
+        std::vector<uint8_t> tile;
+        for (size_t l = 0; l < tex.levels.size(); ++l) {
+            const Level& level = tex.levels[l];
+            const int stride = level.tileWidth + 1;
+            tile.resize(tileBytes(level.tileWidth, level.tileHeight));
+            if (!seekTo(tex.file, level.fileOffset)) return false;
+
+            // Tiles in row-major order; texels past the right and top edges
+            // wrap around, which also fills the shared border
+            for (int ty = 0; ty < level.tilesY; ++ty) {
+                for (int tx = 0; tx < level.tilesX; ++tx) {
+                    for (int y = 0; y <= level.tileHeight; ++y) {
+                        const int sy = (ty * level.tileHeight + y) % level.height;
+                        for (int x = 0; x <= level.tileWidth; ++x) {
+                            const int sx = (tx * level.tileWidth + x) % level.width;
+                            const uint8_t* src = &texels[(static_cast<size_t>(sy) * level.width + sx) * 4];
+                            std::copy(src, src + 4, &tile[(static_cast<size_t>(y) * stride + x) * 4]);
+                        }
+                    }
+                    if (std::fwrite(tile.data(), 1, tile.size(), tex.file) != tile.size()) {
+                        std::cerr << "[TextureTileCache] Failed to write tiles for " << tex.path << std::endl;
+                        return false;
+                    }
+                }
+            }
+
+            if (l + 1 == tex.levels.size()) break;
+
+            // 2x2 box filter into the next level; odd edges repeat
+            const Level& next = tex.levels[l + 1];
+            const float* decode = gammaToLinear();
+            std::vector<uint8_t> smaller(static_cast<size_t>(next.width) * next.height * 4);
+            for (int y = 0; y < next.height; ++y) {
+                const int y0 = std::min(2 * y, level.height - 1), y1 = std::min(2 * y + 1, level.height - 1);
+                for (int x = 0; x < next.width; ++x) {
+                    const int x0 = std::min(2 * x, level.width - 1), x1 = std::min(2 * x + 1, level.width - 1);
+                    const uint8_t* q[4] = { &texels[(static_cast<size_t>(y0) * level.width + x0) * 4],
+                                            &texels[(static_cast<size_t>(y0) * level.width + x1) * 4],
+                                            &texels[(static_cast<size_t>(y1) * level.width + x0) * 4],
+                                            &texels[(static_cast<size_t>(y1) * level.width + x1) * 4] };
+                    uint8_t* out = &smaller[(static_cast<size_t>(y) * next.width + x) * 4];
+                    for (int c = 0; c < 4; ++c) {
+                        if (tex.gammaEncoded && c < 3)
+                            out[c] = linearToGamma(0.25f * (decode[q[0][c]] + decode[q[1][c]] + decode[q[2][c]] + decode[q[3][c]]));
+                        else
+                            out[c] = static_cast<uint8_t>((q[0][c] + q[1][c] + q[2][c] + q[3][c] + 2) / 4);
+                    }
+                }
+            }
+            texels = std::move(smaller);
+        }
+        std::fflush(tex.file);
+
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[TextureTileCache] Tiled " << tex.path << " (" << tex.width << "x" << tex.height << ", "
+                  << tex.levels.size() << " MIP levels, " << ms << " ms)\n";
+        return true;
+    }
+
+    TextureTileCache::TilePtr TextureTileCache::readTile(Texture& tex, int level, int tx, int ty) const
+    {
+        std::lock_guard<std::mutex> lock(tex.mutex);
+        if (!tex.ready && !tex.failed) {
+            tex.ready = buildTiles(tex);
+            tex.failed = !tex.ready;
+        }
+        if (tex.failed) return nullptr;
+
+        const Level& l = tex.levels[level];
+        auto tile = std::make_shared<Tile>();
+        tile->stride = l.tileWidth + 1;
+        tile->texels.resize(tileBytes(l.tileWidth, l.tileHeight));
+        const long long offset = l.fileOffset + (static_cast<long long>(ty) * l.tilesX + tx) * static_cast<long long>(tile->texels.size());
+        if (!seekTo(tex.file, offset) || std::fread(tile->texels.data(), 1, tile->texels.size(), tex.file) != tile->texels.size()) {
+            std::cerr << "[TextureTileCache] Failed to read a tile of " << tex.path << std::endl;
+            tex.failed = true;
+            return nullptr;
+        }
+        m_tileLoads.fetch_add(1, std::memory_order_relaxed);
+        return tile;
+    }
+
+    uint64_t TextureTileCache::tileKey(uint32_t texture, int level, int tile)
+    {
+        return (uint64_t(texture) << 40) | (uint64_t(level) << 32) | uint32_t(tile);
+    }
+
+    TextureTileCache::TilePtr TextureTileCache::tile(uint32_t texture, int level, int tx, int ty) const
+    {
+        const Level& l = m_textures[texture]->levels[level];
+        const uint64_t key = tileKey(texture, level, ty * l.tilesX + tx);
+        Shard& shard = m_shards[(key * 0x9E3779B97F4A7C15ull) >> 60];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key);
+            if (it != shard.index.end()) {
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+                return it->second->second;
+            }
+        }
+
+        // Miss: read without holding the shard so other tiles stay available
+        TilePtr loaded = readTile(*m_textures[texture], level, tx, ty);
+        if (!loaded) return nullptr;
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end())
+            return it->second->second;    // another thread got there first
+        shard.lru.emplace_front(key, loaded);
+        shard.index[key] = shard.lru.begin();
+        shard.bytes += loaded->texels.size();
+        evict(shard, m_budget / kShards);
+        return loaded;
+    }
+
+    void TextureTileCache::evict(Shard& shard, size_t limit) const
+    {
+        // The most recent tile always stays, even over a tiny budget
+        while (shard.bytes > limit && shard.lru.size() > 1) {
+            auto& victim = shard.lru.back();
+            shard.bytes -= victim.second->texels.size();
+            shard.index.erase(victim.first);
+            shard.lru.pop_back();
+        }
+    }
+
+    bool TextureTileCache::bilinear(uint32_t texture, int level, const glm::vec2& uv, glm::vec4& value) const
+    {
+        const Level& l = m_textures[texture]->levels[level];
+        const float x = uv.x * l.width - 0.5f, y = uv.y * l.height - 0.5f;
+        const float fx = std::floor(x), fy = std::floor(y);
+        const float sx = x - fx, sy = y - fy;
+
+        // Texel (x0, y0) with its right and upper neighbours, which the
+        // tile border guarantees are in the same tile
+        auto wrap = [](float i, int n) { const int k = static_cast<int>(std::fmod(i, float(n))); return k < 0 ? k + n : k; };
+        const int x0 = wrap(fx, l.width), y0 = wrap(fy, l.height);
+        const int tx = x0 / l.tileWidth, ty = y0 / l.tileHeight;
+        const TilePtr t = tile(texture, level, tx, ty);
+        if (!t) return false;
+
+        const uint8_t* p = &t->texels[(static_cast<size_t>(y0 - ty * l.tileHeight) * t->stride + (x0 - tx * l.tileWidth)) * 4];
+        const uint8_t* up = p + static_cast<size_t>(t->stride) * 4;
+        const float* decode = gammaToLinear();
+        const bool gammaEncoded = m_textures[texture]->gammaEncoded;
+        auto texel = [&](const uint8_t* q) {
+            if (gammaEncoded) return glm::vec4(decode[q[0]], decode[q[1]], decode[q[2]], q[3] * (1.0f / 255.0f));
+            return glm::vec4(q[0], q[1], q[2], q[3]) * (1.0f / 255.0f);
+        };
+        const glm::vec4 bottom = glm::mix(texel(p), texel(p + 4), sx);
+        const glm::vec4 top = glm::mix(texel(up), texel(up + 4), sx);
+        value = glm::mix(bottom, top, sy);
+        return true;
+    }
+
+    bool TextureTileCache::sample(uint32_t texture, const glm::vec2& uv, float footprint, glm::vec4& value) const
+    {
+        if (texture >= m_textures.size()) return false;
+        const Texture& tex = *m_textures[texture];
+
+        // Level whose texels are as wide as the footprint
+        const int top = static_cast<int>(tex.levels.size()) - 1;
+        float lod = 0.0f;
+        if (footprint > 0.0f)
+            lod = std::clamp(std::log2(footprint * std::sqrt(float(tex.width) * float(tex.height))), 0.0f, float(top));
+        const int level = static_cast<int>(lod);
+        const float t = lod - float(level);
+
+        if (!bilinear(texture, level, uv, value)) return false;
+        glm::vec4 coarse;
+        if (t > 0.0f && level < top && bilinear(texture, level + 1, uv, coarse))
+            value = glm::mix(value, coarse, t);
+        return true;
+    }
+
+    void TextureTileCache::setBudget(size_t bytes)
+    {
+        m_budget = bytes;
+        for (Shard& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            evict(shard, m_budget / kShards);
+        }
+    }
+
+    size_t TextureTileCache::residentBytes() const
+    {
+        size_t bytes = 0;
+        for (const Shard& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            bytes += shard.bytes;
+        }
+        return bytes;
+    }
+}
@@ -0,0 +1,133 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+// Single-threaded web builds have no std::thread support; everything runs inline
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define GLINT_POOL_NO_THREADS 1
+#endif
+
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+#ifdef GLINT_POOL_NO_THREADS
+    threadCount = 1;
+#else
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+#endif
+
+    m_queues.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        m_queues.push_back(std::make_unique<Queue>());
+
+    // Worker 0 is whichever thread calls run()
+    for (unsigned i = 1; i < threadCount; ++i)
+        m_threads.emplace_back(&ThreadPool::workerMain, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_threads)
+        t.join();
+}
+
+ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::run(uint32_t taskCount, const TaskFn& fn)
+{
+    if (taskCount == 0) return;
+
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+
+    if (m_threads.empty())
+    {
+        for (uint32_t i = 0; i < taskCount; ++i)
+            fn(i, 0);
+        return;
+    }
+
+    // Contiguous blocks keep neighbouring tasks (and their cache lines) on one worker
+    const uint32_t workers = workerCount();
+    for (uint32_t w = 0; w < workers; ++w)
+    {
+        const uint32_t begin = static_cast<uint32_t>(uint64_t(taskCount) * w / workers);
+        const uint32_t end = static_cast<uint32_t>(uint64_t(taskCount) * (w + 1) / workers);
+        std::lock_guard<std::mutex> lock(m_queues[w]->mutex);
+        for (uint32_t t = begin; t < end; ++t)
+            m_queues[w]->tasks.push_back(t);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &fn;
+        m_busy = static_cast<unsigned>(m_threads.size());
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    drain(0, fn);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_job = nullptr;
+}
+
+void ThreadPool::workerMain(unsigned worker)
+{
+    uint64_t seen = 0;
+    for (;;)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+        if (m_stop) return;
+        seen = m_generation;
+        const TaskFn* job = m_job;
+        lock.unlock();
+
+        drain(worker, *job);
+
+        lock.lock();
+        if (--m_busy == 0) m_done.notify_all();
+    }
+}
+
+// Tasks are only queued before workers wake, so once every queue is empty
+// the batch has no work left to hand out
+void ThreadPool::drain(unsigned worker, const TaskFn& fn)
+{
+    uint32_t task;
+    while (popLocal(worker, task) || steal(worker, task))
+        fn(task, worker);
+}
+
+bool ThreadPool::popLocal(unsigned worker, uint32_t& task)
+{
+    Queue& q = *m_queues[worker];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty()) return false;
+    task = q.tasks.front();
+    q.tasks.pop_front();
+    return true;
+}
+
+bool ThreadPool::steal(unsigned thief, uint32_t& task)
+{
+    const unsigned workers = workerCount();
+    for (unsigned i = 1; i < workers; ++i)
+    {
+        Queue& q = *m_queues[(thief + i) % workers];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) continue;
+        task = q.tasks.back();
+        q.tasks.pop_back();
+        return true;
+    }
+    return false;
+}
@@ -1 +1,107 @@
-﻿// added description of the implementation in the header.
\ No newline at end of file
+#include "triangle.h"
+#include "objloader.h"
+#include "bvh_node.h"
+
+void TriangleMesh::clear()
+{
+    for (auto* a : { &v0x, &v0y, &v0z, &e1x, &e1y, &e1z, &e2x, &e2y, &e2z })
+        a->clear();
+    indices.clear();
+    normals.clear();
+    texcoords.clear();
+    m_triangleCount = 0;
+}
+
+void TriangleMesh::build(const ObjLoader& mesh)
+{
+    clear();
+
+    const float* pos = mesh.getPositions();
+    const float* nrm = mesh.getNormals();
+    const unsigned int* idx = mesh.getFaces();
+    const size_t Nv = static_cast<size_t>(mesh.getVertCount());
+    const size_t Nt = static_cast<size_t>(mesh.getIndexCount()) / 3;
+
+    m_triangleCount = Nt;
+    for (auto* a : { &v0x, &v0y, &v0z, &e1x, &e1y, &e1z, &e2x, &e2y, &e2z })
+        a->assign(Nt + kSimdPadding, 0.0f);
+    indices.assign(idx, idx + Nt * 3);
+
+    auto vertex = [&](unsigned int i) { return glm::vec3(pos[i * 3 + 0], pos[i * 3 + 1], pos[i * 3 + 2]); };
+    for (size_t t = 0; t < Nt; ++t)
+    {
+        const glm::vec3 a = vertex(idx[t * 3 + 0]);
+        const glm::vec3 e1 = vertex(idx[t * 3 + 1]) - a;
+        const glm::vec3 e2 = vertex(idx[t * 3 + 2]) - a;
+        v0x[t] = a.x;  v0y[t] = a.y;  v0z[t] = a.z;
+        e1x[t] = e1.x; e1y[t] = e1.y; e1z[t] = e1.z;
+        e2x[t] = e2.x; e2y[t] = e2.y; e2z[t] = e2.z;
+    }
+
+    if (nrm)
+    {
+        normals.resize(Nv);
+        for (size_t i = 0; i < Nv; ++i)
+            normals[i] = glm::vec3(nrm[i * 3 + 0], nrm[i * 3 + 1], nrm[i * 3 + 2]);
+    }
+
+    if (mesh.hasTexcoords())
+    {
+        const float* uv = mesh.getTexcoords();
+        texcoords.resize(Nv);
+        for (size_t i = 0; i < Nv; ++i)
+            texcoords[i] = glm::vec2(uv[i * 2 + 0], uv[i * 2 + 1]);
+    }
+}
+
+void TriangleMesh::adoptBVHOrder(BVH& bvh)
+{
+    const std::vector<uint32_t>& order = bvh.primIndices();
+    if (order.size() != triangleCount()) return;
+
+    auto permute = [&](auto& arr, size_t stride) {
+        const auto copy = arr;
+        for (size_t i = 0; i < order.size(); ++i)
+            for (size_t k = 0; k < stride; ++k)
+                arr[i * stride + k] = copy[order[i] * stride + k];
+    };
+    for (auto* a : { &v0x, &v0y, &v0z, &e1x, &e1y, &e1z, &e2x, &e2y, &e2z })
+        permute(*a, 1);
+    permute(indices, 3);
+
+    bvh.resetPrimitiveOrder();
+}
+
+size_t TriangleMesh::memoryBytes() const
+{
+    return 9 * v0x.capacity() * sizeof(float)
+         + indices.capacity() * sizeof(uint32_t)
+         + normals.capacity() * sizeof(glm::vec3)
+         + texcoords.capacity() * sizeof(glm::vec2);
+}
+
+glm::vec3 TriangleMesh::geometricNormal(uint32_t t) const
+{
+    const glm::vec3 e1(e1x[t], e1y[t], e1z[t]);
+    const glm::vec3 e2(e2x[t], e2y[t], e2z[t]);
+    return glm::normalize(glm::cross(e1, e2));
+}
+
+glm::vec3 TriangleMesh::shadingNormal(uint32_t t, float u, float v) const
+{
+    if (!normals.empty())
+    {
+        const glm::vec3 n = (1.0f - u - v) * normals[indices[t * 3 + 0]]
+                          + u * normals[indices[t * 3 + 1]]
+                          + v * normals[indices[t * 3 + 2]];
+        const float len2 = glm::dot(n, n);
+        if (len2 > 1e-12f)
+            return n / std::sqrt(len2);
+    }
+    return geometricNormal(t);
+}
+
+glm::vec2 TriangleMesh::texcoord(uint32_t t, float u, float v) const
+{
+    return (1.0f - u - v) * texcoord(t, 0) + u * texcoord(t, 1) + v * texcoord(t, 2);
+}
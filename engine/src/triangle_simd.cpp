@@ -0,0 +1,231 @@
+#include "triangle_simd.h"
+#include "triangle.h"
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GLINT_HAS_SSE 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace
+{
+    using simd::Isa;
+    using simd::Kernels;
+    using simd::LeafHit;
+
+    // --- Scalar: the reference path, one triangle at a time ---
+
+    bool intersectScalar(const TriangleMesh& mesh, uint32_t first, uint32_t count,
+                         const glm::vec3& o, const glm::vec3& d, float& tMax, LeafHit& hit)
+    {
+        bool found = false;
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            float t, u, v;
+            if (!mesh.intersect(i, o, d, tMax, t, u, v)) continue;
+            tMax = t;
+            hit = { i, u, v };
+            found = true;
+        }
+        return found;
+    }
+
+    bool occludedScalar(const TriangleMesh& mesh, uint32_t first, uint32_t count,
+                        const glm::vec3& o, const glm::vec3& d, float tMax)
+    {
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            float t, u, v;
+            if (mesh.intersect(i, o, d, tMax, t, u, v)) return true;
+        }
+        return false;
+    }
+
+#ifdef GLINT_HAS_SSE
+    // --- SSE: one ray against 4 triangles ---
+    // Same operation order as TriangleMesh::intersect so results match the
+    // scalar path; rejected lanes are masked instead of branching.
+
+    struct Hit4
+    {
+        __m128 mask, t, u, v;
+    };
+
+    inline Hit4 intersect4(const TriangleMesh& m, uint32_t base, uint32_t remaining,
+                           const __m128 o[3], const __m128 d[3], __m128 tMax)
+    {
+        const __m128 ax = _mm_loadu_ps(&m.e1x[base]), ay = _mm_loadu_ps(&m.e1y[base]), az = _mm_loadu_ps(&m.e1z[base]);
+        const __m128 bx = _mm_loadu_ps(&m.e2x[base]), by = _mm_loadu_ps(&m.e2y[base]), bz = _mm_loadu_ps(&m.e2z[base]);
+
+        const __m128 px = _mm_sub_ps(_mm_mul_ps(d[1], bz), _mm_mul_ps(d[2], by));
+        const __m128 py = _mm_sub_ps(_mm_mul_ps(d[2], bx), _mm_mul_ps(d[0], bz));
+        const __m128 pz = _mm_sub_ps(_mm_mul_ps(d[0], by), _mm_mul_ps(d[1], bx));
+        const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, px), _mm_mul_ps(ay, py)), _mm_mul_ps(az, pz));
+
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        __m128 mask = _mm_cmpge_ps(_mm_and_ps(det, absMask), _mm_set1_ps(1e-12f));
+        const __m128i lane = _mm_set_epi32(3, 2, 1, 0);
+        mask = _mm_and_ps(mask, _mm_castsi128_ps(_mm_cmplt_epi32(lane, _mm_set1_epi32(static_cast<int>(remaining)))));
+        const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+        const __m128 sx = _mm_sub_ps(o[0], _mm_loadu_ps(&m.v0x[base]));
+        const __m128 sy = _mm_sub_ps(o[1], _mm_loadu_ps(&m.v0y[base]));
+        const __m128 sz = _mm_sub_ps(o[2], _mm_loadu_ps(&m.v0z[base]));
+        const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), invDet);
+        const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+        mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+
+        const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, az), _mm_mul_ps(sz, ay));
+        const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, ax), _mm_mul_ps(sx, az));
+        const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, ay), _mm_mul_ps(sy, ax));
+        const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(d[0], qx), _mm_mul_ps(d[1], qy)), _mm_mul_ps(d[2], qz)), invDet);
+        mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+
+        const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(bx, qx), _mm_mul_ps(by, qy)), _mm_mul_ps(bz, qz)), invDet);
+        mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpgt_ps(t, _mm_set1_ps(TriangleMesh::kMinT)), _mm_cmplt_ps(t, tMax)));
+
+        return { mask, t, u, v };
+    }
+
+    inline int lowestBit(int bits)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, static_cast<unsigned long>(bits));
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(static_cast<unsigned>(bits));
+#endif
+    }
+
+    bool intersectSSE(const TriangleMesh& mesh, uint32_t first, uint32_t count,
+                      const glm::vec3& orig, const glm::vec3& dir, float& tMax, LeafHit& hit)
+    {
+        const __m128 o[3] = { _mm_set1_ps(orig.x), _mm_set1_ps(orig.y), _mm_set1_ps(orig.z) };
+        const __m128 d[3] = { _mm_set1_ps(dir.x), _mm_set1_ps(dir.y), _mm_set1_ps(dir.z) };
+        bool found = false;
+
+        for (uint32_t base = first; base < first + count; base += 4)
+        {
+            const Hit4 h = intersect4(mesh, base, first + count - base, o, d, _mm_set1_ps(tMax));
+            if (_mm_movemask_ps(h.mask) == 0) continue;
+
+            // Closest lane; ties keep the lowest triangle index like the scalar loop
+            __m128 tMin = _mm_or_ps(_mm_and_ps(h.mask, h.t), _mm_andnot_ps(h.mask, _mm_set1_ps(FLT_MAX)));
+            tMin = _mm_min_ps(tMin, _mm_shuffle_ps(tMin, tMin, _MM_SHUFFLE(2, 3, 0, 1)));
+            tMin = _mm_min_ps(tMin, _mm_shuffle_ps(tMin, tMin, _MM_SHUFFLE(1, 0, 3, 2)));
+            const int lane = lowestBit(_mm_movemask_ps(_mm_and_ps(h.mask, _mm_cmpeq_ps(h.t, tMin))));
+
+            alignas(16) float t[4], u[4], v[4];
+            _mm_store_ps(t, h.t);
+            _mm_store_ps(u, h.u);
+            _mm_store_ps(v, h.v);
+            tMax = t[lane];
+            hit = { base + lane, u[lane], v[lane] };
+            found = true;
+        }
+        return found;
+    }
+
+    bool occludedSSE(const TriangleMesh& mesh, uint32_t first, uint32_t count,
+                     const glm::vec3& orig, const glm::vec3& dir, float tMax)
+    {
+        const __m128 o[3] = { _mm_set1_ps(orig.x), _mm_set1_ps(orig.y), _mm_set1_ps(orig.z) };
+        const __m128 d[3] = { _mm_set1_ps(dir.x), _mm_set1_ps(dir.y), _mm_set1_ps(dir.z) };
+        const __m128 tMax4 = _mm_set1_ps(tMax);
+
+        for (uint32_t base = first; base < first + count; base += 4)
+            if (_mm_movemask_ps(intersect4(mesh, base, first + count - base, o, d, tMax4).mask) != 0)
+                return true;
+        return false;
+    }
+#endif
+
+    bool cpuHasAvx2()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;   // OS must save YMM state
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    const Kernels kScalar{ Isa::Scalar, intersectScalar, occludedScalar };
+#ifdef GLINT_HAS_SSE
+    const Kernels kSSE{ Isa::SSE, intersectSSE, occludedSSE };
+#endif
+
+    const Kernels& selectKernels()
+    {
+        const Kernels* best = &kScalar;
+        for (Isa isa : { Isa::SSE, Isa::AVX2 })
+            if (const Kernels* k = simd::kernelsFor(isa)) best = k;
+
+        if (const char* env = std::getenv("GLINT_SIMD"))
+        {
+            const Kernels* forced = nullptr;
+            if (std::strcmp(env, "scalar") == 0) forced = &kScalar;
+            else if (std::strcmp(env, "sse") == 0) forced = simd::kernelsFor(Isa::SSE);
+            else if (std::strcmp(env, "avx2") == 0) forced = simd::kernelsFor(Isa::AVX2);
+
+            if (forced) best = forced;
+            else std::cerr << "[SIMD] GLINT_SIMD=" << env << " not available, using " << simd::isaName(best->isa) << "\n";
+        }
+        return *best;
+    }
+}
+
+namespace simd
+{
+    const Kernels& kernels()
+    {
+        static const Kernels& selected = selectKernels();
+        return selected;
+    }
+
+    const Kernels* kernelsFor(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::Scalar:
+            return &kScalar;
+        case Isa::SSE:
+#ifdef GLINT_HAS_SSE
+            return &kSSE;
+#else
+            return nullptr;
+#endif
+        case Isa::AVX2:
+            return cpuHasAvx2() ? detail::avx2Kernels() : nullptr;
+        }
+        return nullptr;
+    }
+
+    const char* isaName(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::Scalar: return "scalar";
+        case Isa::SSE:    return "sse";
+        case Isa::AVX2:   return "avx2";
+        }
+        return "unknown";
+    }
+}
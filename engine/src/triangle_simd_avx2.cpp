@@ -0,0 +1,136 @@
+// 8-wide triangle kernels. This file is the only one compiled with AVX2
+// enabled; the dispatcher in triangle_simd.cpp calls into it only after
+// checking the CPU, so the rest of the engine stays baseline x86-64.
+#include "triangle_simd.h"
+#include "triangle.h"
+#include <cfloat>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    using simd::Isa;
+    using simd::Kernels;
+    using simd::LeafHit;
+
+    struct Hit8
+    {
+        __m256 mask, t, u, v;
+    };
+
+    // Mirrors TriangleMesh::intersect operation by operation (no FMA) so the
+    // results match the scalar and SSE paths bit for bit
+    inline Hit8 intersect8(const TriangleMesh& m, uint32_t base, uint32_t remaining,
+                           const __m256 o[3], const __m256 d[3], __m256 tMax)
+    {
+        const __m256 ax = _mm256_loadu_ps(&m.e1x[base]), ay = _mm256_loadu_ps(&m.e1y[base]), az = _mm256_loadu_ps(&m.e1z[base]);
+        const __m256 bx = _mm256_loadu_ps(&m.e2x[base]), by = _mm256_loadu_ps(&m.e2y[base]), bz = _mm256_loadu_ps(&m.e2z[base]);
+
+        const __m256 px = _mm256_sub_ps(_mm256_mul_ps(d[1], bz), _mm256_mul_ps(d[2], by));
+        const __m256 py = _mm256_sub_ps(_mm256_mul_ps(d[2], bx), _mm256_mul_ps(d[0], bz));
+        const __m256 pz = _mm256_sub_ps(_mm256_mul_ps(d[0], by), _mm256_mul_ps(d[1], bx));
+        const __m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax, px), _mm256_mul_ps(ay, py)), _mm256_mul_ps(az, pz));
+
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        __m256 mask = _mm256_cmp_ps(_mm256_and_ps(det, absMask), _mm256_set1_ps(1e-12f), _CMP_GE_OQ);
+        const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        mask = _mm256_and_ps(mask, _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(remaining)), lane)));
+        const __m256 invDet = _mm256_div_ps(_mm256_set1_ps(1.0f), det);
+
+        const __m256 sx = _mm256_sub_ps(o[0], _mm256_loadu_ps(&m.v0x[base]));
+        const __m256 sy = _mm256_sub_ps(o[1], _mm256_loadu_ps(&m.v0y[base]));
+        const __m256 sz = _mm256_sub_ps(o[2], _mm256_loadu_ps(&m.v0z[base]));
+        const __m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, px), _mm256_mul_ps(sy, py)), _mm256_mul_ps(sz, pz)), invDet);
+        const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+        mask = _mm256_and_ps(mask, _mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_GE_OQ), _mm256_cmp_ps(u, one, _CMP_LE_OQ)));
+
+        const __m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, az), _mm256_mul_ps(sz, ay));
+        const __m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, ax), _mm256_mul_ps(sx, az));
+        const __m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, ay), _mm256_mul_ps(sy, ax));
+        const __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(d[0], qx), _mm256_mul_ps(d[1], qy)), _mm256_mul_ps(d[2], qz)), invDet);
+        mask = _mm256_and_ps(mask, _mm256_and_ps(_mm256_cmp_ps(v, zero, _CMP_GE_OQ),
+                                                 _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ)));
+
+        const __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(bx, qx), _mm256_mul_ps(by, qy)), _mm256_mul_ps(bz, qz)), invDet);
+        mask = _mm256_and_ps(mask, _mm256_and_ps(_mm256_cmp_ps(t, _mm256_set1_ps(TriangleMesh::kMinT), _CMP_GT_OQ),
+                                                 _mm256_cmp_ps(t, tMax, _CMP_LT_OQ)));
+
+        return { mask, t, u, v };
+    }
+
+    inline int lowestBit(int bits)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, static_cast<unsigned long>(bits));
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(static_cast<unsigned>(bits));
+#endif
+    }
+
+    bool intersectAVX2(const TriangleMesh& mesh, uint32_t first, uint32_t count,
+                       const glm::vec3& orig, const glm::vec3& dir, float& tMax, LeafHit& hit)
+    {
+        const __m256 o[3] = { _mm256_set1_ps(orig.x), _mm256_set1_ps(orig.y), _mm256_set1_ps(orig.z) };
+        const __m256 d[3] = { _mm256_set1_ps(dir.x), _mm256_set1_ps(dir.y), _mm256_set1_ps(dir.z) };
+        bool found = false;
+
+        for (uint32_t base = first; base < first + count; base += 8)
+        {
+            const Hit8 h = intersect8(mesh, base, first + count - base, o, d, _mm256_set1_ps(tMax));
+            if (_mm256_movemask_ps(h.mask) == 0) continue;
+
+            // Closest lane; ties keep the lowest triangle index like the scalar loop
+            __m256 tMin = _mm256_blendv_ps(_mm256_set1_ps(FLT_MAX), h.t, h.mask);
+            tMin = _mm256_min_ps(tMin, _mm256_permute_ps(tMin, _MM_SHUFFLE(2, 3, 0, 1)));
+            tMin = _mm256_min_ps(tMin, _mm256_permute_ps(tMin, _MM_SHUFFLE(1, 0, 3, 2)));
+            tMin = _mm256_min_ps(tMin, _mm256_permute2f128_ps(tMin, tMin, 0x01));
+            const int bits = _mm256_movemask_ps(_mm256_and_ps(h.mask, _mm256_cmp_ps(h.t, tMin, _CMP_EQ_OQ)));
+            const int lane = lowestBit(bits);
+
+            alignas(32) float t[8], u[8], v[8];
+            _mm256_store_ps(t, h.t);
+            _mm256_store_ps(u, h.u);
+            _mm256_store_ps(v, h.v);
+            tMax = t[lane];
+            hit = { base + lane, u[lane], v[lane] };
+            found = true;
+        }
+        return found;
+    }
+
+    bool occludedAVX2(const TriangleMesh& mesh, uint32_t first, uint32_t count,
+                      const glm::vec3& orig, const glm::vec3& dir, float tMax)
+    {
+        const __m256 o[3] = { _mm256_set1_ps(orig.x), _mm256_set1_ps(orig.y), _mm256_set1_ps(orig.z) };
+        const __m256 d[3] = { _mm256_set1_ps(dir.x), _mm256_set1_ps(dir.y), _mm256_set1_ps(dir.z) };
+        const __m256 tMax8 = _mm256_set1_ps(tMax);
+
+        for (uint32_t base = first; base < first + count; base += 8)
+            if (_mm256_movemask_ps(intersect8(mesh, base, first + count - base, o, d, tMax8).mask) != 0)
+                return true;
+        return false;
+    }
+
+    const Kernels kAVX2{ Isa::AVX2, intersectAVX2, occludedAVX2 };
+}
+
+const simd::Kernels* simd::detail::avx2Kernels()
+{
+    return &kAVX2;
+}
+
+#else
+
+// Built without AVX2 support (non-x86 target or missing compiler flags)
+const simd::Kernels* simd::detail::avx2Kernels()
+{
+    return nullptr;
+}
+
+#endif
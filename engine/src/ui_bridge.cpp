@@ -745,7 +745,7 @@ void UIBridge::handleConsoleCommand(const UICommandData& cmd)
         addConsoleMessage("  exposure         - Adjust scene exposure");
         addConsoleMessage("  tone_map         - Configure tone mapping (linear/reinhard/filmic/aces)");
         addConsoleMessage("--- Rendering ---");
-        addConsoleMessage("  render_image     - Render scene to PNG file");
+        addConsoleMessage("  render_image     - Render scene to PNG (or multi-layer .exr) file");
         addConsoleMessage("");
         addConsoleMessage("See examples/json-ops/ for detailed examples and schemas/json_ops_v1.json for validation.");
         addConsoleMessage("Check Help > JSON Operations (menu bar) for interactive reference with examples.");
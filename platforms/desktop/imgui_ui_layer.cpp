@@ -711,6 +711,10 @@ void ImGuiUILayer::renderSettingsPanel(const UIState& state)
                 ImGui::Text("Draw Calls:");
                 ImGui::SameLine(120);
                 ImGui::Text("%d", state.renderStats.drawCalls);
+
+                ImGui::Text("Instanced:");
+                ImGui::SameLine(120);
+                ImGui::Text("%d objects", state.renderStats.instancedObjects);
                 
                 ImGui::Text("Triangles:");
                 ImGui::SameLine(120);
@@ -723,6 +727,14 @@ void ImGuiUILayer::renderSettingsPanel(const UIState& state)
                 ImGui::Text("Textures:");
                 ImGui::SameLine(120);
                 ImGui::Text("%zu (%.1f MB)", state.renderStats.uniqueTextures, state.renderStats.texturesMB);
+
+                ImGui::Text("Tex Cache:");
+                ImGui::SameLine(120);
+                ImGui::Text("%llu hit / %llu miss / %llu evict (%.1f MB)",
+                            (unsigned long long)state.renderStats.textureCacheHits,
+                            (unsigned long long)state.renderStats.textureCacheMisses,
+                            (unsigned long long)state.renderStats.textureCacheEvictions,
+                            state.renderStats.textureCacheMB);
                 
                 ImGui::Text("Est. VRAM:");
                 ImGui::SameLine(120);
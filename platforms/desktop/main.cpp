@@ -141,11 +141,9 @@ int main(int argc, char** argv)
         app->setRaytraceMode(true);
     }
     
-    // Configure reflection samples per pixel
-    if (parseResult.options.reflectionSpp != 8) { // Only log if not default
-        Logger::debug("Setting reflection samples per pixel to " + std::to_string(parseResult.options.reflectionSpp));
+    if (parseResult.options.deprecatedReflectionSpp) {
+        Logger::warn("--refl-spp is deprecated and has no effect; glossy bounces share pixel samples");
     }
-    app->setReflectionSpp(parseResult.options.reflectionSpp);
     
     // Configure schema validation
     if (parseResult.options.strictSchema) {
@@ -300,9 +298,15 @@ int main(int argc, char** argv)
                         ", tone=" + RenderSettings::toneMappingToString(rs.toneMapping) + 
                         ", exposure=" + std::to_string(rs.exposure) + 
                         ", gamma=" + std::to_string(rs.gamma) + 
-                        ", samples=" + std::to_string(rs.samples));
+                        ", samples=" + std::to_string(rs.samples) +
+                        ", quality=" + std::to_string(rs.quality) +
+                        ", time-budget=" + std::to_string(rs.timeBudget) + "s" +
+                        ", lod-error=" + std::to_string(rs.lodErrorPixels) + "px");
             
-            if (!app->renderToPNG(outputPath, parseResult.options.outputWidth, parseResult.options.outputHeight)) {
+            const bool rendered = RenderUtils::isExrPath(outputPath)
+                ? app->renderToEXR(outputPath, parseResult.options.outputWidth, parseResult.options.outputHeight)
+                : app->renderToPNG(outputPath, parseResult.options.outputWidth, parseResult.options.outputHeight);
+            if (!rendered) {
                 Logger::error("Render failed");
                 delete app;
                 return static_cast<int>(CLIExitCode::RuntimeError);
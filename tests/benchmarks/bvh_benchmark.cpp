@@ -0,0 +1,238 @@
+// BVH benchmark: reports build time and closest-hit / any-hit throughput
+// for OBJ models (defaults to every .obj under assets/models), for the scalar
+// triangle kernels, the CPU's best SIMD kernels and 4-ray primary packets.
+//
+// Usage: bvh_benchmark [--res N] [model.obj ...]
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <glm/glm.hpp>
+#include "../../engine/include/bvh_node.h"
+#include "../../engine/include/triangle.h"
+#include "../../engine/include/triangle_simd.h"
+#include "../../engine/include/objloader.h"
+#include "../../engine/include/path_utils.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double secondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    struct Scene
+    {
+        TriangleMesh mesh;
+        BVH bvh;
+        glm::vec3 boundsMin{ FLT_MAX };
+        glm::vec3 boundsMax{ -FLT_MAX };
+    };
+
+    bool loadScene(const std::string& path, Scene& scene)
+    {
+        ObjLoader loader;
+        loader.load(path.c_str());
+        if (loader.getIndexCount() < 3) return false;
+
+        scene.mesh.build(loader);
+        scene.boundsMin = loader.getMinBounds();
+        scene.boundsMax = loader.getMaxBounds();
+        return true;
+    }
+
+    double buildBVH(Scene& scene)
+    {
+        const auto start = Clock::now();
+        const size_t n = scene.mesh.triangleCount();
+        std::vector<glm::vec3> primMin(n), primMax(n);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            const glm::vec3 a = scene.mesh.vertex0(i), b = scene.mesh.vertex1(i), c = scene.mesh.vertex2(i);
+            primMin[i] = glm::min(a, glm::min(b, c));
+            primMax[i] = glm::max(a, glm::max(b, c));
+        }
+        scene.bvh.build(primMin, primMax, 4);   // same leaf width as the raytracer's BLAS
+        scene.mesh.adoptBVHOrder(scene.bvh);
+        return secondsSince(start);
+    }
+
+    // Primary rays from a camera framing the model bounds
+    std::vector<Ray> makePrimaryRays(const Scene& scene, int res)
+    {
+        const glm::vec3 center = 0.5f * (scene.boundsMin + scene.boundsMax);
+        const float radius = 0.5f * glm::length(scene.boundsMax - scene.boundsMin);
+        const glm::vec3 eye = center + glm::vec3(0.3f, 0.4f, 1.0f) * (radius * 2.2f);
+        const glm::vec3 front = glm::normalize(center - eye);
+        const glm::vec3 right = glm::normalize(glm::cross(front, glm::vec3(0, 1, 0)));
+        const glm::vec3 up = glm::cross(right, front);
+        const float scale = std::tan(glm::radians(22.5f));
+
+        std::vector<Ray> rays;
+        rays.reserve(static_cast<size_t>(res) * res);
+        for (int y = 0; y < res; ++y)
+            for (int x = 0; x < res; ++x)
+            {
+                const float u = ((x + 0.5f) / res * 2.0f - 1.0f) * scale;
+                const float v = (1.0f - (y + 0.5f) / res * 2.0f) * scale;
+                rays.emplace_back(eye, front + u * right + v * up);
+            }
+        return rays;
+    }
+
+    // Incoherent rays between random points inside the bounds
+    std::vector<Ray> makeRandomRays(const Scene& scene, size_t count)
+    {
+        std::mt19937 rng(1234u);
+        std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+        auto randomPoint = [&]() {
+            return scene.boundsMin + glm::vec3(uni(rng), uni(rng), uni(rng)) * (scene.boundsMax - scene.boundsMin);
+        };
+        std::vector<Ray> rays;
+        rays.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const glm::vec3 o = randomPoint();
+            glm::vec3 d = randomPoint() - o;
+            if (glm::dot(d, d) < 1e-12f) d = glm::vec3(0, 1, 0);
+            rays.emplace_back(o, d);
+        }
+        return rays;
+    }
+
+    double traceClosest(const Scene& scene, const simd::Kernels& kernels, const std::vector<Ray>& rays, size_t& hits)
+    {
+        hits = 0;
+        const auto start = Clock::now();
+        for (const Ray& ray : rays)
+        {
+            float tMax = FLT_MAX;
+            simd::LeafHit leafHit;
+            const bool hit = scene.bvh.intersectRanges(ray, tMax, [&](uint32_t first, uint32_t count, float& tBest) {
+                return kernels.intersect(scene.mesh, first, count, ray.origin, ray.direction, tBest, leafHit);
+            });
+            hits += hit ? 1 : 0;
+        }
+        return secondsSince(start);
+    }
+
+    double traceAny(const Scene& scene, const simd::Kernels& kernels, const std::vector<Ray>& rays, size_t& hits)
+    {
+        hits = 0;
+        const auto start = Clock::now();
+        for (const Ray& ray : rays)
+        {
+            const bool hit = scene.bvh.intersectAnyRanges(ray, FLT_MAX, [&](uint32_t first, uint32_t count, float tMax) {
+                return kernels.occluded(scene.mesh, first, count, ray.origin, ray.direction, tMax);
+            });
+            hits += hit ? 1 : 0;
+        }
+        return secondsSince(start);
+    }
+
+    // Primary rays in 2x2 pixel packets (rays are generated row by row)
+    double tracePackets(const Scene& scene, const simd::Kernels& kernels, const std::vector<Ray>& rays, int res, size_t& hits)
+    {
+        constexpr int W = BVHRayPacket::kWidth;
+        hits = 0;
+        const auto start = Clock::now();
+        for (int y = 0; y + 1 < res; y += 2)
+            for (int x = 0; x + 1 < res; x += 2)
+            {
+                const Ray packet[W] = { rays[y * res + x], rays[y * res + x + 1],
+                                        rays[(y + 1) * res + x], rays[(y + 1) * res + x + 1] };
+                float tMax[W] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+                int mask = 0;
+                scene.bvh.intersectPacket(BVHRayPacket(packet), tMax, [&](uint32_t first, uint32_t count, float (&tBest)[W]) {
+                    simd::LeafHit leafHit;
+                    for (int i = 0; i < W; ++i)
+                        if (kernels.intersect(scene.mesh, first, count, packet[i].origin, packet[i].direction, tBest[i], leafHit))
+                            mask |= 1 << i;
+                });
+                for (int i = 0; i < W; ++i) hits += (mask >> i) & 1;
+            }
+        return secondsSince(start);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int res = 512;
+    std::vector<std::string> models;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--res" && i + 1 < argc) res = std::max(16, std::atoi(argv[++i]));
+        else models.push_back(arg);
+    }
+
+    if (models.empty())
+    {
+        const std::string dir = PathUtils::resolveProjectPath("assets/models");
+        if (!dir.empty())
+            for (const auto& entry : std::filesystem::directory_iterator(dir))
+                if (entry.path().extension() == ".obj") models.push_back(entry.path().string());
+    }
+    if (models.empty())
+    {
+        std::cerr << "No models found (pass OBJ paths or run from inside the repository)\n";
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Running BVH benchmark (" << res << "x" << res << " primary rays per model)\n";
+
+    for (const auto& path : models)
+    {
+        Scene scene;
+        if (!loadScene(path, scene))
+        {
+            std::cerr << "Skipping " << path << ": no geometry\n";
+            continue;
+        }
+
+        const double buildSec = buildBVH(scene);
+        const auto primary = makePrimaryRays(scene, res);
+        const auto random = makeRandomRays(scene, primary.size());
+
+        const simd::Kernels& scalar = *simd::kernelsFor(simd::Isa::Scalar);
+        const simd::Kernels& best = simd::kernels();
+        auto mrays = [](size_t n, double s) { return s > 0.0 ? n / s * 1e-6 : 0.0; };
+
+        std::cout << std::filesystem::path(path).filename().string() << "\n"
+                  << "  triangles:        " << scene.mesh.triangleCount() << " ("
+                  << scene.mesh.memoryBytes() / (1024.0 * 1024.0) << " MB)\n"
+                  << "  build:            " << buildSec * 1000.0 << " ms ("
+                  << scene.bvh.nodeCount() << " nodes, " << scene.bvh.memoryBytes() / (1024.0 * 1024.0) << " MB)\n";
+
+        std::vector<const simd::Kernels*> kernelSets = { &scalar };
+        if (&best != &scalar) kernelSets.push_back(&best);
+        for (const simd::Kernels* kernels : kernelSets)
+        {
+            size_t primaryHits = 0, randomHits = 0, occluded = 0;
+            const double primarySec = traceClosest(scene, *kernels, primary, primaryHits);
+            const double randomSec = traceClosest(scene, *kernels, random, randomHits);
+            const double anySec = traceAny(scene, *kernels, random, occluded);
+
+            std::cout << "  [" << simd::isaName(kernels->isa) << "]\n"
+                      << "    primary closest:  " << mrays(primary.size(), primarySec) << " Mrays/s ("
+                      << primaryHits << " hits)\n"
+                      << "    random closest:   " << mrays(random.size(), randomSec) << " Mrays/s ("
+                      << randomHits << " hits)\n"
+                      << "    random any-hit:   " << mrays(random.size(), anySec) << " Mrays/s ("
+                      << occluded << " occluded)\n";
+        }
+
+        size_t packetHits = 0;
+        const double packetSec = tracePackets(scene, best, primary, res, packetHits);
+        std::cout << "  [" << simd::isaName(best.isa) << " + 2x2 packets]\n"
+                  << "    primary closest:  " << mrays(primary.size(), packetSec) << " Mrays/s ("
+                  << packetHits << " hits)\n";
+    }
+    return 0;
+}
@@ -1,5 +1,7 @@
 #include <iostream>
 #include <cassert>
+#include <cmath>
+#include <random>
 #include <glm/glm.hpp>
 #include "../../engine/include/brdf.h"
 
@@ -36,6 +38,66 @@ int main()
         std::cout << "✓ N·V <= 0 returns 0" << std::endl;
     }
 
+    // Case 3: VNDF sampling matches its pdf, and sample weights equal
+    // f·cos/pdf. The estimate of the directional albedo from importance
+    // samples must agree with brute-force uniform hemisphere integration.
+    {
+        const glm::vec3 N(0, 1, 0);
+        const glm::vec3 F0(1.0f);
+        std::mt19937 rng(3u);
+        std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+
+        for (float rough : { 0.3f, 0.6f, 0.9f })
+        {
+            for (float thetaV : { 0.2f, 1.0f, 1.4f })
+            {
+                const glm::vec3 V(std::sin(thetaV), std::cos(thetaV), 0.0f);
+                const float alpha = brdf::roughnessToAlpha(rough);
+
+                const int n = 200000;
+                double importance = 0.0;
+                for (int i = 0; i < n; ++i)
+                {
+                    brdf::GlossySample sample;
+                    if (!brdf::sampleGGXReflection(N, V, F0, rough, uni(rng), uni(rng), sample)) continue;
+                    assert(sample.weight.x <= 1.0f + 1e-4f && "white furnace weight must not exceed 1");
+                    const float pdf = brdf::ggxReflectionPdf(N, V, sample.direction, alpha);
+                    assert(std::abs(pdf - sample.pdf) <= 1e-3f * pdf && "sample pdf must match ggxReflectionPdf");
+                    const float f = brdf::ggxSpecular(N, V, sample.direction, F0, alpha).x;
+                    assert(std::abs(f * glm::dot(N, sample.direction) / pdf - sample.weight.x) <= 1e-3f);
+                    importance += sample.weight.x;
+                }
+                importance /= n;
+
+                double uniform = 0.0, pdfIntegral = 0.0;
+                for (int i = 0; i < n; ++i)
+                {
+                    const float z = uni(rng), phi = 2.0f * 3.14159265f * uni(rng);
+                    const float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+                    const glm::vec3 L(r * std::cos(phi), z, r * std::sin(phi));
+                    uniform += brdf::ggxSpecular(N, V, L, F0, alpha).x * z;
+                    pdfIntegral += brdf::ggxReflectionPdf(N, V, L, alpha);
+                }
+                uniform *= 2.0 * 3.14159265 / n;
+                pdfIntegral *= 2.0 * 3.14159265 / n;
+
+                assert(std::abs(importance - uniform) < 0.02 && "importance and uniform estimates must agree");
+                assert(pdfIntegral < 1.02 && "pdf over the hemisphere integrates to at most 1");
+            }
+        }
+        std::cout << "✓ GGX VNDF sampling is consistent with its pdf" << std::endl;
+    }
+
+    // Case 4: smooth surfaces reflect close to the mirror direction
+    {
+        const glm::vec3 N(0, 1, 0);
+        const glm::vec3 V = glm::normalize(glm::vec3(1, 1, 0));
+        brdf::GlossySample sample;
+        const bool ok = brdf::sampleGGXReflection(N, V, glm::vec3(1.0f), 0.0f, 0.37f, 0.81f, sample);
+        assert(ok && glm::dot(sample.direction, glm::reflect(-V, N)) > 0.999f);
+        std::cout << "✓ Zero roughness samples the mirror direction" << std::endl;
+    }
+
     std::cout << "\n✅ BRDF tests passed!\n";
     return 0;
 }
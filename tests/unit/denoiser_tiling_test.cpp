@@ -0,0 +1,71 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <vector>
+#include "../../engine/include/denoiser.h"
+
+// Every pixel of [0, size) kept exactly once, by a tile of tileSize that
+// gives it `overlap` pixels of context on both sides or reaches the edge
+static void checkLayout(int size, int tileSize, int overlap, int alignment)
+{
+    const std::vector<Denoiser::Span> spans = Denoiser::splitAxis(size, tileSize, overlap, alignment);
+    assert(!spans.empty());
+    const int extent = std::min(size, tileSize);
+    int next = 0;
+    for (size_t i = 0; i < spans.size(); ++i)
+    {
+        const Denoiser::Span& s = spans[i];
+        assert(s.begin == next && s.end > s.begin && "spans tile the axis in order");
+        assert(s.origin >= 0 && s.origin + extent <= size && "tiles stay inside the image");
+        assert(s.origin <= s.begin && s.end <= s.origin + extent);
+        assert((s.begin - s.origin >= overlap || s.origin == 0) && "left context");
+        assert((s.origin + extent - s.end >= overlap || s.origin + extent == size) && "right context");
+        if (i + 1 < spans.size())
+            assert(s.origin % alignment == 0 && "aligned origins");
+        next = s.end;
+    }
+    assert(next == size);
+}
+
+int main()
+{
+    std::cout << "Running denoiser tiling tests...\n";
+
+    // Case 1: frames up to the tile size are a single tile
+    {
+        const std::vector<Denoiser::Span> spans = Denoiser::splitAxis(1920, 2048, 128, 16);
+        assert(spans.size() == 1);
+        assert(spans[0].origin == 0 && spans[0].begin == 0 && spans[0].end == 1920);
+        assert(Denoiser::splitAxis(0, 2048, 128, 16).empty());
+        std::cout << "✓ Small frames are not split" << std::endl;
+    }
+
+    // Case 2: 8K and odd sizes split into overlapping, equally sized tiles
+    {
+        checkLayout(7680, Denoiser::kTileExtent, 128, 16);
+        checkLayout(4320, Denoiser::kTileExtent, 128, 16);
+        checkLayout(8191, Denoiser::kTileExtent, 100, 16);   // overlap rounds up to the alignment
+        checkLayout(2049, Denoiser::kTileExtent, 128, 16);
+        checkLayout(15360, 1024, 96, 32);
+
+        const std::vector<Denoiser::Span> spans = Denoiser::splitAxis(7680, 2048, 128, 16);
+        assert(spans.size() == 5 && "8K needs five 2048 tiles with 128 pixels of overlap");
+        std::cout << "✓ Large frames split into overlapping tiles" << std::endl;
+    }
+
+    // Case 3: tiles too small for the overlap degrade to plain tiling
+    {
+        const std::vector<Denoiser::Span> spans = Denoiser::splitAxis(1000, 200, 128, 16);
+        int covered = 0;
+        for (const Denoiser::Span& s : spans)
+        {
+            assert(s.begin == covered);
+            covered = s.end;
+        }
+        assert(covered == 1000);
+        std::cout << "✓ Degenerate overlap still covers the frame" << std::endl;
+    }
+
+    std::cout << "\n✅ Denoiser tiling tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <filesystem>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "../../engine/include/triangle.h"
+#include "../../engine/include/objloader.h"
+#include "../../engine/include/emissive_lights.h"
+
+using namespace raytracer;
+
+// Unit square [-1,1]^2 in the z = 0 plane, as two triangles
+static void buildQuad(TriangleMesh& mesh)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "glint_emissive_lights_test.obj").string();
+    {
+        std::ofstream obj(path);
+        obj << "v -1 -1 0\nv 1 -1 0\nv 1 1 0\nv -1 1 0\n";
+        obj << "f 1 2 3\nf 1 3 4\n";
+    }
+    ObjLoader loader;
+    loader.load(path.c_str());
+    std::remove(path.c_str());
+    mesh.build(loader);
+}
+
+// Solid angle of a 2a x 2b rectangle seen from distance d along its axis
+static double rectangleSolidAngle(double a, double b, double d)
+{
+    return 4.0 * std::asin(a * b / std::sqrt((a * a + d * d) * (b * b + d * d)));
+}
+
+int main()
+{
+    std::cout << "Running emissive light tests...\n";
+
+    TriangleMesh quad;
+    buildQuad(quad);
+    assert(quad.triangleCount() == 2);
+
+    // Case 1: sampled points cover both emitters with consistent densities:
+    // the mean of 1/pdf is the total solid angle they subtend
+    {
+        EmissiveLights lights;
+        const glm::mat4 below = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -2.0f));
+        const glm::mat4 above = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 3.0f)), glm::vec3(0.5f, 1.5f, 1.0f));
+        lights.setInstance(0, quad, below, glm::vec3(1.0f));
+        lights.setInstance(1, quad, above, glm::vec3(4.0f, 2.0f, 1.0f));
+        lights.refresh();
+        assert(lights.emitterCount() == 2 && lights.triangleCount() == 4);
+
+        std::mt19937 rng(5u);
+        std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+        const int n = 400000;
+        double solidAngle = 0.0;
+        for (int i = 0; i < n; ++i)
+        {
+            const float u[4] = { uni(rng), uni(rng), uni(rng), uni(rng) };
+            EmissiveSample sample;
+            assert(lights.sample(glm::vec3(0.0f), u, sample));
+            const uint32_t instance = sample.point.z < 0.0f ? 0u : 1u;
+            const float pdf = lights.pdf(instance, glm::vec3(0.0f), sample.point, glm::vec3(0.0f, 0.0f, 1.0f));
+            assert(std::abs(pdf - sample.pdf) <= 1e-4f * sample.pdf && "pdf() must match sample()");
+            assert(sample.radiance == lights.radiance(instance));
+            solidAngle += 1.0 / sample.pdf;
+        }
+        solidAngle /= n;
+        const double exact = rectangleSolidAngle(1.0, 1.0, 2.0) + rectangleSolidAngle(0.5, 1.5, 3.0);
+        assert(std::abs(solidAngle - exact) < 0.01 * exact && "emissive sampling must be unbiased");
+        std::cout << "✓ Area sampling densities are consistent" << std::endl;
+    }
+
+    // Case 2: material and transform changes update one emitter in place
+    {
+        EmissiveLights lights;
+        const glm::mat4 identity(1.0f);
+        lights.setRadiance(0, quad, identity, glm::vec3(0.0f));
+        lights.setInstance(1, quad, identity, glm::vec3(1.0f));
+        lights.setRadiance(2, quad, glm::translate(identity, glm::vec3(5.0f, 0.0f, 0.0f)), glm::vec3(2.0f));
+        lights.refresh();
+        assert(lights.emitterCount() == 2 && lights.radiance(0) == glm::vec3(0.0f));
+
+        lights.setRadiance(2, quad, identity, glm::vec3(3.0f));
+        lights.refresh();
+        assert(lights.radiance(2) == glm::vec3(3.0f));
+        EmissiveSample sample;
+        for (int i = 0; i < 16; ++i)
+        {
+            const float u[4] = { (i + 0.5f) / 16.0f, 0.5f, 0.5f, 0.5f };
+            assert(lights.sample(glm::vec3(5.0f, 0.0f, 1.0f), u, sample));
+            if (sample.radiance == glm::vec3(3.0f))
+                assert(sample.point.x > 3.0f && "a material change keeps the emitter's triangles");
+        }
+
+        // Removing an emitter keeps the others addressable
+        lights.setRadiance(1, quad, identity, glm::vec3(0.0f));
+        lights.refresh();
+        assert(lights.emitterCount() == 1 && lights.radiance(1) == glm::vec3(0.0f));
+        assert(lights.radiance(2) == glm::vec3(3.0f));
+        assert(lights.pdf(1, glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f)) == 0.0f);
+
+        lights.setRadiance(2, quad, identity, glm::vec3(0.0f));
+        lights.refresh();
+        const float u[4] = { 0.5f, 0.5f, 0.5f, 0.5f };
+        assert(lights.empty() && !lights.sample(glm::vec3(0.0f), u, sample));
+        std::cout << "✓ Incremental emitter updates" << std::endl;
+    }
+
+    std::cout << "\n✅ Emissive light tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../../engine/include/environment_map.h"
+
+static const float PI = 3.14159265358979323846f;
+
+// Dim sky with a small bright sun, RGB rows bottom to top
+static std::vector<float> skyWithSun(int width, int height, const glm::vec3& sun)
+{
+    std::vector<float> pixels(static_cast<size_t>(width) * height * 3);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+        {
+            const float latitude = ((y + 0.5f) / height - 0.5f) * PI;
+            const float phi = ((x + 0.5f) / width - 0.5f) * 2.0f * PI;
+            const glm::vec3 d(std::cos(latitude) * std::cos(phi), std::sin(latitude), std::cos(latitude) * std::sin(phi));
+            const glm::vec3 c = glm::dot(d, sun) > 0.998f ? glm::vec3(200.0f, 180.0f, 160.0f)
+                                                           : glm::vec3(0.2f, 0.3f, 0.5f) * (1.2f + d.y);
+            float* p = &pixels[(static_cast<size_t>(y) * width + x) * 3];
+            p[0] = c.r; p[1] = c.g; p[2] = c.b;
+        }
+    return pixels;
+}
+
+int main()
+{
+    std::cout << "Running environment map tests...\n";
+
+    const int width = 256, height = 128;
+    const glm::vec3 sun = glm::normalize(glm::vec3(0.3f, 0.8f, -0.5f));
+    const std::vector<float> pixels = skyWithSun(width, height, sun);
+    const EnvironmentMap env(width, height, 3, pixels.data());
+
+    // Case 1: orientation follows the equirect shader and the pyramid ends
+    // in one texel holding the average
+    {
+        assert(env.levelCount() == 9);
+        assert(glm::length(env.eval(sun)) > 100.0f && "the sun must be where the shader puts it");
+        assert(glm::length(env.eval(-sun)) < 1.0f);
+
+        glm::dvec3 average(0.0);
+        for (const glm::vec3& t : env.texels()) average += glm::dvec3(t);
+        average /= double(env.texels().size());
+        const glm::vec3 top = env.eval(glm::vec3(0.0f, 1.0f, 0.0f), float(env.levelCount() - 1));
+        assert(glm::length(glm::dvec3(top) - average) < 1e-3 * glm::length(average));
+
+        assert(env.lodForSolidAngle(1e-6f) == 0.0f);
+        assert(std::abs(env.lodForSolidAngle(4.0f * 4.0f * PI / (width * height)) - 1.0f) < 1e-4f);
+        std::cout << "✓ Orientation and MIP pyramid" << std::endl;
+    }
+
+    // Case 2: sampling is consistent with pdf() and unbiased: the mean of
+    // 1/pdf is the full sphere and the mean of L/pdf the total radiance
+    {
+        glm::dvec3 reference(0.0);
+        const int grid = 1024;
+        for (int y = 0; y < grid / 2; ++y)
+            for (int x = 0; x < grid; ++x)
+            {
+                const float latitude = ((y + 0.5f) / (grid / 2) - 0.5f) * PI;
+                const float phi = ((x + 0.5f) / grid - 0.5f) * 2.0f * PI;
+                const glm::vec3 d(std::cos(latitude) * std::cos(phi), std::sin(latitude), std::cos(latitude) * std::sin(phi));
+                const double dOmega = (2.0 * PI / grid) * (PI / (grid / 2)) * std::cos(latitude);
+                reference += glm::dvec3(env.eval(d)) * dOmega;
+            }
+
+        std::mt19937 rng(3u);
+        std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+        const int n = 400000;
+        double sphere = 0.0;
+        glm::dvec3 estimate(0.0);
+        int sunHits = 0, mismatches = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            glm::vec3 dir;
+            float pdf;
+            assert(env.sample(uni(rng), uni(rng), dir, pdf));
+            assert(std::abs(glm::length(dir) - 1.0f) < 1e-4f);
+            // Round trips through atan2/asin may land in the neighbouring
+            // texel right at a cell edge
+            if (std::abs(env.pdf(dir) - pdf) > 1e-3f * pdf) ++mismatches;
+            sphere += 1.0 / pdf;
+            estimate += glm::dvec3(env.eval(dir)) / double(pdf);
+            if (glm::dot(dir, sun) > 0.99f) ++sunHits;
+        }
+        sphere /= n;
+        estimate /= double(n);
+        assert(std::abs(sphere - 4.0 * PI) < 0.02 * 4.0 * PI);
+        assert(glm::length(estimate - reference) < 0.02 * glm::length(reference) && "environment sampling must be unbiased");
+        assert(mismatches < n / 1000 && "pdf() must match sample()");
+        assert(sunHits > n / 4 && "samples must concentrate on the sun");
+        std::cout << "✓ Importance sampling is consistent" << std::endl;
+    }
+
+    std::cout << "\n✅ Environment map tests passed!\n";
+    return 0;
+}
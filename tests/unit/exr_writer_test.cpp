@@ -0,0 +1,130 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../../engine/include/image_io.h"
+#include "tinyexr.h"
+
+// Build with EXR_ENABLED and miniz, like the engine: image_io.cpp carries
+// the TinyEXR implementation
+
+struct LoadedExr {
+    EXRHeader header;
+    EXRImage image;
+    int channel(const char* name) const {
+        for (int c = 0; c < header.num_channels; ++c)
+            if (std::strcmp(header.channels[c].name, name) == 0) return c;
+        return -1;
+    }
+};
+
+static bool loadExr(const std::string& path, LoadedExr& out) {
+    EXRVersion version;
+    if (ParseEXRVersionFromFile(&version, path.c_str()) != TINYEXR_SUCCESS) return false;
+    InitEXRHeader(&out.header);
+    const char* err = nullptr;
+    if (ParseEXRHeaderFromFile(&out.header, &version, path.c_str(), &err) != TINYEXR_SUCCESS) return false;
+    // Keep half channels as stored so their precision can be checked
+    InitEXRImage(&out.image);
+    return LoadEXRImageFromFile(&out.image, &out.header, path.c_str(), &err) == TINYEXR_SUCCESS;
+}
+
+int main()
+{
+    std::cout << "Running EXR writer tests...\n";
+
+    const int width = 7, height = 5;
+    // Interleaved buffers with GL row order: row 0 is the bottom of the image
+    std::vector<glm::vec3> color(width * height);
+    std::vector<float> depth(width * height);
+    std::vector<uint32_t> ids(width * height);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+        {
+            const int i = y * width + x;
+            color[i] = glm::vec3(x * 0.5f, y * 4.0f, 100.0f + i);   // HDR values above 1
+            depth[i] = (x == 0) ? std::numeric_limits<float>::infinity() : 1.0f + 0.001f * i;
+            ids[i] = static_cast<uint32_t>(i * 1000 + 7);
+        }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "glint_exr_writer_test.exr").string();
+
+    // Case 1: channels of interleaved buffers round-trip with their types,
+    // in name order, with the rows flipped during the write
+    {
+        std::vector<ImageIO::ExrChannel> channels = {
+            { "Z", depth.data(), 1, ImageIO::ExrPixelType::Float },
+            { "R", &color[0].x, 3, ImageIO::ExrPixelType::Half },
+            { "G", &color[0].y, 3, ImageIO::ExrPixelType::Half },
+            { "B", &color[0].z, 3, ImageIO::ExrPixelType::Float },
+            { "id", ids.data(), 1, ImageIO::ExrPixelType::Uint },
+        };
+        assert(ImageIO::SaveImageEXR(path, width, height, channels, /*flipY=*/true));
+
+        LoadedExr exr;
+        assert(loadExr(path, exr));
+        assert(exr.image.width == width && exr.image.height == height);
+        assert(exr.header.num_channels == 5);
+        for (int c = 1; c < exr.header.num_channels; ++c)
+            assert(std::strcmp(exr.header.channels[c - 1].name, exr.header.channels[c].name) < 0 && "sorted channels");
+
+        const int r = exr.channel("R"), b = exr.channel("B"), z = exr.channel("Z"), id = exr.channel("id");
+        assert(r >= 0 && b >= 0 && z >= 0 && id >= 0);
+        assert(exr.header.pixel_types[r] == TINYEXR_PIXELTYPE_HALF);
+        assert(exr.header.pixel_types[b] == TINYEXR_PIXELTYPE_FLOAT);
+        assert(exr.header.pixel_types[id] == TINYEXR_PIXELTYPE_UINT);
+
+        const float* blue = reinterpret_cast<const float*>(exr.image.images[b]);
+        const float* zs = reinterpret_cast<const float*>(exr.image.images[z]);
+        const uint32_t* idPlane = reinterpret_cast<const uint32_t*>(exr.image.images[id]);
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+            {
+                const int src = (height - 1 - y) * width + x;   // file row 0 is the top
+                const int dst = y * width + x;
+                assert(blue[dst] == color[src].z);
+                assert(zs[dst] == depth[src]);
+                assert(idPlane[dst] == ids[src]);
+            }
+        FreeEXRImage(&exr.image);
+        FreeEXRHeader(&exr.header);
+        std::cout << "✓ Channels round-trip in name order with rows flipped" << std::endl;
+    }
+
+    // Case 2: half channels keep HDR values to half precision
+    {
+        float* rgba = nullptr;
+        int w = 0, h = 0;
+        const char* err = nullptr;
+        assert(LoadEXR(&rgba, &w, &h, path.c_str(), &err) == TINYEXR_SUCCESS);
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x)
+            {
+                const glm::vec3& expected = color[(height - 1 - y) * width + x];
+                const float* p = rgba + 4 * (y * w + x);
+                assert(std::abs(p[0] - expected.x) <= 1e-3f * std::max(1.0f, expected.x));
+                assert(std::abs(p[1] - expected.y) <= 1e-3f * std::max(1.0f, expected.y));
+            }
+        std::free(rgba);
+        std::cout << "✓ Half channels keep HDR values" << std::endl;
+    }
+
+    // Case 3: malformed channel lists are rejected
+    {
+        assert(!ImageIO::SaveImageEXR(path, width, height, {}));
+        assert(!ImageIO::SaveImageEXR(path, width, height, { { "R", nullptr, 1, ImageIO::ExrPixelType::Half } }));
+        assert(!ImageIO::SaveImageEXR(path, 0, height, { { "R", depth.data(), 1, ImageIO::ExrPixelType::Half } }));
+        std::cout << "✓ Invalid requests fail" << std::endl;
+    }
+
+    std::remove(path.c_str());
+    std::cout << "\n✅ EXR writer tests passed!\n";
+    return 0;
+}
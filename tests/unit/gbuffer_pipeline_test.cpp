@@ -0,0 +1,103 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include "../../engine/include/rhi/rhi_null.h"
+#include "../../engine/include/managers/pipeline_manager.h"
+#include "../../engine/include/managers/scene_manager.h"
+
+// Null backend that keeps every pipeline description it is given
+class RecordingRhi : public RhiNull {
+public:
+    PipelineHandle createPipeline(const PipelineDesc& desc) override
+    {
+        const PipelineHandle handle = RhiNull::createPipeline(desc);
+        pipelines.push_back(desc);
+        return handle;
+    }
+    std::vector<PipelineDesc> pipelines;
+};
+
+// RhiGL::setupVertexArray only enables an attribute whose binding exists and
+// has a buffer; any other attribute reads nothing and the draw rasterizes nothing
+static const VertexBinding* bindingFor(const PipelineDesc& pd, uint32_t location)
+{
+    for (const VertexAttribute& a : pd.vertexAttributes) {
+        if (a.location != location) continue;
+        for (const VertexBinding& b : pd.vertexBindings)
+            if (b.binding == a.binding && b.buffer != INVALID_HANDLE) return &b;
+    }
+    return nullptr;
+}
+
+static const VertexAttribute* attributeAt(const PipelineDesc& pd, uint32_t location)
+{
+    for (const VertexAttribute& a : pd.vertexAttributes)
+        if (a.location == location) return &a;
+    return nullptr;
+}
+
+int main()
+{
+    std::cout << "Running G-buffer pipeline tests...\n";
+
+    RecordingRhi rhi;
+    PipelineManager pipelines;
+    assert(pipelines.init(&rhi));
+    const ShaderHandle gBufferShader = rhi.createShader(ShaderDesc{});
+
+    SceneObject obj;
+    obj.name = "cube";
+    obj.rhiVboPositions = rhi.createBuffer(BufferDesc{});
+    obj.rhiVboNormals = rhi.createBuffer(BufferDesc{});
+    obj.rhiVboTexCoords = rhi.createBuffer(BufferDesc{});
+    obj.rhiEbo = rhi.createBuffer(BufferDesc{});
+
+    // Case 1: every input of gbuffer.vert the mesh provides reads its own stream
+    {
+        rhi.pipelines.clear();
+        const PipelineHandle p = pipelines.createGBufferPipeline(obj, gBufferShader);
+        assert(p != INVALID_HANDLE && rhi.pipelines.size() == 1);
+        const PipelineDesc& pd = rhi.pipelines.back();
+        assert(pd.shader == gBufferShader && pd.depthTestEnable && pd.depthWriteEnable);
+        assert(bindingFor(pd, 0) && bindingFor(pd, 0)->buffer == obj.rhiVboPositions && bindingFor(pd, 0)->stride == 8);
+        assert(bindingFor(pd, 1) && bindingFor(pd, 1)->buffer == obj.rhiVboNormals && bindingFor(pd, 1)->stride == 4);
+        assert(attributeAt(pd, 0)->format == TextureFormat::RGBA16Unorm && attributeAt(pd, 1)->format == TextureFormat::RG16Snorm);
+        assert(bindingFor(pd, 2) && bindingFor(pd, 2)->buffer == obj.rhiVboTexCoords && bindingFor(pd, 2)->stride == 8);
+        assert(attributeAt(pd, 2)->format == TextureFormat::RG32F);
+        assert(pd.indexBuffer == obj.rhiEbo);
+        for (const VertexAttribute& a : pd.vertexAttributes) assert(bindingFor(pd, a.location));
+        std::cout << "✓ G-buffer pipeline binds quantized positions, normals and UVs" << std::endl;
+    }
+
+    // Case 2: half-precision UVs keep their compact stride and format
+    {
+        SceneObject half = obj;
+        half.rhiHalfTexCoords = true;
+        rhi.pipelines.clear();
+        assert(pipelines.createGBufferPipeline(half, gBufferShader) != INVALID_HANDLE);
+        const PipelineDesc& pd = rhi.pipelines.back();
+        assert(bindingFor(pd, 2)->stride == 4 && attributeAt(pd, 2)->format == TextureFormat::RG16F);
+        std::cout << "✓ Half-precision UVs" << std::endl;
+    }
+
+    // Case 3: meshes without normals or UVs bind only what they have; no
+    // pipeline without positions or a shader
+    {
+        SceneObject bare;
+        bare.name = "bare";
+        bare.rhiVboPositions = obj.rhiVboPositions;
+        rhi.pipelines.clear();
+        assert(pipelines.createGBufferPipeline(bare, gBufferShader) != INVALID_HANDLE);
+        const PipelineDesc& pd = rhi.pipelines.back();
+        assert(pd.vertexAttributes.size() == 1 && bindingFor(pd, 0));
+        assert(pd.indexBuffer == INVALID_HANDLE);
+
+        assert(pipelines.createGBufferPipeline(SceneObject{}, gBufferShader) == INVALID_HANDLE);
+        assert(pipelines.createGBufferPipeline(obj, INVALID_HANDLE) == INVALID_HANDLE);
+        std::cout << "✓ Optional streams" << std::endl;
+    }
+
+    pipelines.shutdown();
+    std::cout << "\n✅ G-buffer pipeline tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <vector>
+#include "../../engine/include/rhi/rhi_null.h"
+#include "../../engine/include/instance_batcher.h"
+#include "../../engine/include/managers/pipeline_manager.h"
+#include "../../engine/include/managers/scene_manager.h"
+
+// Null backend that keeps draws and transform uploads
+class RecordingRhi : public RhiNull {
+public:
+    void draw(const DrawDesc& desc) override { RhiNull::draw(desc); draws.push_back(desc); }
+    void updateBuffer(BufferHandle buffer, const void* data, size_t size, size_t offset = 0) override
+    {
+        (void)data;
+        uploads.push_back({ buffer, size, offset });
+    }
+    void destroyPipeline(PipelineHandle) override { ++destroyedPipelines; }
+
+    struct Upload { BufferHandle buffer; size_t size, offset; };
+    std::vector<DrawDesc> draws;
+    std::vector<Upload> uploads;
+    int destroyedPipelines = 0;
+};
+
+static std::vector<SceneObject> duplicates(const std::shared_ptr<MeshBuffers>& mesh, int count)
+{
+    std::vector<SceneObject> objects(count);
+    for (int i = 0; i < count; ++i) {
+        SceneObject& o = objects[i];
+        o.name = "copy" + std::to_string(i);
+        o.meshBuffers = mesh;
+        o.rhiVboPositions = mesh->positions;
+        o.rhiEbo = mesh->indices;
+        o.modelMatrix[3] = glm::vec4(float(i), 0.0f, 0.0f, 1.0f);
+    }
+    return objects;
+}
+
+static std::vector<SceneObject*> pointers(std::vector<SceneObject>& objects)
+{
+    std::vector<SceneObject*> out;
+    for (SceneObject& o : objects) out.push_back(&o);
+    return out;
+}
+
+int main()
+{
+    std::cout << "Running instance batcher tests...\n";
+
+    RecordingRhi rhi;
+    PipelineManager pipelines;
+    assert(pipelines.init(&rhi));
+    InstanceBatcher batcher;
+    batcher.init(&rhi, &pipelines);
+
+    auto mesh = std::make_shared<MeshBuffers>();
+    mesh->positions = rhi.createBuffer(BufferDesc{});
+    mesh->indices = rhi.createBuffer(BufferDesc{});
+    int prepared = 0;
+    auto prepare = [&](const SceneObject&, DrawDesc& d) { ++prepared; d.indexBuffer = mesh->indices; d.indexCount = 36; };
+
+    // Case 1: N duplicates of one mesh are one draw of N instances
+    {
+        const int n = 7;
+        std::vector<SceneObject> objects = duplicates(mesh, n);
+        const auto batches = InstanceBatcher::group(pointers(objects));
+        assert(batches.size() == 1 && batches[0].size() == size_t(n));
+
+        rhi.beginFrame();
+        batcher.beginFrame();
+        assert(batcher.draw(batches[0], prepare));
+        batcher.endFrame();
+        assert(rhi.getDrawCallCount() == 1 && rhi.getInstanceCount() == uint32_t(n) && prepared == 1);
+        assert(rhi.draws.back().instanceCount == uint32_t(n) && rhi.draws.back().indexCount == 36);
+        assert(rhi.uploads.back().size == n * sizeof(glm::mat4));
+        std::cout << "✓ " << n << " duplicates in one instanced draw" << std::endl;
+    }
+
+    // Case 2: a different material, a different LOD level or an unshared
+    // mesh starts a batch of its own; order of first appearance is kept
+    {
+        std::vector<SceneObject> objects = duplicates(mesh, 6);
+        objects[1].materialCore.baseColor = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+        objects[2].lodLevel = 1;
+        objects[4].lodLevel = 1;
+        objects[5].meshBuffers.reset();
+        const auto batches = InstanceBatcher::group(pointers(objects));
+        assert(batches.size() == 4);
+        assert(batches[0].size() == 2 && batches[0][0] == &objects[0] && batches[0][1] == &objects[3]);
+        assert(batches[1].size() == 1 && batches[1][0] == &objects[1]);
+        assert(batches[2].size() == 2 && batches[2][0] == &objects[2] && batches[2][1] == &objects[4]);
+        assert(batches[3].size() == 1 && batches[3][0] == &objects[5]);
+
+        std::vector<SceneObject> textured = duplicates(mesh, 2);
+        textured[1].materialCore.baseColorTex = "albedo.png";
+        assert(InstanceBatcher::group(pointers(textured)).size() == 2);
+        std::cout << "✓ Material and LOD split batches" << std::endl;
+    }
+
+    // Case 3: batches in one frame write disjoint regions of the ring and
+    // draw from them; a frame that would not fit three times grows the ring
+    {
+        std::vector<SceneObject> objects = duplicates(mesh, 5);
+        objects[3].lodLevel = objects[4].lodLevel = 1;
+        const auto batches = InstanceBatcher::group(pointers(objects));
+        assert(batches.size() == 2);
+
+        rhi.draws.clear();
+        rhi.uploads.clear();
+        batcher.beginFrame();
+        for (const auto& batch : batches) assert(batcher.draw(batch, prepare));
+        batcher.endFrame();
+        assert(rhi.draws.size() == 2 && rhi.uploads.size() == 2);
+        assert(rhi.uploads[0].buffer == rhi.uploads[1].buffer);
+        for (size_t i = 0; i < 2; ++i)
+            assert(rhi.uploads[i].offset == rhi.draws[i].firstInstance * sizeof(glm::mat4));
+        assert(rhi.uploads[0].offset + rhi.uploads[0].size <= rhi.uploads[1].offset);
+
+        const size_t capacity = batcher.capacity();
+        std::vector<SceneObject> crowd = duplicates(mesh, int(capacity / 2));
+        const auto crowdBatches = InstanceBatcher::group(pointers(crowd));
+        batcher.beginFrame();
+        assert(batcher.draw(crowdBatches[0], prepare));
+        batcher.endFrame();
+        batcher.beginFrame();
+        assert(batcher.capacity() >= crowd.size() * InstanceBatcher::kFramesInFlight);
+        assert(batcher.draw(crowdBatches[0], prepare));
+        batcher.endFrame();
+        std::cout << "✓ Per-batch ring regions" << std::endl;
+    }
+
+    // Case 4: pipelines of meshes that are gone are released
+    {
+        const int before = rhi.destroyedPipelines;
+        mesh.reset();
+        batcher.beginFrame();
+        batcher.endFrame();
+        assert(rhi.destroyedPipelines == before + 1);
+        std::cout << "✓ Pipelines released with their mesh" << std::endl;
+    }
+
+    batcher.shutdown();
+    pipelines.shutdown();
+    std::cout << "\n✅ Instance batcher tests passed!\n";
+    return 0;
+}
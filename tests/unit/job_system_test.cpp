@@ -0,0 +1,77 @@
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "../../engine/include/job_system.h"
+#include "../../engine/include/thread_pool.h"
+
+int main()
+{
+    std::cout << "Running job system tests...\n";
+
+    // Case 1: every job runs once and hands back its result
+    {
+        JobSystem jobs(3);
+        assert(jobs.threadCount() == 3);
+        std::vector<std::future<int>> results;
+        for (int i = 0; i < 200; ++i)
+            results.push_back(jobs.submit([i]() { return i * i; }));
+        for (int i = 0; i < 200; ++i)
+            assert(results[i].get() == i * i);
+        std::cout << "✓ Results delivered through futures" << std::endl;
+    }
+
+    // Case 2: submit returns at once and jobs overlap each other. Each job
+    // waits until both have started, which only happens if they run together.
+    {
+        JobSystem jobs(2);
+        std::atomic<int> started{ 0 };
+        auto job = [&]() {
+            ++started;
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (started.load() < 2 && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+            return started.load() == 2;
+        };
+        auto a = jobs.submit(job);
+        auto b = jobs.submit(job);
+        assert(a.get() && b.get() && "jobs must run concurrently");
+        std::cout << "✓ Jobs run concurrently" << std::endl;
+    }
+
+    // Case 3: exceptions reach the waiter, and jobs may use ThreadPool
+    {
+        JobSystem jobs(2);
+        auto failing = jobs.submit([]() -> int { throw std::runtime_error("bad asset"); });
+        bool caught = false;
+        try { failing.get(); } catch (const std::runtime_error&) { caught = true; }
+        assert(caught);
+
+        auto nested = jobs.submit([]() {
+            std::atomic<int> sum{ 0 };
+            ThreadPool::shared().run(100, [&](uint32_t task, unsigned) { sum += int(task); });
+            return sum.load();
+        });
+        assert(nested.get() == 4950);
+        std::cout << "✓ Exceptions propagate and jobs can fan out" << std::endl;
+    }
+
+    // Case 4: queued jobs still complete when the system shuts down
+    {
+        std::atomic<int> done{ 0 };
+        {
+            JobSystem jobs(1);
+            for (int i = 0; i < 20; ++i)
+                jobs.submit([&]() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); ++done; });
+        }
+        assert(done.load() == 20);
+        std::cout << "✓ Shutdown drains the queue" << std::endl;
+    }
+
+    std::cout << "\n✅ Job system tests passed!\n";
+    return 0;
+}
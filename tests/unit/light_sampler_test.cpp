@@ -0,0 +1,146 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../../engine/include/light_sampler.h"
+
+using namespace raytracer;
+
+// What a light actually delivers to (p, n), up to the BRDF: zero below the
+// surface and outside spot cones, attenuated by distance otherwise
+static float contribution(const LightSource& light, const glm::vec3& p, const glm::vec3& n)
+{
+    const glm::vec3 toLight = light.position - p;
+    const float d = glm::length(toLight);
+    const glm::vec3 l = toLight / d;
+    if (glm::dot(l, n) <= 0.0f) return 0.0f;
+    if (light.type == LightType::SPOT &&
+        glm::dot(-l, glm::normalize(light.direction)) <= std::cos(glm::radians(light.outerConeDeg)))
+        return 0.0f;
+    const float lum = 0.2126f * light.color.r + 0.7152f * light.color.g + 0.0722f * light.color.b;
+    return light.intensity * lum * distanceAttenuation(d) * glm::dot(l, n);
+}
+
+int main()
+{
+    std::cout << "Running light sampler tests...\n";
+
+    // Case 1: alias table reproduces its weights and never picks zero weights
+    {
+        AliasTable table;
+        table.build({ 1.0f, 0.0f, 3.0f, 6.0f });
+        const int n = 100000;
+        std::vector<int> counts(4, 0);
+        for (int i = 0; i < n; ++i)
+        {
+            float pmf;
+            const uint32_t index = table.sample((i + 0.5f) / n, pmf);
+            assert(std::abs(pmf - table.pmf(index)) < 1e-7f);
+            ++counts[index];
+        }
+        assert(counts[1] == 0 && "zero-weight entries must never be sampled");
+        assert(std::abs(counts[0] / double(n) - 0.1) < 1e-3);
+        assert(std::abs(counts[2] / double(n) - 0.3) < 1e-3);
+        assert(std::abs(counts[3] / double(n) - 0.6) < 1e-3);
+
+        AliasTable empty;
+        empty.build({ 0.0f, 0.0f });
+        assert(empty.empty());
+        std::cout << "✓ Alias table matches its weights" << std::endl;
+    }
+
+    // Case 2: BVH and power selection are unbiased: the weighted sum over
+    // many picks matches the exact sum over all lights
+    {
+        std::mt19937 rng(11u);
+        std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+        Light lights;
+        for (int i = 0; i < 120; ++i)
+        {
+            const glm::vec3 pos(uni(rng) * 40.0f - 20.0f, 2.0f + uni(rng) * 4.0f, uni(rng) * 40.0f - 20.0f);
+            const glm::vec3 color(uni(rng), uni(rng), uni(rng));
+            if (i % 3 == 0)
+                lights.addSpotLight(pos, glm::vec3(uni(rng) - 0.5f, -1.0f, uni(rng) - 0.5f), color, 1.0f + uni(rng), 10.0f, 20.0f + 30.0f * uni(rng));
+            else
+                lights.addLight(pos, color, 0.5f + uni(rng));
+        }
+
+        for (LightSampling mode : { LightSampling::BVH, LightSampling::Power })
+        {
+            LightSampler sampler;
+            sampler.build(lights, mode, 2);
+            assert(sampler.mode() == mode);
+
+            for (int q = 0; q < 8; ++q)
+            {
+                const glm::vec3 p(uni(rng) * 30.0f - 15.0f, 0.0f, uni(rng) * 30.0f - 15.0f);
+                const glm::vec3 n = glm::normalize(glm::vec3(uni(rng) - 0.5f, 1.0f, uni(rng) - 0.5f));
+
+                double exact = 0.0;
+                for (const auto& light : lights.m_lights) exact += contribution(light, p, n);
+
+                const int picks = 200000;
+                double estimate = 0.0;
+                for (int i = 0; i < picks; ++i)
+                {
+                    const float u[4] = { (i + 0.5f) / picks, uni(rng), 0.0f, 0.0f };
+                    LightSelection selection;
+                    sampler.select(p, n, u, selection);
+                    assert(!selection.all && selection.count <= 2);
+                    for (int k = 0; k < selection.count; ++k)
+                        estimate += selection.weight[k] * contribution(lights.m_lights[selection.index[k]], p, n);
+                }
+                estimate /= picks;
+                assert(std::abs(estimate - exact) <= 0.01 * exact && "light selection must be unbiased");
+            }
+        }
+        std::cout << "✓ BVH and power selection are unbiased" << std::endl;
+    }
+
+    // Case 3: the BVH never picks lights that cannot reach the point
+    {
+        Light lights;
+        for (int i = 0; i < 16; ++i)
+            lights.addSpotLight(glm::vec3(float(i), 3.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f), 1.0f, 10.0f, 20.0f);
+        lights.addLight(glm::vec3(5.0f, 3.0f, 5.0f), glm::vec3(1.0f), 1.0f);
+
+        LightSampler sampler;
+        sampler.build(lights, LightSampling::BVH, 1);
+        for (int i = 0; i < 1000; ++i)
+        {
+            const float u[4] = { (i + 0.5f) / 1000.0f, 0.0f, 0.0f, 0.0f };
+            LightSelection selection;
+            sampler.select(glm::vec3(4.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f), u, selection);
+            assert(selection.count == 1 && selection.index[0] == 16 && "upward spots cannot light the floor");
+            assert(std::abs(selection.weight[0] - 1.0f) < 1e-5f);
+        }
+        std::cout << "✓ Unreachable lights are culled" << std::endl;
+    }
+
+    // Case 4: small rigs evaluate every light; directional lights stay fixed
+    {
+        Light lights;
+        for (int i = 0; i < LightSampler::kExhaustiveLightLimit; ++i)
+            lights.addLight(glm::vec3(float(i), 2.0f, 0.0f), glm::vec3(1.0f), 1.0f);
+        LightSampler sampler;
+        sampler.build(lights, LightSampling::Auto, 1);
+        assert(sampler.mode() == LightSampling::All);
+
+        lights.addLight(glm::vec3(0.0f, 2.0f, 3.0f), glm::vec3(1.0f), 1.0f);
+        lights.addDirectionalLight(glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(1.0f), 1.0f);
+        sampler.build(lights, LightSampling::Auto, 1);
+        assert(sampler.mode() == LightSampling::BVH);
+
+        const float u[4] = { 0.5f, 0.5f, 0.5f, 0.5f };
+        LightSelection selection;
+        sampler.select(glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), u, selection);
+        assert(!selection.all && selection.fixed && selection.fixed->size() == 1);
+        assert((*selection.fixed)[0] == lights.m_lights.size() - 1);
+        std::cout << "✓ Auto mode and directional lights" << std::endl;
+    }
+
+    std::cout << "\n✅ Light sampler tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../../engine/include/mesh_cache.h"
+#include "../../engine/include/bvh_node.h"
+#include "../../engine/include/objloader.h"
+
+namespace fs = std::filesystem;
+
+// Byte offset of the last copy of an array in a file image
+template <typename T>
+static size_t findArray(const std::vector<char>& bytes, const T* a, size_t n)
+{
+    const char* p = reinterpret_cast<const char*>(a);
+    const auto it = std::find_end(bytes.begin(), bytes.end(), p, p + n * sizeof(T));
+    assert(it != bytes.end());
+    return static_cast<size_t>(it - bytes.begin());
+}
+
+template <typename T>
+static bool sameArray(const T* a, const T* b, size_t n)
+{
+    if (!a || !b) return a == b;
+    return std::memcmp(a, b, n * sizeof(T)) == 0;
+}
+
+int main()
+{
+    std::cout << "Running mesh cache tests...\n";
+
+    const fs::path dir = fs::temp_directory_path() / "glint_mesh_cache_test";
+    fs::remove_all(dir);
+    MeshCache::setDirectory((dir / "cache").string());
+    fs::create_directories(dir);
+
+    // A textured grid, so normals and tangents are derived at load
+    const std::string source = (dir / "grid.obj").string();
+    {
+        std::ostringstream text;
+        const int grid = 12;
+        for (int y = 0; y <= grid; ++y)
+            for (int x = 0; x <= grid; ++x)
+            {
+                text << "v " << x * 0.5f << ' ' << ((x * 5 + y * 3) % 4) * 0.1f << ' ' << y * 0.5f << '\n';
+                text << "vt " << x / float(grid) << ' ' << y / float(grid) << '\n';
+            }
+        for (int y = 0; y < grid; ++y)
+            for (int x = 0; x < grid; ++x)
+            {
+                const int i = y * (grid + 1) + x + 1;
+                text << "f " << i << '/' << i << ' ' << i + grid + 1 << '/' << i + grid + 1 << ' '
+                     << i + grid + 2 << '/' << i + grid + 2 << ' ' << i + 1 << '/' << i + 1 << '\n';
+            }
+        std::ofstream(source, std::ios::binary) << text.str();
+    }
+
+    ObjLoader loaded;
+    loaded.load(source.c_str());
+    const MeshArrays mesh = loaded.arrays();
+    assert(mesh.vertexCount > 0 && mesh.normals && mesh.texcoords && mesh.tangents);
+    BVH bvh;
+    bvh.buildTriangles(mesh.positions, mesh.indices, mesh.indexCount / 3);
+    // Sibling pairs start at even indices of a 64-byte aligned array
+    assert(reinterpret_cast<uintptr_t>(bvh.nodes().data()) % 64 == 0 && bvh.nodes()[0].leftFirst % 2 == 0);
+
+    // Case 1: a stored mesh maps back unchanged, with 64-byte aligned arrays
+    {
+        MeshCache::View view;
+        assert(!MeshCache::open(source, view) && "nothing cached yet");
+        assert(MeshCache::store(source, mesh, bvh));
+        assert(fs::exists(MeshCache::cachePathFor(source)));
+        assert(MeshCache::open(source, view));
+
+        const MeshArrays& c = view.arrays();
+        assert(c.vertexCount == mesh.vertexCount && c.indexCount == mesh.indexCount);
+        assert(sameArray(c.positions, mesh.positions, mesh.vertexCount));
+        assert(sameArray(c.normals, mesh.normals, mesh.vertexCount));
+        assert(sameArray(c.texcoords, mesh.texcoords, mesh.vertexCount));
+        assert(sameArray(c.tangents, mesh.tangents, mesh.vertexCount));
+        assert(sameArray(c.indices, mesh.indices, mesh.indexCount));
+        assert(c.minBound == mesh.minBound && c.maxBound == mesh.maxBound);
+        assert(c.normalsFromSource == mesh.normalsFromSource);
+        for (const void* p : { (const void*)c.positions, (const void*)c.normals, (const void*)c.indices,
+                               (const void*)view.bvhNodes(), (const void*)view.bvhPrimIndices() })
+            assert(reinterpret_cast<uintptr_t>(p) % MeshCache::kSectionAlignment == 0);
+
+        assert(view.bvhNodeCount() == bvh.nodeCount());
+        assert(sameArray(view.bvhNodes(), bvh.nodes().data(), bvh.nodeCount()));
+        assert(sameArray(view.bvhPrimIndices(), bvh.primIndices().data(), bvh.primIndices().size()));
+
+        // A loader filled from the view matches the parsed one
+        ObjLoader copy;
+        copy.copyFrom(c);
+        const MeshArrays r = copy.arrays();
+        assert(r.vertexCount == mesh.vertexCount && sameArray(r.tangents, mesh.tangents, mesh.vertexCount));
+        assert(sameArray(r.indices, mesh.indices, mesh.indexCount) && copy.hasTexcoords());
+        assert(view.lods().empty());
+
+        // LOD levels come back in order with their errors
+        std::vector<MeshLod::Level> lods(2);
+        lods[0].indices.assign(mesh.indices, mesh.indices + mesh.indexCount / 2 / 3 * 3);
+        lods[0].error = 0.01f;
+        lods[1].indices.assign(mesh.indices, mesh.indices + 6);
+        lods[1].error = 0.25f;
+        assert(MeshCache::store(source, mesh, bvh, lods));
+        assert(MeshCache::open(source, view) && view.lods().size() == 2);
+        for (size_t i = 0; i < lods.size(); ++i)
+        {
+            const MeshCache::View::Lod& l = view.lods()[i];
+            assert(l.indexCount == lods[i].indices.size() && l.error == lods[i].error);
+            assert(sameArray(l.indices, lods[i].indices.data(), l.indexCount));
+        }
+        std::cout << "✓ Round trip" << std::endl;
+    }
+
+    // Case 2: damaged or foreign entries are rejected
+    {
+        const std::string cachePath = MeshCache::cachePathFor(source);
+        std::vector<char> bytes(fs::file_size(cachePath));
+        std::ifstream(cachePath, std::ios::binary).read(bytes.data(), bytes.size());
+
+        MeshCache::View view;
+        fs::resize_file(cachePath, bytes.size() / 2);
+        assert(!MeshCache::open(source, view) && "truncated");
+
+        std::vector<char> wrongVersion = bytes;
+        wrongVersion[8] ^= 0x7f;
+        std::ofstream(cachePath, std::ios::binary | std::ios::trunc).write(wrongVersion.data(), wrongVersion.size());
+        assert(!MeshCache::open(source, view) && "other version");
+
+        // Entries of the right size whose indices point outside their arrays
+        std::vector<uint32_t> lodIndices(mesh.indices, mesh.indices + mesh.indexCount / 2 / 3 * 3);
+        lodIndices.insert(lodIndices.end(), mesh.indices, mesh.indices + 6);
+        const uint32_t outOfRange = static_cast<uint32_t>(mesh.vertexCount);
+        const struct { size_t offset; uint32_t value; const char* what; } damage[] = {
+            { findArray(bytes, mesh.indices, mesh.indexCount) + 4, outOfRange, "vertex index" },
+            { findArray(bytes, lodIndices.data(), lodIndices.size()) + 8, outOfRange, "LOD vertex index" },
+            { findArray(bytes, bvh.primIndices().data(), bvh.primIndices().size()), uint32_t(mesh.indexCount / 3), "triangle index" },
+            { findArray(bytes, bvh.nodes().data(), bvh.nodeCount()) + offsetof(BVHNode, leftFirst), uint32_t(bvh.nodeCount()), "child node" },
+        };
+        for (const auto& d : damage)
+        {
+            std::vector<char> damaged = bytes;
+            std::memcpy(damaged.data() + d.offset, &d.value, sizeof(d.value));
+            std::ofstream(cachePath, std::ios::binary | std::ios::trunc).write(damaged.data(), damaged.size());
+            if (MeshCache::open(source, view))
+            {
+                std::cerr << "accepted a damaged " << d.what << std::endl;
+                assert(false);
+            }
+        }
+
+        std::ofstream(cachePath, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size());
+        assert(MeshCache::open(source, view));
+        view.close();
+        std::cout << "✓ Damaged entries fail" << std::endl;
+    }
+
+    // Case 3: editing the source invalidates its entry
+    {
+        std::ofstream(source, std::ios::binary | std::ios::app) << "# edited\n";
+        MeshCache::View view;
+        assert(!MeshCache::open(source, view));
+
+        MeshCache::setDirectory("");
+        assert(MeshCache::cachePathFor(source).empty() && !MeshCache::store(source, mesh, bvh));
+        std::cout << "✓ Stale entries and disabled cache" << std::endl;
+    }
+
+    // Case 4: copies of a loader (duplicated objects) share its arrays until
+    // one of them is modified
+    {
+        ObjLoader duplicate = loaded;
+        assert(duplicate.getPositions() == loaded.getPositions() && duplicate.getFaces() == loaded.getFaces());
+        duplicate.flipWindingAndNormals();
+        assert(duplicate.getFaces() != loaded.getFaces() && duplicate.getNormals() != loaded.getNormals());
+        assert(sameArray(loaded.arrays().indices, mesh.indices, mesh.indexCount));
+        assert(duplicate.getFaces()[1] == mesh.indices[2] && duplicate.getNormals()[0] == -mesh.normals[0].x);
+        std::cout << "✓ Copies share mesh arrays" << std::endl;
+    }
+
+    fs::remove_all(dir);
+    std::cout << "\n✅ Mesh cache tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../../engine/include/mesh_lod.h"
+
+// UV sphere whose seam column is duplicated with u = 0 and u = 1, as an
+// exporter would write it
+struct Sphere {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> uvs;
+    std::vector<uint32_t> indices;
+};
+
+static Sphere makeSphere(int rings, int segments)
+{
+    Sphere s;
+    const float pi = 3.14159265f;
+    for (int r = 0; r <= rings; ++r)
+        for (int g = 0; g <= segments; ++g) {
+            const float theta = pi * r / rings, phi = 2.0f * pi * (g % segments) / segments;
+            // Poles and the seam column share exact positions
+            const float st = (r == 0 || r == rings) ? 0.0f : std::sin(theta);
+            s.positions.push_back(glm::vec3(st * std::cos(phi), std::cos(theta), st * std::sin(phi)));
+            s.uvs.push_back(glm::vec2(float(g) / segments, float(r) / rings));
+        }
+    auto at = [&](int r, int g) { return uint32_t(r * (segments + 1) + g); };
+    for (int r = 0; r < rings; ++r)
+        for (int g = 0; g < segments; ++g) {
+            if (r > 0) s.indices.insert(s.indices.end(), { at(r, g), at(r, g + 1), at(r + 1, g) });
+            if (r < rings - 1) s.indices.insert(s.indices.end(), { at(r, g + 1), at(r + 1, g + 1), at(r + 1, g) });
+        }
+    return s;
+}
+
+// Edges between distinct positions, counted over triangles; a closed surface
+// uses every one exactly twice
+static bool closedSurface(const std::vector<glm::vec3>& positions, const uint32_t* indices, size_t count)
+{
+    auto key = [&](uint32_t v) { const glm::vec3 p = positions[v]; return std::make_tuple(p.x, p.y, p.z); };
+    std::map<std::pair<std::tuple<float, float, float>, std::tuple<float, float, float>>, int> uses;
+    for (size_t t = 0; t < count; t += 3)
+        for (int k = 0; k < 3; ++k) {
+            auto a = key(indices[t + k]), b = key(indices[t + (k + 1) % 3]);
+            if (a == b) return false;   // degenerate triangle
+            ++uses[a < b ? std::make_pair(a, b) : std::make_pair(b, a)];
+        }
+    for (const auto& e : uses)
+        if (e.second != 2) return false;
+    return true;
+}
+
+int main()
+{
+    std::cout << "Running mesh LOD tests...\n";
+
+    // Case 1: a flat grid simplifies to a handful of triangles without error,
+    // and its open border keeps the grid's full extent
+    {
+        const int n = 32;
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+        for (int y = 0; y <= n; ++y)
+            for (int x = 0; x <= n; ++x) positions.push_back(glm::vec3(float(x), 0.0f, float(y)));
+        for (int y = 0; y < n; ++y)
+            for (int x = 0; x < n; ++x) {
+                const uint32_t a = y * (n + 1) + x, b = a + 1, c = a + n + 1, d = c + 1;
+                indices.insert(indices.end(), { a, c, b, b, c, d });
+            }
+        std::vector<uint32_t> out(indices.size());
+        float error = -1.0f;
+        const size_t count = MeshLod::simplify(out.data(), indices.data(), indices.size(), positions.data(), positions.size(),
+                                               0, 1e-4f, &error);
+        assert(count > 0 && count < indices.size() / 4);
+        assert(error >= 0.0f && error <= 1e-4f);
+        float area = 0.0f;
+        for (size_t t = 0; t < count; t += 3) {
+            const glm::vec3 nrm = glm::cross(positions[out[t + 1]] - positions[out[t]], positions[out[t + 2]] - positions[out[t]]);
+            assert(nrm.y > 0.0f && "no triangle folds over");
+            area += 0.5f * nrm.y;
+        }
+        assert(std::abs(area - float(n * n)) < 1e-2f);
+        std::cout << "✓ Planar grid: " << indices.size() / 3 << " -> " << count / 3 << " triangles" << std::endl;
+    }
+
+    // Case 2: a sphere's chain halves per level with growing error, and the
+    // duplicated seam never tears
+    {
+        const Sphere s = makeSphere(48, 96);
+        MeshArrays mesh;
+        mesh.positions = s.positions.data();
+        mesh.texcoords = s.uvs.data();
+        mesh.vertexCount = s.positions.size();
+        mesh.indices = s.indices.data();
+        mesh.indexCount = s.indices.size();
+        mesh.minBound = glm::vec3(-1.0f);
+        mesh.maxBound = glm::vec3(1.0f);
+        assert(closedSurface(s.positions, s.indices.data(), s.indices.size()));
+
+        const std::vector<MeshLod::Level> chain = MeshLod::buildChain(mesh);
+        assert(chain.size() >= 3);
+        size_t previous = s.indices.size();
+        float previousError = 0.0f;
+        for (const MeshLod::Level& level : chain) {
+            assert(level.indices.size() <= previous * 4 / 5 && level.indices.size() % 3 == 0);
+            assert(level.error >= previousError && level.error > 0.0f);
+            for (uint32_t i : level.indices) assert(i < mesh.vertexCount);
+            assert(closedSurface(s.positions, level.indices.data(), level.indices.size()));
+            std::cout << "  level: " << level.indices.size() / 3 << " triangles, error " << level.error << std::endl;
+            previous = level.indices.size();
+            previousError = level.error;
+        }
+        assert(chain.back().error < MeshLod::kMaxRelativeError * glm::length(mesh.maxBound - mesh.minBound));
+        std::cout << "✓ Seam-preserving LOD chain" << std::endl;
+    }
+
+    // Case 3: selection refines at once, coarsens with hysteresis
+    {
+        const float errors[] = { 0.01f, 0.02f, 0.04f };
+        assert(MeshLod::selectLevel(errors, 3, 1000.0f, 1.0f, 0) == 0);   // 10 px: base mesh
+        assert(MeshLod::selectLevel(errors, 3, 10.0f, 1.0f, 0) == 3);     // 0.4 px: coarsest
+        assert(MeshLod::selectLevel(errors, 3, 60.0f, 1.0f, 0) == 1);     // 0.6 px, 1.2 px
+        // 45 px/unit puts level 2 at 0.9 px: fine to keep, too close to switch to
+        assert(MeshLod::selectLevel(errors, 3, 45.0f, 1.0f, 2) == 2);
+        assert(MeshLod::selectLevel(errors, 3, 45.0f, 1.0f, 1) == 1);
+        assert(MeshLod::selectLevel(errors, 3, 60.0f, 1.0f, 2) == 1);     // 1.2 px shows: refine
+        assert(MeshLod::selectLevel(errors, 3, 10.0f, 0.0f, 3) == 0);     // threshold 0 disables LODs
+        std::cout << "✓ Screen-space selection with hysteresis" << std::endl;
+    }
+
+    std::cout << "\n✅ Mesh LOD tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "../../engine/include/mesh_optimizer.h"
+
+// Triangles as position triples, rotated to start at the smallest, so two
+// meshes compare equal when they draw the same triangles with the same winding
+static std::vector<std::array<float, 9>> triangleSet(const MeshData& m)
+{
+    std::vector<std::array<float, 9>> out;
+    for (size_t t = 0; t + 2 < m.indices.size(); t += 3) {
+        std::array<glm::vec3, 3> p = { m.positions[m.indices[t]], m.positions[m.indices[t + 1]], m.positions[m.indices[t + 2]] };
+        auto less = [](const glm::vec3& a, const glm::vec3& b) {
+            return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+        };
+        const size_t first = std::min_element(p.begin(), p.end(), less) - p.begin();
+        std::rotate(p.begin(), p.begin() + first, p.end());
+        out.push_back({ p[0].x, p[0].y, p[0].z, p[1].x, p[1].y, p[1].z, p[2].x, p[2].y, p[2].z });
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+// n x n quad grid on a bumpy surface, one vertex copy per triangle corner,
+// triangles shuffled so the input has no locality
+static MeshData makeGrid(int n)
+{
+    MeshData m;
+    auto vertex = [&](int x, int y) {
+        m.positions.push_back(glm::vec3(float(x), std::sin(x * 0.3f) * std::cos(y * 0.2f), float(y)));
+        m.normals.push_back(glm::vec3(0.0f, 1.0f, 0.0f));
+        m.uvs.push_back(glm::vec2(x / float(n), y / float(n)));
+        m.indices.push_back(unsigned(m.positions.size() - 1));
+    };
+    std::vector<std::array<int, 6>> tris;
+    for (int y = 0; y < n; ++y)
+        for (int x = 0; x < n; ++x) {
+            tris.push_back({ x, y, x, y + 1, x + 1, y });
+            tris.push_back({ x + 1, y, x, y + 1, x + 1, y + 1 });
+        }
+    std::shuffle(tris.begin(), tris.end(), std::mt19937(7));
+    for (const auto& t : tris) { vertex(t[0], t[1]); vertex(t[2], t[3]); vertex(t[4], t[5]); }
+    m.minBound = glm::vec3(0.0f, -1.0f, 0.0f);
+    m.maxBound = glm::vec3(float(n), 1.0f, float(n));
+    return m;
+}
+
+int main()
+{
+    std::cout << "Running mesh optimizer tests...\n";
+    const int n = 64;
+
+    // Case 1: the whole pipeline merges vertices, improves the cache and
+    // draws exactly the same triangles
+    {
+        MeshData mesh = makeGrid(n);
+        const auto before = triangleSet(mesh);
+        const MeshOptimizer::Report r = MeshOptimizer::optimize(mesh);
+        assert(r.verticesBefore == size_t(n) * n * 6);
+        assert(r.verticesAfter == size_t(n + 1) * (n + 1));
+        assert(mesh.positions.size() == r.verticesAfter && mesh.normals.size() == r.verticesAfter && mesh.uvs.size() == r.verticesAfter);
+        assert(triangleSet(mesh) == before);
+        assert(r.before.acmr == 3.0f);
+        assert(r.after.acmr < 0.8f && "Tipsify gets a grid well below one miss per triangle");
+        assert(r.after.atvr < 1.6f);
+        assert(r.bytesAfter < r.bytesBefore / 4);
+
+        // Vertices come in first-use order
+        unsigned next = 0;
+        for (unsigned i : mesh.indices) { assert(i <= next); if (i == next) ++next; }
+        std::cout << "✓ Optimize: " << MeshOptimizer::describe(r) << std::endl;
+    }
+
+    // Case 2: overdraw ordering keeps the triangle set and the ACMR bound
+    {
+        MeshData mesh = makeGrid(n);
+        MeshOptimizer::dedupVertices(mesh);
+        MeshOptimizer::optimizeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.positions.size());
+        const auto before = triangleSet(mesh);
+        const float acmr = MeshOptimizer::analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.positions.size()).acmr;
+        MeshOptimizer::optimizeOverdraw(mesh.indices.data(), mesh.indices.size(), mesh.positions.data(), mesh.positions.size());
+        assert(triangleSet(mesh) == before);
+        assert(MeshOptimizer::analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.positions.size()).acmr
+               <= acmr * MeshOptimizer::kOverdrawThreshold);
+        std::cout << "✓ Overdraw ordering within ACMR threshold" << std::endl;
+    }
+
+    // Case 3: compact layouts and quantized streams round-trip
+    {
+        MeshData mesh = makeGrid(8);
+        MeshOptimizer::optimize(mesh);
+        const MeshArrays arrays = MeshOptimizer::arraysOf(mesh);
+        const MeshOptimizer::GpuLayout layout = MeshOptimizer::gpuLayout(arrays);
+        assert(layout.quantized && layout.index16 && layout.halfTexcoords);
+        assert(!MeshOptimizer::gpuLayout(arrays, false).quantized && !MeshOptimizer::gpuLayout(arrays, false).index16);
+
+        std::vector<glm::vec2> tiled(arrays.texcoords, arrays.texcoords + arrays.vertexCount);
+        tiled[0] = glm::vec2(1000.3f, 0.0f);   // too far out for half precision
+        MeshArrays tiledArrays = arrays;
+        tiledArrays.texcoords = tiled.data();
+        assert(!MeshOptimizer::gpuLayout(tiledArrays).halfTexcoords);
+
+        const MeshOptimizer::QuantizedMesh q = MeshOptimizer::quantize(arrays);
+        assert(q.positions.size() == 4 * arrays.vertexCount && q.normals.size() == 2 * arrays.vertexCount);
+        const glm::mat4 dequantize = q.dequantize();
+        for (size_t i = 0; i < arrays.vertexCount; ++i) {
+            const glm::vec3 unorm = glm::vec3(q.positions[4 * i], q.positions[4 * i + 1], q.positions[4 * i + 2]) / 65535.0f;
+            const glm::vec3 p = glm::vec3(dequantize * glm::vec4(unorm, 1.0f));
+            assert(glm::length(p - mesh.positions[i]) < 1e-3f);
+        }
+
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+        for (int i = 0; i < 1000; ++i) {
+            const glm::vec3 v = glm::normalize(glm::vec3(u(rng), u(rng), u(rng)));
+            const glm::vec2 e = MeshOptimizer::octEncode(v);
+            const glm::vec2 snorm = glm::round(e * 32767.0f) / 32767.0f;
+            assert(glm::dot(MeshOptimizer::octDecode(snorm), v) > 0.99999f);
+        }
+        std::cout << "✓ 16-bit indices, half UVs and quantized attributes" << std::endl;
+    }
+
+    std::cout << "\n✅ Mesh optimizer tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../../engine/include/obj_reader.h"
+
+static bool parse(const std::string& text, ObjReader::Mesh& mesh, size_t chunkBytes = ObjReader::kDefaultChunkBytes)
+{
+    std::string error;
+    const bool ok = ObjReader::parseBuffer(text.data(), text.size(), mesh, &error, nullptr, chunkBytes);
+    if (!ok) std::cout << "  (" << error << ")" << std::endl;
+    return ok;
+}
+
+static bool sameMesh(const ObjReader::Mesh& a, const ObjReader::Mesh& b)
+{
+    return a.positions == b.positions && a.texcoords == b.texcoords && a.normals == b.normals &&
+           a.indices == b.indices && a.sourcePositions == b.sourcePositions &&
+           a.minBound == b.minBound && a.maxBound == b.maxBound;
+}
+
+int main()
+{
+    std::cout << "Running OBJ reader tests...\n";
+
+    // Case 1: plain triangles and a quad, with comments, groups and CRLF
+    {
+        const std::string text =
+            "# cube side\r\n"
+            "o side\r\n"
+            "v 0 0 0\r\n"
+            "v 1 0 0\r\n"
+            "v 1 1 0\r\n"
+            "v  0 1 +0.5e0\r\n"
+            "g front\r\n"
+            "usemtl red\r\n"
+            "f 1 2 3 4\r\n"
+            "f\t-4 -2 -1 # relative\r\n";
+        ObjReader::Mesh mesh;
+        assert(parse(text, mesh));
+        assert(mesh.positions.size() == 4);
+        assert(mesh.texcoords.empty() && mesh.normals.empty() && mesh.sourcePositions.empty());
+        const std::vector<uint32_t> expected = { 0, 1, 2, 0, 2, 3, 0, 2, 3 };
+        assert(mesh.indices == expected && "quad fans around its first corner");
+        assert(mesh.minBound == glm::vec3(0.0f) && mesh.maxBound == glm::vec3(1.0f, 1.0f, 0.5f));
+        std::cout << "✓ Triangles, polygons and relative indices" << std::endl;
+    }
+
+    // Case 2: corners are deduplicated by their (v, vt, vn) triple
+    {
+        const std::string text =
+            "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+            "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\nvt 0.5\n"
+            "vn 0 0 1\n"
+            "f 1/1/1 2/2/1 3/3/1\n"
+            "f 1/1/1 3/3/1 4/4/1\n"
+            "f 3/5/1 4/4/1 1/1/1\n";   // vertex 3 again with another texcoord
+        ObjReader::Mesh mesh;
+        assert(parse(text, mesh));
+        assert(mesh.positions.size() == 5 && mesh.texcoords.size() == 5 && mesh.normals.size() == 5);
+        const std::vector<uint32_t> expected = { 0, 1, 2, 0, 2, 3, 4, 3, 0 };
+        assert(mesh.indices == expected);
+        assert(mesh.positions[4] == mesh.positions[2]);
+        assert(mesh.texcoords[4] == glm::vec2(0.5f, 0.0f) && "vt takes an optional v");
+        assert((mesh.sourcePositions == std::vector<uint32_t>{ 0, 1, 2, 3, 2 }));
+        assert(mesh.normals[4] == glm::vec3(0.0f, 0.0f, 1.0f));
+
+        // Texcoords without normals, and normals that are dropped because
+        // not every corner has one
+        ObjReader::Mesh partial;
+        assert(parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvn 0 0 1\nf 1/1/1 2/1 3/1\n", partial));
+        assert(partial.texcoords.size() == 3 && partial.normals.empty());
+        std::cout << "✓ Vertices split only where texcoords or normals differ" << std::endl;
+    }
+
+    // Case 3: any chunking gives the same mesh as a single chunk
+    {
+        std::ostringstream text;
+        const int grid = 40;
+        for (int y = 0; y <= grid; ++y)
+            for (int x = 0; x <= grid; ++x)
+            {
+                text << "v " << x * 0.25f << ' ' << y * 0.25f << ' ' << ((x * 7 + y * 3) % 5) * 0.1f << '\n';
+                text << "vt " << x / float(grid) << ' ' << y / float(grid) << '\n';
+            }
+        text << "vn 0 0 1\n";
+        for (int y = 0; y < grid; ++y)
+            for (int x = 0; x < grid; ++x)
+            {
+                const int i = y * (grid + 1) + x + 1;
+                // Alternate absolute and relative references
+                if ((x + y) % 2)
+                    text << "f " << i << '/' << i << "/1 " << i + 1 << '/' << i + 1 << "/1 "
+                         << i + grid + 2 << '/' << i + grid + 2 << "/1 " << i + grid + 1 << '/' << i + grid + 1 << "/1\n";
+                else
+                    text << "f " << i << '/' << i << "/-1 " << i + 1 << '/' << i + 1 << "/-1 "
+                         << i + grid + 2 << '/' << i + grid + 2 << "/-1\n";
+            }
+        const std::string obj = text.str();
+
+        ObjReader::Mesh whole;
+        assert(parse(obj, whole));
+        assert(whole.indices.size() == 3 * (grid * grid + grid * grid / 2));
+        for (size_t chunkBytes : { size_t(1), size_t(17), size_t(256), size_t(4096) })
+        {
+            ObjReader::Mesh chunked;
+            ObjReader::Stats stats;
+            assert(ObjReader::parseBuffer(obj.data(), obj.size(), chunked, nullptr, &stats, chunkBytes));
+            assert(stats.bytes == obj.size() && stats.chunks >= 1);
+            assert(sameMesh(whole, chunked));
+        }
+
+        // The same through a mapped file
+        const std::string path = (std::filesystem::temp_directory_path() / "glint_obj_reader_test.obj").string();
+        std::ofstream(path, std::ios::binary) << obj;
+        ObjReader::Mesh mapped;
+        ObjReader::Stats stats;
+        assert(ObjReader::parseFile(path, mapped, nullptr, &stats));
+        assert(sameMesh(whole, mapped) && stats.megabytesPerSecond() > 0.0);
+        std::remove(path.c_str());
+        std::cout << "✓ Chunked and mapped parsing match" << std::endl;
+    }
+
+    // Case 4: bad input is reported instead of producing a broken mesh
+    {
+        ObjReader::Mesh mesh;
+        std::string error;
+        assert(!parse("v 0 0 0\nv 1 0 0\nf 1 2 3\n", mesh));
+        assert(!parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 0\n", mesh));
+        assert(!parse("v 0 zero 0\n", mesh));
+        assert(!parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3x\n", mesh));
+        assert(!ObjReader::parseFile("does/not/exist.obj", mesh, &error) && !error.empty());
+        assert(parse("", mesh) && mesh.positions.empty() && mesh.indices.empty());
+        std::cout << "✓ Invalid files fail" << std::endl;
+    }
+
+    std::cout << "\n✅ OBJ reader tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include "../../engine/include/seeded_rng.h"
+
+int main()
+{
+    std::cout << "Running Sobol sampler tests...\n";
+
+    // Case 1: direction numbers match the reference Sobol sequence
+    {
+        // First points of dimensions 1-3 (Joe-Kuo) in binary index order, as
+        // multiples of 1/8
+        const uint32_t expected[3][8] = {
+            { 0, 4, 6, 2, 5, 1, 3, 7 },
+            { 0, 4, 6, 2, 3, 7, 5, 1 },
+            { 0, 4, 6, 2, 1, 5, 7, 3 },
+        };
+        for (int dim = 1; dim < 4; ++dim)
+            for (uint32_t i = 0; i < 8; ++i)
+                assert(sampling::sobol(i, dim) >> 29 == expected[dim - 1][i]);
+        for (uint32_t i = 0; i < 64; ++i)
+            assert(sampling::sobol(i, 0) == sampling::reverseBits(i) && "dimension 0 is van der Corput");
+        std::cout << "✓ Direction numbers match the reference sequence" << std::endl;
+    }
+
+    // Case 2: the scrambled (0, 1) projection of the first 4^k samples puts
+    // exactly one point in each cell of a 2^k x 2^k grid, and every dimension
+    // is stratified on its own
+    {
+        for (uint32_t seed : { 1u, 42u, 0xdeadbeefu })
+        {
+            for (int k = 1; k <= 4; ++k)
+            {
+                const int n = 1 << k;
+                std::vector<int> cells(n * n, 0);
+                std::vector<int> strata(4 * n * n, 0);
+                for (uint32_t i = 0; i < uint32_t(n * n); ++i)
+                {
+                    float u[4];
+                    sampling::scrambledSobol4D(i, seed, u);
+                    for (int dim = 0; dim < 4; ++dim)
+                    {
+                        assert(u[dim] >= 0.0f && u[dim] < 1.0f);
+                        ++strata[dim * n * n + int(u[dim] * n * n)];
+                    }
+                    ++cells[int(u[0] * n) * n + int(u[1] * n)];
+                }
+                for (int c : cells)
+                    assert(c == 1 && "each grid cell must hold one sample");
+                for (int c : strata)
+                    assert(c == 1 && "each 1D stratum must hold one sample");
+            }
+        }
+        std::cout << "✓ Scrambled points are stratified in 1D and in the (0, 1) plane" << std::endl;
+    }
+
+    // Case 3: samplers are deterministic and decorrelated across pixels and groups
+    {
+        float a[4], b[4], c[4], d[4];
+        SobolSampler(7, 100, 3).get4D(1, a);
+        SobolSampler(7, 100, 3).get4D(1, b);
+        SobolSampler(7, 101, 3).get4D(1, c);
+        SobolSampler(7, 100, 3).get4D(2, d);
+        for (int i = 0; i < 4; ++i) assert(a[i] == b[i]);
+        assert(a[0] != c[0] && a[0] != d[0]);
+        std::cout << "✓ Sampler output is deterministic per pixel and group" << std::endl;
+    }
+
+    std::cout << "\n✅ Sobol sampler tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../engine/include/texture_cache.h"
+#include "../../engine/include/rhi/rhi_null.h"
+
+namespace fs = std::filesystem;
+
+// Binary PPM, which stb_image reads like any other 8-bit format
+static std::string writeImage(const fs::path& dir, const std::string& name, int size)
+{
+    const std::string path = (dir / name).string();
+    std::ofstream out(path, std::ios::binary);
+    out << "P6\n" << size << ' ' << size << "\n255\n";
+    std::vector<char> pixels(size_t(size) * size * 3, char(0x7f));
+    out.write(pixels.data(), pixels.size());
+    return path;
+}
+
+int main()
+{
+    std::cout << "Running texture cache tests...\n";
+
+    RhiNull rhi;
+    Texture::setRHI(&rhi);
+    const fs::path dir = fs::temp_directory_path() / "glint_texture_cache_test";
+    fs::create_directories(dir);
+    const std::string a = writeImage(dir, "a.ppm", 64);
+    const std::string b = writeImage(dir, "b.ppm", 64);
+    const std::string c = writeImage(dir, "c.ppm", 64);
+    const size_t textureBytes = 64 * 64 * 3 * 4 / 3;   // with MIP chain
+
+    TextureCache& cache = TextureCache::instance();
+
+    // Case 1: repeated lookups hit, missing files fail without being cached
+    {
+        std::shared_ptr<Texture> first = cache.get(a, false);
+        assert(first && first->width() == 64 && first->channels() == 3);
+        assert(cache.get(a, false) == first);
+        assert(cache.get(a, true) != first && "flip is part of the key");
+        assert(!cache.get((dir / "missing.png").string(), false));
+        const TextureCache::Stats s = cache.stats();
+        assert(s.hits == 1 && s.misses == 3 && s.textures == 2);
+        std::cout << "✓ Hits and misses" << std::endl;
+    }
+
+    // Case 2: over budget, only textures nobody holds are evicted, oldest first
+    {
+        cache.clear();
+        cache.setBudget(2 * textureBytes);
+        std::shared_ptr<Texture> held = cache.get(a, false);
+        cache.get(b, false);
+        cache.get(c, false);   // over budget: b is the only unreferenced texture
+        TextureCache::Stats s = cache.stats();
+        assert(s.textures == 2 && s.residentBytes == 2 * textureBytes);
+        const uint64_t evictions = s.evictions;
+        assert(evictions >= 1);
+        assert(cache.get(a, false) == held && "referenced textures stay cached");
+
+        cache.setBudget(0);
+        s = cache.stats();
+        assert(s.textures == 1 && s.evictions == evictions + 1);
+        held.reset();
+        cache.setBudget(0);
+        assert(cache.stats().textures == 0);
+        cache.setBudget(TextureCache::kDefaultBudgetBytes);
+        std::cout << "✓ LRU eviction respects references" << std::endl;
+    }
+
+    // Case 3: prefetches decode on workers (from any thread) and stream in
+    {
+        cache.clear();
+        std::thread([&] {
+            cache.prefetch(a, false);
+            cache.prefetch(b, false);
+            cache.prefetch(a, false);   // already on its way
+        }).join();
+        assert(cache.stats().pendingDecodes == 2);
+
+        size_t uploaded = 0;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (uploaded < 2 && std::chrono::steady_clock::now() < deadline)
+            uploaded += cache.pumpUploads(1);   // tiny budget: still one per call
+        assert(uploaded == 2);
+        const TextureCache::Stats s = cache.stats();
+        assert(s.pendingDecodes == 0 && s.textures == 2);
+
+        // get() on a prefetch in flight waits for it instead of decoding again
+        cache.prefetch(c, false);
+        assert(cache.get(c, false) && cache.pumpUploads(SIZE_MAX) == 0);
+        std::cout << "✓ Prefetch and streamed upload" << std::endl;
+    }
+
+    cache.clear();
+    Texture::setRHI(nullptr);
+    fs::remove_all(dir);
+    std::cout << "\n✅ Texture cache tests passed!\n";
+    return 0;
+}
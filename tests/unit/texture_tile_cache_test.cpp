@@ -0,0 +1,145 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <glm/glm.hpp>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+#include "../../engine/include/texture_tile_cache.h"
+
+using namespace raytracer;
+
+static std::string writePng(const char* name, int width, int height, const std::vector<unsigned char>& rgba)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / name).string();
+    const int ok = stbi_write_png(path.c_str(), width, height, 4, rgba.data(), width * 4);
+    assert(ok);
+    return path;
+}
+
+int main()
+{
+    std::cout << "Running texture tile cache tests...\n";
+
+    // Odd-sized noise: several tiles per row with a partial last one
+    const int width = 200, height = 130;
+    std::vector<unsigned char> noise(static_cast<size_t>(width) * height * 4);
+    std::mt19937 rng(7u);
+    for (auto& c : noise) c = static_cast<unsigned char>(rng() & 0xFF);
+    const std::string noisePath = writePng("glint_tile_cache_noise.png", width, height, noise);
+
+    auto texel = [&](int x, int y) {
+        x = ((x % width) + width) % width;
+        y = ((y % height) + height) % height;
+        const unsigned char* p = &noise[(static_cast<size_t>(y) * width + x) * 4];
+        return glm::vec4(p[0], p[1], p[2], p[3]) / 255.0f;
+    };
+
+    // Case 1: full-resolution lookups reproduce the image, including
+    // bilinear footprints across tile borders and the wrap-around
+    {
+        TextureTileCache cache;
+        const uint32_t tex = cache.acquire(noisePath, /*gammaEncoded=*/false);
+        assert(tex != TextureTileCache::kNoTexture);
+        assert(cache.acquire(noisePath, false) == tex && "one handle per file");
+        assert(cache.acquire("does/not/exist.png", false) == TextureTileCache::kNoTexture);
+
+        glm::vec4 value;
+        for (int y = 0; y < height; y += 7)
+            for (int x = 0; x < width; x += 3)
+            {
+                assert(cache.sample(tex, glm::vec2((x + 0.5f) / width, (y + 0.5f) / height), 0.0f, value));
+                assert(glm::length(value - texel(x, y)) < 1e-5f);
+            }
+
+        const int borders[][2] = { { 63, 10 }, { 127, 63 }, { 199, 64 }, { 5, 129 }, { 199, 129 } };
+        for (const auto& b : borders)
+        {
+            // Halfway between texel (x, y) and its upper-right neighbour
+            const glm::vec2 uv((b[0] + 1.0f) / width, (b[1] + 1.0f) / height);
+            const glm::vec4 expected = 0.25f * (texel(b[0], b[1]) + texel(b[0] + 1, b[1]) +
+                                                texel(b[0], b[1] + 1) + texel(b[0] + 1, b[1] + 1));
+            assert(cache.sample(tex, uv, 0.0f, value));
+            assert(glm::length(value - expected) < 1e-5f);
+            assert(cache.sample(tex, uv + glm::vec2(3.0f, -2.0f), 0.0f, value));
+            assert(glm::length(value - expected) < 1e-4f && "coordinates repeat");
+        }
+        std::cout << "✓ Tiled lookups match the image" << std::endl;
+    }
+
+    // Case 2: wide footprints read coarse levels that average in linear
+    // space for gamma-encoded maps
+    {
+        const int size = 256;
+        std::vector<unsigned char> checker(static_cast<size_t>(size) * size * 4);
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x)
+            {
+                const unsigned char v = ((x / 16 + y / 16) & 1) ? 230 : 40;
+                unsigned char* p = &checker[(static_cast<size_t>(y) * size + x) * 4];
+                p[0] = p[1] = p[2] = v;
+                p[3] = 255;
+            }
+        const std::string checkerPath = writePng("glint_tile_cache_checker.png", size, size, checker);
+
+        TextureTileCache cache;
+        const uint32_t color = cache.acquire(checkerPath, /*gammaEncoded=*/true);
+        const uint32_t data = cache.acquire(checkerPath, /*gammaEncoded=*/false);
+        assert(color != data);
+
+        glm::vec4 value;
+        assert(cache.sample(color, glm::vec2(0.01f), 0.0f, value));
+        assert(std::abs(value.r - std::pow(40.0f / 255.0f, 2.2f)) < 1e-5f);
+
+        const float linearAverage = 0.5f * (std::pow(230.0f / 255.0f, 2.2f) + std::pow(40.0f / 255.0f, 2.2f));
+        assert(cache.sample(color, glm::vec2(0.3f, 0.7f), 1.0f, value));
+        assert(std::abs(value.r - linearAverage) < 0.01f && "color maps filter in linear space");
+        assert(cache.sample(data, glm::vec2(0.3f, 0.7f), 1.0f, value));
+        assert(std::abs(value.r - 135.0f / 255.0f) < 0.01f);
+        assert(std::abs(value.a - 1.0f) < 1e-5f);
+
+        // Between levels the lookup blends; it stays between the extremes
+        assert(cache.sample(color, glm::vec2(0.3f, 0.7f), 24.0f / size, value));
+        assert(value.r > 0.0f && value.r < 1.0f);
+        std::remove(checkerPath.c_str());
+        std::cout << "✓ MIP levels average in linear space" << std::endl;
+    }
+
+    // Case 3: a small budget evicts tiles and reloads them on demand with
+    // identical results
+    {
+        TextureTileCache cache;
+        const uint32_t tex = cache.acquire(noisePath, false);
+        glm::vec4 first, again;
+        assert(cache.sample(tex, glm::vec2(0.1f, 0.1f), 0.0f, first));
+        const size_t oneTile = cache.residentBytes();
+        assert(oneTile > 0 && cache.tileLoads() == 1);
+
+        cache.setBudget(0);
+        for (int i = 0; i < 16; ++i)
+            assert(cache.sample(tex, glm::vec2((i % 4 + 0.5f) / 4.0f, (i / 4 + 0.5f) / 4.0f), 0.0f, again));
+        // Each shard keeps at most its most recent tile
+        assert(cache.residentBytes() <= 16 * oneTile);
+
+        const uint64_t loads = cache.tileLoads();
+        assert(cache.sample(tex, glm::vec2(0.1f, 0.1f), 0.0f, again));
+        assert(again == first);
+        assert(cache.tileLoads() >= loads);
+
+        cache.setBudget(TextureTileCache::kDefaultBudgetBytes);
+        const uint64_t warm = cache.tileLoads();
+        for (int k = 0; k < 2; ++k)
+            for (int i = 0; i < 16; ++i)
+                assert(cache.sample(tex, glm::vec2((i % 4 + 0.5f) / 4.0f, (i / 4 + 0.5f) / 4.0f), 0.0f, again));
+        assert(cache.tileLoads() - warm <= 8 && "resident tiles are not read again");
+        std::cout << "✓ LRU budget evicts and reloads tiles" << std::endl;
+    }
+
+    std::remove(noisePath.c_str());
+    std::cout << "\n✅ Texture tile cache tests passed!\n";
+    return 0;
+}
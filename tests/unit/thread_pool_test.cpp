@@ -0,0 +1,66 @@
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "../../engine/include/thread_pool.h"
+
+int main()
+{
+    std::cout << "Running thread pool tests...\n";
+
+    // Case 1: every task runs exactly once, on a valid worker index
+    {
+        ThreadPool pool(4);
+        assert(pool.workerCount() == 4);
+
+        const uint32_t taskCount = 1000;
+        std::vector<std::atomic<int>> runs(taskCount);
+        std::atomic<bool> badWorker{ false };
+        pool.run(taskCount, [&](uint32_t task, unsigned worker) {
+            runs[task].fetch_add(1);
+            if (worker >= pool.workerCount()) badWorker = true;
+        });
+        for (const auto& r : runs)
+            assert(r.load() == 1 && "each task must run exactly once");
+        assert(!badWorker);
+        std::cout << "✓ All tasks executed once" << std::endl;
+    }
+
+    // Case 2: tasks queued behind a long-running one are stolen. Task 0
+    // waits until all other tasks finish, which only happens if idle workers
+    // take over the rest of its block.
+    {
+        ThreadPool pool(4);
+        std::atomic<uint32_t> completed{ 0 };
+        bool othersFinished = false;
+        pool.run(64, [&](uint32_t task, unsigned) {
+            if (task == 0)
+            {
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+                while (completed.load() < 63 && std::chrono::steady_clock::now() < deadline)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                othersFinished = completed.load() == 63;
+            }
+            completed.fetch_add(1);
+        });
+        assert(othersFinished && "idle workers must steal from a busy worker");
+        std::cout << "✓ Idle workers steal queued tasks" << std::endl;
+    }
+
+    // Case 3: the pool is reusable and handles empty / tiny batches
+    {
+        ThreadPool pool(3);
+        std::atomic<uint32_t> sum{ 0 };
+        for (uint32_t batch = 0; batch < 50; ++batch)
+            pool.run(batch, [&](uint32_t task, unsigned) { sum += task + 1; });
+        uint32_t expected = 0;
+        for (uint32_t batch = 0; batch < 50; ++batch) expected += batch * (batch + 1) / 2;
+        assert(sum.load() == expected);
+        std::cout << "✓ Repeated batches of varying size" << std::endl;
+    }
+
+    std::cout << "\n✅ Thread pool tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,210 @@
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <filesystem>
+#include <glm/glm.hpp>
+#include "../../engine/include/triangle.h"
+#include "../../engine/include/triangle_simd.h"
+#include "../../engine/include/bvh_node.h"
+#include "../../engine/include/objloader.h"
+
+// Random triangle soup written as OBJ and loaded through the normal path
+static void buildSoup(TriangleMesh& mesh, BVH& bvh, int triangles, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> pos(-1.0f, 1.0f), size(0.05f, 0.4f);
+    const std::string path = (std::filesystem::temp_directory_path() / "glint_triangle_simd_test.obj").string();
+    {
+        std::ofstream obj(path);
+        for (int t = 0; t < triangles; ++t)
+        {
+            const glm::vec3 c(pos(rng), pos(rng), pos(rng));
+            const float s = size(rng);
+            for (int k = 0; k < 3; ++k)
+                obj << "v " << c.x + s * pos(rng) << " " << c.y + s * pos(rng) << " " << c.z + s * pos(rng) << "\n";
+        }
+        for (int t = 0; t < triangles; ++t)
+            obj << "f " << t * 3 + 1 << " " << t * 3 + 2 << " " << t * 3 + 3 << "\n";
+    }
+    ObjLoader loader;
+    loader.load(path.c_str());
+    std::remove(path.c_str());
+
+    mesh.build(loader);
+    std::vector<glm::vec3> primMin(mesh.triangleCount()), primMax(mesh.triangleCount());
+    for (uint32_t i = 0; i < mesh.triangleCount(); ++i)
+    {
+        const glm::vec3 a = mesh.vertex0(i), b = mesh.vertex1(i), c = mesh.vertex2(i);
+        primMin[i] = glm::min(a, glm::min(b, c));
+        primMax[i] = glm::max(a, glm::max(b, c));
+    }
+    bvh.build(primMin, primMax, 4);
+    mesh.adoptBVHOrder(bvh);
+}
+
+static Ray randomRay(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> uni(-1.5f, 1.5f);
+    const glm::vec3 o(uni(rng), uni(rng), uni(rng));
+    glm::vec3 target(uni(rng) * 0.5f, uni(rng) * 0.5f, uni(rng) * 0.5f);
+    if (glm::length(target - o) < 1e-3f) target += glm::vec3(1.0f, 0.0f, 0.0f);
+    return Ray(o, target - o);
+}
+
+int main()
+{
+    std::cout << "Running SIMD triangle kernel tests...\n";
+
+    std::mt19937 rng(7u);
+    TriangleMesh mesh;
+    BVH bvh;
+    buildSoup(mesh, bvh, 500, rng);
+    assert(mesh.triangleCount() == 500);
+
+    const simd::Kernels& scalar = *simd::kernelsFor(simd::Isa::Scalar);
+    std::vector<const simd::Kernels*> wide;
+    for (simd::Isa isa : { simd::Isa::SSE, simd::Isa::AVX2 })
+        if (const simd::Kernels* k = simd::kernelsFor(isa)) wide.push_back(k);
+    std::cout << "  kernels under test: scalar";
+    for (const auto* k : wide) std::cout << ", " << simd::isaName(k->isa);
+    std::cout << " (dispatched: " << simd::isaName(simd::kernels().isa) << ")\n";
+
+    // Case 1: wide kernels match the scalar path on every leaf-sized range,
+    // including ranges that end inside a 4/8-lane group
+    {
+        int hits = 0;
+        for (int r = 0; r < 2000; ++r)
+        {
+            const uint32_t first = static_cast<uint32_t>(rng() % 490);
+            const uint32_t count = 1 + static_cast<uint32_t>(rng() % 10);
+
+            // Aim most rays at a triangle of the range so hits are common
+            Ray ray = randomRay(rng);
+            if (r % 4 != 0)
+            {
+                const uint32_t tri = first + static_cast<uint32_t>(rng() % count);
+                const glm::vec3 target = (mesh.vertex0(tri) + mesh.vertex1(tri) + mesh.vertex2(tri)) / 3.0f;
+                ray = Ray(ray.origin, target - ray.origin);
+            }
+
+            float tRef = 1e30f;
+            simd::LeafHit ref;
+            const bool refHit = scalar.intersect(mesh, first, count, ray.origin, ray.direction, tRef, ref);
+            const bool refOccluded = scalar.occluded(mesh, first, count, ray.origin, ray.direction, 1e30f);
+            assert(refHit == refOccluded);
+            hits += refHit ? 1 : 0;
+
+            for (const auto* k : wide)
+            {
+                float t = 1e30f;
+                simd::LeafHit h;
+                const bool hit = k->intersect(mesh, first, count, ray.origin, ray.direction, t, h);
+                assert(hit == refHit && "wide kernel must agree on hit/miss");
+                assert(k->occluded(mesh, first, count, ray.origin, ray.direction, 1e30f) == refOccluded);
+                if (hit)
+                {
+                    assert(h.triangle == ref.triangle && "wide kernel must find the same triangle");
+                    assert(t == tRef && h.u == ref.u && h.v == ref.v);
+                }
+            }
+        }
+        assert(hits > 0);
+        std::cout << "✓ Wide leaf kernels match scalar (" << hits << " hits)" << std::endl;
+    }
+
+    // Case 2: degenerate rays and a tMax that excludes every hit
+    {
+        const glm::vec3 o = mesh.vertex0(0) + glm::vec3(0.0f, 0.0f, 5.0f);
+        const glm::vec3 d = glm::normalize(mesh.vertex0(0) - o);
+        for (const auto* k : wide)
+        {
+            float t = 1e-4f;
+            simd::LeafHit h;
+            assert(!k->intersect(mesh, 0, 8, o, d, t, h) && "hits beyond tMax are rejected");
+            assert(!k->occluded(mesh, 0, 8, o, d, 1e-4f));
+            float tZero = 1e30f;
+            assert(!k->intersect(mesh, 0, 8, o, glm::vec3(0.0f), tZero, h) && "zero direction never hits");
+        }
+        std::cout << "✓ tMax and degenerate rays rejected" << std::endl;
+    }
+
+    // Case 3: packet traversal finds the same closest hits as single rays
+    {
+        const simd::Kernels& k = simd::kernels();
+        int hits = 0;
+        for (int p = 0; p < 500; ++p)
+        {
+            Ray rays[BVHRayPacket::kWidth];
+            for (auto& r : rays) r = randomRay(rng);
+
+            float tMax[BVHRayPacket::kWidth] = { 1e30f, 1e30f, 1e30f, -1.0f };   // last lane inactive
+            simd::LeafHit packetHit[BVHRayPacket::kWidth];
+            int mask = 0;
+            bvh.intersectPacket(BVHRayPacket(rays), tMax, [&](uint32_t first, uint32_t count, float (&tBest)[BVHRayPacket::kWidth]) {
+                for (int i = 0; i < BVHRayPacket::kWidth; ++i)
+                    if (tBest[i] > 0.0f && k.intersect(mesh, first, count, rays[i].origin, rays[i].direction, tBest[i], packetHit[i]))
+                        mask |= 1 << i;
+            });
+            assert(!(mask & 8) && "inactive lane must not report hits");
+
+            for (int i = 0; i < 3; ++i)
+            {
+                float t = 1e30f;
+                simd::LeafHit single;
+                const bool hit = bvh.intersectRanges(rays[i], t, [&](uint32_t first, uint32_t count, float& tBest) {
+                    return scalar.intersect(mesh, first, count, rays[i].origin, rays[i].direction, tBest, single);
+                });
+                assert(hit == ((mask >> i) & 1) && "packet and single ray must agree on hit/miss");
+                if (hit)
+                {
+                    assert(tMax[i] == t && packetHit[i].triangle == single.triangle);
+                    ++hits;
+                }
+            }
+        }
+        assert(hits > 0);
+        std::cout << "✓ Packet traversal matches single-ray traversal (" << hits << " hits)" << std::endl;
+    }
+
+    // Case 4: packet any-hit (shadow rays from one point) agrees with single rays
+    {
+        const simd::Kernels& k = simd::kernels();
+        int blocked = 0;
+        for (int p = 0; p < 500; ++p)
+        {
+            const Ray seed = randomRay(rng);
+            Ray rays[BVHRayPacket::kWidth];
+            float tMax[BVHRayPacket::kWidth];
+            for (int i = 0; i < BVHRayPacket::kWidth; ++i)
+            {
+                rays[i] = Ray(seed.origin, randomRay(rng).direction);
+                tMax[i] = 0.5f + 0.5f * static_cast<float>(i);
+            }
+            const float limit[BVHRayPacket::kWidth] = { tMax[0], tMax[1], tMax[2], tMax[3] };
+
+            const int mask = bvh.intersectAnyPacket(BVHRayPacket(rays), tMax, [&](uint32_t first, uint32_t count, float (&tBest)[BVHRayPacket::kWidth]) {
+                int found = 0;
+                for (int i = 0; i < BVHRayPacket::kWidth; ++i)
+                    if (tBest[i] >= 0.0f && k.occluded(mesh, first, count, rays[i].origin, rays[i].direction, tBest[i]))
+                        found |= 1 << i;
+                return found;
+            });
+
+            for (int i = 0; i < BVHRayPacket::kWidth; ++i)
+            {
+                const bool single = bvh.intersectAnyRanges(rays[i], limit[i], [&](uint32_t first, uint32_t count, float t) {
+                    return scalar.occluded(mesh, first, count, rays[i].origin, rays[i].direction, t);
+                });
+                assert(single == ((mask >> i) & 1) && "packet any-hit must match single-ray occlusion");
+                blocked += single ? 1 : 0;
+            }
+        }
+        assert(blocked > 0);
+        std::cout << "✓ Packet any-hit matches single-ray occlusion (" << blocked << " blocked)" << std::endl;
+    }
+
+    std::cout << "\n✅ SIMD triangle kernel tests passed!\n";
+    return 0;
+}